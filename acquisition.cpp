@@ -0,0 +1,182 @@
+/******************************************************************************
+ * @file    acquisition.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Concurrent sensor acquisition. Each bus worker blocks on its
+ *          start semaphore, runs its jobs and sets its bit in the event
+ *          group the loop task waits on. The jobs write to the output buffer
+ *          of their bus, so no lock is taken around them; the loop task
+ *          reads it after the join, only when the bus completed in time.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "acquisition.h"
+#include <string.h>
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+
+typedef struct
+{
+  acqJob_t jobs[ACQ_MAX_JOBS_PER_BUS];
+  uint8_t jobCount;
+  bool busy; /*!< started and not joined yet, owned by the loop task */
+  void *out; /*!< results of the run, owned by the worker while busy */
+  size_t outSize;
+  SemaphoreHandle_t start;
+  TaskHandle_t task;
+  StaticTask_t taskBuffer;
+  StackType_t stack[ACQ_TASK_STACK_SIZE];
+} acqWorker_t;
+
+static acqWorker_t tWorkers[ACQ_BUS_MAX];
+static const char *const pcWorkerNames[ACQ_BUS_MAX] = {"acqI2c", "acqUart", "acqAdc"};
+
+static EventGroupHandle_t acqDoneGroup = NULL;
+static StaticEventGroup_t acqDoneGroupBuffer;
+
+/******************************************************
+ * @brief worker of one bus
+ ******************************************************/
+static void vMspAcq_workerTask(void *pvParameters)
+{
+  acqWorker_t *p_tWorker = (acqWorker_t *)pvParameters;
+  EventBits_t doneBit = (EventBits_t)(1U << (p_tWorker - tWorkers));
+
+  for (;;)
+  {
+    xSemaphoreTake(p_tWorker->start, portMAX_DELAY);
+    if (p_tWorker->out != NULL)
+    {
+      memset(p_tWorker->out, 0, p_tWorker->outSize);
+    }
+    for (uint8_t i = 0; i < p_tWorker->jobCount; i++)
+    {
+      p_tWorker->jobs[i]();
+    }
+    xEventGroupSetBits(acqDoneGroup, doneBit);
+  }
+}
+
+void vMspAcq_init(void)
+{
+  if (acqDoneGroup == NULL)
+  {
+    acqDoneGroup = xEventGroupCreateStatic(&acqDoneGroupBuffer);
+    if (acqDoneGroup == NULL)
+    {
+      log_e("Failed to create acquisition event group");
+      return;
+    }
+  }
+
+  for (uint32_t bus = 0; bus < ACQ_BUS_MAX; bus++)
+  {
+    acqWorker_t *p_tWorker = &tWorkers[bus];
+    if (p_tWorker->task != NULL)
+    {
+      continue;
+    }
+    p_tWorker->start = xSemaphoreCreateBinary();
+    if (p_tWorker->start == NULL)
+    {
+      log_e("Failed to create the start semaphore of %s", pcWorkerNames[bus]);
+      continue;
+    }
+    p_tWorker->task = xTaskCreateStaticPinnedToCore(
+        vMspAcq_workerTask,
+        pcWorkerNames[bus],
+        ACQ_TASK_STACK_SIZE,
+        p_tWorker,
+        ACQ_TASK_PRIORITY,
+        p_tWorker->stack,
+        &p_tWorker->taskBuffer,
+        1 // Core 1, with the loop task
+    );
+    if (p_tWorker->task == NULL)
+    {
+      log_e("Failed to create acquisition task %s", pcWorkerNames[bus]);
+    }
+  }
+  log_i("Acquisition workers created");
+}
+
+bool bMspAcq_addJob(acqBus_t bus, acqJob_t job)
+{
+  if (((uint32_t)bus >= ACQ_BUS_MAX) || (tWorkers[bus].jobCount >= ACQ_MAX_JOBS_PER_BUS))
+  {
+    log_e("No room for another acquisition job on bus %d", (int)bus);
+    return false;
+  }
+  tWorkers[bus].jobs[tWorkers[bus].jobCount++] = job;
+  return true;
+}
+
+void vMspAcq_setOutput(acqBus_t bus, void *p_vOut, size_t size)
+{
+  if ((uint32_t)bus < ACQ_BUS_MAX)
+  {
+    tWorkers[bus].out = p_vOut;
+    tWorkers[bus].outSize = size;
+  }
+}
+
+uint32_t ulMspAcq_run(TickType_t timeout)
+{
+  EventBits_t finished = (acqDoneGroup != NULL) ? xEventGroupGetBits(acqDoneGroup) : 0;
+  EventBits_t started = 0;
+  uint32_t completed = 0;
+
+  for (uint32_t bus = 0; bus < ACQ_BUS_MAX; bus++)
+  {
+    acqWorker_t *p_tWorker = &tWorkers[bus];
+    EventBits_t bit = (EventBits_t)(1U << bus);
+    if ((p_tWorker->jobCount == 0) || (p_tWorker->task == NULL))
+    {
+      completed |= bit; // nothing to wait for
+      continue;
+    }
+    if (p_tWorker->busy && !(finished & bit))
+    {
+      log_w("Acquisition bus %s still busy from the previous run, skipped", pcWorkerNames[bus]);
+      continue;
+    }
+    p_tWorker->busy = true;
+    started |= bit;
+  }
+
+  if (started == 0)
+  {
+    return completed;
+  }
+
+  // a bit left set by a late worker is cleared only when the bus starts again
+  xEventGroupClearBits(acqDoneGroup, started);
+  for (uint32_t bus = 0; bus < ACQ_BUS_MAX; bus++)
+  {
+    if (started & (1U << bus))
+    {
+      xSemaphoreGive(tWorkers[bus].start);
+    }
+  }
+
+  EventBits_t done = xEventGroupWaitBits(acqDoneGroup, started, pdFALSE, pdTRUE, timeout) & started;
+  for (uint32_t bus = 0; bus < ACQ_BUS_MAX; bus++)
+  {
+    if (done & (1U << bus))
+    {
+      tWorkers[bus].busy = false;
+    }
+    else if (started & (1U << bus))
+    {
+      log_e("Acquisition bus %s did not complete in time, its sample is dropped", pcWorkerNames[bus]);
+    }
+  }
+  xEventGroupClearBits(acqDoneGroup, done);
+
+  return completed | (uint32_t)done;
+}
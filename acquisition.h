@@ -0,0 +1,83 @@
+/******************************************************************************
+ * @file    acquisition.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Concurrent sensor acquisition: one worker task per bus runs the
+ *          read jobs registered on it in order, the buses run in parallel,
+ *          so a sample takes as long as the slowest bus instead of the sum
+ *          of every sensor retry chain.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef ACQUISITION_H
+#define ACQUISITION_H
+
+// -- includes --
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+
+// buses whose transactions conflict, jobs on the same bus never overlap
+typedef enum __ACQ_BUS__
+{
+  ACQ_BUS_I2C,  /*!< BME680, MICS6814/MICS4514 */
+  ACQ_BUS_UART, /*!< PMS5003 */
+  ACQ_BUS_ADC,  /*!< analog O3 */
+  ACQ_BUS_MAX
+} acqBus_t;
+
+typedef void (*acqJob_t)(void);
+
+#define ACQ_MAX_JOBS_PER_BUS 4
+#define ACQ_ALL_BUSES ((1U << ACQ_BUS_MAX) - 1U)
+
+// Acquisition task configuration
+#ifndef ACQ_TASK_STACK_SIZE
+#define ACQ_TASK_STACK_SIZE (6 * 1024) // BSEC and the log calls of the read jobs
+#endif
+
+#ifndef ACQ_TASK_PRIORITY
+#define ACQ_TASK_PRIORITY 3 // above the loop task, which waits for the jobs anyway
+#endif
+
+#ifndef ACQ_RUN_TIMEOUT_MS
+#define ACQ_RUN_TIMEOUT_MS 30000 // far above the worst retry chain
+#endif
+
+/******************************************************
+ * @brief creates the worker tasks and the completion
+ *        event group
+ ******************************************************/
+void vMspAcq_init(void);
+
+/******************************************************
+ * @brief registers a read job, jobs of a bus run in
+ *        the order they were added
+ *
+ * @return false when the bus has no free job slot
+ ******************************************************/
+bool bMspAcq_addJob(acqBus_t bus, acqJob_t job);
+
+/******************************************************
+ * @brief gives a bus the buffer its jobs write their
+ *        results to, cleared by the worker before each
+ *        run; it is read only for the buses
+ *        ulMspAcq_run() returns as completed, so a late
+ *        run writes nothing the loop task uses and its
+ *        results are dropped when the bus starts again
+ ******************************************************/
+void vMspAcq_setOutput(acqBus_t bus, void *p_vOut, size_t size);
+
+/******************************************************
+ * @brief starts every bus and waits for their jobs
+ *
+ * @param timeout ticks to wait for the slowest bus
+ * @return bit mask (1 << acqBus_t) of the buses that
+ *         completed; a bus still running from an
+ *         earlier timeout is not started again
+ ******************************************************/
+uint32_t ulMspAcq_run(TickType_t timeout);
+
+#endif
@@ -0,0 +1,220 @@
+/******************************************************************************
+ * @file    aqIndex.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Rolling windows of the air quality indices. A window is a ring of
+ *          buckets on epoch boundaries with a running sum and count, the
+ *          bucket that falls out is taken off them before it is reused. The
+ *          loop task adds the samples, the display task reads the means,
+ *          under a mutex held for one sample.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "aqIndex.h"
+#include "freertos/semphr.h"
+
+#define AQ_MAX_BUCKETS 24
+#define AQ_CAQI_GRID_POINTS 5
+
+typedef struct
+{
+  stats_channel_t channel;
+  uint8_t buckets;
+  uint32_t bucketS;
+} aqWindowSpec_t;
+
+typedef struct
+{
+  bool started;
+  uint32_t slot;      /*!< epoch / bucketS of the last sample */
+  uint32_t lastEpoch;
+  double total;
+  uint32_t count;
+  double sum[AQ_MAX_BUCKETS];
+  uint16_t samples[AQ_MAX_BUCKETS];
+} aqWindowState_t;
+
+// 1 h in 5 minutes, 8 h in half hours, 24 h in hours
+static const aqWindowSpec_t tSpecs[AQ_WINDOW_MAX] = {
+    {STATS_CH_NO2, 12, 300UL},
+    {STATS_CH_O3, 12, 300UL},
+    {STATS_CH_O3, 16, 1800UL},
+    {STATS_CH_PM25, 24, 3600UL},
+    {STATS_CH_PM10, 24, 3600UL},
+};
+static const char *const pcWindowNames[AQ_WINDOW_MAX] = {"no2_1h", "o3_1h", "o3_8h", "pm25_24h", "pm10_24h"};
+
+// CAQI background grid, concentrations (ug/m3) at the sub index 0, 25, 50, 75, 100
+static const float fCaqiGrid[AQ_WINDOW_MAX][AQ_CAQI_GRID_POINTS] = {
+    {0.0f, 50.0f, 100.0f, 200.0f, 400.0f},
+    {0.0f, 60.0f, 120.0f, 180.0f, 240.0f},
+    {0.0f, 0.0f, 0.0f, 0.0f, 0.0f}, // not on the grid
+    {0.0f, 10.0f, 20.0f, 30.0f, 60.0f},
+    {0.0f, 15.0f, 30.0f, 50.0f, 100.0f},
+};
+
+static aqWindowState_t tWindows[AQ_WINDOW_MAX];
+static uint32_t ulPeriodS;
+static SemaphoreHandle_t aqMutex = NULL;
+static StaticSemaphore_t aqMutexBuffer;
+
+/******************************************************
+ * @brief moves a window to the bucket of epoch, the
+ *        buckets it goes past are taken off the sums
+ ******************************************************/
+static void vMspAq_advance(aqWindowState_t *p_tWindow, const aqWindowSpec_t *p_tSpec, uint32_t epoch)
+{
+  uint32_t slot = epoch / p_tSpec->bucketS;
+  if (!p_tWindow->started || (slot < p_tWindow->slot))
+  {
+    // first sample, or the clock stepped back: the window starts over
+    memset(p_tWindow, 0, sizeof(*p_tWindow));
+    p_tWindow->started = true;
+    p_tWindow->slot = slot;
+    return;
+  }
+
+  uint32_t steps = slot - p_tWindow->slot;
+  if (steps > p_tSpec->buckets)
+  {
+    steps = p_tSpec->buckets;
+  }
+  for (uint32_t i = 1; i <= steps; i++)
+  {
+    uint32_t index = (p_tWindow->slot + i) % p_tSpec->buckets;
+    p_tWindow->total -= p_tWindow->sum[index];
+    p_tWindow->count -= p_tWindow->samples[index];
+    p_tWindow->sum[index] = 0.0;
+    p_tWindow->samples[index] = 0;
+  }
+  if (p_tWindow->count == 0)
+  {
+    p_tWindow->total = 0.0; // no rounding left over from the buckets gone
+  }
+  p_tWindow->slot = slot;
+}
+
+/******************************************************
+ * @brief sub index of a concentration on the CAQI grid,
+ *        the last slope carried on past 100
+ ******************************************************/
+static float fMspAq_subIndex(const float *p_fGrid, float value)
+{
+  if (value <= 0.0f)
+  {
+    return 0.0f;
+  }
+  int i = 1;
+  while ((i < (AQ_CAQI_GRID_POINTS - 1)) && (value > p_fGrid[i]))
+  {
+    i++;
+  }
+  return 25.0f * ((float)(i - 1) + ((value - p_fGrid[i - 1]) / (p_fGrid[i] - p_fGrid[i - 1])));
+}
+
+void vMspAq_init(uint32_t samplingPeriodS)
+{
+  if (aqMutex == NULL)
+  {
+    aqMutex = xSemaphoreCreateMutexStatic(&aqMutexBuffer);
+  }
+  xSemaphoreTake(aqMutex, portMAX_DELAY);
+  memset(tWindows, 0, sizeof(tWindows));
+  ulPeriodS = (samplingPeriodS > 0) ? samplingPeriodS : 1U;
+  xSemaphoreGive(aqMutex);
+}
+
+void vMspAq_add(const sensorSample_t *p_tSample)
+{
+  xSemaphoreTake(aqMutex, portMAX_DELAY);
+  for (int w = 0; w < AQ_WINDOW_MAX; w++)
+  {
+    const aqWindowSpec_t *p_tSpec = &tSpecs[w];
+    aqWindowState_t *p_tWindow = &tWindows[w];
+    // a channel not read still moves its window on, the old buckets go
+    vMspAq_advance(p_tWindow, p_tSpec, p_tSample->epoch);
+    p_tWindow->lastEpoch = p_tSample->epoch;
+    if (bMspRing_hasChannel(p_tSample, p_tSpec->channel))
+    {
+      uint32_t index = p_tWindow->slot % p_tSpec->buckets;
+      p_tWindow->sum[index] += (double)p_tSample->value[p_tSpec->channel];
+      p_tWindow->samples[index]++;
+      p_tWindow->total += (double)p_tSample->value[p_tSpec->channel];
+      p_tWindow->count++;
+    }
+  }
+  xSemaphoreGive(aqMutex);
+}
+
+bool bMspAq_mean(aqWindow_t window, float *p_fMean)
+{
+  if ((window >= AQ_WINDOW_MAX) || (aqMutex == NULL))
+  {
+    return false;
+  }
+
+  const aqWindowSpec_t *p_tSpec = &tSpecs[window];
+  xSemaphoreTake(aqMutex, portMAX_DELAY);
+  const aqWindowState_t *p_tWindow = &tWindows[window];
+  // the window ends with the sampling period of the last sample
+  uint64_t span = ((uint64_t)(p_tSpec->buckets - 1U) * p_tSpec->bucketS) + (p_tWindow->lastEpoch % p_tSpec->bucketS) + ulPeriodS;
+  uint64_t full = (uint64_t)p_tSpec->buckets * p_tSpec->bucketS;
+  if (span > full)
+  {
+    span = full;
+  }
+  bool covered = (p_tWindow->count > 0) && (((uint64_t)p_tWindow->count * ulPeriodS * 100U) >= (span * AQ_MIN_COVERAGE_PCT));
+  if (covered)
+  {
+    *p_fMean = (float)(p_tWindow->total / (double)p_tWindow->count);
+  }
+  xSemaphoreGive(aqMutex);
+  return covered;
+}
+
+void vMspAq_applyWindows(sensorData_t *p_tData)
+{
+  float mean;
+  if (bMspAq_mean(AQ_WINDOW_PM25_24H, &mean))
+  {
+    p_tData->airQualityData.particleMicron25 = (int32_t)lroundf(mean);
+  }
+  if (bMspAq_mean(AQ_WINDOW_NO2_1H, &mean))
+  {
+    p_tData->pollutionData.nitrogenDioxide = mean;
+  }
+  if (bMspAq_mean(AQ_WINDOW_O3_8H, &mean))
+  {
+    p_tData->ozoneData.ozone = mean;
+  }
+}
+
+int16_t sMspAq_caqi(const peripheralStatus_t *p_tStatus)
+{
+  // the sensors each window comes from, as for the MSP# index
+  const bool fitted[AQ_WINDOW_MAX] = {p_tStatus->MICS6814Sensor != 0, p_tStatus->O3Sensor != 0, false,
+                                      p_tStatus->PMS5003Sensor != 0, p_tStatus->PMS5003Sensor != 0};
+  float caqi = -1.0f;
+  for (int w = 0; w < AQ_WINDOW_MAX; w++)
+  {
+    float mean;
+    if (fitted[w] && bMspAq_mean((aqWindow_t)w, &mean))
+    {
+      float index = fMspAq_subIndex(fCaqiGrid[w], mean);
+      if (index > caqi)
+      {
+        caqi = index;
+      }
+    }
+  }
+  return (caqi < 0.0f) ? -1 : (int16_t)lroundf((caqi < (float)INT16_MAX) ? caqi : (float)INT16_MAX);
+}
+
+const char *pcMspAq_windowName(aqWindow_t window)
+{
+  return (window < AQ_WINDOW_MAX) ? pcWindowNames[window] : "?";
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+ * @file    aqIndex.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Air quality indices on the averaging windows of the standards:
+ *          rolling 1 h NO2 and O3, 8 h O3, 24 h PM2.5 and PM10 means, each
+ *          kept as a ring of bucket sums so that a sample costs O(1). The
+ *          MSP# index is rated on them, and the EU Common Air Quality Index
+ *          (CAQI, CiteAir II background grid) computed, instead of the
+ *          means of the transmission interval.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef AQ_INDEX_H
+#define AQ_INDEX_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+#include "sampleRing.h"
+
+#ifndef AQ_MIN_COVERAGE_PCT
+#define AQ_MIN_COVERAGE_PCT 75 // share of the window with samples for its mean to count, as the EU directive asks
+#endif
+
+typedef enum __AQ_WINDOW__
+{
+  AQ_WINDOW_NO2_1H = 0,
+  AQ_WINDOW_O3_1H,
+  AQ_WINDOW_O3_8H,
+  AQ_WINDOW_PM25_24H,
+  AQ_WINDOW_PM10_24H,
+  AQ_WINDOW_MAX
+} aqWindow_t;
+
+/******************************************************
+ * @brief empties the windows, at boot
+ ******************************************************/
+void vMspAq_init(uint32_t samplingPeriodS);
+
+/******************************************************
+ * @brief loop task: adds the channels of a sample to
+ *        their windows; O(1), a gap in the samples
+ *        empties the buckets it skipped
+ ******************************************************/
+void vMspAq_add(const sensorSample_t *p_tSample);
+
+/******************************************************
+ * @brief mean of a window, over the window up to the
+ *        last sample
+ *
+ * @return false below AQ_MIN_COVERAGE_PCT of the window
+ ******************************************************/
+bool bMspAq_mean(aqWindow_t window, float *p_fMean);
+
+/******************************************************
+ * @brief replaces PM2.5 (24 h), NO2 (1 h) and O3 (8 h)
+ *        with their window means, for the MSP# index;
+ *        a window not covered yet keeps the value given
+ ******************************************************/
+void vMspAq_applyWindows(sensorData_t *p_tData);
+
+/******************************************************
+ * @brief CAQI of the sensors fitted: the highest sub
+ *        index of NO2 (1 h), O3 (1 h), PM10 and PM2.5
+ *        (24 h), above 100 past the grid
+ *
+ * @return -1 when no window is covered yet
+ ******************************************************/
+int16_t sMspAq_caqi(const peripheralStatus_t *p_tStatus);
+
+/******************************************************
+ * @brief short name of a window, in the log
+ ******************************************************/
+const char *pcMspAq_windowName(aqWindow_t window);
+
+#endif
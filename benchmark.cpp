@@ -0,0 +1,273 @@
+/******************************************************************************
+ * @file    benchmark.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Microbenchmarks of the sensor math run in every measurement cycle:
+ *          gas compensation, ozone conversion, MICS4514 Rs/R0 curves, ppm to
+ *          ug/m3, ISA pressure reduction and MSP# index. Each case calls the
+ *          firmware function over a small table of realistic inputs; the
+ *          median of MSP_BENCH_RUNS runs is reported next to the fastest.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifdef MSP_BENCHMARK
+
+// -- includes --
+#include "benchmark.h"
+#include "sensors.h"
+#include "generic_functions.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <esp_heap_caps.h>
+#endif
+
+#define MSP_BENCH_INPUT_MASK (MSP_BENCH_INPUTS - 1)
+#define MSP_BENCH_WARMUP_DIVISOR 10 /*!< warm-up run length, fraction of a timed run */
+
+typedef float (*mspBenchLoop_t)(uint32_t iterations);
+
+typedef struct
+{
+  const char *name;
+  mspBenchLoop_t loop;
+} mspBenchCase_t;
+
+typedef struct
+{
+  bme680Data_t bme[MSP_BENCH_INPUTS];
+  float gas[MSP_BENCH_INPUTS];
+  float rsRed[MSP_BENCH_INPUTS];
+  float rsOx[MSP_BENCH_INPUTS];
+  float ppm[MSP_BENCH_INPUTS];
+  int o3Points[MSP_BENCH_INPUTS];
+  sensorData_t data[MSP_BENCH_INPUTS]; /*!< calibration and averaged values */
+} mspBenchInputs_t;
+
+static mspBenchInputs_t tInputs;
+static volatile float fSink; // keeps the results alive
+static uint32_t ulSeed = 1;
+
+#ifdef ARDUINO_ARCH_ESP32
+uint32_t ulMspBench_ticks(void)
+{
+  return ESP.getCycleCount();
+}
+
+uint32_t ulMspBench_ticksPerUs(void)
+{
+  return getCpuFrequencyMhz();
+}
+
+uint32_t ulMspBench_allocations(void)
+{
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_DEFAULT);
+  return info.allocated_blocks;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// inputs
+//------------------------------------------------------------------------------
+
+static float fMspBench_uniform(float low, float high)
+{
+  ulSeed = (ulSeed * 1103515245U) + 12345U;
+  return low + ((high - low) * (float)(ulSeed >> 8) / (float)(1U << 24));
+}
+
+/******************************************************
+ * @brief inputs spread over the range seen in the
+ *        field, calibration as the firmware defaults
+ ******************************************************/
+static void vMspBench_initInputs(void)
+{
+  memset(&tInputs, 0, sizeof(tInputs));
+  for (uint32_t i = 0; i < MSP_BENCH_INPUTS; i++)
+  {
+    tInputs.bme[i].temperature = fMspBench_uniform(-10.0f, 40.0f);
+    tInputs.bme[i].humidity = fMspBench_uniform(20.0f, 100.0f);
+    tInputs.bme[i].pressure = fMspBench_uniform(960.0f, 1040.0f);
+    tInputs.bme[i].seaLevelAltitude = SEA_LEVEL_ALTITUDE_IN_M;
+    tInputs.gas[i] = fMspBench_uniform(5.0f, 300.0f);
+    tInputs.rsRed[i] = fMspBench_uniform(0.05f, 5.0f);
+    tInputs.rsOx[i] = fMspBench_uniform(0.02f, 40.0f);
+    tInputs.ppm[i] = fMspBench_uniform(0.0f, 10.0f);
+    tInputs.o3Points[i] = (int)fMspBench_uniform(-50.0f, 1000.0f);
+
+    sensorData_t *p_tData = &tInputs.data[i];
+    p_tData->status.BME680Sensor = true;
+    p_tData->status.PMS5003Sensor = true;
+    p_tData->status.MICS6814Sensor = true;
+    p_tData->status.O3Sensor = true;
+    p_tData->molarMass.carbonMonoxide = CO_MOLAR_MASS;
+    p_tData->molarMass.nitrogenDioxide = NO2_MOLAR_MASS;
+    p_tData->molarMass.ammonia = NH3_MOLAR_MASS;
+    p_tData->compParams.currentHumidity = HUMIDITY_COMP_PARAM;
+    p_tData->compParams.currentTemperature = TEMP_COMP_PARAM;
+    p_tData->compParams.currentPressure = PRESS_COMP_PARAM;
+    p_tData->airQualityData.particleMicron25 = (int)fMspBench_uniform(0.0f, 80.0f);
+    p_tData->pollutionData.nitrogenDioxide = fMspBench_uniform(0.0f, 500.0f);
+    p_tData->ozoneData.ozone = fMspBench_uniform(0.0f, 300.0f);
+  }
+}
+
+//------------------------------------------------------------------------------
+// cases
+//------------------------------------------------------------------------------
+
+static float fMspBench_baseline(uint32_t iterations)
+{
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    acc += tInputs.gas[i & MSP_BENCH_INPUT_MASK];
+  }
+  return acc;
+}
+
+static float fMspBench_compensation(uint32_t iterations)
+{
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    uint32_t k = i & MSP_BENCH_INPUT_MASK;
+    acc += fHalSensor_no2AndVocCompensation(tInputs.gas[k], &tInputs.bme[k], &tInputs.data[k]);
+  }
+  return acc;
+}
+
+static float fMspBench_ozone(uint32_t iterations)
+{
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    uint32_t k = i & MSP_BENCH_INPUT_MASK;
+    acc += fHalSensor_o3PointsToUgM3(tInputs.o3Points[k], tInputs.bme[k].temperature);
+  }
+  return acc;
+}
+
+static float fMspBench_rsR0(uint32_t iterations)
+{
+  float acc = 0.0f;
+  MICS4514SensorReading_t reading;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    uint32_t k = i & MSP_BENCH_INPUT_MASK;
+    tHalSensor_calculateGasFromRsR0(tInputs.rsRed[k], tInputs.rsOx[k], &reading);
+    acc += reading.carbonMonoxide + reading.nitrogenDioxide + reading.ammonia;
+  }
+  return acc;
+}
+
+static float fMspBench_ppmToUgM3(uint32_t iterations)
+{
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    acc += vGeneric_convertPpmToUgM3(tInputs.ppm[i & MSP_BENCH_INPUT_MASK], NO2_MOLAR_MASS);
+  }
+  return acc;
+}
+
+static float fMspBench_seaLevelPressure(uint32_t iterations)
+{
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    const bme680Data_t *p_tBme = &tInputs.bme[i & MSP_BENCH_INPUT_MASK];
+    acc += fHalSensor_seaLevelPressure(p_tBme->pressure, p_tBme->temperature, p_tBme->seaLevelAltitude);
+  }
+  return acc;
+}
+
+static float fMspBench_mspIndex(uint32_t iterations)
+{
+  float acc = 0.0f;
+  for (uint32_t i = 0; i < iterations; i++)
+  {
+    acc += sHalSensor_evaluateMSPIndex(&tInputs.data[i & MSP_BENCH_INPUT_MASK]);
+  }
+  return acc;
+}
+
+static const mspBenchCase_t tCases[] = {
+    {"loop baseline", fMspBench_baseline},
+    {"no2AndVocCompensation", fMspBench_compensation},
+    {"o3PointsToUgM3", fMspBench_ozone},
+    {"calculateGasFromRsR0", fMspBench_rsR0},
+    {"convertPpmToUgM3", fMspBench_ppmToUgM3},
+    {"seaLevelPressure (pow)", fMspBench_seaLevelPressure},
+    {"evaluateMSPIndex", fMspBench_mspIndex},
+};
+
+//------------------------------------------------------------------------------
+// runner
+//------------------------------------------------------------------------------
+
+static void vMspBench_sort(uint32_t *p_ulTicks, uint32_t count)
+{
+  for (uint32_t i = 1; i < count; i++)
+  {
+    uint32_t value = p_ulTicks[i];
+    uint32_t j = i;
+    while ((j > 0) && (p_ulTicks[j - 1] > value))
+    {
+      p_ulTicks[j] = p_ulTicks[j - 1];
+      j--;
+    }
+    p_ulTicks[j] = value;
+  }
+}
+
+/******************************************************
+ * @brief time one case and print its line
+ ******************************************************/
+static void vMspBench_measure(const mspBenchCase_t *p_tCase)
+{
+  uint32_t ticks[MSP_BENCH_RUNS];
+  fSink = fSink + p_tCase->loop(MSP_BENCH_ITERATIONS / MSP_BENCH_WARMUP_DIVISOR);
+
+  uint32_t allocations = ulMspBench_allocations();
+  for (uint32_t run = 0; run < MSP_BENCH_RUNS; run++)
+  {
+    uint32_t start = ulMspBench_ticks();
+    fSink = fSink + p_tCase->loop(MSP_BENCH_ITERATIONS);
+    ticks[run] = ulMspBench_ticks() - start;
+  }
+  allocations = ulMspBench_allocations() - allocations;
+  vMspBench_sort(ticks, MSP_BENCH_RUNS);
+
+  float perOp = (float)ticks[MSP_BENCH_RUNS / 2] / (float)MSP_BENCH_ITERATIONS;
+  float bestPerOp = (float)ticks[0] / (float)MSP_BENCH_ITERATIONS;
+  float ticksPerNs = (float)ulMspBench_ticksPerUs() / 1000.0f;
+  printf("%-24s %10.2f %10.2f", p_tCase->name, perOp / ticksPerNs, bestPerOp / ticksPerNs);
+#ifdef MSP_BENCH_CYCLES
+  printf(" %10.1f", perOp);
+#endif
+  printf(" %10.3f\n", (float)allocations / (float)(MSP_BENCH_ITERATIONS * MSP_BENCH_RUNS));
+}
+
+void vMspBench_run(void)
+{
+  vMspBench_initInputs();
+  printf("\n==== SENSOR MATH BENCHMARK ====\n");
+  printf("%u calls x %u runs per case, %u distinct inputs, median run reported\n",
+         (unsigned)MSP_BENCH_ITERATIONS, (unsigned)MSP_BENCH_RUNS, (unsigned)MSP_BENCH_INPUTS);
+  printf("%-24s %10s %10s", "case", "ns/op", "best ns/op");
+#ifdef MSP_BENCH_CYCLES
+  printf(" %10s", "cycles/op");
+#endif
+  printf(" %10s\n", "allocs/op");
+  for (size_t i = 0; i < (sizeof(tCases) / sizeof(tCases[0])); i++)
+  {
+    vMspBench_measure(&tCases[i]);
+  }
+  printf("===============================\n");
+}
+
+#endif
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * @file    benchmark.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Microbenchmarks of the sensor math run in every measurement cycle.
+ *          Compiled only when MSP_BENCHMARK is defined (make build BENCHMARK=1
+ *          for the board, make host-bench for the host): the firmware then
+ *          runs the suite once at boot and prints it on the debug serial.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// -- includes --
+#include <Arduino.h>
+
+#ifdef ARDUINO_ARCH_ESP32
+#define MSP_BENCH_ITERATIONS 20000U   /*!< calls per timed run */
+#define MSP_BENCH_CYCLES              /*!< ticks are CCOUNT CPU cycles, printed next to the ns */
+#else
+#define MSP_BENCH_ITERATIONS 2000000U /*!< calls per timed run, ticks are ns of the monotonic clock */
+#endif
+
+#define MSP_BENCH_RUNS 7    /*!< timed runs per case, the median is reported */
+#define MSP_BENCH_INPUTS 16 /*!< distinct inputs cycled through, power of two */
+
+/******************************************************
+ * @brief platform counters, the ESP32 ones live in
+ *        benchmark.cpp, the host ones in host_bench.cpp
+ ******************************************************/
+uint32_t ulMspBench_ticks(void);
+uint32_t ulMspBench_ticksPerUs(void);
+
+/******************************************************
+ * @brief heap allocations so far: every call on the
+ *        host, blocks in use on the ESP32 (net count)
+ ******************************************************/
+uint32_t ulMspBench_allocations(void);
+
+/******************************************************
+ * @brief runs every case and prints ns/op, ticks/op
+ *        and allocations/op
+ ******************************************************/
+void vMspBench_run(void);
+
+#endif
@@ -0,0 +1,162 @@
+/******************************************************************************
+ * @file    bootPipeline.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Boot pipeline. A lane task walks the stage table, waits in the
+ *          event group for the dependencies of each of its stages, runs it
+ *          and sets the stage bit; the caller runs the main lane the same
+ *          way, then waits for every bit. Lane tasks are only needed at
+ *          boot, so they are created on the heap and delete themselves.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "bootPipeline.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+typedef struct
+{
+  uint32_t startMs; /*!< from the start of the pipeline */
+  uint32_t endMs;
+} bootStageTiming_t;
+
+static const bootStage_t *p_tBootStages = NULL;
+static uint8_t bootStageCount = 0;
+static uint32_t bootStartMs = 0;
+static bootStageTiming_t tBootTiming[BOOT_MAX_STAGES];
+static const char *const pcLaneNames[BOOT_LANE_MAX] = {"main", "i2c", "uart", "adc"};
+static const char *const pcLaneTaskNames[BOOT_LANE_MAX] = {"bootMain", "bootI2c", "bootUart", "bootAdc"};
+
+static EventGroupHandle_t bootDoneGroup = NULL;
+static StaticEventGroup_t bootDoneGroupBuffer;
+
+/******************************************************
+ * @brief runs the stages of a lane in table order
+ ******************************************************/
+static void vMspBoot_runLane(bootLane_t lane)
+{
+  for (uint8_t i = 0; i < bootStageCount; i++)
+  {
+    const bootStage_t *p_tStage = &p_tBootStages[i];
+    if (p_tStage->lane != lane)
+    {
+      continue;
+    }
+    if ((p_tStage->deps != 0) &&
+        ((xEventGroupWaitBits(bootDoneGroup, (EventBits_t)p_tStage->deps, pdFALSE, pdTRUE, pdMS_TO_TICKS(BOOT_RUN_TIMEOUT_MS)) &
+          p_tStage->deps) != p_tStage->deps))
+    {
+      log_e("Boot stage %s skipped, the stages it needs did not complete", p_tStage->name);
+      continue;
+    }
+    tBootTiming[i].startMs = millis() - bootStartMs;
+    p_tStage->run();
+    tBootTiming[i].endMs = millis() - bootStartMs;
+    xEventGroupSetBits(bootDoneGroup, (EventBits_t)BOOT_DEP(i));
+  }
+}
+
+/******************************************************
+ * @brief task of a lane other than the main one
+ ******************************************************/
+static void vMspBoot_laneTask(void *pvParameters)
+{
+  vMspBoot_runLane((bootLane_t)(uintptr_t)pvParameters);
+  vTaskDelete(NULL);
+}
+
+/******************************************************
+ * @brief stage timing table; the sum of the stage
+ *        times is how long a sequential boot would take
+ ******************************************************/
+static void vMspBoot_logTiming(uint32_t completed)
+{
+  uint32_t sumMs = 0;
+  for (uint8_t i = 0; i < bootStageCount; i++)
+  {
+    if (!(completed & BOOT_DEP(i)))
+    {
+      log_e("boot stage %-10s (%s) did not complete", p_tBootStages[i].name, pcLaneNames[p_tBootStages[i].lane]);
+      continue;
+    }
+    uint32_t tookMs = tBootTiming[i].endMs - tBootTiming[i].startMs;
+    sumMs += tookMs;
+    log_i("boot stage %-10s (%-4s): start %6lu ms, took %6lu ms", p_tBootStages[i].name, pcLaneNames[p_tBootStages[i].lane],
+          (unsigned long)tBootTiming[i].startMs, (unsigned long)tookMs);
+  }
+  log_i("boot pipeline done in %lu ms, %lu ms of stages", (unsigned long)(millis() - bootStartMs), (unsigned long)sumMs);
+}
+
+uint32_t ulMspBoot_run(const bootStage_t *p_tStages, uint8_t count, TickType_t timeout)
+{
+  if (count > BOOT_MAX_STAGES)
+  {
+    log_e("Too many boot stages (%d), only %d run", count, BOOT_MAX_STAGES);
+    count = BOOT_MAX_STAGES;
+  }
+  for (uint8_t i = 0; i < count; i++)
+  {
+    // a dependency on a later stage could wait forever behind it in the same lane
+    if (p_tStages[i].deps & ~(BOOT_DEP(i) - 1UL))
+    {
+      log_e("Boot stage %s depends on a later stage, boot table rejected", p_tStages[i].name);
+      return 0;
+    }
+  }
+
+  if (bootDoneGroup == NULL)
+  {
+    bootDoneGroup = xEventGroupCreateStatic(&bootDoneGroupBuffer);
+    if (bootDoneGroup == NULL)
+    {
+      log_e("Failed to create boot event group");
+      return 0;
+    }
+  }
+  xEventGroupClearBits(bootDoneGroup, (EventBits_t)(BOOT_DEP(BOOT_MAX_STAGES) - 1UL));
+
+  p_tBootStages = p_tStages;
+  bootStageCount = count;
+  bootStartMs = millis();
+  memset(tBootTiming, 0, sizeof(tBootTiming));
+
+  uint32_t all = 0;
+  uint32_t lanes = 0;
+  for (uint8_t i = 0; i < count; i++)
+  {
+    all |= BOOT_DEP(i);
+    lanes |= 1UL << p_tStages[i].lane;
+  }
+
+  for (uint32_t lane = BOOT_LANE_MAIN + 1; lane < BOOT_LANE_MAX; lane++)
+  {
+    if (!(lanes & (1UL << lane)))
+    {
+      continue;
+    }
+    if (xTaskCreatePinnedToCore(vMspBoot_laneTask, pcLaneTaskNames[lane], BOOT_TASK_STACK_SIZE, (void *)(uintptr_t)lane,
+                                BOOT_TASK_PRIORITY, NULL, 1) != pdPASS)
+    {
+      // nothing can run them in parallel, the caller does after its own
+      log_w("Failed to create boot task %s, its stages run on the main lane", pcLaneTaskNames[lane]);
+      lanes &= ~(1UL << lane);
+    }
+  }
+
+  vMspBoot_runLane(BOOT_LANE_MAIN);
+  for (uint32_t lane = BOOT_LANE_MAIN + 1; lane < BOOT_LANE_MAX; lane++)
+  {
+    if (!(lanes & (1UL << lane)))
+    {
+      vMspBoot_runLane((bootLane_t)lane);
+    }
+  }
+
+  uint32_t completed = (uint32_t)xEventGroupWaitBits(bootDoneGroup, (EventBits_t)all, pdFALSE, pdTRUE, timeout) & all;
+  vMspBoot_logTiming(completed);
+  return completed;
+}
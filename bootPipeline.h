@@ -0,0 +1,74 @@
+/******************************************************************************
+ * @file    bootPipeline.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Boot as a dependency graph of init stages: each stage belongs to a
+ *          lane (the hardware it drives) and lists the stages it needs. The
+ *          lanes run in parallel, one task each, the stages of a lane in
+ *          table order, so the network task, the I2C sensors, the PMS5003 and
+ *          the O3 ADC come up together instead of one after the other.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef BOOT_PIPELINE_H
+#define BOOT_PIPELINE_H
+
+// -- includes --
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+
+// hardware a stage drives, stages of the same lane never overlap
+typedef enum __BOOT_LANE__
+{
+  BOOT_LANE_MAIN, /*!< SD card, configuration and network task, run by the caller */
+  BOOT_LANE_I2C,  /*!< BME680, MICS6814/MICS4514 */
+  BOOT_LANE_UART, /*!< PMS5003 */
+  BOOT_LANE_ADC,  /*!< analog O3 */
+  BOOT_LANE_MAX
+} bootLane_t;
+
+typedef void (*bootStageFn_t)(void);
+
+typedef struct __BOOT_STAGE__
+{
+  const char *name;
+  bootLane_t lane;
+  uint32_t deps; /*!< BOOT_DEP() mask of the stages to wait for, earlier in the table only */
+  bootStageFn_t run;
+} bootStage_t;
+
+#define BOOT_MAX_STAGES 16
+#define BOOT_DEP(stage) (1UL << (stage))
+
+// Boot task configuration
+#ifndef BOOT_TASK_STACK_SIZE
+#define BOOT_TASK_STACK_SIZE (6 * 1024) // BSEC init and the log calls of the stages
+#endif
+
+#ifndef BOOT_TASK_PRIORITY
+#define BOOT_TASK_PRIORITY 2 // above the loop task, which waits for the lanes anyway
+#endif
+
+#ifndef BOOT_RUN_TIMEOUT_MS
+#define BOOT_RUN_TIMEOUT_MS 60000 // far above the slowest sensor detection
+#endif
+
+/******************************************************
+ * @brief runs the stages: BOOT_LANE_MAIN on the calling
+ *        task, every other lane with stages on a task of
+ *        its own, deleted when its stages are done; the
+ *        timing of each stage is logged at the end
+ *
+ * @param p_tStages stage table, dependencies pointing
+ *        only to earlier entries
+ * @param count     entries in the table
+ * @param timeout   ticks to wait for the slowest lane
+ *        once the main one is done
+ * @return mask (1 << index) of the stages completed
+ ******************************************************/
+uint32_t ulMspBoot_run(const bootStage_t *p_tStages, uint8_t count, TickType_t timeout);
+
+#endif
@@ -0,0 +1,306 @@
+/******************************************************************************
+ * @file    channelStats.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Streaming statistics of a measurement channel. The mean and the
+ *          variance follow Welford's update, the median the P2 algorithm
+ *          (Jain and Chlamtac, 1985): five markers track the minimum, the
+ *          quartiles, the median and the maximum, and are moved along a
+ *          parabola as the samples arrive, so no sample is kept.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "channelStats.h"
+#include "channelTable.h"
+
+#define STATS_P2_MEDIAN_MARKER 2
+
+// shift of the desired marker positions at each sample, for the median (p = 0.5)
+static const float fP2Increment[STATS_P2_MARKERS] = {0.0f, 0.25f, 0.5f, 0.75f, 1.0f};
+
+static const char *const pcMethodNames[STATS_METHOD_MAX] = {
+    "mean",
+    "median",
+    "trimmed",
+};
+
+/******************************************************
+ * @brief in place insertion sort, for the few samples
+ *        held before the P2 markers start
+ ******************************************************/
+static void vMspStats_sort(float *p_fValues, uint32_t count)
+{
+  for (uint32_t i = 1; i < count; i++)
+  {
+    float value = p_fValues[i];
+    uint32_t j = i;
+    while ((j > 0) && (p_fValues[j - 1] > value))
+    {
+      p_fValues[j] = p_fValues[j - 1];
+      j--;
+    }
+    p_fValues[j] = value;
+  }
+}
+
+/******************************************************
+ * @brief piecewise parabolic prediction of a marker
+ *        moved by d (+1 or -1) positions
+ ******************************************************/
+static float fMspStats_parabolic(const channelStats_t *p_tStats, int i, int d)
+{
+  const float *q = p_tStats->height;
+  const int32_t *n = p_tStats->pos;
+  return q[i] + ((float)d / (float)(n[i + 1] - n[i - 1])) *
+                    (((float)(n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (float)(n[i + 1] - n[i])) +
+                     ((float)(n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (float)(n[i] - n[i - 1])));
+}
+
+/******************************************************
+ * @brief linear prediction, when the parabola leaves
+ *        the neighbouring markers
+ ******************************************************/
+static float fMspStats_linear(const channelStats_t *p_tStats, int i, int d)
+{
+  const float *q = p_tStats->height;
+  const int32_t *n = p_tStats->pos;
+  return q[i] + ((float)d * (q[i + d] - q[i]) / (float)(n[i + d] - n[i]));
+}
+
+/******************************************************
+ * @brief P2 update of the markers with a sample
+ ******************************************************/
+static void vMspStats_updateMarkers(channelStats_t *p_tStats, float value)
+{
+  float *q = p_tStats->height;
+  int32_t *n = p_tStats->pos;
+
+  if (p_tStats->count <= STATS_P2_MARKERS)
+  {
+    q[p_tStats->count - 1] = value;
+    if (p_tStats->count == STATS_P2_MARKERS)
+    {
+      vMspStats_sort(q, STATS_P2_MARKERS);
+      for (int i = 0; i < STATS_P2_MARKERS; i++)
+      {
+        n[i] = i;
+        p_tStats->desired[i] = 4.0f * fP2Increment[i];
+      }
+    }
+    return;
+  }
+
+  // cell of the sample, the extreme markers follow min and max
+  int k;
+  if (value < q[0])
+  {
+    q[0] = value;
+    k = 0;
+  }
+  else if (value >= q[STATS_P2_MARKERS - 1])
+  {
+    q[STATS_P2_MARKERS - 1] = value;
+    k = STATS_P2_MARKERS - 2;
+  }
+  else
+  {
+    k = 0;
+    while (value >= q[k + 1])
+    {
+      k++;
+    }
+  }
+
+  for (int i = k + 1; i < STATS_P2_MARKERS; i++)
+  {
+    n[i]++;
+  }
+  for (int i = 0; i < STATS_P2_MARKERS; i++)
+  {
+    p_tStats->desired[i] += fP2Increment[i];
+  }
+
+  // move the middle markers that fell one position or more off their desired one
+  for (int i = 1; i < (STATS_P2_MARKERS - 1); i++)
+  {
+    float offset = p_tStats->desired[i] - (float)n[i];
+    if (((offset >= 1.0f) && ((n[i + 1] - n[i]) > 1)) || ((offset <= -1.0f) && ((n[i - 1] - n[i]) < -1)))
+    {
+      int d = (offset > 0.0f) ? 1 : -1;
+      float height = fMspStats_parabolic(p_tStats, i, d);
+      if (!((q[i - 1] < height) && (height < q[i + 1])))
+      {
+        height = fMspStats_linear(p_tStats, i, d);
+      }
+      q[i] = height;
+      n[i] += d;
+    }
+  }
+}
+
+void vMspStats_reset(channelStats_t *p_tStats)
+{
+  memset(p_tStats, 0, sizeof(channelStats_t));
+}
+
+void vMspStats_resetAll(channelStats_t *p_tStats)
+{
+  memset(p_tStats, 0, sizeof(channelStats_t) * STATS_CH_MAX);
+}
+
+void vMspStats_add(channelStats_t *p_tStats, float value)
+{
+  p_tStats->count++;
+
+  double delta = (double)value - p_tStats->mean;
+  p_tStats->mean += delta / (double)p_tStats->count;
+  p_tStats->m2 += delta * ((double)value - p_tStats->mean);
+
+  if ((p_tStats->count == 1) || (value < p_tStats->min))
+  {
+    p_tStats->min = value;
+  }
+  if ((p_tStats->count == 1) || (value > p_tStats->max))
+  {
+    p_tStats->max = value;
+  }
+
+  vMspStats_updateMarkers(p_tStats, value);
+}
+
+void vMspStats_addTimed(channelStats_t *p_tStats, float value, uint32_t epoch, uint32_t periodS)
+{
+  uint32_t held = periodS;
+  if ((p_tStats->count > 0) && (epoch > p_tStats->lastEpoch))
+  {
+    // the value held since the previous sample, not longer than a few periods
+    held = epoch - p_tStats->lastEpoch;
+    if (held > (periodS * STATS_MAX_HOLD_PERIODS))
+    {
+      held = periodS * STATS_MAX_HOLD_PERIODS;
+    }
+  }
+  if (held != periodS)
+  {
+    p_tStats->uneven = true;
+  }
+
+  vMspStats_add(p_tStats, value);
+  p_tStats->weightedSum += (double)value * (double)held;
+  p_tStats->weight += (double)held;
+  p_tStats->lastEpoch = epoch;
+}
+
+float fMspStats_mean(const channelStats_t *p_tStats)
+{
+  return (float)p_tStats->mean;
+}
+
+float fMspStats_timeWeightedMean(const channelStats_t *p_tStats)
+{
+  if (p_tStats->weight <= 0.0)
+  {
+    return fMspStats_mean(p_tStats);
+  }
+  return (float)(p_tStats->weightedSum / p_tStats->weight);
+}
+
+float fMspStats_stdDev(const channelStats_t *p_tStats)
+{
+  if (p_tStats->count < 2)
+  {
+    return -1.0f;
+  }
+  return (float)sqrt(p_tStats->m2 / (double)(p_tStats->count - 1));
+}
+
+float fMspStats_median(const channelStats_t *p_tStats)
+{
+  if (p_tStats->count == 0)
+  {
+    return 0.0f;
+  }
+  if (p_tStats->count >= STATS_P2_MARKERS)
+  {
+    return p_tStats->height[STATS_P2_MEDIAN_MARKER];
+  }
+
+  // too few samples for the markers, exact median of the ones held
+  float sorted[STATS_P2_MARKERS];
+  memcpy(sorted, p_tStats->height, sizeof(float) * p_tStats->count);
+  vMspStats_sort(sorted, p_tStats->count);
+  uint32_t middle = p_tStats->count / 2;
+  if ((p_tStats->count % 2) == 0)
+  {
+    return (sorted[middle - 1] + sorted[middle]) / 2.0f;
+  }
+  return sorted[middle];
+}
+
+float fMspStats_trimmedMean(const channelStats_t *p_tStats)
+{
+  if (p_tStats->count < 3)
+  {
+    return fMspStats_mean(p_tStats);
+  }
+  double sum = p_tStats->mean * (double)p_tStats->count;
+  return (float)((sum - (double)p_tStats->min - (double)p_tStats->max) / (double)(p_tStats->count - 2));
+}
+
+float fMspStats_value(const channelStats_t *p_tStats, statsMethod_t method)
+{
+  switch (method)
+  {
+  case STATS_METHOD_MEDIAN:
+    return fMspStats_median(p_tStats);
+  case STATS_METHOD_TRIMMED_MEAN:
+    return fMspStats_trimmedMean(p_tStats);
+  case STATS_METHOD_MEAN:
+  default:
+    return fMspStats_timeWeightedMean(p_tStats);
+  }
+}
+
+const char *pcMspStats_channelName(stats_channel_t channel)
+{
+  return pcMspChan_name(channel);
+}
+
+bool bMspStats_parseChannel(const char *name, stats_channel_t *p_tChannel)
+{
+  for (int i = 0; i < STATS_CH_MAX; i++)
+  {
+    if (strcmp(name, pcMspChan_name((stats_channel_t)i)) == 0)
+    {
+      *p_tChannel = (stats_channel_t)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char *pcMspStats_methodName(statsMethod_t method)
+{
+  if (method >= STATS_METHOD_MAX)
+  {
+    return pcMethodNames[STATS_METHOD_MEAN];
+  }
+  return pcMethodNames[method];
+}
+
+bool bMspStats_parseMethod(const char *name, statsMethod_t *p_tMethod)
+{
+  for (int i = 0; i < STATS_METHOD_MAX; i++)
+  {
+    if (strcmp(name, pcMethodNames[i]) == 0)
+    {
+      *p_tMethod = (statsMethod_t)i;
+      return true;
+    }
+  }
+  return false;
+}
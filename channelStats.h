@@ -0,0 +1,138 @@
+/******************************************************************************
+ * @file    channelStats.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Streaming statistics of the samples of a measurement channel over
+ *          an averaging interval: Welford mean and variance, min, max, P2
+ *          median estimate and trimmed mean, in constant memory whatever
+ *          the number of samples.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef CHANNEL_STATS_H
+#define CHANNEL_STATS_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+
+#define STATS_P2_MARKERS 5 /*!< markers of the P2 quantile estimator */
+
+#ifndef STATS_MAX_HOLD_PERIODS
+#define STATS_MAX_HOLD_PERIODS 2 // sampling periods a sample stands for at most, a longer gap stays uncovered
+#endif
+
+// value of a channel over the averaging interval
+typedef enum __STATS_METHOD__
+{
+  STATS_METHOD_MEAN = 0,     /*!< time-weighted mean, the default */
+  STATS_METHOD_MEDIAN,       /*!< median, exact up to STATS_P2_MARKERS samples, P2 estimate above */
+  STATS_METHOD_TRIMMED_MEAN, /*!< mean without the lowest and the highest sample */
+  STATS_METHOD_MAX
+} statsMethod_t;
+
+typedef struct __CHANNEL_STATS__
+{
+  uint32_t count;                /*!< samples since the last reset */
+  double mean;                   /*!< running mean */
+  double m2;                     /*!< sum of the squared deviations from the running mean */
+  float min;
+  float max;
+  float height[STATS_P2_MARKERS];  /*!< P2 marker heights; the samples themselves while count <= STATS_P2_MARKERS */
+  int32_t pos[STATS_P2_MARKERS];   /*!< P2 marker positions */
+  float desired[STATS_P2_MARKERS]; /*!< P2 desired marker positions */
+  uint32_t lastEpoch;            /*!< start of the sampling period of the last timed sample */
+  double weightedSum;            /*!< timed samples times the seconds each one stands for */
+  double weight;                 /*!< seconds the timed samples stand for */
+  bool uneven;                   /*!< a timed sample stands for more than one period, after a missed one */
+} channelStats_t;
+
+/******************************************************
+ * @brief empties the statistics of a channel
+ ******************************************************/
+void vMspStats_reset(channelStats_t *p_tStats);
+
+/******************************************************
+ * @brief empties the statistics of every channel of
+ *        an array of STATS_CH_MAX
+ ******************************************************/
+void vMspStats_resetAll(channelStats_t *p_tStats);
+
+/******************************************************
+ * @brief adds a sample to the statistics
+ ******************************************************/
+void vMspStats_add(channelStats_t *p_tStats, float value);
+
+/******************************************************
+ * @brief adds a sample taken in the sampling period
+ *        starting at epoch: it stands for the time since
+ *        the previous one, up to STATS_MAX_HOLD_PERIODS
+ *        periods; the first one for one period
+ ******************************************************/
+void vMspStats_addTimed(channelStats_t *p_tStats, float value, uint32_t epoch, uint32_t periodS);
+
+/******************************************************
+ * @brief mean of the samples, 0 with none
+ ******************************************************/
+float fMspStats_mean(const channelStats_t *p_tStats);
+
+/******************************************************
+ * @brief mean of the timed samples weighted by the
+ *        time each one stands for, plain mean without
+ *        them; the same as the plain mean when no
+ *        period was missed
+ ******************************************************/
+float fMspStats_timeWeightedMean(const channelStats_t *p_tStats);
+
+/******************************************************
+ * @brief sample standard deviation, -1 with less than
+ *        two samples
+ ******************************************************/
+float fMspStats_stdDev(const channelStats_t *p_tStats);
+
+/******************************************************
+ * @brief median of the samples, 0 with none
+ ******************************************************/
+float fMspStats_median(const channelStats_t *p_tStats);
+
+/******************************************************
+ * @brief mean without the lowest and the highest
+ *        sample, plain mean with less than three
+ ******************************************************/
+float fMspStats_trimmedMean(const channelStats_t *p_tStats);
+
+/******************************************************
+ * @brief value of the channel with an aggregation
+ *        method
+ ******************************************************/
+float fMspStats_value(const channelStats_t *p_tStats, statsMethod_t method);
+
+/******************************************************
+ * @brief short name of a channel, used as config key
+ *        and in the upload fields
+ ******************************************************/
+const char *pcMspStats_channelName(stats_channel_t channel);
+
+/******************************************************
+ * @brief channel from its short name
+ *
+ * @return false when the name is unknown
+ ******************************************************/
+bool bMspStats_parseChannel(const char *name, stats_channel_t *p_tChannel);
+
+/******************************************************
+ * @brief config name of an aggregation method
+ ******************************************************/
+const char *pcMspStats_methodName(statsMethod_t method);
+
+/******************************************************
+ * @brief aggregation method from its config name
+ *
+ * @return false when the name is unknown
+ ******************************************************/
+bool bMspStats_parseMethod(const char *name, statsMethod_t *p_tMethod);
+
+#endif
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * @file    channelTable.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Table of the measurement channels. The fields are reached through
+ *          their offset in the structures, a float or, for the whole
+ *          channels, an int32_t; the table is built from the field names, so
+ *          the compiler checks both types and derives the whole flag.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <stddef.h>
+#include <type_traits>
+#include "channelTable.h"
+
+#define CHAN_LOG_LINE_LEN 192
+
+static_assert(sizeof(float) == sizeof(int32_t), "the channel fields are copied as 32 bit words");
+
+// declared type of a field of a structure
+#define CHAN_FIELD_TYPE(type, field) decltype(((type *)nullptr)->field)
+
+/******************************************************
+ * @brief whole flag of a channel from the types of its
+ *        two fields, which must be the same float or
+ *        int32_t: anything else does not compile
+ ******************************************************/
+template <typename tData, typename tSend>
+constexpr bool bMspChan_fieldWhole(void)
+{
+  static_assert(std::is_same<tData, tSend>::value, "a channel has the same type in sensorData_t and send_data_t");
+  static_assert(std::is_same<tData, float>::value || std::is_same<tData, int32_t>::value, "a channel field is a float or an int32_t");
+  return std::is_same<tData, int32_t>::value;
+}
+
+// one line of the table, from the fields of the channel in sensorData_t and send_data_t
+#define CHAN_ENTRY(name, label, unit, sensor, dataField, sendField)                                          \
+  {name, label, unit, sensor,                                                                                \
+   bMspChan_fieldWhole<CHAN_FIELD_TYPE(sensorData_t, dataField), CHAN_FIELD_TYPE(send_data_t, sendField)>(), \
+   offsetof(sensorData_t, dataField), offsetof(send_data_t, sendField)}
+
+typedef struct
+{
+  const char *name;   /*!< upload field */
+  const char *label;
+  const char *unit;
+  uint8_t sensor;     /*!< channelSensor_t */
+  bool whole;         /*!< int32_t fields, derived by CHAN_ENTRY() */
+  uint16_t dataOffset; /*!< in sensorData_t */
+  uint16_t sendOffset; /*!< in send_data_t */
+} channelInfo_t;
+
+// same order as stats_channel_t
+static const channelInfo_t tChannels[STATS_CH_MAX] = {
+    CHAN_ENTRY("temp", "Temperature", "C", CHAN_SENSOR_BME680, gasData.temperature, temp),
+    CHAN_ENTRY("hum", "Humidity", "%", CHAN_SENSOR_BME680, gasData.humidity, hum),
+    CHAN_ENTRY("pre", "Pressure", "hPa", CHAN_SENSOR_BME680, gasData.pressure, pre),
+    CHAN_ENTRY("voc", "VOC", "kOhm", CHAN_SENSOR_BME680, gasData.volatileOrganicCompounds, VOC),
+    CHAN_ENTRY("cox", "CO", "ug/m3", CHAN_SENSOR_MICS6814, pollutionData.carbonMonoxide, MICS_CO),
+    CHAN_ENTRY("nox", "NOx", "ug/m3", CHAN_SENSOR_MICS6814, pollutionData.nitrogenDioxide, MICS_NO2),
+    CHAN_ENTRY("nh3", "NH3", "ug/m3", CHAN_SENSOR_MICS6814, pollutionData.ammonia, MICS_NH3),
+    CHAN_ENTRY("pm1", "PM1", "ug/m3", CHAN_SENSOR_PMS5003, airQualityData.particleMicron1, PM1),
+    CHAN_ENTRY("pm25", "PM2.5", "ug/m3", CHAN_SENSOR_PMS5003, airQualityData.particleMicron25, PM25),
+    CHAN_ENTRY("pm10", "PM10", "ug/m3", CHAN_SENSOR_PMS5003, airQualityData.particleMicron10, PM10),
+    CHAN_ENTRY("o3", "O3", "ug/m3", CHAN_SENSOR_O3, ozoneData.ozone, ozone),
+};
+
+/******************************************************
+ * @brief value of the field of a channel at an offset
+ ******************************************************/
+static float fMspChan_read(const void *p_vBase, const channelInfo_t *p_tInfo, uint16_t offset)
+{
+  const uint8_t *p_ucField = (const uint8_t *)p_vBase + offset;
+  if (p_tInfo->whole)
+  {
+    return (float)*(const int32_t *)p_ucField;
+  }
+  return *(const float *)p_ucField;
+}
+
+/******************************************************
+ * @brief field of a channel at an offset, overwritten
+ *        or summed to
+ ******************************************************/
+static void vMspChan_write(void *p_vBase, const channelInfo_t *p_tInfo, uint16_t offset, float value, bool add)
+{
+  uint8_t *p_ucField = (uint8_t *)p_vBase + offset;
+  if (p_tInfo->whole)
+  {
+    int32_t *p_lField = (int32_t *)p_ucField;
+    *p_lField = (add ? *p_lField : 0) + (int32_t)value;
+  }
+  else
+  {
+    float *p_fField = (float *)p_ucField;
+    *p_fField = (add ? *p_fField : 0.0f) + value;
+  }
+}
+
+const char *pcMspChan_name(stats_channel_t channel)
+{
+  return (channel < STATS_CH_MAX) ? tChannels[channel].name : "unknown";
+}
+
+const char *pcMspChan_label(stats_channel_t channel)
+{
+  return (channel < STATS_CH_MAX) ? tChannels[channel].label : "?";
+}
+
+const char *pcMspChan_unit(stats_channel_t channel)
+{
+  return (channel < STATS_CH_MAX) ? tChannels[channel].unit : "";
+}
+
+channelSensor_t tMspChan_sensor(stats_channel_t channel)
+{
+  return (channelSensor_t)tChannels[channel].sensor;
+}
+
+bool bMspChan_whole(stats_channel_t channel)
+{
+  return tChannels[channel].whole;
+}
+
+bool bMspChan_fitted(const peripheralStatus_t *p_tStatus, channelSensor_t sensor)
+{
+  switch (sensor)
+  {
+  case CHAN_SENSOR_BME680:
+    return p_tStatus->BME680Sensor != 0;
+  case CHAN_SENSOR_PMS5003:
+    return p_tStatus->PMS5003Sensor != 0;
+  case CHAN_SENSOR_MICS6814:
+    return p_tStatus->MICS6814Sensor != 0;
+  case CHAN_SENSOR_O3:
+    return p_tStatus->O3Sensor != 0;
+  default:
+    return false;
+  }
+}
+
+float fMspChan_get(const sensorData_t *p_tData, stats_channel_t channel)
+{
+  return fMspChan_read(p_tData, &tChannels[channel], tChannels[channel].dataOffset);
+}
+
+void vMspChan_set(sensorData_t *p_tData, stats_channel_t channel, float value)
+{
+  vMspChan_write(p_tData, &tChannels[channel], tChannels[channel].dataOffset, value, false);
+}
+
+void vMspChan_add(sensorData_t *p_tData, stats_channel_t channel, float value)
+{
+  vMspChan_write(p_tData, &tChannels[channel], tChannels[channel].dataOffset, value, true);
+}
+
+void vMspChan_resetAll(sensorData_t *p_tData)
+{
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
+  {
+    vMspChan_write(p_tData, &tChannels[ch], tChannels[ch].dataOffset, 0.0f, false);
+  }
+}
+
+void vMspChan_toSendData(const sensorData_t *p_tData, send_data_t *p_tSend)
+{
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
+  {
+    const channelInfo_t *p_tInfo = &tChannels[ch];
+    // field to field, a whole channel never goes through a float
+    memcpy((uint8_t *)p_tSend + p_tInfo->sendOffset, (const uint8_t *)p_tData + p_tInfo->dataOffset, sizeof(float));
+  }
+}
+
+float fMspChan_sent(const send_data_t *p_tSend, stats_channel_t channel)
+{
+  return fMspChan_read(p_tSend, &tChannels[channel], tChannels[channel].sendOffset);
+}
+
+void vMspChan_log(const char *what, const sensorData_t *p_tData)
+{
+  char line[CHAN_LOG_LINE_LEN];
+  int written = 0;
+  for (int ch = 0; (ch < STATS_CH_MAX) && (written < (int)sizeof(line)); ch++)
+  {
+    written += snprintf(line + written, sizeof(line) - written, " %s=%.*f", tChannels[ch].name, tChannels[ch].whole ? 0 : 2,
+                        fMspChan_get(p_tData, (stats_channel_t)ch));
+  }
+  log_i("%s:%s", what, line);
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ * @file    channelTable.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Table of the measurement channels, in stats_channel_t order: the
+ *          field of each one in sensorData_t and send_data_t, the sensor it
+ *          comes from, its upload name and its unit. Resetting, summing,
+ *          copying, uploading and logging the channels are loops over it,
+ *          a new channel is a line of the table.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef CHANNEL_TABLE_H
+#define CHANNEL_TABLE_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+
+// sensor a channel is read from, its cycle average and its status flag
+typedef enum __CHANNEL_SENSOR__
+{
+  CHAN_SENSOR_BME680 = 0,
+  CHAN_SENSOR_PMS5003,
+  CHAN_SENSOR_MICS6814, /*!< the MICS4514 fills the same fields from its ADC counts */
+  CHAN_SENSOR_O3,
+  CHAN_SENSOR_MAX
+} channelSensor_t;
+
+/******************************************************
+ * @brief name of a channel, in the uploads and the
+ *        configuration
+ ******************************************************/
+const char *pcMspChan_name(stats_channel_t channel);
+
+/******************************************************
+ * @brief label and unit of a channel, in the log
+ ******************************************************/
+const char *pcMspChan_label(stats_channel_t channel);
+const char *pcMspChan_unit(stats_channel_t channel);
+
+/******************************************************
+ * @brief sensor a channel is read from
+ ******************************************************/
+channelSensor_t tMspChan_sensor(stats_channel_t channel);
+
+/******************************************************
+ * @brief the channel is kept in whole ug/m3 (int32_t
+ *        fields, the PMS5003 ones)
+ ******************************************************/
+bool bMspChan_whole(stats_channel_t channel);
+
+/******************************************************
+ * @brief the sensor of the channels is switched on
+ ******************************************************/
+bool bMspChan_fitted(const peripheralStatus_t *p_tStatus, channelSensor_t sensor);
+
+/******************************************************
+ * @brief value of a channel in a record
+ ******************************************************/
+float fMspChan_get(const sensorData_t *p_tData, stats_channel_t channel);
+
+/******************************************************
+ * @brief sets a channel of a record; a whole channel
+ *        takes the integer part
+ ******************************************************/
+void vMspChan_set(sensorData_t *p_tData, stats_channel_t channel, float value);
+
+/******************************************************
+ * @brief adds to the sum of a channel in a record, a
+ *        whole channel the integer part
+ ******************************************************/
+void vMspChan_add(sensorData_t *p_tData, stats_channel_t channel, float value);
+
+/******************************************************
+ * @brief zeroes every channel of a record, the sums of
+ *        a new measurement cycle
+ ******************************************************/
+void vMspChan_resetAll(sensorData_t *p_tData);
+
+/******************************************************
+ * @brief copies every channel of a record into the
+ *        data to send
+ ******************************************************/
+void vMspChan_toSendData(const sensorData_t *p_tData, send_data_t *p_tSend);
+
+/******************************************************
+ * @brief value of a channel in the data to send
+ ******************************************************/
+float fMspChan_sent(const send_data_t *p_tSend, stats_channel_t channel);
+
+/******************************************************
+ * @brief one log line with every channel of a record
+ ******************************************************/
+void vMspChan_log(const char *what, const sensorData_t *p_tData);
+
+#endif
@@ -92,6 +92,14 @@
 #define CONFIG_FILENAME "config_v4.json"
 #define CONFIG_PATH "/" CONFIG_FILENAME
 
+// BSEC calibration state, kept across reboots
+#define BSEC_STATE_PATH "/bsec_state.bin"
+#define BSEC_STATE_TMP_PATH "/bsec_state.tmp"
+
+// MICS baseline (R0) tracking, kept across reboots
+#define MICS_BASELINE_PATH "/mics_baseline.bin"
+#define MICS_BASELINE_TMP_PATH "/mics_baseline.tmp"
+
 // JSON Config Keys
 #define JSON_CONFIG_SECTION "config"
 #define JSON_HELP_SECTION "help"
@@ -103,6 +111,7 @@
 #define JSON_KEY_WIFI_POWER "wifi_power"
 #define JSON_KEY_O3_ZERO_VALUE "o3_zero_value"
 #define JSON_KEY_AVERAGE_MEASUREMENTS "average_measurements"
+#define JSON_KEY_SAMPLING_PERIOD "sampling_period"
 #define JSON_KEY_SEA_LEVEL_ALTITUDE "sea_level_altitude"
 #define JSON_KEY_UPLOAD_SERVER "upload_server"
 #define JSON_KEY_MICS_CALIBRATION_VALUES "mics_calibration_values"
@@ -114,6 +123,10 @@
 #define JSON_KEY_TIMEZONE "timezone"
 #define JSON_KEY_FW_AUTO_UPGRADE "fw_auto_upgrade"
 #define JSON_KEY_GAS_SENSOR_TYPE "gas_sensor_type"
+#define JSON_KEY_UPLOAD_LATENCY "upload_latency"
+#define JSON_KEY_AGGREGATION "aggregation"
+#define JSON_KEY_MICS_BASELINE "mics_baseline"
+#define JSON_KEY_MICS_BASELINE_DAYS "mics_baseline_days"
 
 // MICS Calibration Sub-keys
 #define JSON_KEY_MICS_RED "RED"
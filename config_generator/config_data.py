@@ -22,6 +22,7 @@ DEFAULT_VALUES = {
     "gas_sensor_type": "MICS6814",
     "o3_zero_value": "-1",
     "average_measurements": "30",
+    "sampling_period": "60",
     "sea_level_altitude": "122.00",
 
     # MICS Calibration Values
@@ -49,6 +50,20 @@ DEFAULT_VALUES = {
 
     # Firmware Settings
     "fw_auto_upgrade": True,
+    "upload_latency": False,
+
+    # Aggregation Methods
+    "agg_temp": "mean",
+    "agg_hum": "mean",
+    "agg_pre": "mean",
+    "agg_voc": "mean",
+    "agg_cox": "mean",
+    "agg_nox": "mean",
+    "agg_nh3": "mean",
+    "agg_pm1": "mean",
+    "agg_pm25": "mean",
+    "agg_pm10": "mean",
+    "agg_o3": "mean",
 }
 
 # ============================================================================
@@ -59,15 +74,36 @@ WIFI_POWER_VALUES = ["-1", "2", "5", "7", "8.5", "11", "13", "15", "17", "18.5",
 
 AVERAGE_MEASUREMENTS_VALUES = ["1", "2", "3", "4", "5", "6", "10", "12", "15", "20", "30", "60"]
 
+SAMPLING_PERIOD_VALUES = ["5", "10", "15", "20", "30", "60"]
+
 GAS_SENSOR_TYPES = {
     "MICS6814": 0,
     "MICS4514 (DFRobot SEN0377)": 1
 }
 
+# Canali dell'oggetto "aggregation": chiave JSON -> etichetta
+AGGREGATION_CHANNELS = {
+    "temp": "Temperature",
+    "hum": "Humidity",
+    "pre": "Pressure",
+    "voc": "VOC",
+    "cox": "CO",
+    "nox": "NO2",
+    "nh3": "NH3",
+    "pm1": "PM1",
+    "pm25": "PM2.5",
+    "pm10": "PM10",
+    "o3": "O3"
+}
+
+AGGREGATION_METHODS = ["mean", "median", "trimmed"]
+
 # ============================================================================
 # TESTI DI HELP
 # ============================================================================
 
+AGGREGATION_HELP_TEXT = "Valore inviato per questo canale su ogni intervallo di media:\n\nmean = media aritmetica (default)\nmedian = mediana, non risente dei picchi isolati\ntrimmed = media senza il campione più basso e quello più alto\n\nLa deviazione standard dei campioni viene sempre inviata come <canale>_sd"
+
 HELP_TEXTS = {
     # Network Settings
     "ssid": "Nome della rete WiFi a cui il dispositivo si connetterà",
@@ -82,6 +118,7 @@ HELP_TEXTS = {
     "gas_sensor_type": "Tipo di sensore gas installato sul dispositivo:\n\n0 = MICS6814 (sensore standard)\n1 = MICS4514 (DFRobot SEN0377)\n\nSeleziona il tipo corretto in base all'hardware installato",
     "o3_zero_value": "Valore di calibrazione zero per il sensore O3\n\nUsa -1 per la calibrazione automatica\nUsa un valore specifico se hai già calibrato il sensore",
     "average_measurements": "Numero di misurazioni da mediare prima di inviare i dati\n\nValori accettati: 1, 2, 3, 4, 5, 6, 10, 12, 15, 20, 30, 60\n\nValori più alti = dati più stabili ma aggiornamenti meno frequenti",
+    "sampling_period": "Secondi tra due campioni, mediati poi su average_measurements minuti\n\nValori accettati: 5, 10, 15, 20, 30, 60\n\nValori più bassi = maggiore risoluzione temporale, stessa frequenza di invio",
     "sea_level_altitude": "Altitudine sul livello del mare della posizione del dispositivo in metri\n\nQuesto valore è necessario per la calibrazione corretta della pressione atmosferica\n\nEsempio: 122.0 metri è l'altitudine media di Milano, Italia",
 
     # MICS Calibration Values
@@ -109,6 +146,20 @@ HELP_TEXTS = {
 
     # Firmware Settings
     "fw_auto_upgrade": "Abilita l'aggiornamento automatico del firmware\n\nSe abilitato, il dispositivo controllerà e installerà automaticamente nuove versioni del firmware quando disponibili",
+    "upload_latency": "Invia al server, insieme alle misure, la durata massima di ogni stato del ciclo principale e di ogni lettura dei sensori\n\nUtile per la diagnostica, lasciare disabilitato se non richiesto",
+
+    # Aggregation Methods
+    "agg_temp": AGGREGATION_HELP_TEXT,
+    "agg_hum": AGGREGATION_HELP_TEXT,
+    "agg_pre": AGGREGATION_HELP_TEXT,
+    "agg_voc": AGGREGATION_HELP_TEXT,
+    "agg_cox": AGGREGATION_HELP_TEXT,
+    "agg_nox": AGGREGATION_HELP_TEXT,
+    "agg_nh3": AGGREGATION_HELP_TEXT,
+    "agg_pm1": AGGREGATION_HELP_TEXT,
+    "agg_pm25": AGGREGATION_HELP_TEXT,
+    "agg_pm10": AGGREGATION_HELP_TEXT,
+    "agg_o3": AGGREGATION_HELP_TEXT,
 }
 
 # ============================================================================
@@ -118,9 +169,12 @@ HELP_TEXTS = {
 JSON_HELP_TEXTS = {
     "wifi_power": "Accepted values: -1, 2, 5, 7, 8.5, 11, 13, 15, 17, 18.5, 19, 19.5 dBm",
     "average_measurements": "Accepted values: 1, 2, 3, 4, 5, 6, 10, 12, 15, 20, 30, 60",
+    "sampling_period": "Seconds between two samples, averaged over average_measurements minutes. Accepted values: 5, 10, 15, 20, 30, 60",
     "sea_level_altitude": "Value in meters, must be changed according to device location. 122.0 meters is the average altitude in Milan, Italy",
     "timezone": "Standard tz timezone definition. More details at https://www.gnu.org/software/libc/manual/html_node/TZ-Variable.html",
-    "gas_sensor_type": "Gas sensor type: 0 = MICS6814, 1 = MICS4514 (DFRobot SEN0377)"
+    "gas_sensor_type": "Gas sensor type: 0 = MICS6814, 1 = MICS4514 (DFRobot SEN0377)",
+    "upload_latency": "Add the longest duration of each main loop state and sensor reading since the previous record to the uploads",
+    "aggregation": "Value sent for each channel (temp, hum, pre, voc, cox, nox, nh3, pm1, pm25, pm10, o3) over the averaging interval: mean, median or trimmed (mean without the lowest and highest sample). The standard deviation of the samples is sent as <channel>_sd"
 }
 
 # ============================================================================
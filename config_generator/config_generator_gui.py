@@ -15,8 +15,9 @@ from pathlib import Path
 
 # Import moduli locali
 from config_data import (
-    DEFAULT_VALUES, WIFI_POWER_VALUES, AVERAGE_MEASUREMENTS_VALUES,
-    GAS_SENSOR_TYPES, HELP_TEXTS, JSON_HELP_TEXTS, GITHUB_REPO
+    DEFAULT_VALUES, WIFI_POWER_VALUES, AVERAGE_MEASUREMENTS_VALUES, SAMPLING_PERIOD_VALUES,
+    GAS_SENSOR_TYPES, AGGREGATION_CHANNELS, AGGREGATION_METHODS,
+    HELP_TEXTS, JSON_HELP_TEXTS, GITHUB_REPO
 )
 from esp32_utils import (
     get_available_ports, detect_flash_size, get_chip_info,
@@ -104,6 +105,8 @@ class ConfigGeneratorGUI:
         row = self.create_entry(scrollable_frame, row, "O3 Zero Value", "o3_zero_value")
         row = self.create_combobox(scrollable_frame, row, "Average Measurements", "average_measurements",
                                    AVERAGE_MEASUREMENTS_VALUES)
+        row = self.create_combobox(scrollable_frame, row, "Sampling Period (s)", "sampling_period",
+                                   SAMPLING_PERIOD_VALUES)
         row = self.create_entry(scrollable_frame, row, "Sea Level Altitude (m)", "sea_level_altitude")
 
         # MICS Calibration Values
@@ -137,6 +140,12 @@ class ConfigGeneratorGUI:
         # Firmware Settings
         row = self.create_section(scrollable_frame, row, "Firmware Settings")
         row = self.create_checkbox(scrollable_frame, row, "Auto Firmware Upgrade", "fw_auto_upgrade")
+        row = self.create_checkbox(scrollable_frame, row, "Upload Loop Latency", "upload_latency")
+
+        # Aggregation Methods
+        row = self.create_section(scrollable_frame, row, "Aggregation Methods")
+        for channel, label in AGGREGATION_CHANNELS.items():
+            row = self.create_combobox(scrollable_frame, row, label, "agg_" + channel, AGGREGATION_METHODS)
 
         # Buttons
         button_frame = ttk.Frame(scrollable_frame)
@@ -328,6 +337,7 @@ class ConfigGeneratorGUI:
                     "wifi_power": self.vars["wifi_power"].get() + "dBm",
                     "o3_zero_value": int(self.vars["o3_zero_value"].get()),
                     "average_measurements": int(self.vars["average_measurements"].get()),
+                    "sampling_period": int(self.vars["sampling_period"].get()),
                     "sea_level_altitude": float(self.vars["sea_level_altitude"].get()),
                     "upload_server": self.vars["upload_server"].get(),
                     "mics_calibration_values": {
@@ -350,7 +360,11 @@ class ConfigGeneratorGUI:
                     "ntp_server": self.vars["ntp_server"].get(),
                     "timezone": self.vars["timezone"].get(),
                     "fw_auto_upgrade": self.vars["fw_auto_upgrade"].get(),
-                    "gas_sensor_type": gas_sensor_value
+                    "gas_sensor_type": gas_sensor_value,
+                    "upload_latency": self.vars["upload_latency"].get(),
+                    "aggregation": {
+                        channel: self.vars["agg_" + channel].get() for channel in AGGREGATION_CHANNELS
+                    }
                 },
                 "help": JSON_HELP_TEXTS
             }
@@ -407,6 +421,7 @@ class ConfigGeneratorGUI:
 
             self.vars["o3_zero_value"].set(str(config.get("o3_zero_value", -1)))
             self.vars["average_measurements"].set(str(config.get("average_measurements", 30)))
+            self.vars["sampling_period"].set(str(config.get("sampling_period", 60)))
             self.vars["sea_level_altitude"].set(str(config.get("sea_level_altitude", 122.00)))
             self.vars["upload_server"].set(config.get("upload_server", ""))
 
@@ -432,6 +447,12 @@ class ConfigGeneratorGUI:
             self.vars["timezone"].set(config.get("timezone", "GMT0"))
 
             self.vars["fw_auto_upgrade"].set(config.get("fw_auto_upgrade", True))
+            self.vars["upload_latency"].set(config.get("upload_latency", False))
+
+            aggregation = config.get("aggregation", {})
+            for channel in AGGREGATION_CHANNELS:
+                method = aggregation.get(channel, "mean")
+                self.vars["agg_" + channel].set(method if method in AGGREGATION_METHODS else "mean")
 
             gas_type_value = config.get("gas_sensor_type", 0)
             gas_type_text = "MICS6814"
@@ -15,6 +15,7 @@
 #include "display.h"
 #include "display_task.h"
 #include "mspOs.h"
+#include "i2cArbiter.h"
 #include <Wire.h>
 #include <U8g2lib.h>
 
@@ -95,6 +96,7 @@ static U8G2_SH1106_128X64_NONAME_F_HW_I2C u8g2(U8G2_R0, U8X8_PIN_NONE, I2C_SCL_P
 // -------------------------------local function prototype -------------------------------
 static void vHal_displayDrawScrHead(systemStatus_t *statPtr, deviceNetworkInfo_t *devinfoPtr);
 static short sHalDisplay_getLineHOffset(const char string[]);
+static void vHalDisplay_sendBuffer(void);
 
 // ------------------------------- functions declerations---------------------------------
 
@@ -108,7 +110,28 @@ void vHalDisplay_initSerialAndI2c(void)
   Serial.begin(115200);
   delay(2000); // give time to serial to initialize properly
   Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN);
+  vMspI2c_init();
+  bMspI2c_take(I2C_CLIENT_DISPLAY, portMAX_DELAY);
   u8g2.begin();
+  vMspI2c_give(I2C_CLIENT_DISPLAY);
+}
+
+/******************************************************
+ * @brief sends the frame buffer one tile row (page) at
+ *        a time, each with its own take of the bus, so
+ *        a sensor read waits for a page, not a frame
+ ******************************************************/
+static void vHalDisplay_sendBuffer(void)
+{
+  uint8_t tileRows = u8g2.getBufferTileHeight();
+  uint8_t tileCols = u8g2.getBufferTileWidth();
+
+  for (uint8_t row = 0; row < tileRows; row++)
+  {
+    bMspI2c_take(I2C_CLIENT_DISPLAY, portMAX_DELAY);
+    u8g2.updateDisplayArea(0, row, tileCols, 1);
+    vMspI2c_give(I2C_CLIENT_DISPLAY);
+  }
 }
 
 /******************************************************
@@ -130,7 +153,7 @@ void vHalDisplay_DrawBoot(String *fwver, const uint8_t screenDelay)
   u8g2.print(STR_AUTHOR);
   u8g2.setCursor(SET_CRSR_X_POS_FWVER, SET_CRSR_Y_POS_FWVER);
   u8g2.print(*fwver);
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(screenDelay * 1000);
 }
 
@@ -207,7 +230,7 @@ void vHalDisplay_drawLine(const char message[], short secdelay, systemStatus_t *
   vHal_displayDrawScrHead(statPtr, devinfoPtr);
   u8g2.setCursor(offset, DRAW_LINE_Y_OFFSET);
   u8g2.print(message);
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secdelay * 1000);
 }
 
@@ -230,7 +253,7 @@ void vHalDisplay_drawTwoLines(const char message1[], const char message2[], shor
   u8g2.print(message1);
   u8g2.setCursor(offset2, DRAW_TWO_LINE_Y_OFFSET_L2);
   u8g2.print(message2);
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secdelay * 1000);
 }
 
@@ -308,7 +331,7 @@ void vHalDisplay_drawBme680GasSensorData(sensorData_t *p_tData, systemStatus_t *
     u8g2.setCursor(MEAS_DISP_X_OFFSET, MEAS_DISP_Y_OFFSET_L4);
     u8g2.print("VOC: --");
   }
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secdelay * 1000);
 }
 
@@ -357,7 +380,7 @@ void vHalDisplay_drawPMS5003AirQualitySensorData(sensorData_t *p_tData, systemSt
     u8g2.setCursor(MEAS_DISP_X_OFFSET, MEAS_DISP_Y_OFFSET_L3);
     u8g2.print("PM10:--");
   }
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secdelay * 1000);
 }
 
@@ -405,7 +428,7 @@ void vHalDisplay_drawMICSxx14PollutionSensorData(sensorData_t *p_tData, systemSt
     u8g2.setCursor(MEAS_DISP_X_OFFSET, MEAS_DISP_Y_OFFSET_L3);
     u8g2.print("NH3:--");
   }
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secdelay * 1000);
 }
 
@@ -436,7 +459,7 @@ void vHalDisplay_drawOzoneSensorData(sensorData_t *p_tData, systemStatus_t *stat
     u8g2.setCursor(MEAS_DISP_X_OFFSET, MEAS_DISP_Y_OFFSET_L2);
     u8g2.print("O3:--");
   }
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secdelay * 1000);
 }
 
@@ -459,7 +482,7 @@ void vHalDisplay_drawMspIndexData(sensorData_t *p_tData, systemStatus_t *statPtr
   u8g2.setCursor(MEAS_DISP_X_OFFSET, MEAS_DISP_Y_OFFSET_L2);
   u8g2.print("MSP:  ");
   u8g2.print(sensorStringData);
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secdelay * 1000);
 }
 
@@ -490,7 +513,7 @@ void vHalDisplay_drawFirmwareVersion(systemStatus_t *statPtr, deviceNetworkInfo_
   u8g2.print("FW:");
   u8g2.setCursor(2, 42);
   u8g2.print(fwVersion);
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secDelay * 1000);
 }
 
@@ -514,7 +537,7 @@ void vHalDisplay_drawConfigurationValues(sensorData_t *p_tData, systemStatus_t *
   u8g2.print("FW upgrade: " + String(statPtr->fwAutoUpgrade ? "ON" : "OFF"));
   u8g2.setCursor(2, 61);
   u8g2.print("Gas sensor: " + String(statPtr->gasSensorType == 0 ? "MICS6814" : "MICS4514"));
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secDelay * 1000);
 
   // Screen 2: MICS calibration values
@@ -527,7 +550,7 @@ void vHalDisplay_drawConfigurationValues(sensorData_t *p_tData, systemStatus_t *
   u8g2.print("OX:  " + String(p_tData->micsTuningData.sensingResInAir.oxSensor));
   u8g2.setCursor(2, 61);
   u8g2.print("NH3: " + String(p_tData->micsTuningData.sensingResInAir.nh3Sensor));
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secDelay * 1000);
 
   // Screen 3: MICS measurement offsets
@@ -540,7 +563,7 @@ void vHalDisplay_drawConfigurationValues(sensorData_t *p_tData, systemStatus_t *
   u8g2.print("OX:  " + String(p_tData->micsTuningData.sensingResInAirOffset.oxSensor));
   u8g2.setCursor(2, 61);
   u8g2.print("NH3: " + String(p_tData->micsTuningData.sensingResInAirOffset.nh3Sensor));
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secDelay * 1000);
 
   // Screen 4: Compensation factors
@@ -553,7 +576,7 @@ void vHalDisplay_drawConfigurationValues(sensorData_t *p_tData, systemStatus_t *
   u8g2.print("T: " + String(p_tData->compParams.currentTemperature, 3));
   u8g2.setCursor(2, 61);
   u8g2.print("P: " + String(p_tData->compParams.currentPressure, 6));
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(secDelay * 1000);
 }
 
@@ -579,7 +602,7 @@ void vHalDisplay_drawMicsValues(uint16_t redval, uint16_t oxval, uint16_t nh3val
   u8g2.print("OX: " + String(oxval));
   u8g2.setCursor(30, 61);
   u8g2.print("NH3: " + String(nh3val));
-  u8g2.sendBuffer();
+  vHalDisplay_sendBuffer();
   delay(5000);
 }
 
@@ -631,7 +654,10 @@ void vMsp_updateDataAndSendEvent(displayEvents_t event,
 
   vMspOs_takeDataAccessMutex();
 
-  localDisplayData.sensorData = *sensorData; // Always copy so fallback SHOW_MEAS_DATA has valid status flags
+  // Always copy so fallback SHOW_MEAS_DATA has valid status flags, the readings come through the sample ring
+  localDisplayData.sensorInfo.status = sensorData->status;
+  localDisplayData.sensorInfo.compParams = sensorData->compParams;
+  localDisplayData.sensorInfo.micsTuningData = sensorData->micsTuningData;
   localDisplayData.devInfo = *devInfo;
   localDisplayData.measStat = *measStat;
   localDisplayData.sysData = *sysData;
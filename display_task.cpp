@@ -17,6 +17,8 @@
 #include "freertos/event_groups.h"
 #include "display_task.h"
 #include "display.h"
+#include "sensors.h"
+#include "aqIndex.h"
 
 //--------------------------------------------------------------------------------------------------
 //------------------ DISPLAY TASK SECTION ----------------------------------------------------------
@@ -42,6 +44,10 @@ state_machine_t dispFSM;
 // -- display data instance --
 static displayData_t data{};
 
+// -- readings shown, the latest sample of each channel --
+static sampleRing_t displaySampleRing;
+static sensorData_t displaySensorView{};
+
 #define EVENT_WAIT_TIMEOUT 1000
 #define RESET_TIMEOUT 10
 
@@ -64,6 +70,7 @@ void vTaskDisplay_initDataQueue(void)
   {
     displayTaskQueue = xQueueCreate(DISP_QUEUE_LENGTH, DISP_QUEUE_ITEM_SIZE);
   }
+  vMspRing_init(&displaySampleRing);
 }
 
 /******************************************************************
@@ -89,6 +96,38 @@ BaseType_t tTaskDisplay_receiveEvent(displayData_t *data, TickType_t xTicksToWai
   return xQueueReceive(displayTaskQueue, data, xTicksToWait);
 }
 
+/**********************************************************************
+ * @brief function to hand a sample to the display task.
+ *
+ * @param p_tSample
+ * @return bool
+ **********************************************************************/
+bool bTaskDisplay_pushSample(const sensorSample_t *p_tSample)
+{
+  return bMspRing_push(&displaySampleRing, p_tSample);
+}
+
+/**********************************************************************
+ * @brief function to drain the samples into the readings shown,
+ *        with the sensor context of the last event.
+ *
+ **********************************************************************/
+static void vTaskDisplay_updateView(void)
+{
+  sensorSample_t sample;
+  while (bMspRing_pop(&displaySampleRing, &sample))
+  {
+    vMspRing_copyToData(&sample, &displaySensorView);
+  }
+  displaySensorView.status = data.sensorInfo.status;
+  displaySensorView.compParams = data.sensorInfo.compParams;
+  displaySensorView.micsTuningData = data.sensorInfo.micsTuningData;
+  // rated on the rolling windows as the records, the readings shown stay the last ones
+  sensorData_t rated = displaySensorView;
+  vMspAq_applyWindows(&rated);
+  displaySensorView.MSP = sHalSensor_evaluateMSPIndex(&rated);
+}
+
 /*********************************************************************
  * @brief display task function that handles
  * display events and updates the display accordingly.
@@ -112,6 +151,8 @@ void displayTask(void *pvParameters)
     {
     case DISP_EVENT_WAIT_FOR_EVENT:
     {
+      // keep the ring drained, the loop task pushes a sample every sampling period
+      vTaskDisplay_updateView();
       if (pdTRUE != tTaskDisplay_receiveEvent(&data, eventWaitTimeout))
       {
         // check if we have received the first data
@@ -454,13 +495,14 @@ void displayTask(void *pvParameters)
     // measurement data
     case DISP_EVENT_SHOW_MEAS_DATA:
     {
-      vHalDisplay_drawBme680GasSensorData(&data.sensorData, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
-      vHalDisplay_drawPMS5003AirQualitySensorData(&data.sensorData, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
-      vHalDisplay_drawMICSxx14PollutionSensorData(&data.sensorData, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
-      vHalDisplay_drawOzoneSensorData(&data.sensorData, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
-      vHalDisplay_drawMspIndexData(&data.sensorData, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
+      vTaskDisplay_updateView();
+      vHalDisplay_drawBme680GasSensorData(&displaySensorView, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
+      vHalDisplay_drawPMS5003AirQualitySensorData(&displaySensorView, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
+      vHalDisplay_drawMICSxx14PollutionSensorData(&displaySensorView, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
+      vHalDisplay_drawOzoneSensorData(&displaySensorView, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
+      vHalDisplay_drawMspIndexData(&displaySensorView, &data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
       vHalDisplay_drawFirmwareVersion(&data.sysStat, &data.devInfo, THREE_SEC_TIMEOUT);
-      vHalDisplay_drawConfigurationValues(&data.sensorData, &data.sysStat, &data.devInfo, &data.measStat, THREE_SEC_TIMEOUT);
+      vHalDisplay_drawConfigurationValues(&displaySensorView, &data.sysStat, &data.devInfo, &data.measStat, THREE_SEC_TIMEOUT);
       dispFSM.next_state = dispFSM.return_state;
       break;
     }
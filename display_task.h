@@ -14,6 +14,7 @@
 
 // -- includes --
 #include "shared_values.h"
+#include "sampleRing.h"
 #include "freertos/portmacro.h"
 
 // -- display events --
@@ -90,15 +91,23 @@ typedef enum _DISPLAY_EVENTS_
 
 } displayEvents_t;
 
+// -- sensor context of an event, the readings come through the sample ring
+typedef struct _DISP_SENSOR_INFO_
+{
+  peripheralStatus_t status;           /*!< Sensors present */
+  compensationsParams_t compParams;    /*!< Compensation values shown with the configuration */
+  MICS_Tuning_Data_t micsTuningData;   /*!< MICS6814 tuning shown with the configuration */
+} displaySensorInfo_t;
+
 // -- display task queue data
 typedef struct _DISP_TASK_DATA_
 {
-  displayEvents_t currentEvent; /*!< Current event to be displayed */
-  sensorData_t sensorData;      /*!< Sensor data to be displayed */
-  systemStatus_t sysStat;       /*!< System status to be displayed */
-  deviceNetworkInfo_t devInfo;  /*!< Device network information to be displayed */
-  systemData_t sysData;         /*!< System data to be displayed */
-  deviceMeasurement_t measStat; /*!< Device measurement status to be displayed */
+  displayEvents_t currentEvent;   /*!< Current event to be displayed */
+  displaySensorInfo_t sensorInfo; /*!< Sensor context to be displayed */
+  systemStatus_t sysStat;         /*!< System status to be displayed */
+  deviceNetworkInfo_t devInfo;    /*!< Device network information to be displayed */
+  systemData_t sysData;           /*!< System data to be displayed */
+  deviceMeasurement_t measStat;   /*!< Device measurement status to be displayed */
 } displayData_t;
 
 /*********************************************************
@@ -130,6 +139,15 @@ BaseType_t tTaskDisplay_sendEvent(displayData_t *data);
  **********************************************************************/
 BaseType_t tTaskDisplay_receiveEvent(displayData_t *data, TickType_t xTicksToWait);
 
+/**********************************************************************
+ * @brief function to hand a sample to the display task, the only
+ *        producer is the loop task.
+ *
+ * @param p_tSample
+ * @return false when the display task is behind and the sample is lost
+ **********************************************************************/
+bool bTaskDisplay_pushSample(const sensorSample_t *p_tSample);
+
 // ===== Configuration Macros =====
 
 // Display task configuration
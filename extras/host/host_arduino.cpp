@@ -0,0 +1,743 @@
+/******************************************************************************
+ * @file    host_arduino.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host implementation of the Arduino core subset: String, Print,
+ *          Stream, serial ports, GPIO/ADC and the log sink.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <ctype.h>
+#include <stdarg.h>
+#include "sensors.h"
+#include "host_sim.h"
+
+#define HOST_UART_NUM 3
+#define HOST_ADC_MAX_COUNTS 4095
+#define HOST_MAINS_PERIOD_US 20000ULL /*!< 50 Hz */
+#define HOST_ADC_CAL_OFFSET_MV 142 /*!< coeff_b of a typical eFuse characterisation at 11 dB */
+#define HOST_ADC_CAL_SPAN_MV 3000  /*!< coeff_a scaled to the full 12 bit range */
+
+int g_iHostLog_level = ARDUHAL_LOG_LEVEL_WARN;
+
+HardwareSerial Serial(0);
+
+static HostUartDevice *p_tUartDevices[HOST_UART_NUM] = {nullptr, nullptr, nullptr};
+static unsigned long ulUartBaud[HOST_UART_NUM] = {115200, 9600, 9600};
+
+//------------------------------------------------------------------------------
+// String
+//------------------------------------------------------------------------------
+
+String::String(const char *cstr) : _heap(nullptr), _len(0), _capacity(HOST_STRING_SSO_SIZE - 1)
+{
+    _sso[0] = '\0';
+    if (cstr)
+    {
+        assign(cstr, strlen(cstr));
+    }
+}
+
+String::String(const char *cstr, unsigned int length) : _heap(nullptr), _len(0), _capacity(HOST_STRING_SSO_SIZE - 1)
+{
+    _sso[0] = '\0';
+    if (cstr)
+    {
+        assign(cstr, length);
+    }
+}
+
+String::String(const String &str) : _heap(nullptr), _len(0), _capacity(HOST_STRING_SSO_SIZE - 1)
+{
+    _sso[0] = '\0';
+    assign(str.c_str(), str._len);
+}
+
+String::String(char c) : String()
+{
+    assign(&c, 1);
+}
+
+static const char *pcHostString_format(char *buf, size_t size, unsigned long long value, bool negative, unsigned char base)
+{
+    char tmp[72];
+    int pos = 0;
+    if (base < 2)
+    {
+        base = 10;
+    }
+    do
+    {
+        int digit = (int)(value % base);
+        tmp[pos++] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+        value /= base;
+    } while (value && (pos < (int)sizeof(tmp) - 1));
+    size_t out = 0;
+    if (negative && (out < size - 1))
+    {
+        buf[out++] = '-';
+    }
+    while ((pos > 0) && (out < size - 1))
+    {
+        buf[out++] = tmp[--pos];
+    }
+    buf[out] = '\0';
+    return buf;
+}
+
+String::String(unsigned char value, unsigned char base) : String((unsigned long long)value, base) {}
+String::String(int value, unsigned char base) : String((long long)value, base) {}
+String::String(unsigned int value, unsigned char base) : String((unsigned long long)value, base) {}
+String::String(long value, unsigned char base) : String((long long)value, base) {}
+String::String(unsigned long value, unsigned char base) : String((unsigned long long)value, base) {}
+
+String::String(long long value, unsigned char base) : String()
+{
+    char buf[72];
+    bool negative = (value < 0) && (base == 10);
+    unsigned long long magnitude = negative ? (unsigned long long)(-(value + 1)) + 1ULL : (unsigned long long)value;
+    pcHostString_format(buf, sizeof(buf), magnitude, negative, base);
+    assign(buf, strlen(buf));
+}
+
+String::String(unsigned long long value, unsigned char base) : String()
+{
+    char buf[72];
+    pcHostString_format(buf, sizeof(buf), value, false, base);
+    assign(buf, strlen(buf));
+}
+
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned int decimalPlaces) : String()
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+    assign(buf, strlen(buf));
+}
+
+String::~String()
+{
+    free(_heap);
+}
+
+String &String::operator=(const String &rhs)
+{
+    if (this != &rhs)
+    {
+        assign(rhs.c_str(), rhs._len);
+    }
+    return *this;
+}
+
+String &String::operator=(const char *cstr)
+{
+    assign(cstr ? cstr : "", cstr ? strlen(cstr) : 0);
+    return *this;
+}
+
+bool String::reserve(unsigned int size)
+{
+    if (size <= _capacity)
+    {
+        return true;
+    }
+    char *grown = (char *)malloc(size + 1);
+    if (!grown)
+    {
+        return false;
+    }
+    memcpy(grown, c_str(), _len + 1);
+    free(_heap);
+    _heap = grown;
+    _capacity = size;
+    return true;
+}
+
+void String::assign(const char *cstr, unsigned int length)
+{
+    if (!reserve(length))
+    {
+        return;
+    }
+    memmove(buffer(), cstr, length);
+    _len = length;
+    buffer()[_len] = '\0';
+}
+
+bool String::concat(const char *cstr, unsigned int length)
+{
+    if (!cstr)
+    {
+        return false;
+    }
+    unsigned int newLen = _len + length;
+    if (!reserve(newLen < 2 * _capacity ? 2 * _capacity : newLen))
+    {
+        return false;
+    }
+    memmove(buffer() + _len, cstr, length);
+    _len = newLen;
+    buffer()[_len] = '\0';
+    return true;
+}
+
+bool String::concat(const String &str)
+{
+    String copy(str); // handles self concatenation
+    return concat(copy.c_str(), copy._len);
+}
+
+bool String::concat(const char *cstr)
+{
+    return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::concat(char c) { return concat(&c, 1); }
+bool String::concat(unsigned char num) { return concat(String(num)); }
+bool String::concat(int num) { return concat(String(num)); }
+bool String::concat(unsigned int num) { return concat(String(num)); }
+bool String::concat(long num) { return concat(String(num)); }
+bool String::concat(unsigned long num) { return concat(String(num)); }
+bool String::concat(long long num) { return concat(String(num)); }
+bool String::concat(unsigned long long num) { return concat(String(num)); }
+bool String::concat(float num) { return concat(String(num)); }
+bool String::concat(double num) { return concat(String(num)); }
+
+int String::compareTo(const String &s) const
+{
+    return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String &s) const
+{
+    return (_len == s._len) && (compareTo(s) == 0);
+}
+
+bool String::equals(const char *cstr) const
+{
+    return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String &s) const
+{
+    return (_len == s._len) && (strcasecmp(c_str(), s.c_str()) == 0);
+}
+
+bool String::startsWith(const String &prefix) const
+{
+    return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const
+{
+    if (offset + prefix._len > _len)
+    {
+        return false;
+    }
+    return strncmp(c_str() + offset, prefix.c_str(), prefix._len) == 0;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+    if (suffix._len > _len)
+    {
+        return false;
+    }
+    return strcmp(c_str() + _len - suffix._len, suffix.c_str()) == 0;
+}
+
+char String::charAt(unsigned int index) const
+{
+    return (index < _len) ? c_str()[index] : '\0';
+}
+
+void String::setCharAt(unsigned int index, char c)
+{
+    if (index < _len)
+    {
+        buffer()[index] = c;
+    }
+}
+
+char &String::operator[](unsigned int index)
+{
+    static char dummy;
+    if (index >= _len)
+    {
+        dummy = '\0';
+        return dummy;
+    }
+    return buffer()[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+    if (!bufsize || !buf)
+    {
+        return;
+    }
+    if (index >= _len)
+    {
+        buf[0] = '\0';
+        return;
+    }
+    unsigned int n = bufsize - 1;
+    if (n > _len - index)
+    {
+        n = _len - index;
+    }
+    memcpy(buf, c_str() + index, n);
+    buf[n] = '\0';
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const
+{
+    if (fromIndex >= _len)
+    {
+        return -1;
+    }
+    const char *found = strchr(c_str() + fromIndex, ch);
+    return found ? (int)(found - c_str()) : -1;
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const
+{
+    if (fromIndex >= _len)
+    {
+        return -1;
+    }
+    const char *found = strstr(c_str() + fromIndex, str.c_str());
+    return found ? (int)(found - c_str()) : -1;
+}
+
+int String::lastIndexOf(char ch) const
+{
+    const char *found = strrchr(c_str(), ch);
+    return found ? (int)(found - c_str()) : -1;
+}
+
+int String::lastIndexOf(const String &str) const
+{
+    int found = -1;
+    for (int i = indexOf(str); i >= 0; i = indexOf(str, i + 1))
+    {
+        found = i;
+    }
+    return found;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+    if (beginIndex > endIndex)
+    {
+        unsigned int tmp = beginIndex;
+        beginIndex = endIndex;
+        endIndex = tmp;
+    }
+    if (beginIndex >= _len)
+    {
+        return String();
+    }
+    if (endIndex > _len)
+    {
+        endIndex = _len;
+    }
+    return String(c_str() + beginIndex, endIndex - beginIndex);
+}
+
+void String::replace(char find, char replace)
+{
+    for (unsigned int i = 0; i < _len; i++)
+    {
+        if (buffer()[i] == find)
+        {
+            buffer()[i] = replace;
+        }
+    }
+}
+
+void String::replace(const String &find, const String &replace)
+{
+    if (find._len == 0)
+    {
+        return;
+    }
+    String out;
+    unsigned int pos = 0;
+    for (int hit = indexOf(find); hit >= 0; hit = indexOf(find, pos))
+    {
+        out.concat(c_str() + pos, (unsigned int)hit - pos);
+        out.concat(replace);
+        pos = (unsigned int)hit + find._len;
+    }
+    out.concat(c_str() + pos, _len - pos);
+    *this = out;
+}
+
+void String::remove(unsigned int index)
+{
+    remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count)
+{
+    if (index >= _len)
+    {
+        return;
+    }
+    if (count > _len - index)
+    {
+        count = _len - index;
+    }
+    memmove(buffer() + index, buffer() + index + count, _len - index - count + 1);
+    _len -= count;
+}
+
+void String::toLowerCase(void)
+{
+    for (unsigned int i = 0; i < _len; i++)
+    {
+        buffer()[i] = (char)tolower((unsigned char)buffer()[i]);
+    }
+}
+
+void String::toUpperCase(void)
+{
+    for (unsigned int i = 0; i < _len; i++)
+    {
+        buffer()[i] = (char)toupper((unsigned char)buffer()[i]);
+    }
+}
+
+void String::trim(void)
+{
+    unsigned int begin = 0;
+    while ((begin < _len) && isspace((unsigned char)c_str()[begin]))
+    {
+        begin++;
+    }
+    unsigned int end = _len;
+    while ((end > begin) && isspace((unsigned char)c_str()[end - 1]))
+    {
+        end--;
+    }
+    *this = substring(begin, end);
+}
+
+long String::toInt(void) const
+{
+    return atol(c_str());
+}
+
+float String::toFloat(void) const
+{
+    return (float)atof(c_str());
+}
+
+double String::toDouble(void) const
+{
+    return atof(c_str());
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+    String out(lhs);
+    out.concat(rhs);
+    return out;
+}
+
+String operator+(const String &lhs, char rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, int rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, unsigned int rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, long rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, unsigned long rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, float rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, double rhs) { return lhs + String(rhs); }
+
+//------------------------------------------------------------------------------
+// Print / Stream
+//------------------------------------------------------------------------------
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::printf(const char *format, ...)
+{
+    char buf[512];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0)
+    {
+        return 0;
+    }
+    return write((const uint8_t *)buf, strlen(buf));
+}
+
+/******************************************************
+ * @brief read with timeout; available() lets the
+ *        device model advance the virtual clock
+ ******************************************************/
+static int iHostStream_timedRead(Stream *stream, unsigned long timeout)
+{
+    unsigned long start = millis();
+    do
+    {
+        if (stream->available() > 0)
+        {
+            return stream->read();
+        }
+    } while ((millis() - start) < timeout);
+    return -1;
+}
+
+size_t Stream::readBytes(uint8_t *buffer, size_t length)
+{
+    size_t count = 0;
+    while (count < length)
+    {
+        int c = iHostStream_timedRead(this, _timeout);
+        if (c < 0)
+        {
+            break;
+        }
+        buffer[count++] = (uint8_t)c;
+    }
+    return count;
+}
+
+String Stream::readString()
+{
+    String out;
+    for (int c = iHostStream_timedRead(this, _timeout); c >= 0; c = iHostStream_timedRead(this, _timeout))
+    {
+        out.concat((char)c);
+    }
+    return out;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+    String out;
+    for (int c = iHostStream_timedRead(this, _timeout); (c >= 0) && (c != terminator); c = iHostStream_timedRead(this, _timeout))
+    {
+        out.concat((char)c);
+    }
+    return out;
+}
+
+//------------------------------------------------------------------------------
+// HardwareSerial
+//------------------------------------------------------------------------------
+
+void vHostUart_attach(int uart_nr, HostUartDevice *device)
+{
+    if ((uart_nr >= 0) && (uart_nr < HOST_UART_NUM))
+    {
+        p_tUartDevices[uart_nr] = device;
+    }
+}
+
+void HardwareSerial::begin(unsigned long baud, uint32_t config, int8_t rxPin, int8_t txPin)
+{
+    (void)config;
+    (void)rxPin;
+    (void)txPin;
+    if ((_uart_nr >= 0) && (_uart_nr < HOST_UART_NUM))
+    {
+        ulUartBaud[_uart_nr] = baud;
+    }
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t new_size)
+{
+    HostUartDevice *device = ((_uart_nr > 0) && (_uart_nr < HOST_UART_NUM)) ? p_tUartDevices[_uart_nr] : nullptr;
+    if (device)
+    {
+        device->setRxBufferSize(new_size);
+    }
+    return new_size;
+}
+
+int HardwareSerial::available()
+{
+    HostUartDevice *device = ((_uart_nr > 0) && (_uart_nr < HOST_UART_NUM)) ? p_tUartDevices[_uart_nr] : nullptr;
+    int count = device ? device->available() : 0;
+    if ((count == 0) && (_uart_nr > 0))
+    {
+        // a caller polling an empty FIFO waits for at least one character time
+        vHostClock_advance((10ULL * 1000000ULL) / ulUartBaud[_uart_nr]);
+    }
+    return count;
+}
+
+int HardwareSerial::read()
+{
+    HostUartDevice *device = ((_uart_nr > 0) && (_uart_nr < HOST_UART_NUM)) ? p_tUartDevices[_uart_nr] : nullptr;
+    return device ? device->read() : -1;
+}
+
+int HardwareSerial::peek()
+{
+    HostUartDevice *device = ((_uart_nr > 0) && (_uart_nr < HOST_UART_NUM)) ? p_tUartDevices[_uart_nr] : nullptr;
+    return device ? device->peek() : -1;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (_uart_nr == 0)
+    {
+        return fwrite(buffer, 1, size, stdout);
+    }
+    HostUartDevice *device = (_uart_nr < HOST_UART_NUM) ? p_tUartDevices[_uart_nr] : nullptr;
+    for (size_t i = 0; device && (i < size); i++)
+    {
+        device->write(buffer[i]);
+    }
+    vHostClock_advance(((uint64_t)size * 10ULL * 1000000ULL) / ulUartBaud[_uart_nr]);
+    return size;
+}
+
+//------------------------------------------------------------------------------
+// GPIO / ADC
+//------------------------------------------------------------------------------
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    (void)pin;
+    (void)val;
+}
+
+int digitalRead(uint8_t pin)
+{
+    (void)pin;
+    return LOW;
+}
+
+/******************************************************
+ * @brief O3_ADC_PIN returns the ZE25-O3 output for the
+ *        synthetic ozone level, inverting the firmware
+ *        conversion in fHalSensor_o3PointsToUgM3()
+ ******************************************************/
+uint16_t analogRead(uint8_t pin)
+{
+    vHostClock_advance(10); // one SAR conversion
+    if ((pin != O3_ADC_PIN) || !g_tHostSim_config.o3Present || bHostSim_fault(g_tHostSim_config.o3FailRate))
+    {
+        return 0; // pulled down
+    }
+
+    // the level only moves once per wall clock second, the ADC samples much faster
+    static hostEnvSample_t env;
+    static time_t envEpoch = 0;
+    time_t now = tHostClock_wallEpoch();
+    if (now != envEpoch)
+    {
+        vHostEnv_sample(now, &env);
+        envEpoch = now;
+    }
+    float counts = (env.o3Ugm3 * (CELIUS_TO_KELVIN + env.temperature)) / (O3_CALC_FACTOR_1 * O3_CALC_FACTOR_2 * O3_CALC_FACTOR_3);
+    counts += (fHostSim_uniform() - 0.5f) * g_tHostSim_config.o3NoiseLsb; // ADC noise
+    if (g_tHostSim_config.o3HumLsb > 0.0f)
+    {
+        double phase = (double)(ullHostClock_micros() % HOST_MAINS_PERIOD_US) / HOST_MAINS_PERIOD_US;
+        counts += g_tHostSim_config.o3HumLsb * (float)sin(2.0 * M_PI * phase); // mains pickup
+    }
+    if (counts < 1.0f)
+    {
+        counts = 1.0f;
+    }
+    if (counts > HOST_ADC_MAX_COUNTS)
+    {
+        counts = HOST_ADC_MAX_COUNTS;
+    }
+    return (uint16_t)lroundf(counts);
+}
+
+/******************************************************
+ * @brief esp_adc_cal_raw_to_voltage(): linear in the
+ *        raw points plus the characterisation offset,
+ *        a pulled-down pin reads coeff_b and never 0 mV
+ ******************************************************/
+uint32_t analogReadMilliVolts(uint8_t pin)
+{
+    uint32_t raw = analogRead(pin);
+    return ((raw * HOST_ADC_CAL_SPAN_MV) + (HOST_ADC_MAX_COUNTS / 2)) / HOST_ADC_MAX_COUNTS + HOST_ADC_CAL_OFFSET_MV;
+}
+
+void analogSetAttenuation(adc_attenuation_t attenuation)
+{
+    (void)attenuation;
+}
+
+//------------------------------------------------------------------------------
+// random / log
+//------------------------------------------------------------------------------
+
+long random(long howbig)
+{
+    return (howbig <= 0) ? 0 : (long)(ulHostSim_random() % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig)
+{
+    return (howsmall >= howbig) ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed)
+{
+    vHostSim_seed((uint32_t)seed);
+}
+
+void vHostLog_write(char level, const char *file, int line, const char *func, const char *format, ...)
+{
+    const char *base = strrchr(file, '/');
+    base = base ? base + 1 : file;
+    flockfile(stdout); // one line per call with several tasks logging
+    fprintf(stdout, "[%8lu][%c][%s:%d] %s(): ", millis(), level, base, line, func);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stdout, format, args);
+    va_end(args);
+    fputc('\n', stdout);
+    funlockfile(stdout);
+}
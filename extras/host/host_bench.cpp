@@ -0,0 +1,74 @@
+/******************************************************************************
+ * @file    host_bench.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host side of the sensor math microbenchmarks (benchmark.cpp):
+ *          native monotonic clock for the timing, since the stubbed micros()
+ *          follows the virtual clock, and a malloc counter for the
+ *          allocations.
+ *
+ *          Usage: host-bench
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include "benchmark.h"
+#include "host_sim.h"
+
+#define HOST_BENCH_NS_PER_US 1000U
+
+// the benchmark drives no simulated peripheral, the stubs only need the symbol
+hostSimConfig_t g_tHostSim_config = {};
+
+static uint32_t ulAllocations;
+
+// glibc entry points of the allocator, the definitions below interpose on them
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+extern "C" void *malloc(size_t size)
+{
+    __atomic_add_fetch(&ulAllocations, 1, __ATOMIC_RELAXED);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+    __atomic_add_fetch(&ulAllocations, 1, __ATOMIC_RELAXED);
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    __atomic_add_fetch(&ulAllocations, 1, __ATOMIC_RELAXED);
+    return __libc_realloc(ptr, size);
+}
+
+uint32_t ulMspBench_ticks(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000000ULL) + (uint64_t)now.tv_nsec);
+}
+
+uint32_t ulMspBench_ticksPerUs(void)
+{
+    return HOST_BENCH_NS_PER_US;
+}
+
+uint32_t ulMspBench_allocations(void)
+{
+    return __atomic_load_n(&ulAllocations, __ATOMIC_RELAXED);
+}
+
+int main(void)
+{
+    g_iHostLog_level = ARDUHAL_LOG_LEVEL_ERROR; // as a release build, the log calls left are only the checks
+    vMspBench_run();
+    return 0;
+}
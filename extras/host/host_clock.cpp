@@ -0,0 +1,260 @@
+/******************************************************************************
+ * @file    host_clock.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Virtual clock of the host simulation. Replaces millis(), delay(),
+ *          getLocalTime() and the SNTP client: time only moves when the
+ *          firmware waits, so weeks of operation run in seconds. With the
+ *          concurrent scheduler the clock follows the host monotonic clock,
+ *          sped up by the time scale.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <atomic>
+#include "esp_sntp.h"
+#include "config.h"
+#include "host_sim.h"
+
+#define HOST_CLOCK_NS_PER_US 1000ULL
+#define HOST_CLOCK_NS_PER_SEC 1000000000ULL
+
+// -- clock state --
+static uint64_t ullUptimeUs = 0;            /*!< virtual time since boot */
+static time_t tBootWallEpoch = 0;           /*!< real world time at boot */
+static std::atomic<bool> bSynced(false);    /*!< true once the firmware has run NTP */
+static bool bRealTime = false;              /*!< time follows the host clock */
+static uint32_t ulTimeScale = 1;            /*!< virtual seconds per host second */
+static uint64_t ullRealBaseNs = 0;          /*!< host monotonic time at ullUptimeUs */
+static char cTimezone[64] = "";             /*!< TZ currently set in the environment */
+
+static uint64_t ullHostClock_monotonicNs(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * HOST_CLOCK_NS_PER_SEC + (uint64_t)now.tv_nsec;
+}
+
+/******************************************************
+ * @brief setenv() is not thread safe against the other
+ *        tasks calling localtime(): only touch TZ when
+ *        it really changes
+ ******************************************************/
+static void vHostClock_setTimezone(const char *tz)
+{
+    if (strcmp(cTimezone, tz) != 0)
+    {
+        snprintf(cTimezone, sizeof(cTimezone), "%s", tz);
+        setenv("TZ", tz, 1);
+        tzset();
+    }
+}
+
+/******************************************************
+ * @brief reset the clock to boot, with the wall time
+ *        the simulated unit would obtain from NTP
+ ******************************************************/
+void vHostClock_init(time_t wallEpoch)
+{
+    ullUptimeUs = 0;
+    tBootWallEpoch = wallEpoch;
+    bSynced = false;
+    vHostClock_setTimezone(TZ_DEFAULT);
+}
+
+/******************************************************
+ * @brief from now on the clock runs by itself, scale
+ *        virtual seconds per host second
+ ******************************************************/
+void vHostClock_startRealTime(uint32_t scale)
+{
+    ulTimeScale = scale ? scale : 1;
+    ullRealBaseNs = ullHostClock_monotonicNs();
+    bRealTime = true;
+}
+
+/******************************************************
+ * @brief host CLOCK_MONOTONIC instant at which the
+ *        virtual clock reaches us
+ ******************************************************/
+void vHostClock_realDeadline(uint64_t us, struct timespec *p_tOut)
+{
+    uint64_t ns = ullRealBaseNs;
+    if (us > ullUptimeUs)
+    {
+        ns += ((us - ullUptimeUs) * HOST_CLOCK_NS_PER_US) / ulTimeScale;
+    }
+    p_tOut->tv_sec = (time_t)(ns / HOST_CLOCK_NS_PER_SEC);
+    p_tOut->tv_nsec = (long)(ns % HOST_CLOCK_NS_PER_SEC);
+}
+
+uint64_t ullHostClock_micros(void)
+{
+    if (bRealTime)
+    {
+        return ullUptimeUs + ((ullHostClock_monotonicNs() - ullRealBaseNs) * ulTimeScale) / HOST_CLOCK_NS_PER_US;
+    }
+    return ullUptimeUs;
+}
+
+/******************************************************
+ * @brief the caller keeps the CPU busy for us
+ ******************************************************/
+void vHostClock_advance(uint64_t us)
+{
+    if (bHostRtos_isRunning())
+    {
+        vHostRtos_busy(us);
+        return;
+    }
+    ullUptimeUs += us;
+}
+
+/******************************************************
+ * @brief jump to a later instant, for the scheduler of
+ *        the virtual clock only
+ ******************************************************/
+void vHostClock_advanceTo(uint64_t us)
+{
+    if (!bRealTime && (us > ullUptimeUs))
+    {
+        ullUptimeUs = us;
+    }
+}
+
+time_t tHostClock_wallEpoch(void)
+{
+    return tBootWallEpoch + (time_t)(ullHostClock_micros() / 1000000ULL);
+}
+
+void vHostClock_setSynced(bool synced)
+{
+    bSynced = synced;
+}
+
+bool bHostClock_isSynced(void)
+{
+    return bSynced;
+}
+
+/***********************************************************
+ * @brief parse a start time in the FAKE_NTP_TIME format:
+ *        "YYYY-MM-DD HH:MM:SS" or "HH:MM:SS" (default date)
+ *
+ * @param text
+ * @param p_tEpoch
+ * @return true on success
+ ***********************************************************/
+bool bHostClock_parseStart(const char *text, time_t *p_tEpoch)
+{
+    struct tm tmStart;
+    memset(&tmStart, 0, sizeof(tmStart));
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+
+    if (sscanf(text, "%d-%d-%d %d:%d:%d", &year, &month, &day, &hour, &minute, &second) != 6)
+    {
+        if (sscanf(text, "%d:%d:%d", &hour, &minute, &second) != 3)
+        {
+            return false;
+        }
+        sscanf(HOST_SIM_DEFAULT_START, "%d-%d-%d", &year, &month, &day);
+    }
+
+    tmStart.tm_year = year - 1900;
+    tmStart.tm_mon = month - 1;
+    tmStart.tm_mday = day;
+    tmStart.tm_hour = hour;
+    tmStart.tm_min = minute;
+    tmStart.tm_sec = second;
+    tmStart.tm_isdst = -1;
+    *p_tEpoch = mktime(&tmStart);
+    return (*p_tEpoch != (time_t)-1);
+}
+
+//------------------------------------------------------------------------------
+// Arduino time API
+//------------------------------------------------------------------------------
+
+unsigned long millis(void)
+{
+    return (unsigned long)(ullHostClock_micros() / 1000ULL);
+}
+
+unsigned long micros(void)
+{
+    return (unsigned long)ullHostClock_micros();
+}
+
+/******************************************************
+ * @brief vTaskDelay() on the ESP32: the other tasks run
+ ******************************************************/
+void delay(uint32_t ms)
+{
+    if (bHostRtos_isRunning())
+    {
+        vHostRtos_sleepUntil(ullHostClock_micros() + (uint64_t)ms * 1000ULL);
+        return;
+    }
+    ullUptimeUs += (uint64_t)ms * 1000ULL;
+}
+
+void delayMicroseconds(uint32_t us)
+{
+    vHostClock_advance(us);
+}
+
+void yield(void)
+{
+}
+
+/***********************************************************
+ * @brief same contract as the ESP32 core: polls the system
+ *        time until it is valid (year > 2016) or ms expired
+ ***********************************************************/
+bool getLocalTime(struct tm *info, uint32_t ms)
+{
+    if (!bSynced)
+    {
+        delay(ms);
+        return false;
+    }
+
+    time_t now = tHostClock_wallEpoch();
+    localtime_r(&now, info);
+    return true;
+}
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1, const char *server2, const char *server3)
+{
+    (void)gmtOffset_sec;
+    (void)daylightOffset_sec;
+    (void)server1;
+    (void)server2;
+    (void)server3;
+    delay(g_tHostSim_config.networkLatencyMs);
+    bSynced = true;
+}
+
+void configTzTime(const char *tz, const char *server1, const char *server2, const char *server3)
+{
+    (void)server1;
+    (void)server2;
+    (void)server3;
+    vHostClock_setTimezone(tz);
+    delay(g_tHostSim_config.networkLatencyMs);
+    bSynced = true;
+}
+
+sntp_sync_status_t sntp_get_sync_status(void)
+{
+    return bSynced ? SNTP_SYNC_STATUS_COMPLETED : SNTP_SYNC_STATUS_RESET;
+}
+
+void sntp_set_sync_interval(uint32_t interval_ms)
+{
+    (void)interval_ms;
+}
@@ -0,0 +1,496 @@
+/******************************************************************************
+ * @file    host_csv.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Reader and writer of the SD card logs: the daily record files
+ *          written by vHalSdcard_logToSD() (CSV_HEADER, legacy layout
+ *          included) and the raw per-minute sample files of the host
+ *          simulation (HOST_CSV_RAW_HEADER). Numbers use the decimal comma
+ *          of vGeneric_floatToComma(), an empty field is a missing value;
+ *          records keep three decimals, samples every digit of the float.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <string>
+#include "host_sim.h"
+#include "channelStats.h"
+
+#define HOST_CSV_SEPARATOR ';'
+#define HOST_CSV_ISO_LEN 19 /*!< YYYY-MM-DDTHH:MM:SS, the rest is ignored */
+#define HOST_CSV_SEC_IN_DAY 86400
+
+typedef struct
+{
+    const char *name;
+    hostCsvColumn_t column;
+} hostCsvName_t;
+
+static const hostCsvName_t tColumnNames[] = {
+    {"recordedAt", HOST_CSV_COL_RECORDED_AT},
+    {"temp", HOST_CSV_COL_TEMP},
+    {"hum", HOST_CSV_COL_HUM},
+    {"pres", HOST_CSV_COL_PRES},
+    {"voc", HOST_CSV_COL_VOC},
+    {"PM1", HOST_CSV_COL_PM1},
+    {"PM2_5", HOST_CSV_COL_PM25},
+    {"PM10", HOST_CSV_COL_PM10},
+    {"nox", HOST_CSV_COL_NOX},
+    {"co", HOST_CSV_COL_CO},
+    {"nh3", HOST_CSV_COL_NH3},
+    {"o3", HOST_CSV_COL_O3},
+    {"msp", HOST_CSV_COL_MSP},
+    {"micsOx", HOST_CSV_COL_MICS_OX},
+    {"micsRed", HOST_CSV_COL_MICS_RED},
+};
+
+//------------------------------------------------------------------------------
+// time stamps
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief days since 1970-01-01 of a civil date
+ *        (proleptic Gregorian), no time zone involved
+ ******************************************************/
+static int64_t llHostCsv_daysFromCivil(int year, int month, int day)
+{
+    year -= (month <= 2) ? 1 : 0;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yoe = year - era * 400;
+    int64_t doy = (153 * (month + ((month > 2) ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+static bool bHostCsv_digits(const char *p_cText, int count, int *p_iOut)
+{
+    int value = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if ((p_cText[i] < '0') || (p_cText[i] > '9'))
+        {
+            return false;
+        }
+        value = value * 10 + (p_cText[i] - '0');
+    }
+    *p_iOut = value;
+    return true;
+}
+
+static bool bHostCsv_parseStamp(const char *p_cText, size_t len, time_t *p_tOut)
+{
+    int year, month, day, hour, minute, second;
+    if ((len < HOST_CSV_ISO_LEN) || !bHostCsv_digits(p_cText, 4, &year) || !bHostCsv_digits(p_cText + 5, 2, &month) ||
+        !bHostCsv_digits(p_cText + 8, 2, &day) || !bHostCsv_digits(p_cText + 11, 2, &hour) ||
+        !bHostCsv_digits(p_cText + 14, 2, &minute) || !bHostCsv_digits(p_cText + 17, 2, &second) || (month < 1) ||
+        (month > 12))
+    {
+        return false;
+    }
+    *p_tOut = (time_t)(llHostCsv_daysFromCivil(year, month, day) * HOST_CSV_SEC_IN_DAY + hour * SEC_IN_HOUR + minute * SEC_IN_MIN + second);
+    return true;
+}
+
+/******************************************************
+ * @brief /YYYY/MM/DD<suffix>.csv, the layout of
+ *        vHalSdcard_logToSD()
+ ******************************************************/
+void vHostCsv_logPath(time_t recordedAt, const char *suffix, char *p_cOut, size_t size)
+{
+    struct tm stamp;
+    gmtime_r(&recordedAt, &stamp);
+    snprintf(p_cOut, size, "/%04d/%02d/%02d%s.csv", stamp.tm_year + 1900, stamp.tm_mon + 1, stamp.tm_mday, suffix);
+}
+
+//------------------------------------------------------------------------------
+// writer
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief append ";value" with the decimal comma of
+ *        vGeneric_floatToComma(), in the given format
+ ******************************************************/
+static size_t ulHostCsv_putNumber(char *p_cOut, size_t size, size_t pos, bool present, const char *format, float value)
+{
+    if (pos + 1 >= size)
+    {
+        return pos;
+    }
+    p_cOut[pos++] = HOST_CSV_SEPARATOR;
+    p_cOut[pos] = '\0';
+    if (!present)
+    {
+        return pos;
+    }
+    int written = snprintf(p_cOut + pos, size - pos, format, (double)value);
+    if (written < 0)
+    {
+        return pos;
+    }
+    size_t end = pos + (((size_t)written < size - pos) ? (size_t)written : size - pos - 1);
+    for (size_t i = pos; i < end; i++)
+    {
+        if (p_cOut[i] == '.')
+        {
+            p_cOut[i] = ',';
+        }
+    }
+    return end;
+}
+
+/******************************************************
+ * @brief three decimals, as the record files
+ ******************************************************/
+static size_t ulHostCsv_putFloat(char *p_cOut, size_t size, size_t pos, bool present, float value)
+{
+    return ulHostCsv_putNumber(p_cOut, size, pos, present, "%.3f", value);
+}
+
+/******************************************************
+ * @brief every digit of the float, so that samples sum
+ *        up to the same accumulators as on the device
+ ******************************************************/
+static size_t ulHostCsv_putExact(char *p_cOut, size_t size, size_t pos, bool present, float value)
+{
+    return ulHostCsv_putNumber(p_cOut, size, pos, present, "%.9g", value);
+}
+
+static size_t ulHostCsv_putInt(char *p_cOut, size_t size, size_t pos, bool present, int32_t value)
+{
+    int written = snprintf(p_cOut + pos, size - pos, present ? ";%d" : ";", (int)value);
+    if (written < 0)
+    {
+        return pos;
+    }
+    return pos + (((size_t)written < size - pos) ? (size_t)written : size - pos - 1);
+}
+
+/******************************************************
+ * @brief a record line, field for field what
+ *        vHalSdcard_logToSD() writes (no line end)
+ ******************************************************/
+size_t ulHostCsv_formatRecord(const hostCsvRow_t *p_tRow, char *p_cOut, size_t size)
+{
+    struct tm stamp;
+    gmtime_r(&p_tRow->recordedAt, &stamp);
+    int written = snprintf(p_cOut, size, "%04d-%02d-%02dT%02d:%02d:%02d.000Z;%02d/%02d/%04d;%02d:%02d:%02d;%d;%d",
+                           stamp.tm_year + 1900, stamp.tm_mon + 1, stamp.tm_mday, stamp.tm_hour, stamp.tm_min, stamp.tm_sec,
+                           stamp.tm_mday, stamp.tm_mon + 1, stamp.tm_year + 1900, stamp.tm_hour, stamp.tm_min, stamp.tm_sec,
+                           stamp.tm_year + 1900, stamp.tm_mon + 1);
+    if ((written < 0) || ((size_t)written >= size))
+    {
+        return 0;
+    }
+    size_t pos = (size_t)written;
+    bool bme = (p_tRow->present & HOST_CSV_HAS_BME) != 0;
+    bool pms = (p_tRow->present & HOST_CSV_HAS_PMS) != 0;
+    bool mics = (p_tRow->present & HOST_CSV_HAS_MICS) != 0;
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, bme, p_tRow->temp);
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, bme, p_tRow->hum);
+    pos = ulHostCsv_putInt(p_cOut, size, pos, pms, p_tRow->pm1);
+    pos = ulHostCsv_putInt(p_cOut, size, pos, pms, p_tRow->pm25);
+    pos = ulHostCsv_putInt(p_cOut, size, pos, pms, p_tRow->pm10);
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, bme, p_tRow->pres);
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, false, 0.0f); // radiation
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, mics, p_tRow->no2);
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, mics, p_tRow->co);
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, mics, p_tRow->nh3);
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, (p_tRow->present & HOST_CSV_HAS_O3) != 0, p_tRow->o3);
+    pos = ulHostCsv_putFloat(p_cOut, size, pos, bme, p_tRow->voc);
+    return ulHostCsv_putInt(p_cOut, size, pos, true, p_tRow->msp);
+}
+
+/******************************************************
+ * @brief a raw sample line, HOST_CSV_RAW_HEADER
+ ******************************************************/
+size_t ulHostCsv_formatSample(const hostCsvRow_t *p_tRow, char *p_cOut, size_t size)
+{
+    struct tm stamp;
+    gmtime_r(&p_tRow->recordedAt, &stamp);
+    int written = snprintf(p_cOut, size, "%04d-%02d-%02dT%02d:%02d:%02d.000Z", stamp.tm_year + 1900, stamp.tm_mon + 1,
+                           stamp.tm_mday, stamp.tm_hour, stamp.tm_min, stamp.tm_sec);
+    if ((written < 0) || ((size_t)written >= size))
+    {
+        return 0;
+    }
+    size_t pos = (size_t)written;
+    bool bme = (p_tRow->present & HOST_CSV_HAS_BME) != 0;
+    bool pms = (p_tRow->present & HOST_CSV_HAS_PMS) != 0;
+    bool mics = (p_tRow->present & HOST_CSV_HAS_MICS) != 0;
+    bool adc = (p_tRow->present & HOST_CSV_HAS_MICS_ADC) != 0;
+    pos = ulHostCsv_putExact(p_cOut, size, pos, bme, p_tRow->temp);
+    pos = ulHostCsv_putExact(p_cOut, size, pos, bme, p_tRow->hum);
+    pos = ulHostCsv_putExact(p_cOut, size, pos, bme, p_tRow->pres);
+    pos = ulHostCsv_putExact(p_cOut, size, pos, bme, p_tRow->voc);
+    pos = ulHostCsv_putInt(p_cOut, size, pos, pms, p_tRow->pm1);
+    pos = ulHostCsv_putInt(p_cOut, size, pos, pms, p_tRow->pm25);
+    pos = ulHostCsv_putInt(p_cOut, size, pos, pms, p_tRow->pm10);
+    pos = ulHostCsv_putExact(p_cOut, size, pos, mics, p_tRow->no2);
+    pos = ulHostCsv_putExact(p_cOut, size, pos, mics, p_tRow->co);
+    pos = ulHostCsv_putExact(p_cOut, size, pos, mics, p_tRow->nh3);
+    pos = ulHostCsv_putExact(p_cOut, size, pos, (p_tRow->present & HOST_CSV_HAS_O3) != 0, p_tRow->o3);
+    pos = ulHostCsv_putInt(p_cOut, size, pos, adc, p_tRow->micsOx);
+    return ulHostCsv_putInt(p_cOut, size, pos, adc, p_tRow->micsRed);
+}
+
+//------------------------------------------------------------------------------
+// reader
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief map the header fields to columns, unknown
+ *        ones (date, time, radiation, sent_ok?...)
+ *        are skipped
+ ******************************************************/
+bool bHostCsv_parseHeader(const char *p_cLine, size_t len, hostCsvLayout_t *p_tLayout)
+{
+    memset(p_tLayout, 0, sizeof(*p_tLayout));
+    bool stamped = false;
+    size_t start = 0;
+    while ((len > 0) && ((p_cLine[len - 1] == '\r') || (p_cLine[len - 1] == '\n')))
+    {
+        len--;
+    }
+    for (size_t i = 0; i <= len; i++)
+    {
+        if ((i < len) && (p_cLine[i] != HOST_CSV_SEPARATOR))
+        {
+            continue;
+        }
+        if (p_tLayout->count >= HOST_CSV_MAX_COLUMNS)
+        {
+            return false;
+        }
+        uint8_t column = HOST_CSV_COL_IGNORED;
+        for (size_t n = 0; n < sizeof(tColumnNames) / sizeof(tColumnNames[0]); n++)
+        {
+            if ((strlen(tColumnNames[n].name) == i - start) && (memcmp(tColumnNames[n].name, p_cLine + start, i - start) == 0))
+            {
+                column = tColumnNames[n].column;
+                break;
+            }
+        }
+        stamped = stamped || (column == HOST_CSV_COL_RECORDED_AT);
+        p_tLayout->raw = p_tLayout->raw || (column == HOST_CSV_COL_MICS_OX);
+        p_tLayout->column[p_tLayout->count++] = column;
+        start = i + 1;
+    }
+    return stamped;
+}
+
+/******************************************************
+ * @brief decimal number with comma or dot and an
+ *        optional exponent; false on an empty field
+ ******************************************************/
+static bool bHostCsv_parseNumber(const char *p_cText, size_t len, float *p_fOut)
+{
+    static const double dPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+    size_t i = 0;
+    bool negative = false;
+    if ((len > 0) && ((p_cText[0] == '-') || (p_cText[0] == '+')))
+    {
+        negative = (p_cText[0] == '-');
+        i++;
+    }
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int decimals = -1;
+    int exponent = 0;
+    for (; i < len; i++)
+    {
+        char c = p_cText[i];
+        if (((c == 'e') || (c == 'E')) && (digits > 0))
+        {
+            char *end = nullptr;
+            char text[8] = {0};
+            size_t count = len - i - 1;
+            if ((count == 0) || (count >= sizeof(text)))
+            {
+                return false;
+            }
+            memcpy(text, p_cText + i + 1, count);
+            exponent = (int)strtol(text, &end, 10);
+            if (*end != '\0')
+            {
+                return false;
+            }
+            break;
+        }
+        if ((c >= '0') && (c <= '9'))
+        {
+            if (digits < 18)
+            {
+                mantissa = mantissa * 10 + (uint64_t)(c - '0');
+                digits++;
+                decimals += (decimals >= 0) ? 1 : 0;
+            }
+            else if (decimals < 0)
+            {
+                return false; // out of range for a sensor value
+            }
+        }
+        else if (((c == ',') || (c == '.')) && (decimals < 0))
+        {
+            decimals = 0;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    if (digits == 0)
+    {
+        return false;
+    }
+    int scale = exponent - ((decimals > 0) ? decimals : 0);
+    if ((scale < -18) || (scale > 18))
+    {
+        return false; // out of range for a sensor value
+    }
+    double value = (scale < 0) ? (double)mantissa / dPow10[-scale] : (double)mantissa * dPow10[scale];
+    *p_fOut = (float)(negative ? -value : value);
+    return true;
+}
+
+/******************************************************
+ * @brief one data line; false when the time stamp
+ *        cannot be read
+ ******************************************************/
+bool bHostCsv_parseRow(const hostCsvLayout_t *p_tLayout, const char *p_cLine, size_t len, hostCsvRow_t *p_tRow)
+{
+    memset(p_tRow, 0, sizeof(*p_tRow));
+    bool stamped = false;
+    uint8_t field = 0;
+    size_t start = 0;
+    uint8_t bme = 0;
+    uint8_t pms = 0;
+    uint8_t mics = 0;
+    uint8_t adc = 0;
+    while ((len > 0) && ((p_cLine[len - 1] == '\r') || (p_cLine[len - 1] == '\n')))
+    {
+        len--;
+    }
+    for (size_t i = 0; (i <= len) && (field < p_tLayout->count); i++)
+    {
+        if ((i < len) && (p_cLine[i] != HOST_CSV_SEPARATOR))
+        {
+            continue;
+        }
+        const char *text = p_cLine + start;
+        size_t textLen = i - start;
+        uint8_t column = p_tLayout->column[field++];
+        start = i + 1;
+        float value = 0.0f;
+        if (column == HOST_CSV_COL_IGNORED)
+        {
+            continue;
+        }
+        if (column == HOST_CSV_COL_RECORDED_AT)
+        {
+            stamped = bHostCsv_parseStamp(text, textLen, &p_tRow->recordedAt);
+            continue;
+        }
+        if (!bHostCsv_parseNumber(text, textLen, &value))
+        {
+            continue;
+        }
+        switch (column)
+        {
+        case HOST_CSV_COL_TEMP:
+            p_tRow->temp = value;
+            bme++;
+            break;
+        case HOST_CSV_COL_HUM:
+            p_tRow->hum = value;
+            bme++;
+            break;
+        case HOST_CSV_COL_PRES:
+            p_tRow->pres = value;
+            bme++;
+            break;
+        case HOST_CSV_COL_VOC:
+            p_tRow->voc = value;
+            bme++;
+            break;
+        case HOST_CSV_COL_PM1:
+            p_tRow->pm1 = (int32_t)value;
+            pms++;
+            break;
+        case HOST_CSV_COL_PM25:
+            p_tRow->pm25 = (int32_t)value;
+            pms++;
+            break;
+        case HOST_CSV_COL_PM10:
+            p_tRow->pm10 = (int32_t)value;
+            pms++;
+            break;
+        case HOST_CSV_COL_NOX:
+            p_tRow->no2 = value;
+            mics++;
+            break;
+        case HOST_CSV_COL_CO:
+            p_tRow->co = value;
+            mics++;
+            break;
+        case HOST_CSV_COL_NH3:
+            p_tRow->nh3 = value;
+            mics++;
+            break;
+        case HOST_CSV_COL_O3:
+            p_tRow->o3 = value;
+            p_tRow->present |= HOST_CSV_HAS_O3;
+            break;
+        case HOST_CSV_COL_MSP:
+            p_tRow->msp = (int8_t)value;
+            p_tRow->present |= HOST_CSV_HAS_MSP;
+            break;
+        case HOST_CSV_COL_MICS_OX:
+            p_tRow->micsOx = (uint16_t)value;
+            adc++;
+            break;
+        case HOST_CSV_COL_MICS_RED:
+            p_tRow->micsRed = (uint16_t)value;
+            adc++;
+            break;
+        default:
+            break;
+        }
+    }
+    // a sensor counts only with all of its fields, as the firmware writes them together
+    p_tRow->present |= (bme == 4) ? HOST_CSV_HAS_BME : 0;
+    p_tRow->present |= (pms == 3) ? HOST_CSV_HAS_PMS : 0;
+    p_tRow->present |= (mics == 3) ? HOST_CSV_HAS_MICS : 0;
+    p_tRow->present |= (adc == 2) ? HOST_CSV_HAS_MICS_ADC : 0;
+    return stamped;
+}
+
+/******************************************************
+ * @brief CHANNEL=METHOD of --aggregation, CHANNEL the
+ *        upload field name of a channel or all
+ ******************************************************/
+bool bHostSim_parseAggregation(const char *p_cArg, uint8_t *p_ucMethods)
+{
+    const char *equal = strchr(p_cArg, '=');
+    statsMethod_t method;
+    if ((equal == nullptr) || !bMspStats_parseMethod(equal + 1, &method))
+    {
+        return false;
+    }
+    std::string name(p_cArg, (size_t)(equal - p_cArg));
+    if (name == "all")
+    {
+        memset(p_ucMethods, (int)method, STATS_CH_MAX);
+        return true;
+    }
+    stats_channel_t channel;
+    if (!bMspStats_parseChannel(name.c_str(), &channel))
+    {
+        return false;
+    }
+    p_ucMethods[channel] = (uint8_t)method;
+    return true;
+}
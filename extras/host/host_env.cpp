@@ -0,0 +1,104 @@
+/******************************************************************************
+ * @file    host_env.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Synthetic environment and deterministic random source of the host
+ *          simulation. The environment follows daily cycles typical of an
+ *          urban site in Milan so that averages and indices move over a run.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <atomic>
+#include "host_sim.h"
+
+#define HOST_ENV_TWO_PI 6.28318530718f
+
+static std::atomic<uint32_t> ulRandomState(0x2545F491UL); /*!< shared by the tasks */
+
+void vHostSim_seed(uint32_t seed)
+{
+    ulRandomState = seed ? seed : 0x2545F491UL;
+}
+
+/******************************************************
+ * @brief xorshift32, same sequence on every host
+ ******************************************************/
+uint32_t ulHostSim_random(void)
+{
+    uint32_t current = ulRandomState.load();
+    uint32_t x;
+    do
+    {
+        x = current;
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    } while (!ulRandomState.compare_exchange_weak(current, x));
+    return x;
+}
+
+float fHostSim_uniform(void)
+{
+    return (float)(ulHostSim_random() >> 8) / (float)(1UL << 24);
+}
+
+bool bHostSim_fault(float rate)
+{
+    return (rate > 0.0f) && (fHostSim_uniform() < rate);
+}
+
+/******************************************************
+ * @brief bell shaped peak centered on hour, width in h
+ ******************************************************/
+static float fHostEnv_peak(float hourOfDay, float center, float width)
+{
+    float d = hourOfDay - center;
+    return expf(-(d * d) / (2.0f * width * width));
+}
+
+/***********************************************************
+ * @brief environment at a wall clock time: temperature and
+ *        humidity follow the sun, PM and NO2 the two traffic
+ *        rush hours, O3 the afternoon photochemistry; noise
+ *        in [-0.5, 0.5) scales the fluctuations
+ ***********************************************************/
+static void vHostEnv_compute(time_t epoch, float noise, hostEnvSample_t *p_tOut)
+{
+    struct tm local;
+    localtime_r(&epoch, &local);
+    float hourOfDay = (float)local.tm_hour + (float)local.tm_min / 60.0f + (float)local.tm_sec / 3600.0f;
+    float daily = sinf(HOST_ENV_TWO_PI * (hourOfDay - 9.0f) / 24.0f); // max at 15:00
+    float rush = fHostEnv_peak(hourOfDay, 8.0f, 1.2f) + fHostEnv_peak(hourOfDay, 18.5f, 1.5f);
+    float afternoon = fHostEnv_peak(hourOfDay, 15.0f, 2.5f);
+
+    p_tOut->temperature = 14.0f + 7.0f * daily + 0.2f * noise;
+    p_tOut->humidity = 65.0f - 20.0f * daily + 1.0f * noise;
+    p_tOut->pressurePa = 100800.0f + 150.0f * sinf(HOST_ENV_TWO_PI * (float)(epoch % 604800) / 604800.0f);
+    p_tOut->gasOhm = 60000.0f - 15000.0f * rush + 500.0f * noise;
+
+    p_tOut->pm25 = 12.0f + 20.0f * rush + 2.0f * noise;
+    p_tOut->pm1 = 0.7f * p_tOut->pm25;
+    p_tOut->pm10 = 1.4f * p_tOut->pm25;
+
+    // MICS Rs/R0: the oxidising channel rises with NO2, the reducing ones drop with CO/NH3
+    p_tOut->oxRatio = 0.6f + 0.8f * rush + 0.02f * noise;
+    p_tOut->redRatio = 1.0f - 0.3f * rush + 0.02f * noise;
+    p_tOut->nh3Ratio = 1.0f - 0.2f * rush + 0.02f * noise;
+
+    p_tOut->o3Ugm3 = 40.0f + 60.0f * afternoon + 2.0f * noise;
+}
+
+void vHostEnv_sample(time_t epoch, hostEnvSample_t *p_tOut)
+{
+    vHostEnv_compute(epoch, fHostSim_uniform() - 0.5f, p_tOut);
+}
+
+void vHostEnv_level(time_t epoch, hostEnvSample_t *p_tOut)
+{
+    vHostEnv_compute(epoch, 0.0f, p_tOut);
+}
@@ -0,0 +1,1288 @@
+/******************************************************************************
+ * @file    host_freertos.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host implementation of the FreeRTOS API used by the firmware.
+ *          Every task, the Arduino loop task included, is a pthread; queues,
+ *          mutexes, semaphores and event groups are shared objects guarded
+ *          by one kernel lock, like the kernel critical section.
+ *
+ *          Two scheduling modes (hostSimConfig_t.rtosMode):
+ *          - deterministic: a single core, priority based scheduler. One
+ *            task runs at a time and the CPU only changes hands at kernel
+ *            calls, busy time included, so a higher priority task whose
+ *            timeout expires preempts the running one. When every task is
+ *            blocked the virtual clock jumps to the earliest timeout. The
+ *            same seed gives the same run, latencies included.
+ *          - concurrent: tasks run in parallel on host threads and the
+ *            clock is the host monotonic clock times the time scale, to
+ *            expose the races the deterministic mode serialises away.
+ *            Priorities are not enforced.
+ *
+ *          Each object keeps the counters printed by vHostRtos_report():
+ *          queue backlog and latency, lock contention and hold time, event
+ *          group wake-up latency.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <errno.h>
+#include <dlfcn.h>
+#include <cxxabi.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
+#include "host_sim.h"
+
+#define HOST_RTOS_FOREVER UINT64_MAX
+#define HOST_RTOS_MAX_TASKS 16
+#define HOST_RTOS_MAX_OBJECTS 64
+#define HOST_RTOS_NAME_LEN 40
+#define HOST_RTOS_TASK_NAME_LEN 16
+#define HOST_RTOS_MIN_STACK (1024U * 1024U) /*!< host frames are larger than the Xtensa ones */
+#define HOST_RTOS_LOOP_PRIORITY 1
+#define HOST_RTOS_LOOP_CORE_ID 1
+
+typedef enum
+{
+    HOST_TASK_READY,
+    HOST_TASK_RUNNING,
+    HOST_TASK_BLOCKED,
+    HOST_TASK_DELETED
+} hostTaskState_t;
+
+typedef enum
+{
+    HOST_OBJ_QUEUE,
+    HOST_OBJ_MUTEX,
+    HOST_OBJ_SEMAPHORE,
+    HOST_OBJ_EVENT_GROUP
+} hostObjKind_t;
+
+/*!< blocking behaviour of one kind of call on one object */
+typedef struct
+{
+    uint64_t calls;
+    uint64_t waits;    /*!< calls that found the object unavailable and blocked */
+    uint64_t fails;    /*!< calls that returned without the object, timeouts included */
+    uint64_t waitUs;   /*!< total time spent blocked */
+    uint64_t maxWaitUs;
+} hostWaitStats_t;
+
+struct HostTask
+{
+    char name[HOST_RTOS_TASK_NAME_LEN];
+    UBaseType_t basePriority;
+    UBaseType_t priority; /*!< effective priority, raised by priority inheritance */
+    BaseType_t coreId;
+    hostTaskState_t state;
+    pthread_t thread;
+    pthread_cond_t turn; /*!< deterministic mode: signalled when given the CPU */
+    TaskFunction_t code;
+    void *param;
+    struct HostObject *waitObj; /*!< object blocked on, nullptr for a delay */
+    uint64_t wakeUs;            /*!< timeout of the current block */
+    bool timedOut;
+    uint64_t readySeq; /*!< FIFO order among the ready tasks of a priority */
+    uint64_t createdUs;
+    uint64_t switchesIn;
+    uint64_t blocks;
+    uint64_t blockedUs;
+};
+
+struct HostObject
+{
+    hostObjKind_t kind;
+    char name[HOST_RTOS_NAME_LEN];
+    pthread_cond_t changed; /*!< concurrent mode: state changed, waiters re-check */
+};
+
+struct HostQueue : HostObject
+{
+    uint8_t *storage;
+    uint64_t *stamps; /*!< enqueue time of each slot */
+    UBaseType_t length;
+    UBaseType_t itemSize;
+    UBaseType_t head;
+    UBaseType_t count;
+    UBaseType_t peak;
+    uint64_t dropped; /*!< items discarded by reset or overwrite */
+    uint64_t latencyUs;
+    uint64_t maxLatencyUs;
+    hostWaitStats_t send;
+    hostWaitStats_t receive;
+};
+
+struct HostSemaphore : HostObject
+{
+    bool isMutex;
+    UBaseType_t count;
+    HostTask *holder;
+    uint64_t takenUs;
+    uint64_t holdUs;
+    uint64_t maxHoldUs;
+    hostWaitStats_t take;
+};
+
+struct HostEventGroup : HostObject
+{
+    EventBits_t bits;
+    uint64_t sets;
+    uint64_t setUs; /*!< time of the last set, for the wake-up latency */
+    uint64_t wakeups;
+    uint64_t wakeLatencyUs;
+    uint64_t maxWakeLatencyUs;
+    hostWaitStats_t wait;
+};
+
+// -- kernel state --
+static pthread_mutex_t tKernelLock = PTHREAD_MUTEX_INITIALIZER;
+static bool bStarted = false;
+static bool bDeterministic = true;
+static uint64_t ullEndUs = HOST_RTOS_FOREVER;
+static hostRtosFinish_t pfFinish = nullptr;
+static HostTask *p_tTasks[HOST_RTOS_MAX_TASKS];
+static UBaseType_t uxTaskCount = 0;
+static HostObject *p_tObjects[HOST_RTOS_MAX_OBJECTS];
+static UBaseType_t uxObjectCount = 0;
+static HostTask *p_tRunning = nullptr; /*!< deterministic mode: owner of the CPU */
+static HostTask *p_tLoopTask = nullptr;
+static uint64_t ullReadySeq = 0;
+static uint64_t ullSwitches = 0;
+static thread_local HostTask *p_tSelf = nullptr;
+
+static void vHostRtos_schedule(HostTask *self);
+
+//------------------------------------------------------------------------------
+// kernel internals, called with tKernelLock held
+//------------------------------------------------------------------------------
+
+static uint64_t ullHostRtos_deadline(TickType_t xTicksToWait)
+{
+    if (xTicksToWait == portMAX_DELAY)
+    {
+        return HOST_RTOS_FOREVER;
+    }
+    return ullHostClock_micros() + (uint64_t)xTicksToWait * portTICK_PERIOD_MS * 1000ULL;
+}
+
+/******************************************************
+ * @brief end the run: the hook reports and exits
+ ******************************************************/
+static void vHostRtos_end(const char *reason)
+{
+    if (pfFinish)
+    {
+        pfFinish(reason);
+    }
+    fflush(stdout);
+    _exit(0);
+}
+
+static void vHostRtos_makeReady(HostTask *task, bool timedOut)
+{
+    task->state = HOST_TASK_READY;
+    task->waitObj = nullptr;
+    task->wakeUs = HOST_RTOS_FOREVER;
+    task->timedOut = timedOut;
+    task->readySeq = ++ullReadySeq;
+}
+
+/******************************************************
+ * @brief highest priority ready task, FIFO among equals
+ ******************************************************/
+static HostTask *p_tHostRtos_nextReady(void)
+{
+    HostTask *best = nullptr;
+    for (UBaseType_t i = 0; i < uxTaskCount; i++)
+    {
+        HostTask *task = p_tTasks[i];
+        if ((task->state == HOST_TASK_READY) &&
+            (!best || (task->priority > best->priority) || ((task->priority == best->priority) && (task->readySeq < best->readySeq))))
+        {
+            best = task;
+        }
+    }
+    return best;
+}
+
+/******************************************************
+ * @brief blocked task with the earliest timeout
+ ******************************************************/
+static HostTask *p_tHostRtos_nextTimeout(void)
+{
+    HostTask *first = nullptr;
+    for (UBaseType_t i = 0; i < uxTaskCount; i++)
+    {
+        HostTask *task = p_tTasks[i];
+        if ((task->state == HOST_TASK_BLOCKED) && (task->wakeUs != HOST_RTOS_FOREVER) && (!first || (task->wakeUs < first->wakeUs)))
+        {
+            first = task;
+        }
+    }
+    return first;
+}
+
+static void vHostRtos_expireTimeouts(void)
+{
+    uint64_t now = ullHostClock_micros();
+    for (UBaseType_t i = 0; i < uxTaskCount; i++)
+    {
+        HostTask *task = p_tTasks[i];
+        if ((task->state == HOST_TASK_BLOCKED) && (task->wakeUs <= now))
+        {
+            vHostRtos_makeReady(task, true);
+        }
+    }
+}
+
+static void vHostRtos_deadlock(void)
+{
+    log_e("deadlock: every task is blocked without a timeout");
+    for (UBaseType_t i = 0; i < uxTaskCount; i++)
+    {
+        HostTask *task = p_tTasks[i];
+        if (task->state == HOST_TASK_BLOCKED)
+        {
+            log_e("  %s blocked on %s", task->name, task->waitObj ? task->waitObj->name : "delay");
+        }
+    }
+    vHostRtos_end("deadlock");
+}
+
+/******************************************************
+ * @brief deterministic mode: give the CPU to the next
+ *        ready task, letting time pass when none is
+ ******************************************************/
+static void vHostRtos_dispatch(void)
+{
+    for (;;)
+    {
+        HostTask *next = p_tHostRtos_nextReady();
+        if (next)
+        {
+            if (next != p_tRunning)
+            {
+                ullSwitches++;
+                next->switchesIn++;
+            }
+            next->state = HOST_TASK_RUNNING;
+            p_tRunning = next;
+            pthread_cond_signal(&next->turn);
+            return;
+        }
+
+        HostTask *first = p_tHostRtos_nextTimeout();
+        if (!first)
+        {
+            vHostRtos_deadlock();
+        }
+        if (first->wakeUs >= ullEndUs)
+        {
+            vHostClock_advanceTo(ullEndUs);
+            vHostRtos_end("end of run");
+        }
+        vHostClock_advanceTo(first->wakeUs);
+        vHostRtos_expireTimeouts();
+    }
+}
+
+static void vHostRtos_schedule(HostTask *self)
+{
+    vHostRtos_dispatch();
+    while (p_tRunning != self)
+    {
+        pthread_cond_wait(&self->turn, &tKernelLock);
+    }
+}
+
+/******************************************************
+ * @brief deterministic mode: yield if a higher priority
+ *        task became ready
+ ******************************************************/
+static void vHostRtos_preemptIfNeeded(void)
+{
+    HostTask *self = p_tSelf;
+    if (!bStarted || !bDeterministic || !self)
+    {
+        return;
+    }
+    HostTask *next = p_tHostRtos_nextReady();
+    if (next && (next->priority > self->priority))
+    {
+        vHostRtos_makeReady(self, false);
+        vHostRtos_schedule(self);
+    }
+}
+
+/******************************************************
+ * @brief block the caller until obj changes or the
+ *        deadline passes
+ *
+ * @return false on timeout
+ ******************************************************/
+static bool bHostRtos_wait(HostObject *obj, uint64_t deadlineUs)
+{
+    HostTask *self = p_tSelf;
+    if (!bStarted || !self)
+    {
+        // before the scheduler runs there is nobody to wake us up
+        if (deadlineUs != HOST_RTOS_FOREVER)
+        {
+            vHostClock_advanceTo(deadlineUs);
+        }
+        return false;
+    }
+
+    uint64_t start = ullHostClock_micros();
+    bool woken = true;
+    self->blocks++;
+    if (bDeterministic)
+    {
+        self->state = HOST_TASK_BLOCKED;
+        self->waitObj = obj;
+        self->wakeUs = deadlineUs;
+        self->timedOut = false;
+        vHostRtos_schedule(self);
+        woken = !self->timedOut;
+    }
+    else if (deadlineUs == HOST_RTOS_FOREVER)
+    {
+        pthread_cond_wait(&obj->changed, &tKernelLock);
+    }
+    else
+    {
+        struct timespec until;
+        vHostClock_realDeadline(deadlineUs, &until);
+        woken = (pthread_cond_timedwait(&obj->changed, &tKernelLock, &until) != ETIMEDOUT);
+    }
+    self->blockedUs += ullHostClock_micros() - start;
+    return woken;
+}
+
+/******************************************************
+ * @brief wake the tasks blocked on obj
+ ******************************************************/
+static void vHostRtos_notify(HostObject *obj)
+{
+    if (!bDeterministic)
+    {
+        pthread_cond_broadcast(&obj->changed);
+        return;
+    }
+    for (UBaseType_t i = 0; i < uxTaskCount; i++)
+    {
+        HostTask *task = p_tTasks[i];
+        if ((task->state == HOST_TASK_BLOCKED) && (task->waitObj == obj))
+        {
+            vHostRtos_makeReady(task, false);
+        }
+    }
+    vHostRtos_preemptIfNeeded();
+}
+
+/******************************************************
+ * @brief wait up to xTicksToWait for ready() to hold,
+ *        accounting the call in stats
+ ******************************************************/
+template <typename Ready>
+static bool bHostRtos_waitFor(HostObject *obj, TickType_t xTicksToWait, hostWaitStats_t *stats, Ready ready)
+{
+    stats->calls++;
+    if (ready())
+    {
+        return true;
+    }
+    if (xTicksToWait == 0)
+    {
+        stats->fails++;
+        return false;
+    }
+
+    uint64_t deadline = ullHostRtos_deadline(xTicksToWait);
+    uint64_t start = ullHostClock_micros();
+    bool satisfied = false;
+    stats->waits++;
+    for (;;)
+    {
+        bHostRtos_wait(obj, deadline);
+        if (ready())
+        {
+            satisfied = true;
+            break;
+        }
+        if (!bStarted || (ullHostClock_micros() >= deadline))
+        {
+            break;
+        }
+    }
+    uint64_t waited = ullHostClock_micros() - start;
+    stats->waitUs += waited;
+    if (waited > stats->maxWaitUs)
+    {
+        stats->maxWaitUs = waited;
+    }
+    if (!satisfied)
+    {
+        stats->fails++;
+    }
+    return satisfied;
+}
+
+/******************************************************
+ * @brief name an object after the function creating it
+ ******************************************************/
+static void vHostRtos_register(HostObject *obj, hostObjKind_t kind, const void *caller)
+{
+    obj->kind = kind;
+    snprintf(obj->name, sizeof(obj->name), "%p", caller);
+    Dl_info info;
+    if (dladdr(caller, &info) && info.dli_sname)
+    {
+        int status = -1;
+        char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        snprintf(obj->name, sizeof(obj->name), "%s", ((status == 0) && demangled) ? demangled : info.dli_sname);
+        free(demangled);
+        char *args = strchr(obj->name, '(');
+        if (args)
+        {
+            *args = '\0';
+        }
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&obj->changed, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_mutex_lock(&tKernelLock);
+    unsigned same = 1;
+    for (UBaseType_t i = 0; i < uxObjectCount; i++)
+    {
+        if (strncmp(p_tObjects[i]->name, obj->name, strlen(obj->name)) == 0)
+        {
+            same++;
+        }
+    }
+    if (same > 1)
+    {
+        size_t len = strlen(obj->name);
+        snprintf(obj->name + len, sizeof(obj->name) - len, "#%u", same);
+    }
+    if (uxObjectCount < HOST_RTOS_MAX_OBJECTS)
+    {
+        p_tObjects[uxObjectCount++] = obj;
+    }
+    pthread_mutex_unlock(&tKernelLock);
+}
+
+static void vHostRtos_unregister(HostObject *obj)
+{
+    pthread_mutex_lock(&tKernelLock);
+    for (UBaseType_t i = 0; i < uxObjectCount; i++)
+    {
+        if (p_tObjects[i] == obj)
+        {
+            p_tObjects[i] = p_tObjects[--uxObjectCount];
+            break;
+        }
+    }
+    pthread_mutex_unlock(&tKernelLock);
+    pthread_cond_destroy(&obj->changed);
+}
+
+//------------------------------------------------------------------------------
+// scheduler control
+//------------------------------------------------------------------------------
+
+static HostTask *p_tHostRtos_newTask(const char *pcName, UBaseType_t uxPriority, BaseType_t xCoreID)
+{
+    HostTask *task = new HostTask();
+    snprintf(task->name, sizeof(task->name), "%s", pcName ? pcName : "");
+    task->basePriority = uxPriority;
+    task->priority = uxPriority;
+    task->coreId = xCoreID;
+    task->state = HOST_TASK_READY;
+    task->wakeUs = HOST_RTOS_FOREVER;
+    task->createdUs = ullHostClock_micros();
+    pthread_cond_init(&task->turn, nullptr);
+    return task;
+}
+
+/******************************************************
+ * @brief concurrent mode: end the run on time even if
+ *        the loop task is blocked
+ ******************************************************/
+static void *pvHostRtos_monitor(void *arg)
+{
+    (void)arg;
+    struct timespec until;
+    vHostClock_realDeadline(ullEndUs, &until);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) == EINTR)
+    {
+    }
+    pthread_mutex_lock(&tKernelLock);
+    if (ullEndUs == HOST_RTOS_FOREVER)
+    {
+        pthread_mutex_unlock(&tKernelLock); // the loop task is ending the run itself
+        return nullptr;
+    }
+    vHostRtos_end("end of run");
+    return nullptr;
+}
+
+/******************************************************
+ * @brief turn the calling thread into the Arduino loop
+ *        task and start scheduling
+ *
+ * @param endUs  virtual time at which the run ends
+ * @param finish called with the kernel lock held when
+ *               the run ends, must not return
+ ******************************************************/
+void vHostRtos_start(uint64_t endUs, hostRtosFinish_t finish)
+{
+    bDeterministic = (g_tHostSim_config.rtosMode == HOST_RTOS_DETERMINISTIC);
+    ullEndUs = endUs;
+    pfFinish = finish;
+
+    HostTask *loop = p_tHostRtos_newTask("loopTask", HOST_RTOS_LOOP_PRIORITY, HOST_RTOS_LOOP_CORE_ID);
+    loop->thread = pthread_self();
+    loop->state = HOST_TASK_RUNNING;
+    p_tTasks[uxTaskCount++] = loop;
+    p_tLoopTask = loop;
+    p_tRunning = loop;
+    p_tSelf = loop;
+
+    if (!bDeterministic)
+    {
+        vHostClock_startRealTime(g_tHostSim_config.timeScale);
+        pthread_t monitor;
+        pthread_create(&monitor, nullptr, pvHostRtos_monitor, nullptr);
+        pthread_detach(monitor);
+    }
+    bStarted = true;
+}
+
+bool bHostRtos_isRunning(void)
+{
+    return bStarted && p_tSelf;
+}
+
+/******************************************************
+ * @brief the loop task runs the shutdown handlers at the
+ *        end of the run, they must not be cut short by
+ *        the end time passing in one of their calls
+ ******************************************************/
+void vHostRtos_holdEnd(void)
+{
+    pthread_mutex_lock(&tKernelLock);
+    ullEndUs = HOST_RTOS_FOREVER;
+    pthread_mutex_unlock(&tKernelLock);
+}
+
+void vHostRtos_finish(const char *reason)
+{
+    pthread_mutex_lock(&tKernelLock);
+    vHostRtos_end(reason);
+}
+
+/******************************************************
+ * @brief the caller keeps the CPU for us: in the
+ *        deterministic mode a higher priority task whose
+ *        timeout falls in the interval preempts it
+ ******************************************************/
+void vHostRtos_busy(uint64_t us)
+{
+    if (!bDeterministic)
+    {
+        uint64_t ns = (us * 1000ULL) / g_tHostSim_config.timeScale;
+        if (ns == 0)
+        {
+            sched_yield();
+            return;
+        }
+        struct timespec span = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+        nanosleep(&span, nullptr);
+        return;
+    }
+
+    pthread_mutex_lock(&tKernelLock);
+    uint64_t remaining = us;
+    for (;;)
+    {
+        uint64_t now = ullHostClock_micros();
+        HostTask *first = p_tHostRtos_nextTimeout();
+        if (!first || (first->wakeUs >= now + remaining))
+        {
+            vHostClock_advanceTo(now + remaining);
+            break;
+        }
+        if (first->wakeUs > now)
+        {
+            remaining -= first->wakeUs - now;
+            vHostClock_advanceTo(first->wakeUs);
+        }
+        vHostRtos_expireTimeouts();
+        vHostRtos_preemptIfNeeded();
+    }
+    if (ullHostClock_micros() >= ullEndUs)
+    {
+        vHostRtos_end("end of run");
+    }
+    pthread_mutex_unlock(&tKernelLock);
+}
+
+/******************************************************
+ * @brief block the caller until the given virtual time,
+ *        a yield when it has already come
+ ******************************************************/
+void vHostRtos_sleepUntil(uint64_t us)
+{
+    if (!bDeterministic)
+    {
+        struct timespec until;
+        vHostClock_realDeadline(us, &until);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, nullptr) == EINTR)
+        {
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&tKernelLock);
+    HostTask *self = p_tSelf;
+    if (us <= ullHostClock_micros())
+    {
+        vHostRtos_makeReady(self, false);
+        vHostRtos_schedule(self);
+    }
+    else
+    {
+        bHostRtos_wait(nullptr, us);
+    }
+    pthread_mutex_unlock(&tKernelLock);
+}
+
+//------------------------------------------------------------------------------
+// tasks
+//------------------------------------------------------------------------------
+
+static void *pvHostRtos_taskEntry(void *arg)
+{
+    HostTask *task = (HostTask *)arg;
+    p_tSelf = task;
+    if (bDeterministic)
+    {
+        pthread_mutex_lock(&tKernelLock);
+        while (p_tRunning != task)
+        {
+            pthread_cond_wait(&task->turn, &tKernelLock);
+        }
+        pthread_mutex_unlock(&tKernelLock);
+    }
+    task->code(task->param);
+    vTaskDelete(nullptr);
+    return nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char *pcName, uint32_t usStackDepth,
+                                   void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask,
+                                   BaseType_t xCoreID)
+{
+    if (!bStarted)
+    {
+        log_e("task %s created before the scheduler started", pcName);
+        return pdFAIL;
+    }
+
+    pthread_mutex_lock(&tKernelLock);
+    if (uxTaskCount >= HOST_RTOS_MAX_TASKS)
+    {
+        pthread_mutex_unlock(&tKernelLock);
+        return pdFAIL;
+    }
+    HostTask *task = p_tHostRtos_newTask(pcName, uxPriority, xCoreID);
+    task->code = pvTaskCode;
+    task->param = pvParameters;
+    task->readySeq = ++ullReadySeq;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, (usStackDepth > HOST_RTOS_MIN_STACK) ? usStackDepth : HOST_RTOS_MIN_STACK);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int err = pthread_create(&task->thread, &attr, pvHostRtos_taskEntry, task);
+    pthread_attr_destroy(&attr);
+    if (err != 0)
+    {
+        pthread_mutex_unlock(&tKernelLock);
+        log_e("pthread_create failed for task %s: %d", task->name, err);
+        delete task;
+        return pdFAIL;
+    }
+    p_tTasks[uxTaskCount++] = task;
+    if (pvCreatedTask)
+    {
+        *pvCreatedTask = task;
+    }
+    vHostRtos_preemptIfNeeded();
+    pthread_mutex_unlock(&tKernelLock);
+    return pdPASS;
+}
+
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t pvTaskCode, const char *pcName, uint32_t ulStackDepth,
+                                           void *pvParameters, UBaseType_t uxPriority, StackType_t *pxStackBuffer,
+                                           StaticTask_t *pxTaskBuffer, BaseType_t xCoreID)
+{
+    (void)pxStackBuffer;
+    (void)pxTaskBuffer;
+    TaskHandle_t task = nullptr;
+    xTaskCreatePinnedToCore(pvTaskCode, pcName, ulStackDepth, pvParameters, uxPriority, &task, xCoreID);
+    return task;
+}
+
+/******************************************************
+ * @brief host threads cannot be killed: a task deleted
+ *        by another one never runs again in the
+ *        deterministic mode, a running thread is left
+ *        alone in the concurrent one
+ ******************************************************/
+void vTaskDelete(TaskHandle_t xTask)
+{
+    HostTask *self = p_tSelf;
+    HostTask *task = xTask ? xTask : self;
+    if (!task)
+    {
+        return;
+    }
+    if (task == p_tLoopTask)
+    {
+        vHostRtos_finish("loop task deleted");
+    }
+
+    pthread_mutex_lock(&tKernelLock);
+    task->state = HOST_TASK_DELETED;
+    if (task != self)
+    {
+        if (!bDeterministic)
+        {
+            log_w("task %s deleted while running on a host thread", task->name);
+        }
+        pthread_mutex_unlock(&tKernelLock);
+        return;
+    }
+    if (bDeterministic)
+    {
+        vHostRtos_dispatch();
+    }
+    pthread_mutex_unlock(&tKernelLock);
+    pthread_exit(nullptr);
+}
+
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+    if (xTicksToDelay == portMAX_DELAY)
+    {
+        if (p_tSelf == p_tLoopTask)
+        {
+            log_e("loop task suspended forever, stopping");
+            vHostRtos_finish("loop task suspended forever");
+        }
+        if (!bDeterministic)
+        {
+            for (;;)
+            {
+                pause();
+            }
+        }
+        pthread_mutex_lock(&tKernelLock);
+        bHostRtos_wait(nullptr, HOST_RTOS_FOREVER); // nothing notifies a delay
+        pthread_mutex_unlock(&tKernelLock);
+        return;
+    }
+    if (!bHostRtos_isRunning())
+    {
+        vHostClock_advance((uint64_t)xTicksToDelay * portTICK_PERIOD_MS * 1000ULL);
+        return;
+    }
+    vHostRtos_sleepUntil(ullHostClock_micros() + (uint64_t)xTicksToDelay * portTICK_PERIOD_MS * 1000ULL);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(millis() / portTICK_PERIOD_MS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return p_tSelf;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    (void)xTask;
+    return 0;
+}
+
+char *pcTaskGetName(TaskHandle_t xTask)
+{
+    static char unknownName[] = "main";
+    HostTask *task = xTask ? xTask : p_tSelf;
+    return task ? task->name : unknownName;
+}
+
+void taskYIELD(void)
+{
+    if (!bHostRtos_isRunning())
+    {
+        return;
+    }
+    if (!bDeterministic)
+    {
+        sched_yield();
+        return;
+    }
+    pthread_mutex_lock(&tKernelLock);
+    vHostRtos_makeReady(p_tSelf, false);
+    vHostRtos_schedule(p_tSelf);
+    pthread_mutex_unlock(&tKernelLock);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    HostTask *self = p_tSelf;
+    return (self && (self->coreId != tskNO_AFFINITY)) ? self->coreId : HOST_RTOS_LOOP_CORE_ID;
+}
+
+//------------------------------------------------------------------------------
+// queues
+//------------------------------------------------------------------------------
+
+static HostQueue *p_tHostRtos_newQueue(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, const void *caller)
+{
+    HostQueue *queue = new HostQueue();
+    queue->storage = new uint8_t[uxQueueLength * uxItemSize];
+    queue->stamps = new uint64_t[uxQueueLength];
+    queue->length = uxQueueLength;
+    queue->itemSize = uxItemSize;
+    vHostRtos_register(queue, HOST_OBJ_QUEUE, caller);
+    return queue;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize)
+{
+    return p_tHostRtos_newQueue(uxQueueLength, uxItemSize, __builtin_return_address(0));
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t uxQueueLength, UBaseType_t uxItemSize, uint8_t *pucQueueStorageBuffer,
+                                 StaticQueue_t *pxQueueBuffer)
+{
+    (void)pucQueueStorageBuffer;
+    (void)pxQueueBuffer;
+    return p_tHostRtos_newQueue(uxQueueLength, uxItemSize, __builtin_return_address(0));
+}
+
+void vQueueDelete(QueueHandle_t xQueue)
+{
+    if (xQueue)
+    {
+        vHostRtos_unregister(xQueue);
+        delete[] xQueue->storage;
+        delete[] xQueue->stamps;
+        delete xQueue;
+    }
+}
+
+static void vHostRtos_queuePush(HostQueue *queue, const void *item)
+{
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage + tail * queue->itemSize, item, queue->itemSize);
+    queue->stamps[tail] = ullHostClock_micros();
+    queue->count++;
+    if (queue->count > queue->peak)
+    {
+        queue->peak = queue->count;
+    }
+}
+
+static void vHostRtos_queueCopyHead(HostQueue *queue, void *buffer)
+{
+    memcpy(buffer, queue->storage + queue->head * queue->itemSize, queue->itemSize);
+}
+
+BaseType_t xQueueSend(QueueHandle_t xQueue, const void *pvItemToQueue, TickType_t xTicksToWait)
+{
+    pthread_mutex_lock(&tKernelLock);
+    bool sent = bHostRtos_waitFor(xQueue, xTicksToWait, &xQueue->send, [xQueue]() { return xQueue->count < xQueue->length; });
+    if (sent)
+    {
+        vHostRtos_queuePush(xQueue, pvItemToQueue);
+        vHostRtos_notify(xQueue);
+    }
+    pthread_mutex_unlock(&tKernelLock);
+    return sent ? pdPASS : errQUEUE_FULL;
+}
+
+/******************************************************
+ * @brief only meant for length 1 queues, as in FreeRTOS
+ ******************************************************/
+BaseType_t xQueueOverwrite(QueueHandle_t xQueue, const void *pvItemToQueue)
+{
+    pthread_mutex_lock(&tKernelLock);
+    xQueue->send.calls++;
+    xQueue->dropped += xQueue->count;
+    xQueue->head = 0;
+    xQueue->count = 0;
+    vHostRtos_queuePush(xQueue, pvItemToQueue);
+    vHostRtos_notify(xQueue);
+    pthread_mutex_unlock(&tKernelLock);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    pthread_mutex_lock(&tKernelLock);
+    bool received = bHostRtos_waitFor(xQueue, xTicksToWait, &xQueue->receive, [xQueue]() { return xQueue->count > 0; });
+    if (received)
+    {
+        vHostRtos_queueCopyHead(xQueue, pvBuffer);
+        uint64_t latency = ullHostClock_micros() - xQueue->stamps[xQueue->head];
+        xQueue->latencyUs += latency;
+        if (latency > xQueue->maxLatencyUs)
+        {
+            xQueue->maxLatencyUs = latency;
+        }
+        xQueue->head = (xQueue->head + 1) % xQueue->length;
+        xQueue->count--;
+        vHostRtos_notify(xQueue);
+    }
+    pthread_mutex_unlock(&tKernelLock);
+    return received ? pdPASS : errQUEUE_EMPTY;
+}
+
+BaseType_t xQueuePeek(QueueHandle_t xQueue, void *pvBuffer, TickType_t xTicksToWait)
+{
+    hostWaitStats_t peekStats = {};
+    pthread_mutex_lock(&tKernelLock);
+    bool available = bHostRtos_waitFor(xQueue, xTicksToWait, &peekStats, [xQueue]() { return xQueue->count > 0; });
+    if (available)
+    {
+        vHostRtos_queueCopyHead(xQueue, pvBuffer);
+    }
+    pthread_mutex_unlock(&tKernelLock);
+    return available ? pdPASS : errQUEUE_EMPTY;
+}
+
+BaseType_t xQueueReset(QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&tKernelLock);
+    xQueue->dropped += xQueue->count;
+    xQueue->head = 0;
+    xQueue->count = 0;
+    vHostRtos_notify(xQueue);
+    pthread_mutex_unlock(&tKernelLock);
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&tKernelLock);
+    UBaseType_t count = xQueue->count;
+    pthread_mutex_unlock(&tKernelLock);
+    return count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t xQueue)
+{
+    pthread_mutex_lock(&tKernelLock);
+    UBaseType_t spaces = xQueue->length - xQueue->count;
+    pthread_mutex_unlock(&tKernelLock);
+    return spaces;
+}
+
+//------------------------------------------------------------------------------
+// semaphores
+//------------------------------------------------------------------------------
+
+static HostSemaphore *p_tHostRtos_newSemaphore(bool isMutex, const void *caller)
+{
+    HostSemaphore *sem = new HostSemaphore();
+    sem->isMutex = isMutex;
+    sem->count = isMutex ? 1 : 0;
+    vHostRtos_register(sem, isMutex ? HOST_OBJ_MUTEX : HOST_OBJ_SEMAPHORE, caller);
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return p_tHostRtos_newSemaphore(true, __builtin_return_address(0));
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *pxMutexBuffer)
+{
+    (void)pxMutexBuffer;
+    return p_tHostRtos_newSemaphore(true, __builtin_return_address(0));
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return p_tHostRtos_newSemaphore(false, __builtin_return_address(0));
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore)
+{
+    if (xSemaphore)
+    {
+        vHostRtos_unregister(xSemaphore);
+        delete xSemaphore;
+    }
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait)
+{
+    HostTask *self = p_tSelf;
+    pthread_mutex_lock(&tKernelLock);
+    if (xSemaphore->isMutex && (xSemaphore->count == 0))
+    {
+        if (self && (xSemaphore->holder == self))
+        {
+            // FreeRTOS mutexes are not recursive
+            log_e("mutex %s taken again by its holder %s", xSemaphore->name, self->name);
+        }
+        else if (self && xSemaphore->holder && (xSemaphore->holder->priority < self->priority))
+        {
+            xSemaphore->holder->priority = self->priority; // priority inheritance
+        }
+    }
+    bool taken = bHostRtos_waitFor(xSemaphore, xTicksToWait, &xSemaphore->take, [xSemaphore]() { return xSemaphore->count > 0; });
+    if (taken)
+    {
+        xSemaphore->count--;
+        xSemaphore->holder = self;
+        xSemaphore->takenUs = ullHostClock_micros();
+    }
+    pthread_mutex_unlock(&tKernelLock);
+    return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+    pthread_mutex_lock(&tKernelLock);
+    if (xSemaphore->count > 0)
+    {
+        pthread_mutex_unlock(&tKernelLock);
+        return pdFALSE;
+    }
+    if (xSemaphore->isMutex)
+    {
+        uint64_t held = ullHostClock_micros() - xSemaphore->takenUs;
+        xSemaphore->holdUs += held;
+        if (held > xSemaphore->maxHoldUs)
+        {
+            xSemaphore->maxHoldUs = held;
+        }
+        if (xSemaphore->holder)
+        {
+            xSemaphore->holder->priority = xSemaphore->holder->basePriority;
+        }
+    }
+    xSemaphore->holder = nullptr;
+    xSemaphore->count++;
+    vHostRtos_notify(xSemaphore);
+    pthread_mutex_unlock(&tKernelLock);
+    return pdTRUE;
+}
+
+//------------------------------------------------------------------------------
+// event groups
+//------------------------------------------------------------------------------
+
+static HostEventGroup *p_tHostRtos_newEventGroup(const void *caller)
+{
+    HostEventGroup *group = new HostEventGroup();
+    vHostRtos_register(group, HOST_OBJ_EVENT_GROUP, caller);
+    return group;
+}
+
+EventGroupHandle_t xEventGroupCreate(void)
+{
+    return p_tHostRtos_newEventGroup(__builtin_return_address(0));
+}
+
+EventGroupHandle_t xEventGroupCreateStatic(StaticEventGroup_t *pxEventGroupBuffer)
+{
+    (void)pxEventGroupBuffer;
+    return p_tHostRtos_newEventGroup(__builtin_return_address(0));
+}
+
+void vEventGroupDelete(EventGroupHandle_t xEventGroup)
+{
+    if (xEventGroup)
+    {
+        vHostRtos_unregister(xEventGroup);
+        delete xEventGroup;
+    }
+}
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet)
+{
+    pthread_mutex_lock(&tKernelLock);
+    xEventGroup->bits |= uxBitsToSet;
+    xEventGroup->sets++;
+    xEventGroup->setUs = ullHostClock_micros();
+    EventBits_t bits = xEventGroup->bits;
+    vHostRtos_notify(xEventGroup);
+    pthread_mutex_unlock(&tKernelLock);
+    return bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToClear)
+{
+    pthread_mutex_lock(&tKernelLock);
+    EventBits_t previous = xEventGroup->bits;
+    xEventGroup->bits &= ~uxBitsToClear;
+    pthread_mutex_unlock(&tKernelLock);
+    return previous;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t xEventGroup)
+{
+    pthread_mutex_lock(&tKernelLock);
+    EventBits_t bits = xEventGroup->bits;
+    pthread_mutex_unlock(&tKernelLock);
+    return bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToWaitFor,
+                                const BaseType_t xClearOnExit, const BaseType_t xWaitForAllBits,
+                                TickType_t xTicksToWait)
+{
+    pthread_mutex_lock(&tKernelLock);
+    uint64_t waitsBefore = xEventGroup->wait.waits;
+    auto satisfied = [xEventGroup, uxBitsToWaitFor, xWaitForAllBits]()
+    {
+        EventBits_t current = xEventGroup->bits & uxBitsToWaitFor;
+        return xWaitForAllBits ? (current == uxBitsToWaitFor) : (current != 0);
+    };
+    bool ok = bHostRtos_waitFor(xEventGroup, xTicksToWait, &xEventGroup->wait, satisfied);
+    EventBits_t bits = xEventGroup->bits;
+    if (ok)
+    {
+        if (xEventGroup->wait.waits != waitsBefore)
+        {
+            uint64_t latency = ullHostClock_micros() - xEventGroup->setUs;
+            xEventGroup->wakeups++;
+            xEventGroup->wakeLatencyUs += latency;
+            if (latency > xEventGroup->maxWakeLatencyUs)
+            {
+                xEventGroup->maxWakeLatencyUs = latency;
+            }
+        }
+        if (xClearOnExit)
+        {
+            xEventGroup->bits &= ~uxBitsToWaitFor;
+        }
+    }
+    pthread_mutex_unlock(&tKernelLock);
+    return bits;
+}
+
+//------------------------------------------------------------------------------
+// report
+//------------------------------------------------------------------------------
+
+void vHostRtos_nameObject(const void *handle, const char *name)
+{
+    pthread_mutex_lock(&tKernelLock);
+    for (UBaseType_t i = 0; i < uxObjectCount; i++)
+    {
+        if (p_tObjects[i] == handle)
+        {
+            snprintf(p_tObjects[i]->name, sizeof(p_tObjects[i]->name), "%s", name);
+        }
+    }
+    pthread_mutex_unlock(&tKernelLock);
+}
+
+static double dHostRtos_ms(uint64_t us)
+{
+    return (double)us / 1000.0;
+}
+
+static double dHostRtos_avgMs(uint64_t totalUs, uint64_t count)
+{
+    return count ? (double)totalUs / (double)count / 1000.0 : 0.0;
+}
+
+/******************************************************
+ * @brief print the task and object counters; called at
+ *        the end of the run, with the kernel lock held
+ ******************************************************/
+void vHostRtos_report(void)
+{
+    uint64_t now = ullHostClock_micros();
+
+    printf("\n==== RTOS REPORT (%s) ====\n", bDeterministic ? "deterministic scheduler" : "concurrent threads");
+    if (bDeterministic)
+    {
+        printf("context switches : %llu\n", (unsigned long long)ullSwitches);
+    }
+    printf("%-24s %4s %10s %10s %9s\n", "task", "prio", "switches", "blocks", "blocked");
+    for (UBaseType_t i = 0; i < uxTaskCount; i++)
+    {
+        HostTask *task = p_tTasks[i];
+        uint64_t life = now - task->createdUs;
+        printf("%-24s %4u %10llu %10llu %8.2f%%\n", task->name, task->basePriority, (unsigned long long)task->switchesIn,
+               (unsigned long long)task->blocks, life ? 100.0 * (double)task->blockedUs / (double)life : 0.0);
+    }
+
+    printf("%-24s %5s %5s %8s %6s %7s %11s %11s\n", "queue", "len", "peak", "sent", "full", "dropped", "avg lat ms", "max lat ms");
+    for (UBaseType_t i = 0; i < uxObjectCount; i++)
+    {
+        if (p_tObjects[i]->kind != HOST_OBJ_QUEUE)
+        {
+            continue;
+        }
+        HostQueue *queue = (HostQueue *)p_tObjects[i];
+        uint64_t received = queue->receive.calls - queue->receive.fails;
+        printf("%-24s %5u %5u %8llu %6llu %7llu %11.1f %11.1f\n", queue->name, queue->length, queue->peak,
+               (unsigned long long)(queue->send.calls - queue->send.fails), (unsigned long long)queue->send.fails,
+               (unsigned long long)queue->dropped, dHostRtos_avgMs(queue->latencyUs, received), dHostRtos_ms(queue->maxLatencyUs));
+    }
+
+    printf("%-24s %8s %9s %8s %12s %12s %12s\n", "mutex/semaphore", "takes", "contended", "failed", "avg wait ms", "max wait ms",
+           "max hold ms");
+    for (UBaseType_t i = 0; i < uxObjectCount; i++)
+    {
+        if ((p_tObjects[i]->kind != HOST_OBJ_MUTEX) && (p_tObjects[i]->kind != HOST_OBJ_SEMAPHORE))
+        {
+            continue;
+        }
+        HostSemaphore *sem = (HostSemaphore *)p_tObjects[i];
+        printf("%-24s %8llu %9llu %8llu %12.2f %12.2f %12.2f\n", sem->name, (unsigned long long)sem->take.calls,
+               (unsigned long long)sem->take.waits, (unsigned long long)sem->take.fails,
+               dHostRtos_avgMs(sem->take.waitUs, sem->take.waits), dHostRtos_ms(sem->take.maxWaitUs), dHostRtos_ms(sem->maxHoldUs));
+    }
+
+    printf("%-24s %8s %8s %8s %8s %12s %12s\n", "event group", "sets", "waits", "blocked", "failed", "avg wake ms", "max wake ms");
+    for (UBaseType_t i = 0; i < uxObjectCount; i++)
+    {
+        if (p_tObjects[i]->kind != HOST_OBJ_EVENT_GROUP)
+        {
+            continue;
+        }
+        HostEventGroup *group = (HostEventGroup *)p_tObjects[i];
+        printf("%-24s %8llu %8llu %8llu %8llu %12.2f %12.2f\n", group->name, (unsigned long long)group->sets,
+               (unsigned long long)group->wait.calls, (unsigned long long)group->wait.waits, (unsigned long long)group->wait.fails,
+               dHostRtos_avgMs(group->wakeLatencyUs, group->wakeups), dHostRtos_ms(group->maxWakeLatencyUs));
+    }
+    printf("================================\n");
+}
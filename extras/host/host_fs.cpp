@@ -0,0 +1,355 @@
+/******************************************************************************
+ * @file    host_fs.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host implementation of the Arduino FS/SD API, backed by a directory
+ *          of the host file system that stands for the card root.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <FS.h>
+#include <SD.h>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "host_sim.h"
+
+#define HOST_FS_PATH_LEN 512
+#define HOST_FS_HOST_PATH_LEN (2 * HOST_FS_PATH_LEN) /*!< root + path on the card */
+#define HOST_FS_CARD_SIZE (16ULL * 1024ULL * 1024ULL * 1024ULL)
+
+struct HostFile
+{
+    FILE *fp;
+    DIR *dir;
+    int refs;
+    char path[HOST_FS_PATH_LEN]; /*!< path on the card, starts with '/' */
+    const char *name;            /*!< last component of path */
+};
+
+fs::SDFS SD;
+
+static char cFsRoot[HOST_FS_PATH_LEN] = "sdcard";
+
+void vHostFs_setRoot(const char *root)
+{
+    snprintf(cFsRoot, sizeof(cFsRoot), "%s", root);
+    mkdir(cFsRoot, 0755);
+}
+
+const char *pcHostFs_root(void)
+{
+    return cFsRoot;
+}
+
+static void vHostFs_hostPath(const char *path, char *out, size_t size)
+{
+    snprintf(out, size, "%s%s%s", cFsRoot, (path[0] == '/') ? "" : "/", path);
+}
+
+static bool bHostFs_mounted(void)
+{
+    return g_tHostSim_config.sdPresent;
+}
+
+//------------------------------------------------------------------------------
+// File
+//------------------------------------------------------------------------------
+
+namespace fs
+{
+
+File::File(const File &other) : _impl(other._impl)
+{
+    if (_impl)
+    {
+        _impl->refs++;
+    }
+}
+
+File &File::operator=(const File &other)
+{
+    if (this != &other)
+    {
+        close();
+        _impl = other._impl;
+        if (_impl)
+        {
+            _impl->refs++;
+        }
+    }
+    return *this;
+}
+
+File::~File()
+{
+    close();
+}
+
+size_t File::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t *buf, size_t size)
+{
+    return (_impl && _impl->fp) ? fwrite(buf, 1, size, _impl->fp) : 0;
+}
+
+int File::available()
+{
+    if (!_impl || !_impl->fp)
+    {
+        return 0;
+    }
+    long pos = ftell(_impl->fp);
+    return (int)(size() - (size_t)pos);
+}
+
+int File::read()
+{
+    return (_impl && _impl->fp) ? fgetc(_impl->fp) : -1;
+}
+
+int File::peek()
+{
+    if (!_impl || !_impl->fp)
+    {
+        return -1;
+    }
+    int c = fgetc(_impl->fp);
+    if (c != EOF)
+    {
+        ungetc(c, _impl->fp);
+    }
+    return c;
+}
+
+size_t File::read(uint8_t *buf, size_t size)
+{
+    return (_impl && _impl->fp) ? fread(buf, 1, size, _impl->fp) : 0;
+}
+
+void File::flush()
+{
+    if (_impl && _impl->fp)
+    {
+        fflush(_impl->fp);
+    }
+}
+
+bool File::seek(uint32_t pos)
+{
+    return _impl && _impl->fp && (fseek(_impl->fp, (long)pos, SEEK_SET) == 0);
+}
+
+size_t File::position() const
+{
+    return (_impl && _impl->fp) ? (size_t)ftell(_impl->fp) : 0;
+}
+
+size_t File::size() const
+{
+    if (!_impl || !_impl->fp)
+    {
+        return 0;
+    }
+    fflush(_impl->fp);
+    struct stat st;
+    return (fstat(fileno(_impl->fp), &st) == 0) ? (size_t)st.st_size : 0;
+}
+
+void File::close()
+{
+    if (!_impl)
+    {
+        return;
+    }
+    if (--_impl->refs == 0)
+    {
+        if (_impl->fp)
+        {
+            fclose(_impl->fp);
+        }
+        if (_impl->dir)
+        {
+            closedir(_impl->dir);
+        }
+        delete _impl;
+    }
+    _impl = nullptr;
+}
+
+const char *File::name() const
+{
+    return _impl ? _impl->name : nullptr;
+}
+
+const char *File::path() const
+{
+    return _impl ? _impl->path : nullptr;
+}
+
+bool File::isDirectory(void) const
+{
+    return _impl && _impl->dir;
+}
+
+File File::openNextFile(const char *mode)
+{
+    if (!_impl || !_impl->dir)
+    {
+        return File();
+    }
+    for (struct dirent *entry = readdir(_impl->dir); entry; entry = readdir(_impl->dir))
+    {
+        if ((strcmp(entry->d_name, ".") == 0) || (strcmp(entry->d_name, "..") == 0))
+        {
+            continue;
+        }
+        char child[HOST_FS_HOST_PATH_LEN];
+        snprintf(child, sizeof(child), "%s/%s", (strcmp(_impl->path, "/") == 0) ? "" : _impl->path, entry->d_name);
+        return SD.open(child, mode);
+    }
+    return File();
+}
+
+void File::rewindDirectory(void)
+{
+    if (_impl && _impl->dir)
+    {
+        rewinddir(_impl->dir);
+    }
+}
+
+//------------------------------------------------------------------------------
+// FS
+//------------------------------------------------------------------------------
+
+File FS::open(const char *path, const char *mode, const bool create)
+{
+    (void)create;
+    if (!bHostFs_mounted() || !path)
+    {
+        return File();
+    }
+    char hostPath[HOST_FS_HOST_PATH_LEN];
+    vHostFs_hostPath(path, hostPath, sizeof(hostPath));
+
+    HostFile *impl = new HostFile();
+    impl->fp = nullptr;
+    impl->dir = nullptr;
+    impl->refs = 1;
+    snprintf(impl->path, sizeof(impl->path), "%s", path);
+    const char *slash = strrchr(impl->path, '/');
+    impl->name = slash ? slash + 1 : impl->path;
+
+    struct stat st;
+    if ((strcmp(mode, FILE_READ) == 0) && (stat(hostPath, &st) == 0) && S_ISDIR(st.st_mode))
+    {
+        impl->dir = opendir(hostPath);
+    }
+    else
+    {
+        impl->fp = fopen(hostPath, (strcmp(mode, FILE_READ) == 0) ? "rb" : ((strcmp(mode, FILE_APPEND) == 0) ? "ab" : "wb"));
+    }
+    if (!impl->fp && !impl->dir)
+    {
+        delete impl;
+        return File();
+    }
+    return File(impl);
+}
+
+bool FS::exists(const char *path)
+{
+    if (!bHostFs_mounted())
+    {
+        return false;
+    }
+    char hostPath[HOST_FS_HOST_PATH_LEN];
+    vHostFs_hostPath(path, hostPath, sizeof(hostPath));
+    return access(hostPath, F_OK) == 0;
+}
+
+bool FS::remove(const char *path)
+{
+    char hostPath[HOST_FS_HOST_PATH_LEN];
+    vHostFs_hostPath(path, hostPath, sizeof(hostPath));
+    return bHostFs_mounted() && (unlink(hostPath) == 0);
+}
+
+bool FS::rename(const char *pathFrom, const char *pathTo)
+{
+    char hostFrom[HOST_FS_HOST_PATH_LEN];
+    char hostTo[HOST_FS_HOST_PATH_LEN];
+    vHostFs_hostPath(pathFrom, hostFrom, sizeof(hostFrom));
+    vHostFs_hostPath(pathTo, hostTo, sizeof(hostTo));
+    return bHostFs_mounted() && (::rename(hostFrom, hostTo) == 0);
+}
+
+bool FS::mkdir(const char *path)
+{
+    char hostPath[HOST_FS_HOST_PATH_LEN];
+    vHostFs_hostPath(path, hostPath, sizeof(hostPath));
+    return bHostFs_mounted() && ((::mkdir(hostPath, 0755) == 0) || (errno == EEXIST));
+}
+
+bool FS::rmdir(const char *path)
+{
+    char hostPath[HOST_FS_HOST_PATH_LEN];
+    vHostFs_hostPath(path, hostPath, sizeof(hostPath));
+    return bHostFs_mounted() && (::rmdir(hostPath) == 0);
+}
+
+//------------------------------------------------------------------------------
+// SDFS
+//------------------------------------------------------------------------------
+
+bool SDFS::begin(uint8_t ssPin, SPIClass *spi, uint32_t frequency, const char *mountpoint, uint8_t max_files, bool format_if_empty)
+{
+    (void)ssPin;
+    (void)spi;
+    (void)frequency;
+    (void)mountpoint;
+    (void)max_files;
+    (void)format_if_empty;
+    _mounted = bHostFs_mounted();
+    if (_mounted)
+    {
+        ::mkdir(cFsRoot, 0755);
+    }
+    return _mounted;
+}
+
+void SDFS::end()
+{
+    _mounted = false;
+}
+
+sdcard_type_t SDFS::cardType()
+{
+    return bHostFs_mounted() ? CARD_SDHC : CARD_NONE;
+}
+
+uint64_t SDFS::cardSize()
+{
+    return bHostFs_mounted() ? HOST_FS_CARD_SIZE : 0;
+}
+
+uint64_t SDFS::totalBytes()
+{
+    return cardSize();
+}
+
+uint64_t SDFS::usedBytes()
+{
+    return 0;
+}
+
+} // namespace fs
@@ -0,0 +1,431 @@
+/******************************************************************************
+ * @file    host_net.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Simulated network for the real network task: a WiFi access point
+ *          named HOST_SIM_WIFI_SSID, DNS, and an upload server that accepts
+ *          the records POSTed by sendDataToServer() and reports them to the
+ *          run report. With rawDumpHours set, it asks for a raw history dump
+ *          in one response and checks the chunks it gets.
+ *
+ *          Association and NTP take networkLatencyMs, every HTTPS exchange
+ *          serverResponseMs; connections to the server fail with
+ *          probability netFailRate.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <string>
+#include <WiFi.h>
+#include <HTTPClient.h>
+#include "host_sim.h"
+
+#define HOST_NET_SCAN_MS 2000
+#define HOST_NET_DNS_MS 20
+#define HOST_NET_RSSI (-60)
+#define HOST_NET_RECORDED_AT "recordedAt="
+#define HOST_NET_RAW_PATH "POST /api/v1/raw "
+#define HOST_NET_RAW_SAMPLES "samples="
+#define HOST_NET_ROLLUP_PATH "POST /api/v1/rollups "
+#define HOST_NET_ROLLUP_START "&start="
+#define HOST_NET_ROLLUP_SECONDS "&seconds="
+#define HOST_NET_RESPONSE "HTTP/1.1 201 Created\r\nContent-Type: application/json\r\nContent-Length: 15\r\nConnection: close\r\n\r\n{\"status\":\"ok\"}"
+#define HOST_NET_RESPONSE_HEADER "HTTP/1.1 201 Created\r\nContent-Type: application/json\r\nContent-Length: "
+
+WiFiClass WiFi;
+
+static const uint8_t ucMacAddress[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+
+/******************************************************
+ * @brief one TCP connection to the upload server
+ ******************************************************/
+struct HostSocket
+{
+    std::string request;
+    std::string response;
+    size_t readPos;
+    uint64_t responseAtUs; /*!< virtual time the response reaches the client */
+};
+
+static uint64_t ullHostNet_serverDelayUs(void)
+{
+    return (uint64_t)g_tHostSim_config.serverResponseMs * 1000ULL;
+}
+
+//------------------------------------------------------------------------------
+// upload server
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief the samples of a raw history chunk, one per
+ *        row: epoch, then the channels, empty when not
+ *        read
+ ******************************************************/
+static void vHostNet_readRawChunk(const std::string &body)
+{
+    size_t at = body.find(HOST_NET_RAW_SAMPLES);
+    if (at == std::string::npos)
+    {
+        return;
+    }
+    at += strlen(HOST_NET_RAW_SAMPLES);
+    size_t end = body.find('&', at);
+    std::string samples = body.substr(at, (end == std::string::npos) ? std::string::npos : end - at);
+
+    size_t rowStart = 0;
+    while (rowStart < samples.size())
+    {
+        size_t rowEnd = samples.find(';', rowStart);
+        if (rowEnd == std::string::npos)
+        {
+            rowEnd = samples.size();
+        }
+        std::string row = samples.substr(rowStart, rowEnd - rowStart);
+        const char *p_cField = row.c_str();
+        uint32_t epoch = (uint32_t)strtoul(p_cField, nullptr, 10);
+        uint16_t valid = 0;
+        float value[STATS_CH_MAX] = {};
+        for (int ch = 0; ch < STATS_CH_MAX; ch++)
+        {
+            p_cField = strchr(p_cField, ',');
+            if (p_cField == nullptr)
+            {
+                break;
+            }
+            p_cField++;
+            if ((*p_cField != ',') && (*p_cField != '\0'))
+            {
+                value[ch] = strtof(p_cField, nullptr);
+                valid |= (uint16_t)(1U << ch);
+            }
+        }
+        vHostSim_recordRawSample(epoch, valid, value);
+        rowStart = rowEnd + 1;
+    }
+    vHostSim_recordRawChunk();
+}
+
+/******************************************************
+ * @brief answer the request once headers and body
+ *        (Content-Length) have arrived
+ ******************************************************/
+static void vHostNet_serve(HostSocket *socket)
+{
+    if (!socket->response.empty())
+    {
+        return;
+    }
+    size_t headerEnd = socket->request.find("\r\n\r\n");
+    if (headerEnd == std::string::npos)
+    {
+        return;
+    }
+    size_t bodyLength = 0;
+    size_t lengthField = socket->request.find("Content-Length: ");
+    if ((lengthField != std::string::npos) && (lengthField < headerEnd))
+    {
+        bodyLength = (size_t)strtoul(socket->request.c_str() + lengthField + strlen("Content-Length: "), nullptr, 10);
+    }
+    if (socket->request.size() < headerEnd + 4 + bodyLength)
+    {
+        return;
+    }
+
+    socket->response = HOST_NET_RESPONSE;
+    if (socket->request.compare(0, strlen(HOST_NET_RAW_PATH), HOST_NET_RAW_PATH) == 0)
+    {
+        vHostNet_readRawChunk(socket->request.substr(headerEnd + 4));
+    }
+    else if (socket->request.compare(0, strlen(HOST_NET_ROLLUP_PATH), HOST_NET_ROLLUP_PATH) == 0)
+    {
+        size_t start = socket->request.find(HOST_NET_ROLLUP_START, headerEnd);
+        size_t seconds = socket->request.find(HOST_NET_ROLLUP_SECONDS, headerEnd);
+        if ((start != std::string::npos) && (seconds != std::string::npos))
+        {
+            vHostSim_recordRollupUpload((uint32_t)strtoul(socket->request.c_str() + seconds + strlen(HOST_NET_ROLLUP_SECONDS), nullptr, 10),
+                                        (uint32_t)strtoul(socket->request.c_str() + start + strlen(HOST_NET_ROLLUP_START), nullptr, 10));
+        }
+    }
+    else
+    {
+        size_t recordedAt = socket->request.find(HOST_NET_RECORDED_AT, headerEnd);
+        if (recordedAt != std::string::npos)
+        {
+            vHostSim_recordUpload((time_t)strtoll(socket->request.c_str() + recordedAt + strlen(HOST_NET_RECORDED_AT), nullptr, 10));
+        }
+        uint32_t from = 0;
+        uint32_t to = 0;
+        if (bHostSim_rawDumpRequest(&from, &to))
+        {
+            char body[96];
+            snprintf(body, sizeof(body), "{\"status\":\"ok\",\"raw_dump_from\":%u,\"raw_dump_to\":%u}", from, to);
+            socket->response = std::string(HOST_NET_RESPONSE_HEADER) + std::to_string(strlen(body)) +
+                               "\r\nConnection: close\r\n\r\n" + body;
+        }
+    }
+    socket->readPos = 0;
+    socket->responseAtUs = ullHostClock_micros() + ullHostNet_serverDelayUs();
+}
+
+//------------------------------------------------------------------------------
+// WiFi station
+//------------------------------------------------------------------------------
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase)
+{
+    (void)passphrase;
+    _ssid = ssid;
+    if (_ssid != HOST_SIM_WIFI_SSID)
+    {
+        _status = WL_NO_SSID_AVAIL;
+        return _status;
+    }
+    _status = WL_DISCONNECTED;
+    _connectAtMs = millis() + g_tHostSim_config.networkLatencyMs;
+    return _status;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap)
+{
+    (void)eraseap;
+    _status = WL_DISCONNECTED;
+    _connectAtMs = 0;
+    if (wifioff)
+    {
+        _mode = WIFI_OFF;
+    }
+    return true;
+}
+
+bool WiFiClass::mode(wifi_mode_t mode)
+{
+    _mode = mode;
+    return true;
+}
+
+bool WiFiClass::setTxPower(wifi_power_t power)
+{
+    (void)power;
+    return true;
+}
+
+wl_status_t WiFiClass::status()
+{
+    if ((_status == WL_DISCONNECTED) && _connectAtMs && (millis() >= _connectAtMs))
+    {
+        _status = WL_CONNECTED;
+    }
+    return _status;
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool show_hidden)
+{
+    (void)async;
+    (void)show_hidden;
+    delay(HOST_NET_SCAN_MS);
+    return 1;
+}
+
+String WiFiClass::SSID(uint8_t networkItem) const
+{
+    (void)networkItem;
+    return String(HOST_SIM_WIFI_SSID);
+}
+
+String WiFiClass::SSID() const
+{
+    return _ssid;
+}
+
+int32_t WiFiClass::RSSI(uint8_t networkItem) const
+{
+    (void)networkItem;
+    return HOST_NET_RSSI;
+}
+
+int8_t WiFiClass::RSSI() const
+{
+    return HOST_NET_RSSI;
+}
+
+IPAddress WiFiClass::localIP() const
+{
+    return IPAddress(192, 168, 4, 2);
+}
+
+IPAddress WiFiClass::gatewayIP() const
+{
+    return IPAddress(192, 168, 4, 1);
+}
+
+IPAddress WiFiClass::dnsIP(uint8_t dns_no) const
+{
+    (void)dns_no;
+    return IPAddress(192, 168, 4, 1);
+}
+
+int WiFiClass::hostByName(const char *aHostname, IPAddress &aResult)
+{
+    (void)aHostname;
+    if (status() != WL_CONNECTED)
+    {
+        return 0;
+    }
+    delay(HOST_NET_DNS_MS);
+    aResult = IPAddress(93, 184, 216, 34);
+    return 1;
+}
+
+String WiFiClass::macAddress() const
+{
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X", ucMacAddress[0], ucMacAddress[1], ucMacAddress[2],
+             ucMacAddress[3], ucMacAddress[4], ucMacAddress[5]);
+    return String(text);
+}
+
+esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type)
+{
+    (void)type;
+    memcpy(mac, ucMacAddress, sizeof(ucMacAddress));
+    return ESP_OK;
+}
+
+//------------------------------------------------------------------------------
+// TCP client
+//------------------------------------------------------------------------------
+
+WiFiClient::WiFiClient() : _socket(nullptr)
+{
+}
+
+WiFiClient::~WiFiClient()
+{
+    stop();
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+    return connect(ip.toString().c_str(), port);
+}
+
+/******************************************************
+ * @brief TCP and TLS handshake with the upload server
+ ******************************************************/
+int WiFiClient::connect(const char *host, uint16_t port)
+{
+    (void)host;
+    (void)port;
+    stop();
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        return 0;
+    }
+    delay(g_tHostSim_config.serverResponseMs);
+    if (bHostSim_fault(g_tHostSim_config.netFailRate))
+    {
+        return 0;
+    }
+    _socket = new HostSocket();
+    _socket->readPos = 0;
+    _socket->responseAtUs = 0;
+    return 1;
+}
+
+size_t WiFiClient::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+    if (!_socket)
+    {
+        return 0;
+    }
+    _socket->request.append((const char *)buf, size);
+    vHostNet_serve(_socket);
+    return size;
+}
+
+int WiFiClient::available()
+{
+    if (!_socket || (ullHostClock_micros() < _socket->responseAtUs))
+    {
+        return 0;
+    }
+    return (int)(_socket->response.size() - _socket->readPos);
+}
+
+int WiFiClient::read()
+{
+    if (available() <= 0)
+    {
+        return -1;
+    }
+    return (uint8_t)_socket->response[_socket->readPos++];
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+    size_t count = 0;
+    while ((count < size) && (available() > 0))
+    {
+        buf[count++] = (uint8_t)read();
+    }
+    return (int)count;
+}
+
+int WiFiClient::peek()
+{
+    if (available() <= 0)
+    {
+        return -1;
+    }
+    return (uint8_t)_socket->response[_socket->readPos];
+}
+
+void WiFiClient::stop()
+{
+    delete _socket;
+    _socket = nullptr;
+}
+
+uint8_t WiFiClient::connected()
+{
+    return (_socket && (_socket->response.empty() || (_socket->readPos < _socket->response.size()))) ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+// HTTP client
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief the server answers every request with 200,
+ *        ping and HEAD included
+ ******************************************************/
+int HTTPClient::sendRequest(const char *type, const String &payload)
+{
+    (void)type;
+    (void)payload;
+    _payload = "";
+    if (WiFi.status() != WL_CONNECTED)
+    {
+        return HTTPC_ERROR_NOT_CONNECTED;
+    }
+    if (_client && !_client->connect(_url.c_str(), 443))
+    {
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    delay(g_tHostSim_config.serverResponseMs);
+    if (_client)
+    {
+        _client->stop();
+    }
+    _payload = "{}";
+    return HTTP_CODE_OK;
+}
@@ -0,0 +1,850 @@
+/******************************************************************************
+ * @file    host_replay.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Replay engine: reads the SD card logs of a station and drives
+ *          them through the firmware aggregation code, to re-derive the
+ *          data after a calibration or algorithm change and to benchmark
+ *          the aggregation hot path on real data.
+ *
+ *          Raw samples (HOST_CSV_RAW_HEADER), one per sampling period, are
+ *          grouped into measurement cycles as SYS_STATE_READ_SENSORS and
+ *          EVAL_SENSOR_STATUS do, then averaged by
+ *          vHalSensor_performAverages() (MICS4514 gas calculation included),
+ *          aggregated as --aggregation sets by vHalSensor_applyAggregation()
+ *          and rated by sHalSensor_evaluateMSPIndex() on the rolling windows
+ *          of aqIndex.cpp, fed with the same samples.
+ *          Averaged records (CSV_HEADER or the legacy layout) only get the
+ *          MSP# index evaluated again. Records re-derived from samples are
+ *          compared with the logged ones of the same time.
+ *
+ *          Usage: host-replay [--interval MIN] [--sampling-period S]
+ *                             [--gas mics6814|mics4514]
+ *                             [--r0-red N] [--r0-ox N] [--comp-h F]
+ *                             [--comp-t F] [--comp-p F] [--out DIR]
+ *                             [--repeat N] [--log-level 0..5]
+ *                             [--aggregation CHANNEL=METHOD] PATH...
+ *          PATH is a log file or a directory searched for *.csv files.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include "sensors.h"
+#include "channelStats.h"
+#include "aqIndex.h"
+#include "sdcard.h"
+#include "host_sim.h"
+
+#define HOST_REPLAY_DEFAULT_INTERVAL 5
+#define HOST_REPLAY_DEFAULT_PERIOD SEC_IN_MIN
+#define HOST_REPLAY_MAX_DIFFS 10 /*!< differences printed in full */
+#define HOST_REPLAY_PATH_LEN 512
+
+// the replay drives no simulated peripheral, the stubs only need the symbol
+hostSimConfig_t g_tHostSim_config = {};
+
+typedef struct
+{
+    int32_t interval;      /*!< average_measurements of the station */
+    int32_t period;        /*!< sampling_period of the station, seconds */
+    int32_t intervalSlots; /*!< sampling periods in an interval */
+    int32_t hourSlots;     /*!< sampling periods in an hour */
+    uint8_t gasSensorType; /*!< for records, which carry no ADC counts */
+    sensorData_t defaults; /*!< calibration, as vMspInit_sensorStatusAndData() and the config file */
+    uint32_t repeat;
+    const char *outDir;
+    uint8_t aggregation[STATS_CH_MAX]; /*!< sysStat.aggregation */
+} hostReplayConfig_t;
+
+// a measurement cycle being replayed, the firmware globals it stands for
+typedef struct
+{
+    sensorData_t data;      /*!< sensorData_accumulate */
+    errorVars_t err;        /*!< err */
+    channelStats_t stats[STATS_CH_MAX]; /*!< channelStats */
+    deviceMeasurement_t meas; /*!< measStat */
+    uint8_t gasSensorType;  /*!< sysStat.gasSensorType */
+    int64_t lastSlot;       /*!< sampling period of the last sample */
+    int64_t lastTxSlot;     /*!< sampling period of the last record, 0 after a boot */
+} hostReplayCycle_t;
+
+typedef struct
+{
+    uint32_t files;
+    uint64_t bytes;
+    uint32_t badLines;
+    uint32_t skippedFiles;
+    double parseSec;
+    double sampleSec;
+    double recordSec;
+    uint32_t incomplete; /*!< cycles cut by a gap in the samples */
+    uint32_t mspChanged; /*!< records whose MSP# index differs from the logged one */
+    uint32_t identical;
+    uint32_t different;
+    uint32_t notLogged;
+    uint32_t notReplayed;
+} hostReplayReport_t;
+
+static hostReplayConfig_t tConfig;
+static hostReplayReport_t tReport;
+
+static double dHostReplay_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+//------------------------------------------------------------------------------
+// input
+//------------------------------------------------------------------------------
+
+static bool bHostReplay_isCsv(const char *name)
+{
+    size_t len = strlen(name);
+    return (len > 4) && (strcmp(name + len - 4, ".csv") == 0);
+}
+
+/******************************************************
+ * @brief the log files under a path, in name order,
+ *        which for /YYYY/MM/DD.csv is time order
+ ******************************************************/
+static void vHostReplay_collect(const std::string &path, std::vector<std::string> *p_tFiles)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        log_e("cannot open %s: %s", path.c_str(), strerror(errno));
+        return;
+    }
+    if (!S_ISDIR(st.st_mode))
+    {
+        p_tFiles->push_back(path);
+        return;
+    }
+    DIR *dir = opendir(path.c_str());
+    if (!dir)
+    {
+        return;
+    }
+    std::vector<std::string> entries;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (entry->d_name[0] != '.')
+        {
+            entries.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        std::string child = path + "/" + entries[i];
+        if ((stat(child.c_str(), &st) == 0) && (S_ISDIR(st.st_mode) || bHostReplay_isCsv(entries[i].c_str())))
+        {
+            vHostReplay_collect(child, p_tFiles);
+        }
+    }
+}
+
+/******************************************************
+ * @brief parse one log into records or samples, the
+ *        header tells which
+ ******************************************************/
+static void vHostReplay_load(const std::string &path, std::vector<hostCsvRow_t> *p_tRecords, std::vector<hostCsvRow_t> *p_tSamples)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp)
+    {
+        log_e("cannot open %s: %s", path.c_str(), strerror(errno));
+        return;
+    }
+    std::string text;
+    char chunk[1 << 16];
+    size_t got;
+    while ((got = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+    {
+        text.append(chunk, got);
+    }
+    fclose(fp);
+    tReport.files++;
+    tReport.bytes += text.size();
+
+    hostCsvLayout_t layout;
+    size_t pos = 0;
+    size_t end = text.find('\n');
+    if ((end == std::string::npos) || !bHostCsv_parseHeader(text.data(), end, &layout))
+    {
+        log_w("%s: not a log file, skipped", path.c_str());
+        tReport.skippedFiles++;
+        return;
+    }
+    std::vector<hostCsvRow_t> *p_tOut = layout.raw ? p_tSamples : p_tRecords;
+    hostCsvRow_t row;
+    for (pos = end + 1; pos < text.size(); pos = end + 1)
+    {
+        end = text.find('\n', pos);
+        if (end == std::string::npos)
+        {
+            end = text.size();
+        }
+        if (end == pos)
+        {
+            continue;
+        }
+        if (bHostCsv_parseRow(&layout, text.data() + pos, end - pos, &row))
+        {
+            p_tOut->push_back(row);
+        }
+        else
+        {
+            tReport.badLines++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// aggregation
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief the record the firmware builds from the
+ *        averaged data in SYS_STATE_SEND_DATA
+ ******************************************************/
+static void vHostReplay_toRow(const sensorData_t *p_tData, int64_t slot, hostCsvRow_t *p_tRow)
+{
+    memset(p_tRow, 0, sizeof(*p_tRow));
+    p_tRow->recordedAt = (time_t)(slot * tConfig.period);
+    p_tRow->present |= p_tData->status.BME680Sensor ? HOST_CSV_HAS_BME : 0;
+    p_tRow->present |= p_tData->status.PMS5003Sensor ? HOST_CSV_HAS_PMS : 0;
+    p_tRow->present |= (p_tData->status.MICS6814Sensor || p_tData->status.MICS4514Sensor) ? HOST_CSV_HAS_MICS : 0;
+    p_tRow->present |= p_tData->status.O3Sensor ? HOST_CSV_HAS_O3 : 0;
+    p_tRow->present |= HOST_CSV_HAS_MSP;
+    p_tRow->temp = p_tData->gasData.temperature;
+    p_tRow->hum = p_tData->gasData.humidity;
+    p_tRow->pres = p_tData->gasData.pressure;
+    p_tRow->voc = p_tData->gasData.volatileOrganicCompounds;
+    p_tRow->pm1 = p_tData->airQualityData.particleMicron1;
+    p_tRow->pm25 = p_tData->airQualityData.particleMicron25;
+    p_tRow->pm10 = p_tData->airQualityData.particleMicron10;
+    p_tRow->no2 = p_tData->pollutionData.nitrogenDioxide;
+    p_tRow->co = p_tData->pollutionData.carbonMonoxide;
+    p_tRow->nh3 = p_tData->pollutionData.ammonia;
+    p_tRow->o3 = p_tData->ozoneData.ozone;
+    p_tRow->msp = p_tData->MSP;
+}
+
+/******************************************************
+ * @brief start of a cycle: clear the accumulators and
+ *        size it up to the next boundary, as
+ *        SYS_STATE_READ_SENSORS does
+ ******************************************************/
+static void vHostReplay_startCycle(hostReplayCycle_t *p_tCycle, int64_t slot)
+{
+    int32_t interval = tConfig.intervalSlots;
+    int32_t curr = (int32_t)(slot % tConfig.hourSlots);
+    int32_t next = ((curr % interval) == 0) ? (curr + interval) : (((curr / interval) + 1) * interval);
+    int32_t needed = (next > curr) ? ((next - curr) + 1) : interval;
+
+    peripheralStatus_t status = p_tCycle->data.status;
+    memcpy(&p_tCycle->data, &tConfig.defaults, sizeof(p_tCycle->data));
+    p_tCycle->data.status = status;
+    p_tCycle->err.BMEfails = 0;
+    p_tCycle->err.PMSfails = 0;
+    p_tCycle->err.MICSfails = 0;
+    p_tCycle->err.O3fails = 0;
+    p_tCycle->meas.max_measurements = tConfig.interval;
+    p_tCycle->meas.delay_between_measurements = tConfig.period;
+    p_tCycle->meas.avg_measurements = (needed > interval) ? interval : ((needed == 0) ? 1 : needed);
+    p_tCycle->meas.measurement_count = 0;
+    vMspStats_resetAll(p_tCycle->stats);
+}
+
+/******************************************************
+ * @brief SYS_STATE_READ_SENSORS on one sample: a sensor
+ *        switched off is not read, a missing value of
+ *        one switched on is a failed read
+ ******************************************************/
+static void vHostReplay_accumulate(hostReplayCycle_t *p_tCycle, const hostCsvRow_t *p_tSample)
+{
+    sensorData_t *p_tData = &p_tCycle->data;
+    sensorSample_t sample; // what the firmware hands the loop task, for the index windows
+    memset(&sample, 0, sizeof(sample));
+    sample.epoch = (uint32_t)p_tSample->recordedAt;
+    if (p_tData->status.BME680Sensor)
+    {
+        if (p_tSample->present & HOST_CSV_HAS_BME)
+        {
+            p_tData->gasData.temperature += p_tSample->temp;
+            p_tData->gasData.pressure += p_tSample->pres;
+            p_tData->gasData.humidity += p_tSample->hum;
+            p_tData->gasData.volatileOrganicCompounds += p_tSample->voc;
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_TEMP], p_tSample->temp, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_PRE], p_tSample->pres, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_HUM], p_tSample->hum, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_VOC], p_tSample->voc, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+        }
+        else
+        {
+            p_tCycle->err.BMEfails++;
+        }
+    }
+    if (p_tCycle->gasSensorType == GAS_SENSOR_MICS4514)
+    {
+        if (p_tData->status.MICS4514Sensor)
+        {
+            if (p_tSample->present & HOST_CSV_HAS_MICS_ADC)
+            {
+                p_tData->mics4514AdcAccumulator.oxVoltageSum += p_tSample->micsOx;
+                p_tData->mics4514AdcAccumulator.redVoltageSum += p_tSample->micsRed;
+            }
+            else
+            {
+                p_tCycle->err.MICSfails++;
+            }
+        }
+    }
+    else if (p_tData->status.MICS6814Sensor)
+    {
+        if (p_tSample->present & HOST_CSV_HAS_MICS)
+        {
+            p_tData->pollutionData.carbonMonoxide += p_tSample->co;
+            p_tData->pollutionData.nitrogenDioxide += p_tSample->no2;
+            p_tData->pollutionData.ammonia += p_tSample->nh3;
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_CO], p_tSample->co, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_NO2], p_tSample->no2, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_NH3], p_tSample->nh3, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspRing_setChannel(&sample, STATS_CH_NO2, p_tSample->no2);
+        }
+        else
+        {
+            p_tCycle->err.MICSfails++;
+        }
+    }
+    if (p_tData->status.O3Sensor)
+    {
+        if (p_tSample->present & HOST_CSV_HAS_O3)
+        {
+            p_tData->ozoneData.ozone += p_tSample->o3;
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_O3], p_tSample->o3, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspRing_setChannel(&sample, STATS_CH_O3, p_tSample->o3);
+        }
+        else
+        {
+            p_tCycle->err.O3fails++;
+        }
+    }
+    if (p_tData->status.PMS5003Sensor)
+    {
+        if (p_tSample->present & HOST_CSV_HAS_PMS)
+        {
+            p_tData->airQualityData.particleMicron1 += p_tSample->pm1;
+            p_tData->airQualityData.particleMicron25 += p_tSample->pm25;
+            p_tData->airQualityData.particleMicron10 += p_tSample->pm10;
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_PM1], (float)p_tSample->pm1, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_PM25], (float)p_tSample->pm25, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspStats_addTimed(&p_tCycle->stats[STATS_CH_PM10], (float)p_tSample->pm10, (uint32_t)p_tSample->recordedAt, (uint32_t)tConfig.period);
+            vMspRing_setChannel(&sample, STATS_CH_PM25, (float)p_tSample->pm25);
+            vMspRing_setChannel(&sample, STATS_CH_PM10, (float)p_tSample->pm10);
+        }
+        else
+        {
+            p_tCycle->err.PMSfails++;
+        }
+    }
+    vMspAq_add(&sample);
+    p_tCycle->meas.measurement_count++;
+}
+
+/******************************************************
+ * @brief SYS_STATE_EVAL_SENSOR_STATUS: switch back on
+ *        the sensors an average has switched off
+ ******************************************************/
+static void vHostReplay_evalStatus(hostReplayCycle_t *p_tCycle)
+{
+    peripheralStatus_t *p_tStatus = &p_tCycle->data.status;
+    p_tStatus->BME680Sensor |= p_tCycle->err.senserrs[SENS_STAT_BME680] ? 1 : 0;
+    p_tStatus->PMS5003Sensor |= p_tCycle->err.senserrs[SENS_STAT_PMS5003] ? 1 : 0;
+    if (p_tCycle->gasSensorType == GAS_SENSOR_MICS4514)
+    {
+        p_tStatus->MICS4514Sensor |= p_tCycle->err.senserrs[SENS_STAT_MICSxxxx] ? 1 : 0;
+    }
+    else
+    {
+        p_tStatus->MICS6814Sensor |= p_tCycle->err.senserrs[SENS_STAT_MICSxxxx] ? 1 : 0;
+    }
+    p_tStatus->O3Sensor |= p_tCycle->err.senserrs[SENS_STAT_O3] ? 1 : 0;
+}
+
+/******************************************************
+ * @brief SYS_STATE_EVAL_SENSOR_STATUS: may a record
+ *        go out in this sampling period
+ ******************************************************/
+static bool bHostReplay_canSend(const hostReplayCycle_t *p_tCycle, int64_t slot)
+{
+    if (p_tCycle->meas.measurement_count < p_tCycle->meas.avg_measurements)
+    {
+        return false;
+    }
+    if (p_tCycle->lastTxSlot == 0)
+    {
+        return ((slot % tConfig.hourSlots) % tConfig.intervalSlots) == 0;
+    }
+    return (slot - p_tCycle->lastTxSlot) >= tConfig.intervalSlots;
+}
+
+/******************************************************
+ * @brief first sampling period after the last sample at which
+ *        the full cycle goes out
+ ******************************************************/
+static int64_t llHostReplay_sendSlot(const hostReplayCycle_t *p_tCycle)
+{
+    int64_t slot = p_tCycle->lastSlot + 1;
+    if (p_tCycle->lastTxSlot != 0)
+    {
+        return std::max(slot, p_tCycle->lastTxSlot + tConfig.intervalSlots);
+    }
+    while (((slot % tConfig.hourSlots) % tConfig.intervalSlots) != 0)
+    {
+        slot++;
+    }
+    return slot;
+}
+
+/******************************************************
+ * @brief SYS_STATE_SEND_DATA: average, rate, record
+ ******************************************************/
+static void vHostReplay_send(hostReplayCycle_t *p_tCycle, int64_t slot, std::vector<hostCsvRow_t> *p_tOut)
+{
+    sensorData_t *p_tData = &p_tCycle->data;
+    vHalSensor_performAverages(&p_tCycle->err, p_tData, &p_tCycle->meas);
+    vHalSensor_applyAggregation(p_tData, p_tCycle->stats, tConfig.aggregation);
+    sensorData_t rated = *p_tData;
+    vMspAq_applyWindows(&rated);
+    p_tData->MSP = sHalSensor_evaluateMSPIndex(&rated);
+
+    hostCsvRow_t row;
+    vHostReplay_toRow(p_tData, slot, &row);
+    p_tOut->push_back(row);
+    p_tCycle->lastTxSlot = slot;
+    p_tCycle->meas.measurement_count = 0;
+}
+
+/******************************************************
+ * @brief boot: the sensors the firmware found are the
+ *        ones with a value before the next power off
+ ******************************************************/
+static void vHostReplay_boot(hostReplayCycle_t *p_tCycle, const std::vector<hostCsvRow_t> &samples, size_t first)
+{
+    uint8_t fitted = 0;
+    int64_t last = (int64_t)samples[first].recordedAt / tConfig.period;
+    for (size_t i = first; i < samples.size(); i++)
+    {
+        int64_t slot = (int64_t)samples[i].recordedAt / tConfig.period;
+        if ((slot - last) > tConfig.intervalSlots)
+        {
+            break;
+        }
+        fitted |= samples[i].present;
+        last = slot;
+    }
+    memset(&p_tCycle->err, 0, sizeof(p_tCycle->err));
+    p_tCycle->gasSensorType = (fitted & HOST_CSV_HAS_MICS_ADC) ? (uint8_t)GAS_SENSOR_MICS4514 : tConfig.gasSensorType;
+    peripheralStatus_t *p_tStatus = &p_tCycle->data.status;
+    p_tStatus->BME680Sensor = (fitted & HOST_CSV_HAS_BME) ? 1 : 0;
+    p_tStatus->PMS5003Sensor = (fitted & HOST_CSV_HAS_PMS) ? 1 : 0;
+    p_tStatus->O3Sensor = (fitted & HOST_CSV_HAS_O3) ? 1 : 0;
+    p_tStatus->MICS4514Sensor = (fitted & HOST_CSV_HAS_MICS_ADC) ? 1 : 0;
+    p_tStatus->MICS6814Sensor = ((fitted & HOST_CSV_HAS_MICS) && !p_tStatus->MICS4514Sensor) ? 1 : 0;
+    p_tCycle->lastTxSlot = 0;
+    vMspAq_init((uint32_t)tConfig.period); // the windows are in RAM
+}
+
+/******************************************************
+ * @brief raw samples to records; a gap longer than an
+ *        interval is a station off: a complete cycle
+ *        still went out, an incomplete one is lost
+ ******************************************************/
+static void vHostReplay_samples(const std::vector<hostCsvRow_t> &samples, std::vector<hostCsvRow_t> *p_tOut)
+{
+    hostReplayCycle_t cycle;
+    memset(&cycle, 0, sizeof(cycle));
+    p_tOut->clear();
+    tReport.incomplete = 0;
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        int64_t slot = (int64_t)samples[i].recordedAt / tConfig.period;
+        if (cycle.meas.measurement_count > 0)
+        {
+            if (cycle.meas.measurement_count >= cycle.meas.avg_measurements)
+            {
+                vHostReplay_send(&cycle, llHostReplay_sendSlot(&cycle), p_tOut);
+            }
+            else if ((slot - cycle.lastSlot) > tConfig.intervalSlots)
+            {
+                tReport.incomplete++;
+                cycle.meas.measurement_count = 0;
+            }
+        }
+        if ((i == 0) || ((slot - cycle.lastSlot) > tConfig.intervalSlots))
+        {
+            vHostReplay_boot(&cycle, samples, i);
+        }
+        if (cycle.meas.measurement_count == 0)
+        {
+            vHostReplay_startCycle(&cycle, slot);
+        }
+        vHostReplay_accumulate(&cycle, &samples[i]);
+        vHostReplay_evalStatus(&cycle);
+        cycle.lastSlot = slot;
+        if (bHostReplay_canSend(&cycle, slot))
+        {
+            vHostReplay_send(&cycle, slot, p_tOut);
+        }
+    }
+    if (cycle.meas.measurement_count > 0)
+    {
+        tReport.incomplete++; // the log ends before the record
+    }
+}
+
+/******************************************************
+ * @brief averaged records: one-sample cycles through
+ *        the same code, which leaves the values alone
+ *        and rates them again
+ ******************************************************/
+static void vHostReplay_records(const std::vector<hostCsvRow_t> &records, std::vector<hostCsvRow_t> *p_tOut)
+{
+    hostReplayCycle_t cycle;
+    memset(&cycle, 0, sizeof(cycle));
+    p_tOut->clear();
+    tReport.mspChanged = 0;
+    for (size_t i = 0; i < records.size(); i++)
+    {
+        const hostCsvRow_t *p_tIn = &records[i];
+        sensorData_t *p_tData = &cycle.data;
+        memcpy(p_tData, &tConfig.defaults, sizeof(*p_tData));
+        memset(&cycle.err, 0, sizeof(cycle.err));
+        cycle.meas.measurement_count = 1;
+        p_tData->status.BME680Sensor = (p_tIn->present & HOST_CSV_HAS_BME) ? 1 : 0;
+        p_tData->status.PMS5003Sensor = (p_tIn->present & HOST_CSV_HAS_PMS) ? 1 : 0;
+        // a MICS4514 record holds no ADC counts to recompute from, and does not enter the index
+        p_tData->status.MICS6814Sensor = ((p_tIn->present & HOST_CSV_HAS_MICS) && (tConfig.gasSensorType == GAS_SENSOR_MICS6814)) ? 1 : 0;
+        p_tData->status.O3Sensor = (p_tIn->present & HOST_CSV_HAS_O3) ? 1 : 0;
+        p_tData->gasData.temperature = p_tIn->temp;
+        p_tData->gasData.humidity = p_tIn->hum;
+        p_tData->gasData.pressure = p_tIn->pres;
+        p_tData->gasData.volatileOrganicCompounds = p_tIn->voc;
+        p_tData->airQualityData.particleMicron1 = p_tIn->pm1;
+        p_tData->airQualityData.particleMicron25 = p_tIn->pm25;
+        p_tData->airQualityData.particleMicron10 = p_tIn->pm10;
+        p_tData->pollutionData.nitrogenDioxide = p_tIn->no2;
+        p_tData->pollutionData.carbonMonoxide = p_tIn->co;
+        p_tData->pollutionData.ammonia = p_tIn->nh3;
+        p_tData->ozoneData.ozone = p_tIn->o3;
+
+        vHalSensor_performAverages(&cycle.err, p_tData, &cycle.meas);
+        p_tData->MSP = sHalSensor_evaluateMSPIndex(p_tData);
+
+        hostCsvRow_t row;
+        vHostReplay_toRow(p_tData, (int64_t)p_tIn->recordedAt / tConfig.period, &row);
+        row.present = (row.present & ~HOST_CSV_HAS_MICS) | (p_tIn->present & HOST_CSV_HAS_MICS);
+        if ((p_tIn->present & HOST_CSV_HAS_MSP) && (row.msp != p_tIn->msp))
+        {
+            tReport.mspChanged++;
+        }
+        p_tOut->push_back(row);
+    }
+}
+
+//------------------------------------------------------------------------------
+// output
+//------------------------------------------------------------------------------
+
+static bool bHostReplay_lessAt(const hostCsvRow_t &a, const hostCsvRow_t &b)
+{
+    return a.recordedAt < b.recordedAt;
+}
+
+/******************************************************
+ * @brief records re-derived from samples against the
+ *        logged records of the same time, line for
+ *        line as the card holds them
+ ******************************************************/
+static void vHostReplay_compare(const std::vector<hostCsvRow_t> &replayed, std::vector<hostCsvRow_t> logged)
+{
+    std::stable_sort(logged.begin(), logged.end(), bHostReplay_lessAt);
+    std::vector<bool> matched(logged.size(), false);
+    char lineReplayed[HOST_CSV_LINE_LEN];
+    char lineLogged[HOST_CSV_LINE_LEN];
+    for (size_t i = 0; i < replayed.size(); i++)
+    {
+        std::vector<hostCsvRow_t>::const_iterator it = std::lower_bound(logged.begin(), logged.end(), replayed[i], bHostReplay_lessAt);
+        if ((it == logged.end()) || (it->recordedAt != replayed[i].recordedAt))
+        {
+            tReport.notLogged++;
+            continue;
+        }
+        matched[it - logged.begin()] = true;
+        ulHostCsv_formatRecord(&replayed[i], lineReplayed, sizeof(lineReplayed));
+        ulHostCsv_formatRecord(&*it, lineLogged, sizeof(lineLogged));
+        if (strcmp(lineReplayed, lineLogged) == 0)
+        {
+            tReport.identical++;
+            continue;
+        }
+        if (tReport.different++ < HOST_REPLAY_MAX_DIFFS)
+        {
+            log_w("record differs from the log:\n  logged  : %s\n  replayed: %s", lineLogged, lineReplayed);
+        }
+    }
+    tReport.notReplayed = (uint32_t)std::count(matched.begin(), matched.end(), false);
+}
+
+/******************************************************
+ * @brief write the records in the card layout
+ *        (/YYYY/MM/DD.csv) under the output directory
+ ******************************************************/
+static bool bHostReplay_write(const std::vector<hostCsvRow_t> &rows)
+{
+    std::set<std::string> written;
+    std::string current;
+    FILE *fp = nullptr;
+    char cardPath[HOST_CSV_PATH_LEN];
+    char line[HOST_CSV_LINE_LEN];
+    for (size_t i = 0; i < rows.size(); i++)
+    {
+        vHostCsv_logPath(rows[i].recordedAt, "", cardPath, sizeof(cardPath));
+        std::string path = std::string(tConfig.outDir) + cardPath;
+        if (path != current)
+        {
+            if (fp)
+            {
+                fclose(fp);
+            }
+            // /YYYY/MM/DD.csv: create the year and month directories on the way
+            for (size_t slash = strlen(tConfig.outDir) + 1; (slash = path.find('/', slash)) != std::string::npos; slash++)
+            {
+                mkdir(path.substr(0, slash).c_str(), 0755);
+            }
+            bool fresh = written.insert(path).second;
+            fp = fopen(path.c_str(), fresh ? "w" : "a");
+            if (!fp)
+            {
+                log_e("cannot write %s: %s", path.c_str(), strerror(errno));
+                return false;
+            }
+            if (fresh)
+            {
+                fprintf(fp, "%s\r\n", CSV_HEADER);
+            }
+            current = path;
+        }
+        ulHostCsv_formatRecord(&rows[i], line, sizeof(line));
+        fprintf(fp, "%s\r\n", line);
+    }
+    if (fp)
+    {
+        fclose(fp);
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// driver
+//------------------------------------------------------------------------------
+
+static void vHostReplay_usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--interval MIN] [--sampling-period S] [--gas mics6814|mics4514]\n"
+                    "       [--r0-red N] [--r0-ox N] [--comp-h F] [--comp-t F] [--comp-p F] [--out DIR] [--repeat N]\n"
+                    "       [--log-level 0..5] [--aggregation CHANNEL=mean|median|trimmed] PATH...\n",
+            argv0);
+}
+
+/******************************************************
+ * @brief calibration defaults of a station without
+ *        config overrides
+ ******************************************************/
+static void vHostReplay_defaults(sensorData_t *p_tData)
+{
+    memset(p_tData, 0, sizeof(*p_tData));
+    p_tData->gasData.seaLevelAltitude = SEA_LEVEL_ALTITUDE_IN_M;
+    p_tData->micsTuningData.sensingResInAir.redSensor = R0_RED_SENSOR;
+    p_tData->micsTuningData.sensingResInAir.oxSensor = R0_OX_SENSOR;
+    p_tData->micsTuningData.sensingResInAir.nh3Sensor = R0_NH3_SENSOR;
+    p_tData->molarMass.carbonMonoxide = CO_MOLAR_MASS;
+    p_tData->molarMass.nitrogenDioxide = NO2_MOLAR_MASS;
+    p_tData->molarMass.ammonia = NH3_MOLAR_MASS;
+    p_tData->ozoneData.o3ZeroOffset = O3_SENS_DISABLE_ZERO_OFFSET;
+    p_tData->compParams.currentHumidity = HUMIDITY_COMP_PARAM;
+    p_tData->compParams.currentTemperature = TEMP_COMP_PARAM;
+    p_tData->compParams.currentPressure = PRESS_COMP_PARAM;
+    p_tData->MSP = MSP_DEFAULT_DATA;
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> paths;
+    tConfig.interval = HOST_REPLAY_DEFAULT_INTERVAL;
+    tConfig.period = HOST_REPLAY_DEFAULT_PERIOD;
+    tConfig.gasSensorType = GAS_SENSOR_MICS6814;
+    tConfig.repeat = 1;
+    tConfig.outDir = nullptr;
+    vHostReplay_defaults(&tConfig.defaults);
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        bool value = (i + 1) < argc;
+        if ((strcmp(arg, "--interval") == 0) && value)
+        {
+            tConfig.interval = atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--sampling-period") == 0) && value)
+        {
+            tConfig.period = atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--gas") == 0) && value)
+        {
+            tConfig.gasSensorType = (strcmp(argv[++i], "mics4514") == 0) ? GAS_SENSOR_MICS4514 : GAS_SENSOR_MICS6814;
+        }
+        else if ((strcmp(arg, "--r0-red") == 0) && value)
+        {
+            tConfig.defaults.micsTuningData.sensingResInAir.redSensor = (uint16_t)atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--r0-ox") == 0) && value)
+        {
+            tConfig.defaults.micsTuningData.sensingResInAir.oxSensor = (uint16_t)atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--comp-h") == 0) && value)
+        {
+            tConfig.defaults.compParams.currentHumidity = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--comp-t") == 0) && value)
+        {
+            tConfig.defaults.compParams.currentTemperature = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--comp-p") == 0) && value)
+        {
+            tConfig.defaults.compParams.currentPressure = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--out") == 0) && value)
+        {
+            tConfig.outDir = argv[++i];
+        }
+        else if ((strcmp(arg, "--repeat") == 0) && value)
+        {
+            tConfig.repeat = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        }
+        else if ((strcmp(arg, "--aggregation") == 0) && value)
+        {
+            if (!bHostSim_parseAggregation(argv[++i], tConfig.aggregation))
+            {
+                vHostReplay_usage(argv[0]);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "--log-level") == 0) && value)
+        {
+            g_iHostLog_level = atoi(argv[++i]);
+        }
+        else if (arg[0] != '-')
+        {
+            paths.push_back(arg);
+        }
+        else
+        {
+            vHostReplay_usage(argv[0]);
+            return 2;
+        }
+    }
+    if (paths.empty() || (tConfig.interval <= 0) || (tConfig.interval > MIN_IN_HOUR) || (tConfig.period <= 0) ||
+        ((SEC_IN_MIN % tConfig.period) != 0) || (tConfig.repeat == 0))
+    {
+        vHostReplay_usage(argv[0]);
+        return 2;
+    }
+    tConfig.intervalSlots = (tConfig.interval * SEC_IN_MIN) / tConfig.period;
+    tConfig.hourSlots = SEC_IN_HOUR / tConfig.period;
+
+    std::vector<std::string> files;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        vHostReplay_collect(paths[i], &files);
+    }
+    std::vector<hostCsvRow_t> records;
+    std::vector<hostCsvRow_t> samples;
+    double start = dHostReplay_now();
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        vHostReplay_load(files[i], &records, &samples);
+    }
+    tReport.parseSec = dHostReplay_now() - start;
+    std::stable_sort(samples.begin(), samples.end(), bHostReplay_lessAt);
+
+    // --repeat runs the aggregation again on the loaded data, for timing
+    std::vector<hostCsvRow_t> fromSamples;
+    std::vector<hostCsvRow_t> fromRecords;
+    start = dHostReplay_now();
+    for (uint32_t n = 0; (n < tConfig.repeat) && !samples.empty(); n++)
+    {
+        vHostReplay_samples(samples, &fromSamples);
+    }
+    tReport.sampleSec = dHostReplay_now() - start;
+    start = dHostReplay_now();
+    for (uint32_t n = 0; (n < tConfig.repeat) && !records.empty(); n++)
+    {
+        vHostReplay_records(records, &fromRecords);
+    }
+    tReport.recordSec = dHostReplay_now() - start;
+    if (!samples.empty() && !records.empty())
+    {
+        vHostReplay_compare(fromSamples, records);
+    }
+
+    bool written = true;
+    if (tConfig.outDir)
+    {
+        mkdir(tConfig.outDir, 0755);
+        written = bHostReplay_write(samples.empty() ? fromRecords : fromSamples);
+    }
+
+    uint64_t lines = (uint64_t)records.size() + samples.size();
+    printf("\n==== REPLAY REPORT ====\n");
+    printf("files            : %u (%.1f MB), %u skipped, %u bad lines\n", tReport.files, (double)tReport.bytes / 1e6,
+           tReport.skippedFiles, tReport.badLines);
+    printf("parse            : %llu lines in %.3f s, %.2f M lines/s, %.1f MB/s\n", (unsigned long long)lines, tReport.parseSec,
+           tReport.parseSec > 0 ? (double)lines / tReport.parseSec / 1e6 : 0.0,
+           tReport.parseSec > 0 ? (double)tReport.bytes / tReport.parseSec / 1e6 : 0.0);
+    if (!samples.empty())
+    {
+        printf("raw samples      : %zu -> %zu records, %u incomplete cycles, %.2f M samples/s\n", samples.size(), fromSamples.size(),
+               tReport.incomplete,
+               tReport.sampleSec > 0 ? (double)samples.size() * tConfig.repeat / tReport.sampleSec / 1e6 : 0.0);
+    }
+    if (!records.empty())
+    {
+        printf("logged records   : %zu, MSP# changed: %u, %.2f M records/s\n", records.size(), tReport.mspChanged,
+               tReport.recordSec > 0 ? (double)records.size() * tConfig.repeat / tReport.recordSec / 1e6 : 0.0);
+    }
+    if (!samples.empty() && !records.empty())
+    {
+        printf("vs logged        : %u identical, %u different, %u not in the log, %u not replayed\n", tReport.identical,
+               tReport.different, tReport.notLogged, tReport.notReplayed);
+    }
+    printf("=======================\n");
+    return written ? 0 : 1;
+}
@@ -0,0 +1,844 @@
+/******************************************************************************
+ * @file    host_sensors.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host implementation of the sensor and display libraries used by
+ *          the firmware, backed by simulated devices on the host I2C bus and
+ *          UART2: BME680 (BSEC), PMS5003, MICS6814, MICS4514 and the SH1106.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <Wire.h>
+#include <bsec.h>
+#include <PMS.h>
+#include <MiCS6814-I2C.h>
+#include <DFRobot_MICS.h>
+#include <U8g2lib.h>
+#include <deque>
+#include "sensors.h"
+#include "host_sim.h"
+
+#define HOST_BME_MEAS_DURATION_MS 200 /*!< forced mode TPH + gas heater cycle */
+#define HOST_BME_E_DEV_NOT_FOUND (-2)
+#define HOST_BSEC_STATE_MAGIC 0x4D535042UL
+#define HOST_BSEC_RUNS_PER_ACCURACY 60 /*!< runs, carried over in the state, for each IAQ accuracy step */
+#define HOST_BSEC_MAX_ACCURACY 3
+
+#define HOST_PMS_UART_NR 2
+#define HOST_PMS_FRAME_LEN 32
+#define HOST_PMS_CMD_LEN 7
+#define HOST_PMS_WAKEUP_MS 2500   /*!< fan spin-up before the first frame */
+#define HOST_PMS_GLITCH_UGM3 500  /*!< added to every reading of a glitch frame */
+#define HOST_PMS_RX_BUFFER 256    /*!< ESP32 UART driver RX buffer */
+#define HOST_PMS_BYTE_US 1042     /*!< one 8N1 character at 9600 baud */
+
+#define HOST_DFR_OX_REGISTER_HIGH 0x04
+#define HOST_DFR_POWER_MODE_REGISTER 0x0A
+#define HOST_DFR_POWER_FULL_SCALE 1023
+
+#define HOST_OLED_ADDR 0x3C
+
+const uint8_t u8g2_font_6x13_tf[] = {0};
+const uint8_t u8g2_font_6x13_mf[] = {0};
+const uint8_t u8g2_font_6x13B_tf[] = {0};
+
+/******************************************************
+ * @brief ACKs every address byte, returns the bytes
+ *        prepared by the owner for the next read
+ ******************************************************/
+class HostRegisterDevice : public HostI2cDevice
+{
+public:
+    void receive(const uint8_t *data, size_t len) override
+    {
+        lastCommand = (len > 0) ? data[0] : lastCommand;
+        lastLength = len;
+        if (len <= sizeof(lastWrite))
+        {
+            memcpy(lastWrite, data, len);
+        }
+    }
+    size_t request(uint8_t *data, size_t len) override
+    {
+        if (failNext)
+        {
+            failNext = false;
+            return 0;
+        }
+        size_t n = (len < responseLength) ? len : responseLength;
+        memcpy(data, response, n);
+        return n;
+    }
+
+    uint8_t lastCommand = 0;
+    uint8_t lastWrite[16] = {0};
+    size_t lastLength = 0;
+    uint8_t response[16] = {0};
+    size_t responseLength = 0;
+    bool failNext = false;
+};
+
+static HostRegisterDevice tBmeDevice;
+static HostRegisterDevice tMics6814Device;
+static HostRegisterDevice tMics4514Device;
+static HostRegisterDevice tOledDevice;
+
+static uint16_t uMics6814_r0[3] = {0, 0, 0}; /*!< EEPROM: NH3, RED, OX */
+static bool bMics4514_awake = false;
+
+/******************************************************
+ * @brief simulated PMS5003 on UART2
+ ******************************************************/
+class HostPms5003 : public HostUartDevice
+{
+public:
+    int available() override
+    {
+        pump();
+        return (int)arrived();
+    }
+    int read() override
+    {
+        pump();
+        if (!arrived())
+        {
+            return -1;
+        }
+        uint8_t c = _rx.front().second;
+        _rx.pop_front();
+        return c;
+    }
+    int peek() override
+    {
+        pump();
+        return arrived() ? _rx.front().second : -1;
+    }
+    void write(uint8_t c) override
+    {
+        _cmd[_cmdLen++] = c;
+        if ((_cmdLen == 1) && (c != 0x42))
+        {
+            _cmdLen = 0;
+        }
+        else if (_cmdLen == HOST_PMS_CMD_LEN)
+        {
+            execute();
+            _cmdLen = 0;
+        }
+    }
+
+    void setRxBufferSize(size_t size) override
+    {
+        _rxBufferSize = size;
+    }
+
+    uint64_t awakeUs(void) const
+    {
+        return _awakeUs + (_awake ? ullHostClock_micros() - _awakeSinceUs : 0);
+    }
+
+    void reset(void)
+    {
+        _rx.clear();
+        _rxBufferSize = HOST_PMS_RX_BUFFER;
+        _awake = true;
+        _awakeUs = 0;
+        _awakeSinceUs = ullHostClock_micros();
+        _passive = false;
+        _cmdLen = 0;
+        _nextFrameUs = ullHostClock_micros() + (uint64_t)HOST_PMS_WAKEUP_MS * 1000ULL;
+    }
+
+private:
+    size_t arrived(void) const
+    {
+        uint64_t now = ullHostClock_micros();
+        size_t n = 0;
+        while ((n < _rx.size()) && (_rx[n].first <= now))
+        {
+            n++;
+        }
+        return n;
+    }
+
+    void pump(void)
+    {
+        uint64_t now = ullHostClock_micros();
+        uint64_t period = (uint64_t)g_tHostSim_config.pmsFramePeriodMs * 1000ULL;
+        if (!_awake || _passive || !period)
+        {
+            return;
+        }
+        // frames older than the RX buffer would have been overwritten anyway
+        uint64_t horizon = period * (_rxBufferSize / HOST_PMS_FRAME_LEN + 1);
+        if ((now > horizon) && (_nextFrameUs < now - horizon))
+        {
+            _nextFrameUs += ((now - horizon - _nextFrameUs) / period + 1) * period;
+        }
+        while (_nextFrameUs <= now)
+        {
+            queueFrame(_nextFrameUs);
+            _nextFrameUs += period;
+        }
+        while (arrived() > _rxBufferSize)
+        {
+            _rx.pop_front();
+        }
+    }
+
+    void queueFrame(uint64_t startUs)
+    {
+        hostEnvSample_t env;
+        vHostEnv_sample((time_t)(tHostClock_wallEpoch() - (time_t)((ullHostClock_micros() - startUs) / 1000000ULL)), &env);
+        uint16_t words[13] = {0};
+        words[0] = words[3] = (uint16_t)lroundf(env.pm1);
+        words[1] = words[4] = (uint16_t)lroundf(env.pm25);
+        words[2] = words[5] = (uint16_t)lroundf(env.pm10);
+        if (bHostSim_fault(g_tHostSim_config.pmsGlitchRate))
+        {
+            // insect or droplet through the laser: a burst reading in a well formed frame
+            for (int i = 0; i < 6; i++)
+            {
+                words[i] = (uint16_t)(words[i] + HOST_PMS_GLITCH_UGM3);
+            }
+        }
+
+        uint8_t frame[HOST_PMS_FRAME_LEN];
+        frame[0] = 0x42;
+        frame[1] = 0x4D;
+        frame[2] = 0x00;
+        frame[3] = 2 * 13 + 2;
+        for (int i = 0; i < 13; i++)
+        {
+            frame[4 + 2 * i] = (uint8_t)(words[i] >> 8);
+            frame[5 + 2 * i] = (uint8_t)(words[i] & 0xFF);
+        }
+        uint16_t checksum = 0;
+        for (int i = 0; i < HOST_PMS_FRAME_LEN - 2; i++)
+        {
+            checksum += frame[i];
+        }
+        if (bHostSim_fault(g_tHostSim_config.pmsFailRate))
+        {
+            checksum ^= 0x5A5A; // line noise
+        }
+        frame[30] = (uint8_t)(checksum >> 8);
+        frame[31] = (uint8_t)(checksum & 0xFF);
+
+        for (int i = 0; i < HOST_PMS_FRAME_LEN; i++)
+        {
+            _rx.push_back(std::make_pair(startUs + (uint64_t)i * HOST_PMS_BYTE_US, frame[i]));
+        }
+    }
+
+    void execute(void)
+    {
+        switch (_cmd[2])
+        {
+        case 0xE4: // sleep / wakeup
+            if (_cmd[4] == 0x00)
+            {
+                if (_awake)
+                {
+                    _awakeUs += ullHostClock_micros() - _awakeSinceUs;
+                }
+                _awake = false;
+                _rx.clear();
+            }
+            else if (!_awake)
+            {
+                _awake = true;
+                _awakeSinceUs = ullHostClock_micros();
+                _nextFrameUs = ullHostClock_micros() + (uint64_t)HOST_PMS_WAKEUP_MS * 1000ULL;
+            }
+            break;
+        case 0xE1: // change mode
+            _passive = (_cmd[4] == 0x00);
+            _nextFrameUs = ullHostClock_micros() + (uint64_t)g_tHostSim_config.pmsFramePeriodMs * 1000ULL;
+            break;
+        case 0xE2: // passive read
+            if (_awake && _passive)
+            {
+                queueFrame(ullHostClock_micros() + HOST_PMS_BYTE_US);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::deque<std::pair<uint64_t, uint8_t>> _rx;
+    uint8_t _cmd[HOST_PMS_CMD_LEN] = {0};
+    size_t _cmdLen = 0;
+    size_t _rxBufferSize = HOST_PMS_RX_BUFFER;
+    bool _awake = true;
+    uint64_t _awakeUs = 0;      /*!< laser and fan time before _awakeSinceUs */
+    uint64_t _awakeSinceUs = 0;
+    bool _passive = false;
+    uint64_t _nextFrameUs = 0;
+};
+
+static HostPms5003 tPmsDevice;
+
+/******************************************************
+ * @brief plug the simulated devices selected by the
+ *        simulation config, call once before setup()
+ ******************************************************/
+void vHostSensors_attach(void)
+{
+    if (g_tHostSim_config.bmePresent)
+    {
+        vHostI2c_attach(BME68X_I2C_ADDR_HIGH, &tBmeDevice);
+    }
+    if (g_tHostSim_config.micsPresent && (g_tHostSim_config.gasSensorType == GAS_SENSOR_MICS6814))
+    {
+        vHostI2c_attach(DATA_I2C_ADDR, &tMics6814Device);
+    }
+    if (g_tHostSim_config.micsPresent && (g_tHostSim_config.gasSensorType == GAS_SENSOR_MICS4514))
+    {
+        vHostI2c_attach(0x75, &tMics4514Device);
+    }
+    vHostI2c_attach(HOST_OLED_ADDR, &tOledDevice);
+    if (g_tHostSim_config.pmsPresent)
+    {
+        tPmsDevice.reset();
+        vHostUart_attach(HOST_PMS_UART_NR, &tPmsDevice);
+    }
+}
+
+/******************************************************
+ * @brief time the simulated PMS5003 laser was on
+ ******************************************************/
+uint64_t ullHostSensors_pmsAwakeUs(void)
+{
+    return tPmsDevice.awakeUs();
+}
+
+//------------------------------------------------------------------------------
+// BSEC
+//------------------------------------------------------------------------------
+
+void Bsec::begin(uint8_t i2cAddr, TwoWire &i2c)
+{
+    i2c.beginTransmission(i2cAddr);
+    bme68xStatus = (i2c.endTransmission() == 0) ? BME68X_OK : HOST_BME_E_DEV_NOT_FOUND;
+    bsecStatus = BSEC_OK;
+}
+
+void Bsec::updateSubscription(bsec_virtual_sensor_t sensorList[], uint8_t nSensors, float sampleRate)
+{
+    (void)sensorList;
+    (void)nSensors;
+    _sampleRate = sampleRate;
+    _nextCallMs = getTimeMs();
+}
+
+/******************************************************
+ * @brief same contract as the BSEC library: returns
+ *        true only when a new output set is available
+ ******************************************************/
+bool Bsec::run(int64_t timeMilliseconds)
+{
+    int64_t now = (timeMilliseconds < 0) ? getTimeMs() : timeMilliseconds;
+    if ((bme68xStatus != BME68X_OK) || (_sampleRate >= BSEC_SAMPLE_RATE_DISABLED) || (now < _nextCallMs))
+    {
+        return false;
+    }
+    _nextCallMs = now + (int64_t)(1000.0f / _sampleRate);
+
+    Wire.beginTransmission(BME68X_I2C_ADDR_HIGH);
+    Wire.write(0x74); // ctrl_meas, forced mode
+    Wire.write(0x25);
+    if (Wire.endTransmission() != 0)
+    {
+        bme68xStatus = HOST_BME_E_DEV_NOT_FOUND;
+        return false;
+    }
+    delay(HOST_BME_MEAS_DURATION_MS);
+    tBmeDevice.failNext = bHostSim_fault(g_tHostSim_config.bmeFailRate);
+    tBmeDevice.responseLength = 15;
+    Wire.beginTransmission(BME68X_I2C_ADDR_HIGH);
+    Wire.write(0x1D); // field 0
+    Wire.endTransmission(false);
+    if (Wire.requestFrom(BME68X_I2C_ADDR_HIGH, 15) != 15)
+    {
+        return false;
+    }
+    while (Wire.available())
+    {
+        Wire.read();
+    }
+
+    hostEnvSample_t env;
+    vHostEnv_sample(tHostClock_wallEpoch(), &env);
+    rawTemperature = env.temperature;
+    temperature = env.temperature - _tempOffset;
+    rawHumidity = env.humidity;
+    humidity = env.humidity;
+    pressure = env.pressurePa;
+    gasResistance = env.gasOhm;
+    outputTimestamp = now * 1000000LL;
+    _runCount++;
+    iaqAccuracy = (float)std::min<uint32_t>(_runCount / HOST_BSEC_RUNS_PER_ACCURACY, HOST_BSEC_MAX_ACCURACY);
+    return true;
+}
+
+void Bsec::getState(uint8_t *state)
+{
+    memset(state, 0, BSEC_MAX_STATE_BLOB_SIZE);
+    uint32_t magic = HOST_BSEC_STATE_MAGIC;
+    memcpy(state, &magic, sizeof(magic));
+    memcpy(state + sizeof(magic), &_runCount, sizeof(_runCount));
+    bsecStatus = BSEC_OK;
+}
+
+void Bsec::setState(uint8_t *state)
+{
+    uint32_t magic = 0;
+    memcpy(&magic, state, sizeof(magic));
+    if (magic != HOST_BSEC_STATE_MAGIC)
+    {
+        bsecStatus = BSEC_E_DOSTEPS_INVALIDINPUT;
+        return;
+    }
+    memcpy(&_runCount, state + sizeof(magic), sizeof(_runCount));
+    bsecStatus = BSEC_OK;
+}
+
+//------------------------------------------------------------------------------
+// PMS (port of the fu-hsi PMS library parser)
+//------------------------------------------------------------------------------
+
+PMS::PMS(Stream &stream)
+{
+    _stream = &stream;
+    _data = nullptr;
+    _status = STATUS_WAITING;
+}
+
+void PMS::sleep()
+{
+    uint8_t command[] = {0x42, 0x4D, 0xE4, 0x00, 0x00, 0x01, 0x73};
+    _stream->write(command, sizeof(command));
+}
+
+void PMS::wakeUp()
+{
+    uint8_t command[] = {0x42, 0x4D, 0xE4, 0x00, 0x01, 0x01, 0x74};
+    _stream->write(command, sizeof(command));
+}
+
+void PMS::activeMode()
+{
+    uint8_t command[] = {0x42, 0x4D, 0xE1, 0x00, 0x01, 0x01, 0x71};
+    _stream->write(command, sizeof(command));
+    _mode = MODE_ACTIVE;
+}
+
+void PMS::passiveMode()
+{
+    uint8_t command[] = {0x42, 0x4D, 0xE1, 0x00, 0x00, 0x01, 0x70};
+    _stream->write(command, sizeof(command));
+    _mode = MODE_PASSIVE;
+}
+
+void PMS::requestRead()
+{
+    if (_mode == MODE_PASSIVE)
+    {
+        uint8_t command[] = {0x42, 0x4D, 0xE2, 0x00, 0x00, 0x01, 0x71};
+        _stream->write(command, sizeof(command));
+    }
+}
+
+bool PMS::read(DATA &data)
+{
+    _data = &data;
+    loop();
+    return _status == STATUS_OK;
+}
+
+bool PMS::readUntil(DATA &data, uint16_t timeout)
+{
+    _data = &data;
+    uint32_t start = millis();
+    do
+    {
+        loop();
+        if (_status == STATUS_OK)
+        {
+            break;
+        }
+    } while (millis() - start < timeout);
+    return _status == STATUS_OK;
+}
+
+void PMS::loop()
+{
+    _status = STATUS_WAITING;
+    if (_stream->available())
+    {
+        uint8_t ch = _stream->read();
+        switch (_index)
+        {
+        case 0:
+            if (ch != 0x42)
+            {
+                return;
+            }
+            _calculatedChecksum = ch;
+            break;
+        case 1:
+            if (ch != 0x4D)
+            {
+                _index = 0;
+                return;
+            }
+            _calculatedChecksum += ch;
+            break;
+        case 2:
+            _calculatedChecksum += ch;
+            _frameLen = ch << 8;
+            break;
+        case 3:
+            _frameLen |= ch;
+            // Unsupported sensor, different frame length, transmission error e.t.c.
+            if ((_frameLen != 2 * 9 + 2) && (_frameLen != 2 * 13 + 2))
+            {
+                _index = 0;
+                return;
+            }
+            _calculatedChecksum += ch;
+            break;
+        default:
+            if (_index == _frameLen + 2)
+            {
+                _checksum = ch << 8;
+            }
+            else if (_index == _frameLen + 2 + 1)
+            {
+                _checksum |= ch;
+                if (_calculatedChecksum == _checksum)
+                {
+                    _status = STATUS_OK;
+                    // Standard Particles, CF=1.
+                    _data->PM_SP_UG_1_0 = (uint16_t)((_payload[0] << 8) | _payload[1]);
+                    _data->PM_SP_UG_2_5 = (uint16_t)((_payload[2] << 8) | _payload[3]);
+                    _data->PM_SP_UG_10_0 = (uint16_t)((_payload[4] << 8) | _payload[5]);
+                    // Atmospheric Environment.
+                    _data->PM_AE_UG_1_0 = (uint16_t)((_payload[6] << 8) | _payload[7]);
+                    _data->PM_AE_UG_2_5 = (uint16_t)((_payload[8] << 8) | _payload[9]);
+                    _data->PM_AE_UG_10_0 = (uint16_t)((_payload[10] << 8) | _payload[11]);
+                }
+                _index = 0;
+                return;
+            }
+            else
+            {
+                _calculatedChecksum += ch;
+                uint8_t payloadIndex = _index - 4;
+                // Payload is common to all sensors (first 2x6 bytes).
+                if (payloadIndex < sizeof(_payload))
+                {
+                    _payload[payloadIndex] = ch;
+                }
+            }
+            break;
+        }
+        _index++;
+    }
+}
+
+//------------------------------------------------------------------------------
+// MICS6814
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief one register read: command byte, then 2 bytes
+ ******************************************************/
+static bool bHostMics6814_read(uint8_t address, uint8_t command, uint16_t value, uint16_t *p_uOut)
+{
+    tMics6814Device.response[0] = (uint8_t)(value >> 8);
+    tMics6814Device.response[1] = (uint8_t)(value & 0xFF);
+    tMics6814Device.responseLength = 2;
+    tMics6814Device.failNext = bHostSim_fault(g_tHostSim_config.micsFailRate);
+
+    Wire.beginTransmission(address);
+    Wire.write(command);
+    if (Wire.endTransmission() != 0)
+    {
+        return false;
+    }
+    delay(2);
+    if (Wire.requestFrom(address, (uint8_t)2) != 2)
+    {
+        return false;
+    }
+    uint16_t hi = (uint16_t)Wire.read();
+    *p_uOut = (uint16_t)((hi << 8) | (uint16_t)Wire.read());
+    return true;
+}
+
+static uint16_t uHostMics6814_defaultR0(channel_t channel)
+{
+    return (channel == CH_NH3) ? R0_NH3_SENSOR : ((channel == CH_RED) ? R0_RED_SENSOR : R0_OX_SENSOR);
+}
+
+/******************************************************
+ * @brief ageing of the MICS elements: Rs drifts by
+ *        --mics-drift percent a day since boot
+ ******************************************************/
+static float fHostMics_drift(void)
+{
+    double days = (double)ullHostClock_micros() / 1e6 / (double)(24 * SEC_IN_HOUR);
+    return (float)(1.0 + (double)g_tHostSim_config.micsDriftPct / 100.0 * days);
+}
+
+bool MiCS6814::begin(uint8_t address)
+{
+    _address = address;
+    Wire.beginTransmission(_address);
+    return Wire.endTransmission() == 0;
+}
+
+void MiCS6814::powerOn(void)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(CMD_CONTROL_PWR);
+    Wire.write(1);
+    Wire.endTransmission();
+}
+
+void MiCS6814::powerOff(void)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(CMD_CONTROL_PWR);
+    Wire.write(0);
+    Wire.endTransmission();
+}
+
+void MiCS6814::ledOn(void)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(CMD_CONTROL_LED);
+    Wire.write(1);
+    Wire.endTransmission();
+}
+
+void MiCS6814::ledOff(void)
+{
+    Wire.beginTransmission(_address);
+    Wire.write(CMD_CONTROL_LED);
+    Wire.write(0);
+    Wire.endTransmission();
+}
+
+uint16_t MiCS6814::getBaseResistance(channel_t channel)
+{
+    // the EEPROM of a new board holds the factory values, a CMD_V2_SET_R0 write updates it
+    if ((tMics6814Device.lastCommand == CMD_V2_SET_R0) && (tMics6814Device.lastLength == 7))
+    {
+        uMics6814_r0[CH_NH3] = (uint16_t)((tMics6814Device.lastWrite[1] << 8) | tMics6814Device.lastWrite[2]);
+        uMics6814_r0[CH_RED] = (uint16_t)((tMics6814Device.lastWrite[3] << 8) | tMics6814Device.lastWrite[4]);
+        uMics6814_r0[CH_OX] = (uint16_t)((tMics6814Device.lastWrite[5] << 8) | tMics6814Device.lastWrite[6]);
+    }
+    uint16_t stored = uMics6814_r0[channel] ? uMics6814_r0[channel] : (uint16_t)(uHostMics6814_defaultR0(channel) + 10);
+    uint8_t command = (channel == CH_NH3) ? CMD_READ_R0_NH3 : ((channel == CH_RED) ? CMD_READ_R0_RED : CMD_READ_R0_OX);
+    uint16_t value = 0;
+    return bHostMics6814_read(_address, command, stored, &value) ? value : 0;
+}
+
+uint16_t MiCS6814::getResistance(channel_t channel)
+{
+    hostEnvSample_t env;
+    vHostEnv_sample(tHostClock_wallEpoch(), &env);
+    float ratio = fHostMics_drift() * ((channel == CH_NH3) ? env.nh3Ratio : ((channel == CH_RED) ? env.redRatio : env.oxRatio));
+    uint16_t rs = (uint16_t)lroundf(ratio * (float)uHostMics6814_defaultR0(channel));
+    uint8_t command = (channel == CH_NH3) ? CMD_READ_RS_NH3 : ((channel == CH_RED) ? CMD_READ_RS_RED : CMD_READ_RS_OX);
+    uint16_t value = 0;
+    return bHostMics6814_read(_address, command, rs, &value) ? value : 0;
+}
+
+float MiCS6814::getCurrentRatio(channel_t channel)
+{
+    float base = (float)getBaseResistance(channel);
+    float rs = (float)getResistance(channel);
+    if ((base <= 0.0f) || (rs <= 0.0f))
+    {
+        return -1.0f;
+    }
+    return (rs + (float)_offsets[channel]) / base;
+}
+
+float MiCS6814::measureCO(void)
+{
+    float ratio = getCurrentRatio(CH_RED);
+    return (ratio < 0.0f) ? -1.0f : 4.385f * powf(ratio, -1.179f);
+}
+
+float MiCS6814::measureNO2(void)
+{
+    float ratio = getCurrentRatio(CH_OX);
+    return (ratio < 0.0f) ? -1.0f : 0.6f * powf(ratio, 1.007f);
+}
+
+float MiCS6814::measureNH3(void)
+{
+    float ratio = getCurrentRatio(CH_NH3);
+    return (ratio < 0.0f) ? -1.0f : 1.47f * powf(ratio, -1.67f);
+}
+
+void MiCS6814::setOffsets(int16_t *offsets)
+{
+    // firmware layout is RED, OX, NH3
+    _offsets[CH_RED] = offsets[0];
+    _offsets[CH_OX] = offsets[1];
+    _offsets[CH_NH3] = offsets[2];
+}
+
+//------------------------------------------------------------------------------
+// DFRobot MICS4514
+//------------------------------------------------------------------------------
+
+bool DFRobot_MICS::warmUpTime(uint8_t minute)
+{
+    if ((millis() - _warmupStartMs) < ((unsigned long)minute * 60000UL))
+    {
+        return false;
+    }
+    // the library reads R0 over the bus once warm, the caller must hold it
+    _r0Red = getADCData(RED_MODE);
+    _r0Ox = getADCData(OX_MODE);
+    return true;
+}
+
+int16_t DFRobot_MICS::getADCData(uint8_t mode)
+{
+    hostEnvSample_t env;
+    vHostEnv_sample(tHostClock_wallEpoch(), &env);
+    uint16_t ox = (uint16_t)(HOST_DFR_POWER_FULL_SCALE - lroundf(fHostMics_drift() * env.oxRatio * R0_OX_SENSOR_F));
+    uint16_t red = (uint16_t)(HOST_DFR_POWER_FULL_SCALE - lroundf(fHostMics_drift() * env.redRatio * R0_RED_SENSOR_F));
+    uint16_t power = HOST_DFR_POWER_FULL_SCALE;
+    tMics4514Device.response[0] = (uint8_t)(ox >> 8);
+    tMics4514Device.response[1] = (uint8_t)(ox & 0xFF);
+    tMics4514Device.response[2] = (uint8_t)(red >> 8);
+    tMics4514Device.response[3] = (uint8_t)(red & 0xFF);
+    tMics4514Device.response[4] = (uint8_t)(power >> 8);
+    tMics4514Device.response[5] = (uint8_t)(power & 0xFF);
+    tMics4514Device.responseLength = 6;
+    tMics4514Device.failNext = bHostSim_fault(g_tHostSim_config.micsFailRate);
+
+    uint8_t recv[6] = {0};
+    if (!readData(HOST_DFR_OX_REGISTER_HIGH, recv, sizeof(recv)))
+    {
+        return ERROR;
+    }
+    uint16_t oxData = (uint16_t)((recv[0] << 8) | recv[1]);
+    uint16_t redData = (uint16_t)((recv[2] << 8) | recv[3]);
+    uint16_t powerData = (uint16_t)((recv[4] << 8) | recv[5]);
+    return (int16_t)((mode == OX_MODE) ? (powerData - oxData) : (powerData - redData));
+}
+
+void DFRobot_MICS::sleepMode(void)
+{
+    uint8_t mode = SLEEP_MODE;
+    writeData(HOST_DFR_POWER_MODE_REGISTER, &mode, 1);
+    bMics4514_awake = false;
+}
+
+void DFRobot_MICS::wakeUpMode(void)
+{
+    uint8_t mode = WAKE_UP_MODE;
+    writeData(HOST_DFR_POWER_MODE_REGISTER, &mode, 1);
+    if (!bMics4514_awake)
+    {
+        _warmupStartMs = millis();
+    }
+    bMics4514_awake = true;
+}
+
+uint8_t DFRobot_MICS::getPowerState(void)
+{
+    return bMics4514_awake ? WAKE_UP_MODE : SLEEP_MODE;
+}
+
+bool DFRobot_MICS_I2C::begin(void)
+{
+    _pWire->beginTransmission(_addr);
+    if (_pWire->endTransmission() != 0)
+    {
+        return false;
+    }
+    _warmupStartMs = millis();
+    return true;
+}
+
+bool DFRobot_MICS_I2C::readData(uint8_t reg, uint8_t *data, uint8_t len)
+{
+    _pWire->beginTransmission(_addr);
+    _pWire->write(reg);
+    if (_pWire->endTransmission() != 0)
+    {
+        return false;
+    }
+    if (_pWire->requestFrom(_addr, len) != len)
+    {
+        return false;
+    }
+    for (uint8_t i = 0; i < len; i++)
+    {
+        data[i] = (uint8_t)_pWire->read();
+    }
+    return true;
+}
+
+void DFRobot_MICS_I2C::writeData(uint8_t reg, uint8_t *data, uint8_t len)
+{
+    _pWire->beginTransmission(_addr);
+    _pWire->write(reg);
+    _pWire->write(data, len);
+    _pWire->endTransmission();
+}
+
+//------------------------------------------------------------------------------
+// U8G2
+//------------------------------------------------------------------------------
+
+bool U8G2::begin(void)
+{
+    Wire.beginTransmission(_addr);
+    return Wire.endTransmission() == 0;
+}
+
+/******************************************************
+ * @brief full frame buffer transfer, split in the
+ *        I2C buffer sized chunks u8x8 uses
+ ******************************************************/
+void U8G2::sendBuffer(void)
+{
+    updateDisplayArea(0, 0, getBufferTileWidth(), getBufferTileHeight());
+}
+
+/******************************************************
+ * @brief transfer of a rectangle of 8x8 tiles, 8 bytes
+ *        each, in the same chunks
+ ******************************************************/
+void U8G2::updateDisplayArea(unsigned int tx, unsigned int ty, unsigned int tw, unsigned int th)
+{
+    (void)tx;
+    (void)ty;
+    uint8_t chunk[I2C_BUFFER_LENGTH] = {0};
+    size_t bytes = (size_t)tw * th * 8;
+    for (size_t sent = 0; sent < bytes; sent += sizeof(chunk))
+    {
+        size_t len = ((bytes - sent) < sizeof(chunk)) ? (bytes - sent) : sizeof(chunk);
+        Wire.beginTransmission(_addr);
+        Wire.write(chunk, len);
+        Wire.endTransmission();
+    }
+}
@@ -0,0 +1,361 @@
+/******************************************************************************
+ * @file    host_services.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stand-ins for the firmware services that depend on hardware
+ *          or libraries not available on the host: SD card configuration
+ *          and logging, firmware update. The network and display tasks run
+ *          for real on the simulated network and OLED.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Arduino.h>
+#include <SD.h>
+#include <set>
+#include <string>
+#include "config.h"
+#include "sdcard.h"
+#include "firmware_update.h"
+#include "latency.h"
+#include "host_sim.h"
+#include "sdLogger.h"
+#include "esp_system.h"
+
+//------------------------------------------------------------------------------
+// sd card
+//------------------------------------------------------------------------------
+
+/******************************************************
+ * @brief the configuration the simulated card holds
+ ******************************************************/
+void vHalSdcard_readSD(systemStatus_t *p_tSys, deviceNetworkInfo_t *p_tDev, sensorData_t *p_tData, deviceMeasurement_t *pDev, systemData_t *p_tSysData)
+{
+    (void)p_tData;
+    p_tSys->sdCard = g_tHostSim_config.sdPresent;
+    p_tSys->configuration = g_tHostSim_config.sdPresent;
+    if (!p_tSys->sdCard)
+    {
+        return;
+    }
+    p_tDev->ssid = HOST_SIM_WIFI_SSID;
+    p_tDev->passw = HOST_SIM_WIFI_SSID;
+    p_tDev->deviceid = HOST_SIM_WIFI_SSID;
+    pDev->avg_measurements = g_tHostSim_config.avgMeasurements;
+    pDev->delay_between_measurements = g_tHostSim_config.samplingPeriod;
+    p_tSys->gasSensorType = g_tHostSim_config.gasSensorType;
+    p_tSys->use_modem = false;
+    p_tSys->fwAutoUpgrade = false;
+    p_tSys->uploadLatency = g_tHostSim_config.uploadLatency;
+    memcpy(p_tSys->aggregation, g_tHostSim_config.aggregation, sizeof(p_tSys->aggregation));
+    p_tSys->micsBaselineMode = g_tHostSim_config.micsBaselineMode;
+    p_tSys->micsBaselineDays = g_tHostSim_config.micsBaselineDays;
+    p_tSysData->ntp_server = NTP_SERVER_DEFAULT;
+    p_tSysData->timezone = TZ_DEFAULT;
+}
+
+uint8_t initializeSD(systemStatus_t *p_tSys, deviceNetworkInfo_t *p_tDev)
+{
+    (void)p_tDev;
+    p_tSys->sdCard = g_tHostSim_config.sdPresent;
+    if (p_tSys->sdCard)
+    {
+        esp_register_shutdown_handler(vHalSdLog_closeAll);
+    }
+    return p_tSys->sdCard;
+}
+
+uint8_t checkConfig(const char *configpath, deviceNetworkInfo_t *p_tDev, sensorData_t *p_tData, deviceMeasurement_t *pDev, systemStatus_t *p_tSys, systemData_t *p_tSysData)
+{
+    (void)configpath;
+    vHalSdcard_readSD(p_tSys, p_tDev, p_tData, pDev, p_tSysData);
+    return p_tSys->configuration;
+}
+
+/******************************************************
+ * @brief append a line to a /YYYY/MM/ file of the
+ *        simulated card, the first write of a run
+ *        replaces the file so that runs do not pile up
+ *        in the same days
+ ******************************************************/
+void vHostSim_appendFile(char *path, const char *header, const char *line)
+{
+    static std::set<std::string> tWritten;
+    path[5] = '\0'; // /YYYY
+    SD.mkdir(path);
+    path[5] = '/';
+    path[8] = '\0'; // /YYYY/MM
+    SD.mkdir(path);
+    path[8] = '/';
+
+    bool fresh = tWritten.insert(path).second;
+    File logFile = SD.open(path, fresh ? FILE_WRITE : FILE_APPEND);
+    if (!logFile)
+    {
+        return;
+    }
+    if (fresh)
+    {
+        logFile.println(header);
+    }
+    logFile.println(line);
+    logFile.close();
+}
+
+/******************************************************
+ * @brief append a line through a stream of the SD
+ *        logger, the file replaced at its first line of
+ *        the run as by vHostSim_appendFile()
+ ******************************************************/
+static void vHostSim_appendStream(sdLogStream_t stream, const char *path, const char *header, const char *line)
+{
+    static std::set<std::string> tWritten;
+    if (tWritten.insert(path).second)
+    {
+        SD.remove(path);
+    }
+    bHalSdLog_append(stream, path, header, line);
+}
+
+/******************************************************
+ * @brief append a line to a daily log of the card
+ ******************************************************/
+void vHostSim_appendLog(time_t recordedAt, const char *suffix, const char *header, const char *line)
+{
+    char path[HOST_CSV_PATH_LEN];
+    vHostCsv_logPath(recordedAt, suffix, path, sizeof(path));
+    vHostSim_appendFile(path, header, line);
+}
+
+/******************************************************
+ * @brief the daily record file, in the format of the
+ *        real vHalSdcard_logToSD()
+ ******************************************************/
+void vHalSdcard_logToSD(send_data_t *data, systemData_t *p_tSysData, systemStatus_t *p_tSys, sensorData_t *p_tData, deviceNetworkInfo_t *p_tDev)
+{
+    (void)p_tSysData;
+    (void)p_tSys;
+    (void)p_tDev;
+    vHostSim_recordLog(data);
+
+    hostCsvRow_t row;
+    memset(&row, 0, sizeof(row));
+    struct tm stamp = data->sendTimeInfo;
+    row.recordedAt = timegm(&stamp);
+    row.present |= p_tData->status.BME680Sensor ? HOST_CSV_HAS_BME : 0;
+    row.present |= p_tData->status.PMS5003Sensor ? HOST_CSV_HAS_PMS : 0;
+    row.present |= (p_tData->status.MICS6814Sensor || p_tData->status.MICS4514Sensor) ? HOST_CSV_HAS_MICS : 0;
+    row.present |= p_tData->status.O3Sensor ? HOST_CSV_HAS_O3 : 0;
+    row.temp = data->temp;
+    row.hum = data->hum;
+    row.pres = data->pre;
+    row.voc = data->VOC;
+    row.pm1 = data->PM1;
+    row.pm25 = data->PM25;
+    row.pm10 = data->PM10;
+    row.no2 = data->MICS_NO2;
+    row.co = data->MICS_CO;
+    row.nh3 = data->MICS_NH3;
+    row.o3 = data->ozone;
+    row.msp = data->MSP;
+
+    char line[HOST_CSV_LINE_LEN];
+    ulHostCsv_formatRecord(&row, line, sizeof(line));
+    char path[HOST_CSV_PATH_LEN];
+    vHostCsv_logPath(row.recordedAt, "", path, sizeof(path));
+    vHostSim_appendStream(SDLOG_STREAM_RECORDS, path, CSV_HEADER, line);
+}
+
+/******************************************************
+ * @brief the monthly latency file, in the format of
+ *        the real vHalSdcard_logLatencySummary()
+ ******************************************************/
+void vHalSdcard_logLatencySummary(void)
+{
+    const struct tm *p_tDay = p_tMspLatency_day();
+    char path[HOST_CSV_PATH_LEN + sizeof("latency.csv")];
+    snprintf(path, sizeof(path), "/%04d/%02d/latency.csv", p_tDay->tm_year + 1900, p_tDay->tm_mon + 1);
+
+    char line[LATENCY_CSV_LINE_LEN];
+    for (uint32_t i = 0; i < LATENCY_SLOT_MAX; i++)
+    {
+        latencySummary_t summary;
+        vMspLatency_getSummary((latency_slot_t)i, &summary);
+        if (summary.count != 0)
+        {
+            ulMspLatency_formatCsv((latency_slot_t)i, line, sizeof(line));
+            vHostSim_appendFile(path, LATENCY_CSV_HEADER, line);
+        }
+    }
+}
+
+/******************************************************
+ * @brief the monthly rollup file, in the format of the
+ *        real vHalSdcard_logRollup()
+ ******************************************************/
+void vHalSdcard_logRollup(const rollupRecord_t *p_tRollup)
+{
+    vHostSim_recordRollup(p_tRollup);
+
+    time_t start = (time_t)p_tRollup->start;
+    struct tm local;
+    localtime_r(&start, &local);
+    char path[HOST_CSV_PATH_LEN + sizeof("rollup.csv")];
+    snprintf(path, sizeof(path), "/%04d/%02d/rollup.csv", local.tm_year + 1900, local.tm_mon + 1);
+
+    char line[ROLLUP_CSV_LINE_LEN];
+    ulMspRollup_formatCsv(p_tRollup, line, sizeof(line));
+    vHostSim_appendStream(SDLOG_STREAM_ROLLUPS, path, ROLLUP_CSV_HEADER, line);
+}
+
+/******************************************************
+ * @brief the BSEC state file of the simulated card, it
+ *        outlives the run like the card outlives a
+ *        reboot
+ ******************************************************/
+static bool bHostSd_saveBlob(const char *path, const void *p_vBlob, size_t length)
+{
+    File stateFile = SD.open(path, FILE_WRITE);
+    if (!stateFile)
+    {
+        return false;
+    }
+    size_t written = stateFile.write((const uint8_t *)p_vBlob, length);
+    stateFile.close();
+    return written == length;
+}
+
+static bool bHostSd_loadBlob(const char *path, void *p_vBlob, size_t length)
+{
+    if (!SD.exists(path))
+    {
+        return false;
+    }
+    File stateFile = SD.open(path, FILE_READ);
+    if (!stateFile)
+    {
+        return false;
+    }
+    bool ok = (stateFile.size() == length) && (stateFile.read((uint8_t *)p_vBlob, length) == length);
+    stateFile.close();
+    return ok;
+}
+
+bool bHalSdcard_saveBsecState(const uint8_t *p_ucState, size_t length)
+{
+    return bHostSd_saveBlob(BSEC_STATE_PATH, p_ucState, length);
+}
+
+bool bHalSdcard_loadBsecState(uint8_t *p_ucState, size_t length)
+{
+    return bHostSd_loadBlob(BSEC_STATE_PATH, p_ucState, length);
+}
+
+bool bHalSdcard_saveMicsBaseline(const void *p_vStore, size_t length)
+{
+    return bHostSd_saveBlob(MICS_BASELINE_PATH, p_vStore, length);
+}
+
+bool bHalSdcard_loadMicsBaseline(void *p_vStore, size_t length)
+{
+    return bHostSd_loadBlob(MICS_BASELINE_PATH, p_vStore, length);
+}
+
+bool bHalSdcard_updateFromServerConfig(const String &server_json, deviceNetworkInfo_t *p_tDev, sensorData_t *p_tData, deviceMeasurement_t *pDev, systemStatus_t *p_tSys, systemData_t *p_tSysData)
+{
+    (void)server_json;
+    (void)p_tDev;
+    (void)p_tData;
+    (void)pDev;
+    (void)p_tSys;
+    (void)p_tSysData;
+    return false;
+}
+
+bool bHalSdcard_writeConfig(deviceNetworkInfo_t *p_tDev, sensorData_t *p_tData, deviceMeasurement_t *pDev, systemStatus_t *p_tSys, systemData_t *p_tSysData)
+{
+    (void)p_tDev;
+    (void)p_tData;
+    (void)pDev;
+    (void)p_tSysData;
+    return p_tSys->sdCard;
+}
+
+uint8_t vHalSdcard_periodicCheck(systemStatus_t *p_tSys, deviceNetworkInfo_t *p_tDev)
+{
+    (void)p_tDev;
+    if (p_tSys->sdCard != g_tHostSim_config.sdPresent)
+    {
+        vHalSdLog_cardChanged();
+    }
+    p_tSys->sdCard = g_tHostSim_config.sdPresent;
+    return p_tSys->sdCard;
+}
+
+//------------------------------------------------------------------------------
+// shutdown handlers
+//------------------------------------------------------------------------------
+
+#define HOST_SHUTDOWN_HANDLERS 5 // as many as ESP-IDF keeps
+
+static shutdown_handler_t pfShutdownHandlers[HOST_SHUTDOWN_HANDLERS];
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handle)
+{
+    for (int i = 0; i < HOST_SHUTDOWN_HANDLERS; i++)
+    {
+        if (pfShutdownHandlers[i] == handle)
+        {
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (pfShutdownHandlers[i] == nullptr)
+        {
+            pfShutdownHandlers[i] = handle;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+/******************************************************
+ * @brief runs the shutdown handlers in the order they
+ *        were registered, as esp_restart() does
+ ******************************************************/
+void vHostSim_shutdown(void)
+{
+    for (int i = 0; (i < HOST_SHUTDOWN_HANDLERS) && (pfShutdownHandlers[i] != nullptr); i++)
+    {
+        pfShutdownHandlers[i]();
+    }
+}
+
+//------------------------------------------------------------------------------
+// firmware update
+//------------------------------------------------------------------------------
+
+bool bHalFirmware_checkForUpdates(systemData_t *sysData, systemStatus_t *sysStatus, deviceNetworkInfo_t *devInfo)
+{
+    (void)sysData;
+    (void)sysStatus;
+    (void)devInfo;
+    delay(g_tHostSim_config.networkLatencyMs);
+    return true;
+}
+
+void vHalFirmware_printOTAInfo()
+{
+}
+
+bool bHalFirmware_validateCurrentFirmware()
+{
+    return true;
+}
+
+bool bHalFirmware_checkAndApplyPendingUpdate(const char *firmwarePath)
+{
+    (void)firmwarePath;
+    return false;
+}
@@ -0,0 +1,828 @@
+/******************************************************************************
+ * @file    host_sim.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host simulation driver: runs setup() and loop() of the firmware
+ *          as the loop task, next to the real network and display tasks,
+ *          against the simulated peripherals and the virtual clock, then
+ *          reports the boundary alignment of the records, what reached the
+ *          upload server and the RTOS counters.
+ *
+ *          Usage: host-sim [--days N | --hours N] [--start "YYYY-MM-DD HH:MM:SS"]
+ *                          [--interval MIN] [--sampling-period S]
+ *                          [--gas mics6814|mics4514]
+ *                          [--seed N] [--fail-bme R] [--fail-pms R]
+ *                          [--fail-mics R] [--fail-o3 R] [--fail-net R]
+ *                          [--pms-glitch R] [--o3-noise LSB] [--o3-hum LSB]
+ *                          [--aggregation CHANNEL=mean|median|trimmed]
+ *                          [--no-bme] [--no-pms] [--no-mics] [--no-o3]
+ *                          [--no-sd] [--rtos deterministic|concurrent]
+ *                          [--time-scale N] [--sd-root DIR]
+ *                          [--upload-latency] [--mics-baseline off|propose|apply]
+ *                          [--mics-baseline-days N] [--mics-drift PCT]
+ *                          [--raw-dump HOURS]
+ *                          [--log-level 0..5] [--strict]
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// the sketch is built in this translation unit so the driver can observe its state
+#include "../../msp-firmware.ino"
+
+#include <vector>
+#include <map>
+#include <set>
+#include <pthread.h>
+#include <unistd.h>
+#include "host_sim.h"
+
+#define HOST_SIM_DEFAULT_DAYS 14
+#define HOST_SIM_DEFAULT_INTERVAL 5
+#define HOST_SIM_DEFAULT_SEED 12345
+#define HOST_SIM_DEFAULT_TIME_SCALE 100
+#define HOST_SIM_US_PER_SEC 1000000ULL
+
+hostSimConfig_t g_tHostSim_config = {
+    true,                     // sdPresent
+    true,                     // bmePresent
+    true,                     // pmsPresent
+    true,                     // micsPresent
+    true,                     // o3Present
+    GAS_SENSOR_MICS6814,      // gasSensorType
+    HOST_SIM_DEFAULT_INTERVAL, // avgMeasurements
+    SEC_IN_MIN,               // samplingPeriod
+    false,                    // uploadLatency
+    {},                       // aggregation, all STATS_METHOD_MEAN
+    MICS_BASELINE_PROPOSE,    // micsBaselineMode
+    MICS_BASELINE_DEFAULT_UPDATE_DAYS, // micsBaselineDays
+    0.0f,                     // bmeFailRate
+    0.0f,                     // pmsFailRate
+    0.0f,                     // micsFailRate
+    0.0f,                     // o3FailRate
+    0.0f,                     // pmsGlitchRate
+    0.0f,                     // micsDriftPct
+    4.0f,                     // o3NoiseLsb
+    0.0f,                     // o3HumLsb
+    900,                      // pmsFramePeriodMs
+    2000,                     // networkLatencyMs
+    400,                      // serverResponseMs
+    0.0f,                     // netFailRate
+    0.0f,                     // rawDumpHours
+    HOST_RTOS_DETERMINISTIC,  // rtosMode
+    HOST_SIM_DEFAULT_TIME_SCALE, // timeScale
+    HOST_SIM_DEFAULT_SEED,    // seed
+};
+
+// -- run report --
+typedef struct
+{
+    time_t epoch;        /*!< timestamp of the record */
+    int32_t samples;     /*!< measurements averaged in the record */
+    uint64_t producedUs; /*!< virtual time the loop task handed it over */
+    uint16_t periods;    /*!< sampling periods of the interval */
+    uint16_t minCovered; /*!< fewest periods with a sample, over the channels read */
+} hostSendRecord_t;
+
+typedef struct
+{
+    std::vector<hostSendRecord_t> sends;
+    std::map<time_t, uint32_t> uploads; /*!< records received by the server, by timestamp */
+    uint32_t uploadCount;
+    uint64_t uploadLatencyUs;
+    uint64_t maxUploadLatencyUs;
+    uint64_t firstUploadUs;       /*!< virtual time of the first record received, from boot */
+    uint32_t reads;
+    uint32_t sameSlotReads;       /*!< a second sample taken in the same sampling period */
+    uint32_t missedSlots;         /*!< sampling periods without a sample once the cycle is running */
+    uint64_t maxReadUs;           /*!< longest SYS_STATE_READ_SENSORS iteration */
+    uint64_t totalReadUs;
+    uint32_t o3Samples;           /*!< ozone samples compared with the synthetic level */
+    double o3Error;
+    double o3SquaredError;
+    double o3MaxError;
+    double pmCycleSum;            /*!< synthetic PM2.5 at the samples of the current cycle */
+    uint32_t pmCycleSamples;
+    uint32_t pmRecords;           /*!< PM2.5 records compared with the synthetic level of their samples */
+    double pmError;
+    double pmSquaredError;
+    double pmMaxError;
+    time_t lastReadSlot;
+    uint32_t loopIterations;
+    std::map<uint32_t, sensorSample_t> rawSamples; /*!< samples taken, to check a raw dump against */
+    bool rawRequested;
+    uint32_t rawFrom;
+    uint32_t rawTo;
+    uint32_t rawChunks;
+    uint32_t rawReceived;
+    uint32_t rawMismatched;   /*!< samples not as taken, beyond the rounding of the fixed point */
+    double rawMaxSteps;       /*!< largest error, in steps of the fixed point */
+    std::vector<rollupRecord_t> rollups[ROLLUP_LEVEL_MAX]; /*!< rollups logged, by level */
+    std::set<std::pair<uint32_t, uint32_t> > rollupUploads; /*!< (seconds, start) of the rollups received */
+} hostSimReport_t;
+
+static hostSimReport_t tReport;
+static pthread_mutex_t tReportLock = PTHREAD_MUTEX_INITIALIZER; /*!< the network task reports too */
+static time_t tStartEpoch = 0;
+static uint64_t ullRunUs = 0;
+static bool bStrict = false;
+
+/******************************************************
+ * @brief a record leaves the measurement cycle: the
+ *        loop task logs it to SD right before queueing
+ ******************************************************/
+void vHostSim_recordLog(const send_data_t *p_tData)
+{
+    struct tm stamp = p_tData->sendTimeInfo;
+    hostSendRecord_t record;
+    record.epoch = mktime(&stamp);
+    record.samples = measStat.measurement_count;
+    record.producedUs = ullHostClock_micros();
+    record.periods = p_tData->periods;
+    record.minCovered = p_tData->periods;
+    for (int ch = 0; ch < STATS_CH_MAX; ch++)
+    {
+        if ((p_tData->covered[ch] != 0) && (p_tData->covered[ch] < record.minCovered))
+        {
+            record.minCovered = p_tData->covered[ch];
+        }
+    }
+    pthread_mutex_lock(&tReportLock);
+    tReport.sends.push_back(record);
+    if (sensorData_accumulate.status.PMS5003Sensor && (tReport.pmCycleSamples > 0))
+    {
+        double error = (double)p_tData->PM25 - tReport.pmCycleSum / tReport.pmCycleSamples;
+        tReport.pmRecords++;
+        tReport.pmError += error;
+        tReport.pmSquaredError += error * error;
+        if (fabs(error) > tReport.pmMaxError)
+        {
+            tReport.pmMaxError = fabs(error);
+        }
+    }
+    tReport.pmCycleSum = 0.0;
+    tReport.pmCycleSamples = 0;
+    pthread_mutex_unlock(&tReportLock);
+}
+
+/******************************************************
+ * @brief the upload server received a record
+ ******************************************************/
+void vHostSim_recordUpload(time_t recordedAt)
+{
+    uint64_t now = ullHostClock_micros();
+    pthread_mutex_lock(&tReportLock);
+    tReport.uploadCount++;
+    if (tReport.uploadCount == 1)
+    {
+        tReport.firstUploadUs = now;
+    }
+    tReport.uploads[recordedAt]++;
+    for (size_t i = tReport.sends.size(); i > 0; i--)
+    {
+        if (tReport.sends[i - 1].epoch == recordedAt)
+        {
+            uint64_t latency = now - tReport.sends[i - 1].producedUs;
+            tReport.uploadLatencyUs += latency;
+            if (latency > tReport.maxUploadLatencyUs)
+            {
+                tReport.maxUploadLatencyUs = latency;
+            }
+            break;
+        }
+    }
+    pthread_mutex_unlock(&tReportLock);
+}
+
+/******************************************************
+ * @brief the server asks for a raw dump with the first
+ *        record past rawDumpHours of run: the last hour
+ ******************************************************/
+bool bHostSim_rawDumpRequest(uint32_t *p_ulFrom, uint32_t *p_ulTo)
+{
+    if ((g_tHostSim_config.rawDumpHours <= 0.0f) ||
+        ((double)ullHostClock_micros() < (double)g_tHostSim_config.rawDumpHours * SEC_IN_HOUR * HOST_SIM_US_PER_SEC))
+    {
+        return false;
+    }
+    pthread_mutex_lock(&tReportLock);
+    bool request = !tReport.rawRequested;
+    if (request)
+    {
+        tReport.rawRequested = true;
+        tReport.rawTo = (uint32_t)tHostClock_wallEpoch();
+        tReport.rawFrom = tReport.rawTo - SEC_IN_HOUR;
+        *p_ulFrom = tReport.rawFrom;
+        *p_ulTo = tReport.rawTo;
+    }
+    pthread_mutex_unlock(&tReportLock);
+    return request;
+}
+
+/******************************************************
+ * @brief the server received a raw sample: compared
+ *        with the one taken
+ ******************************************************/
+void vHostSim_recordRawSample(uint32_t epoch, uint16_t valid, const float *p_fValue)
+{
+    pthread_mutex_lock(&tReportLock);
+    tReport.rawReceived++;
+    std::map<uint32_t, sensorSample_t>::const_iterator it = tReport.rawSamples.find(epoch);
+    bool mismatched = (it == tReport.rawSamples.end()) || (it->second.valid != valid) || (epoch < tReport.rawFrom) ||
+                      (epoch > tReport.rawTo);
+    for (int ch = 0; !mismatched && (ch < STATS_CH_MAX); ch++)
+    {
+        if (valid & (1U << ch))
+        {
+            double step = pow(10.0, -cMspHistory_decimals((stats_channel_t)ch));
+            double steps = fabs((double)p_fValue[ch] - (double)it->second.value[ch]) / step;
+            if (steps > tReport.rawMaxSteps)
+            {
+                tReport.rawMaxSteps = steps;
+            }
+            mismatched = (steps > 0.501);
+        }
+    }
+    if (mismatched)
+    {
+        tReport.rawMismatched++;
+    }
+    pthread_mutex_unlock(&tReportLock);
+}
+
+void vHostSim_recordRawChunk(void)
+{
+    pthread_mutex_lock(&tReportLock);
+    tReport.rawChunks++;
+    pthread_mutex_unlock(&tReportLock);
+}
+
+/******************************************************
+ * @brief the loop task logged a closed rollup
+ ******************************************************/
+void vHostSim_recordRollup(const rollupRecord_t *p_tRollup)
+{
+    pthread_mutex_lock(&tReportLock);
+    tReport.rollups[p_tRollup->level].push_back(*p_tRollup);
+    pthread_mutex_unlock(&tReportLock);
+}
+
+/******************************************************
+ * @brief the upload server received a rollup
+ ******************************************************/
+void vHostSim_recordRollupUpload(uint32_t seconds, uint32_t start)
+{
+    pthread_mutex_lock(&tReportLock);
+    tReport.rollupUploads.insert(std::make_pair(seconds, start));
+    pthread_mutex_unlock(&tReportLock);
+}
+
+static void vHostSim_usage(const char *argv0)
+{
+    fprintf(stderr, "usage: %s [--days N | --hours N] [--start \"YYYY-MM-DD HH:MM:SS\"] [--interval MIN] [--sampling-period S]\n"
+                    "       [--gas mics6814|mics4514] [--seed N] [--fail-bme R] [--fail-pms R] [--fail-mics R]\n"
+                    "       [--fail-o3 R] [--fail-net R] [--pms-glitch R] [--o3-noise LSB] [--o3-hum LSB]\n"
+                    "       [--aggregation CHANNEL=mean|median|trimmed] (CHANNEL: upload field name or all)\n"
+                    "       [--no-bme] [--no-pms] [--no-mics] [--no-o3] [--no-sd]\n"
+                    "       [--rtos deterministic|concurrent] [--time-scale N] [--sd-root DIR]\n"
+                    "       [--upload-latency] [--mics-baseline off|propose|apply] [--mics-baseline-days N]\n"
+                    "       [--mics-drift PCT] [--raw-dump HOURS] [--log-level 0..5] [--strict]\n",
+            argv0);
+}
+
+/******************************************************
+ * @brief write the sample just taken to the raw log,
+ *        from the sample just pushed and the growth of the
+ *        failure counters and MICS4514 accumulators
+ ******************************************************/
+static void vHostSim_logSample(int32_t countBefore, time_t readEpoch, const errorVars_t *p_tErrBefore,
+                               const MICS4514AdcAccumulator_t *p_tAdcBefore)
+{
+    // the first read of a cycle starts from cleared counters
+    errorVars_t errBefore;
+    MICS4514AdcAccumulator_t adcBefore;
+    memset(&errBefore, 0, sizeof(errBefore));
+    memset(&adcBefore, 0, sizeof(adcBefore));
+    if (countBefore > 0)
+    {
+        errBefore = *p_tErrBefore;
+        adcBefore = *p_tAdcBefore;
+    }
+    else
+    {
+        pthread_mutex_lock(&tReportLock);
+        tReport.pmCycleSum = 0.0;
+        tReport.pmCycleSamples = 0;
+        pthread_mutex_unlock(&tReportLock);
+    }
+
+    // readings of the sample, the channels it lacks left at zero
+    sensorData_t single;
+    memset(&single, 0, sizeof(single));
+    vMspRing_copyToData(&tSample, &single);
+
+    hostCsvRow_t row;
+    memset(&row, 0, sizeof(row));
+    struct tm stamp;
+    localtime_r(&readEpoch, &stamp);
+    stamp.tm_sec -= stamp.tm_sec % measStat.delay_between_measurements; // start of the sampling period
+    row.recordedAt = timegm(&stamp);
+    const peripheralStatus_t *p_tStatus = &sensorData_accumulate.status;
+    if (p_tStatus->BME680Sensor && (err.BMEfails == errBefore.BMEfails))
+    {
+        row.present |= HOST_CSV_HAS_BME;
+        row.temp = single.gasData.temperature;
+        row.hum = single.gasData.humidity;
+        row.pres = single.gasData.pressure;
+        row.voc = single.gasData.volatileOrganicCompounds;
+    }
+    if (p_tStatus->PMS5003Sensor && (err.PMSfails == errBefore.PMSfails))
+    {
+        row.present |= HOST_CSV_HAS_PMS;
+        row.pm1 = single.airQualityData.particleMicron1;
+        row.pm25 = single.airQualityData.particleMicron25;
+        row.pm10 = single.airQualityData.particleMicron10;
+
+        // level the record of the cycle should give, glitches and fluctuations left out
+        hostEnvSample_t env;
+        vHostEnv_level(readEpoch, &env);
+        pthread_mutex_lock(&tReportLock);
+        tReport.pmCycleSum += env.pm25;
+        tReport.pmCycleSamples++;
+        pthread_mutex_unlock(&tReportLock);
+    }
+    if ((sysStat.gasSensorType == GAS_SENSOR_MICS6814) && p_tStatus->MICS6814Sensor && (err.MICSfails == errBefore.MICSfails))
+    {
+        row.present |= HOST_CSV_HAS_MICS;
+        row.no2 = single.pollutionData.nitrogenDioxide;
+        row.co = single.pollutionData.carbonMonoxide;
+        row.nh3 = single.pollutionData.ammonia;
+    }
+    if ((sysStat.gasSensorType == GAS_SENSOR_MICS4514) && p_tStatus->MICS4514Sensor && (err.MICSfails == errBefore.MICSfails))
+    {
+        row.present |= HOST_CSV_HAS_MICS_ADC;
+        row.micsOx = (uint16_t)(sensorData_accumulate.mics4514AdcAccumulator.oxVoltageSum - adcBefore.oxVoltageSum);
+        row.micsRed = (uint16_t)(sensorData_accumulate.mics4514AdcAccumulator.redVoltageSum - adcBefore.redVoltageSum);
+    }
+    if (p_tStatus->O3Sensor && (err.O3fails == errBefore.O3fails))
+    {
+        row.present |= HOST_CSV_HAS_O3;
+        row.o3 = single.ozoneData.ozone;
+
+        // what the filtered ADC level gives against the level fed to the ADC model
+        hostEnvSample_t env;
+        vHostEnv_sample(readEpoch, &env);
+        double error = (double)row.o3 - (double)env.o3Ugm3;
+        tReport.o3Samples++;
+        tReport.o3Error += error;
+        tReport.o3SquaredError += error * error;
+        if (fabs(error) > tReport.o3MaxError)
+        {
+            tReport.o3MaxError = fabs(error);
+        }
+    }
+
+    char line[HOST_CSV_LINE_LEN];
+    ulHostCsv_formatSample(&row, line, sizeof(line));
+    vHostSim_appendLog(row.recordedAt, HOST_CSV_RAW_SUFFIX, HOST_CSV_RAW_HEADER, line);
+
+    if (g_tHostSim_config.rawDumpHours > 0.0f)
+    {
+        pthread_mutex_lock(&tReportLock);
+        tReport.rawSamples[tSample.epoch] = tSample;
+        pthread_mutex_unlock(&tReportLock);
+    }
+}
+
+/******************************************************
+ * @brief observe one loop() iteration
+ ******************************************************/
+static void vHostSim_observe(uint8_t stateBefore, int32_t countBefore, uint64_t startUs, const errorVars_t *p_tErrBefore,
+                             const MICS4514AdcAccumulator_t *p_tAdcBefore)
+{
+    if (stateBefore != SYS_STATE_READ_SENSORS)
+    {
+        return;
+    }
+    uint64_t elapsed = ullHostClock_micros() - startUs;
+    if (measStat.measurement_count <= countBefore)
+    {
+        return; // target already reached, nothing sampled
+    }
+    vHostSim_logSample(countBefore, (time_t)(tHostClock_wallEpoch() - (time_t)(elapsed / HOST_SIM_US_PER_SEC)), p_tErrBefore,
+                       p_tAdcBefore);
+    tReport.reads++;
+    tReport.totalReadUs += elapsed;
+    if (elapsed > tReport.maxReadUs)
+    {
+        tReport.maxReadUs = elapsed;
+    }
+    time_t readEpoch = (time_t)(tHostClock_wallEpoch() - (time_t)(elapsed / HOST_SIM_US_PER_SEC));
+    time_t slot = readEpoch / measStat.delay_between_measurements;
+    if (tReport.lastReadSlot != 0)
+    {
+        if (slot == tReport.lastReadSlot)
+        {
+            tReport.sameSlotReads++;
+        }
+        else if (slot > tReport.lastReadSlot + 1)
+        {
+            tReport.missedSlots += (uint32_t)(slot - tReport.lastReadSlot - 1);
+            log_w("no sample for %ld period(s) before minute %ld", (long)(slot - tReport.lastReadSlot - 1),
+                  (long)((readEpoch / SEC_IN_MIN) % MIN_IN_HOUR));
+        }
+    }
+    tReport.lastReadSlot = slot;
+}
+
+/******************************************************
+ * @brief print the report, returns the anomaly count;
+ *        called at the end of the run by the scheduler
+ ******************************************************/
+static uint32_t ulHostSim_report(void)
+{
+    int32_t interval = g_tHostSim_config.avgMeasurements;
+    int32_t period = (measStat.delay_between_measurements > 0) ? measStat.delay_between_measurements : SEC_IN_MIN;
+    uint64_t runUs = ullHostClock_micros();
+    uint32_t misaligned = 0;
+    uint32_t gaps = 0;
+    uint32_t duplicates = 0;
+    uint32_t shortRecords = 0;
+    uint32_t received = 0;
+    uint32_t lost = 0;
+    uint32_t pending = 0;
+    uint32_t serverDuplicates = 0;
+
+    pthread_mutex_lock(&tReportLock);
+    for (size_t i = 0; i < tReport.sends.size(); i++)
+    {
+        struct tm stamp;
+        localtime_r(&tReport.sends[i].epoch, &stamp);
+        if (tReport.uploads.count(tReport.sends[i].epoch))
+        {
+            received++;
+        }
+        else if (tReport.sends[i].producedUs + MIN_TO_SEC(interval) * HOST_SIM_US_PER_SEC > runUs)
+        {
+            pending++; // still on its way when the run ended
+        }
+        else
+        {
+            lost++;
+            log_w("record of %02d:%02d never reached the server", stamp.tm_hour, stamp.tm_min);
+        }
+        if ((stamp.tm_min % interval) != 0)
+        {
+            misaligned++;
+            log_w("misaligned record at %02d:%02d", stamp.tm_hour, stamp.tm_min);
+        }
+        if (i == 0)
+        {
+            continue; // the first cycle after boot is shorter by design
+        }
+        time_t delta = tReport.sends[i].epoch - tReport.sends[i - 1].epoch;
+        if (delta < (time_t)MIN_TO_SEC(interval))
+        {
+            duplicates++;
+            log_w("duplicate record at %02d:%02d (%lds after the previous)", stamp.tm_hour, stamp.tm_min, (long)delta);
+        }
+        else if (delta > (time_t)MIN_TO_SEC(interval))
+        {
+            gaps++;
+            log_w("gap before %02d:%02d (%lds after the previous)", stamp.tm_hour, stamp.tm_min, (long)delta);
+        }
+        if (tReport.sends[i].samples != (int32_t)(MIN_TO_SEC(interval) / period))
+        {
+            shortRecords++;
+        }
+    }
+    for (std::map<time_t, uint32_t>::const_iterator it = tReport.uploads.begin(); it != tReport.uploads.end(); ++it)
+    {
+        serverDuplicates += it->second - 1;
+    }
+
+    uint32_t expected = (uint32_t)(runUs / HOST_SIM_US_PER_SEC / MIN_TO_SEC(interval));
+    char startText[32];
+    struct tm startTm;
+    localtime_r(&tStartEpoch, &startTm);
+    strftime(startText, sizeof(startText), "%Y-%m-%d %H:%M:%S", &startTm);
+
+    printf("\n==== HOST SIMULATION REPORT ====\n");
+    printf("start            : %s, %.1f h, interval %d min, sampling every %d s\n", startText,
+           (double)runUs / HOST_SIM_US_PER_SEC / SEC_IN_HOUR, interval, period);
+    printf("loop iterations  : %u\n", tReport.loopIterations);
+    printf("records produced : %zu (expected ~%u)\n", tReport.sends.size(), expected);
+    printf("misaligned       : %u\n", misaligned);
+    printf("gaps             : %u\n", gaps);
+    printf("duplicates       : %u\n", duplicates);
+    printf("wrong sample cnt : %u\n", shortRecords);
+    printf("sensor reads     : %u, same-period: %u, missed periods: %u\n", tReport.reads, tReport.sameSlotReads, tReport.missedSlots);
+    printf("read duration    : avg %.1f ms, max %.1f ms\n",
+           tReport.reads ? (double)tReport.totalReadUs / tReport.reads / 1000.0 : 0.0, (double)tReport.maxReadUs / 1000.0);
+    if (g_tHostSim_config.pmsPresent)
+    {
+        printf("pms5003 laser on : %.1f %% of the run\n", runUs ? 100.0 * (double)ullHostSensors_pmsAwakeUs() / (double)runUs : 0.0);
+    }
+    if (tReport.o3Samples)
+    {
+        printf("o3 vs synthetic  : bias %+.2f ug/m3, rms %.2f ug/m3, max %.2f ug/m3 over %u samples\n",
+               tReport.o3Error / tReport.o3Samples, sqrt(tReport.o3SquaredError / tReport.o3Samples), tReport.o3MaxError,
+               tReport.o3Samples);
+    }
+    if (tReport.pmRecords)
+    {
+        printf("pm2.5 vs synthetic: bias %+.2f ug/m3, rms %.2f ug/m3, max %.2f ug/m3 over %u records\n",
+               tReport.pmError / tReport.pmRecords, sqrt(tReport.pmSquaredError / tReport.pmRecords), tReport.pmMaxError,
+               tReport.pmRecords);
+    }
+    uint32_t uncovered = 0;
+    uint32_t lowest = 0;
+    for (size_t i = 0; i < tReport.sends.size(); i++)
+    {
+        const hostSendRecord_t *p_tSend = &tReport.sends[i];
+        if (p_tSend->minCovered < p_tSend->periods)
+        {
+            uncovered++;
+            if ((uncovered == 1) || (p_tSend->minCovered * tReport.sends[lowest].periods < tReport.sends[lowest].minCovered * p_tSend->periods))
+            {
+                lowest = (uint32_t)i;
+            }
+        }
+    }
+    if (uncovered)
+    {
+        printf("coverage         : %u records not fully covered, lowest %u of %u periods\n", uncovered,
+               tReport.sends[lowest].minCovered, tReport.sends[lowest].periods);
+    }
+    printf("uploads          : %u received, %u records, %u server duplicates, %u lost, %u pending\n", tReport.uploadCount, received,
+           serverDuplicates, lost, pending);
+    printf("upload latency   : avg %.2f s, max %.2f s\n",
+           tReport.uploadCount ? (double)tReport.uploadLatencyUs / tReport.uploadCount / HOST_SIM_US_PER_SEC : 0.0,
+           (double)tReport.maxUploadLatencyUs / HOST_SIM_US_PER_SEC);
+    printf("first upload     : %.1f s after boot\n", (double)tReport.firstUploadUs / HOST_SIM_US_PER_SEC);
+    if (tReport.rawRequested)
+    {
+        uint32_t inWindow = 0;
+        for (std::map<uint32_t, sensorSample_t>::const_iterator it = tReport.rawSamples.lower_bound(tReport.rawFrom);
+             (it != tReport.rawSamples.end()) && (it->first <= tReport.rawTo); ++it)
+        {
+            inWindow++;
+        }
+        printf("raw dump         : %u of %u samples in %u chunks, %u mismatched, max error %.2f steps\n", tReport.rawReceived,
+               inWindow, tReport.rawChunks, tReport.rawMismatched, tReport.rawMaxSteps);
+    }
+    // each level follows on from the previous rollup, uploaded when its level is
+    uint32_t rollupBreaks = 0;
+    for (int level = 0; level < ROLLUP_LEVEL_MAX; level++)
+    {
+        const std::vector<rollupRecord_t> &rollups = tReport.rollups[level];
+        uint32_t partial = 0;
+        uint32_t breaks = 0;
+        uint32_t uploaded = 0;
+        for (size_t i = 0; i < rollups.size(); i++)
+        {
+            partial += (rollups[i].samples < rollups[i].periods) ? 1U : 0U;
+            breaks += ((i > 0) && (rollups[i].start != rollups[i - 1].start + rollups[i - 1].seconds)) ? 1U : 0U;
+            uploaded += tReport.rollupUploads.count(std::make_pair(rollups[i].seconds, rollups[i].start)) ? 1U : 0U;
+        }
+        if (!rollups.empty())
+        {
+            printf("rollup %-10s: %zu logged, %u uploaded, %u partial, %u breaks\n", pcMspRollup_levelName((rollupLevel_t)level),
+                   rollups.size(), uploaded, partial, breaks);
+        }
+        rollupBreaks += breaks;
+    }
+    i2cBusUsage_t busUsage;
+    vMspI2c_getTotals(&busUsage);
+    printf("i2c bus held     : sensors %.2f %%, display %.2f %%, max wait sensors %.1f ms, display %.1f ms\n",
+           fMspI2c_heldPercent(&busUsage, I2C_CLIENT_SENSORS), fMspI2c_heldPercent(&busUsage, I2C_CLIENT_DISPLAY),
+           busUsage.client[I2C_CLIENT_SENSORS].maxWaitUs / 1000.0, busUsage.client[I2C_CLIENT_DISPLAY].maxWaitUs / 1000.0);
+    printf("================================\n");
+    pthread_mutex_unlock(&tReportLock);
+
+    return misaligned + gaps + duplicates + shortRecords + tReport.sameSlotReads + tReport.missedSlots + serverDuplicates + lost +
+           tReport.rawMismatched + rollupBreaks;
+}
+
+/******************************************************
+ * @brief end of the run, from whichever task ends it
+ ******************************************************/
+static void vHostSim_finish(const char *reason)
+{
+    printf("\nrun ended: %s, firmware state %d\n", reason, mainStateMachine.current_state);
+    uint32_t anomalies = ulHostSim_report();
+    vHostRtos_report();
+    fflush(stdout);
+    _exit((bStrict && anomalies) ? 1 : 0);
+}
+
+int main(int argc, char **argv)
+{
+    double hours = HOST_SIM_DEFAULT_DAYS * 24.0;
+    const char *start = (strlen(FAKE_NTP_TIME) > 0) ? FAKE_NTP_TIME : HOST_SIM_DEFAULT_START;
+    const char *sdRoot = "var/host/sdcard";
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if ((strcmp(arg, "--days") == 0) && value)
+        {
+            hours = atof(argv[++i]) * 24.0;
+        }
+        else if ((strcmp(arg, "--hours") == 0) && value)
+        {
+            hours = atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--start") == 0) && value)
+        {
+            start = argv[++i];
+        }
+        else if ((strcmp(arg, "--interval") == 0) && value)
+        {
+            g_tHostSim_config.avgMeasurements = atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--sampling-period") == 0) && value)
+        {
+            g_tHostSim_config.samplingPeriod = atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--gas") == 0) && value)
+        {
+            g_tHostSim_config.gasSensorType = (strcmp(argv[++i], "mics4514") == 0) ? GAS_SENSOR_MICS4514 : GAS_SENSOR_MICS6814;
+        }
+        else if ((strcmp(arg, "--seed") == 0) && value)
+        {
+            g_tHostSim_config.seed = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        }
+        else if ((strcmp(arg, "--fail-bme") == 0) && value)
+        {
+            g_tHostSim_config.bmeFailRate = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--fail-pms") == 0) && value)
+        {
+            g_tHostSim_config.pmsFailRate = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--fail-mics") == 0) && value)
+        {
+            g_tHostSim_config.micsFailRate = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--fail-o3") == 0) && value)
+        {
+            g_tHostSim_config.o3FailRate = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--pms-glitch") == 0) && value)
+        {
+            g_tHostSim_config.pmsGlitchRate = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--aggregation") == 0) && value)
+        {
+            if (!bHostSim_parseAggregation(argv[++i], g_tHostSim_config.aggregation))
+            {
+                vHostSim_usage(argv[0]);
+                return 2;
+            }
+        }
+        else if ((strcmp(arg, "--o3-noise") == 0) && value)
+        {
+            g_tHostSim_config.o3NoiseLsb = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--o3-hum") == 0) && value)
+        {
+            g_tHostSim_config.o3HumLsb = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--fail-net") == 0) && value)
+        {
+            g_tHostSim_config.netFailRate = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--rtos") == 0) && value)
+        {
+            g_tHostSim_config.rtosMode = (strcmp(argv[++i], "concurrent") == 0) ? HOST_RTOS_CONCURRENT : HOST_RTOS_DETERMINISTIC;
+        }
+        else if ((strcmp(arg, "--time-scale") == 0) && value)
+        {
+            g_tHostSim_config.timeScale = (uint32_t)strtoul(argv[++i], nullptr, 0);
+        }
+        else if (strcmp(arg, "--no-bme") == 0)
+        {
+            g_tHostSim_config.bmePresent = false;
+        }
+        else if (strcmp(arg, "--no-pms") == 0)
+        {
+            g_tHostSim_config.pmsPresent = false;
+        }
+        else if (strcmp(arg, "--no-mics") == 0)
+        {
+            g_tHostSim_config.micsPresent = false;
+        }
+        else if (strcmp(arg, "--no-o3") == 0)
+        {
+            g_tHostSim_config.o3Present = false;
+        }
+        else if (strcmp(arg, "--no-sd") == 0)
+        {
+            g_tHostSim_config.sdPresent = false;
+        }
+        else if (strcmp(arg, "--upload-latency") == 0)
+        {
+            g_tHostSim_config.uploadLatency = true;
+        }
+        else if ((strcmp(arg, "--mics-baseline") == 0) && value)
+        {
+            micsBaselineMode_t mode;
+            if (!bMspBaseline_parseMode(argv[++i], &mode))
+            {
+                vHostSim_usage(argv[0]);
+                return 2;
+            }
+            g_tHostSim_config.micsBaselineMode = (uint8_t)mode;
+        }
+        else if ((strcmp(arg, "--mics-baseline-days") == 0) && value)
+        {
+            g_tHostSim_config.micsBaselineDays = (uint8_t)atoi(argv[++i]);
+        }
+        else if ((strcmp(arg, "--mics-drift") == 0) && value)
+        {
+            g_tHostSim_config.micsDriftPct = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--raw-dump") == 0) && value)
+        {
+            g_tHostSim_config.rawDumpHours = (float)atof(argv[++i]);
+        }
+        else if ((strcmp(arg, "--sd-root") == 0) && value)
+        {
+            sdRoot = argv[++i];
+        }
+        else if ((strcmp(arg, "--log-level") == 0) && value)
+        {
+            g_iHostLog_level = atoi(argv[++i]);
+        }
+        else if (strcmp(arg, "--strict") == 0)
+        {
+            bStrict = true;
+        }
+        else
+        {
+            vHostSim_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    vHostClock_init(0);
+    if (!bHostClock_parseStart(start, &tStartEpoch) || (g_tHostSim_config.avgMeasurements <= 0) || (hours <= 0.0) ||
+        (g_tHostSim_config.timeScale == 0))
+    {
+        vHostSim_usage(argv[0]);
+        return 2;
+    }
+    vHostClock_init(tStartEpoch);
+    vHostSim_seed(g_tHostSim_config.seed);
+    vHostFs_setRoot(sdRoot);
+    vHostSensors_attach();
+
+    // this thread becomes the Arduino loop task, setup() starts the other tasks
+    ullRunUs = (uint64_t)(hours * SEC_IN_HOUR * HOST_SIM_US_PER_SEC);
+    vHostRtos_start(ullRunUs, vHostSim_finish);
+    setup();
+
+    int stallState = -1; /*!< state where a run of iterations without time passing began */
+    for (;;)
+    {
+        uint8_t stateBefore = mainStateMachine.current_state;
+        int32_t countBefore = measStat.measurement_count;
+        uint64_t startUs = ullHostClock_micros();
+        errorVars_t errBefore = err;
+        MICS4514AdcAccumulator_t adcBefore = sensorData_accumulate.mics4514AdcAccumulator;
+
+        loop();
+        tReport.loopIterations++;
+        vHostSim_observe(stateBefore, countBefore, startUs, &errBefore, &adcBefore);
+
+        // a busy loop polling the clock, possibly through several states: once it
+        // comes back to where it started skip to the next second, where the result can change
+        if (ullHostClock_micros() != startUs)
+        {
+            stallState = -1;
+        }
+        else
+        {
+            if (stallState < 0)
+            {
+                stallState = stateBefore;
+            }
+            if ((mainStateMachine.current_state == stateBefore) || (mainStateMachine.current_state == stallState))
+            {
+                vHostRtos_sleepUntil((startUs / HOST_SIM_US_PER_SEC + 1) * HOST_SIM_US_PER_SEC);
+                stallState = -1;
+            }
+        }
+
+        if (ullHostClock_micros() >= ullRunUs)
+        {
+            // the handlers of a restart (SD log, BSEC state); the finish hook holds the kernel lock
+            vHostRtos_holdEnd();
+            vHostSim_shutdown();
+            vHostRtos_finish("end of run");
+        }
+    }
+}
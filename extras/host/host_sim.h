@@ -0,0 +1,211 @@
+/******************************************************************************
+ * @file    host_sim.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host simulation of the Milano Smart Park firmware: virtual clock,
+ *          synthetic environment, fault injection and run report.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+// -- includes --
+#include "shared_values.h"
+#include "rollup.h"
+
+#define HOST_SIM_DEFAULT_START "2025-01-15 23:59:30" /*!< FAKE_NTP_TIME format */
+#define HOST_SIM_WIFI_SSID "host-sim"                  /*!< access point of the simulated network */
+
+typedef enum
+{
+    HOST_RTOS_DETERMINISTIC, /*!< one task at a time on the virtual clock, reproducible */
+    HOST_RTOS_CONCURRENT     /*!< parallel host threads on a scaled real time clock */
+} hostRtosMode_t;
+
+// -- simulation configuration --
+typedef struct
+{
+    // simulated hardware population
+    bool sdPresent;
+    bool bmePresent;
+    bool pmsPresent;
+    bool micsPresent;
+    bool o3Present;
+    uint8_t gasSensorType;   /*!< GAS_SENSOR_MICS6814 or GAS_SENSOR_MICS4514 */
+    int avgMeasurements;     /*!< average_measurements of the simulated config file */
+    int samplingPeriod;      /*!< sampling_period of the simulated config file, seconds */
+    bool uploadLatency;      /*!< upload_latency of the simulated config file */
+    uint8_t aggregation[STATS_CH_MAX]; /*!< aggregation of the simulated config file, statsMethod_t per channel */
+    uint8_t micsBaselineMode;          /*!< mics_baseline of the simulated config file, micsBaselineMode_t */
+    uint8_t micsBaselineDays;          /*!< mics_baseline_days of the simulated config file */
+
+    // fault injection, probability of failure per sensor transaction
+    float bmeFailRate;
+    float pmsFailRate;
+    float micsFailRate;
+    float o3FailRate;
+    float pmsGlitchRate; /*!< probability of a PMS5003 frame with a valid checksum and a burst reading */
+    float micsDriftPct;  /*!< MICS Rs drift since boot, percent per day */
+
+    // analog front end of the ZE25-O3 input
+    float o3NoiseLsb; /*!< white noise, peak to peak ADC points */
+    float o3HumLsb;   /*!< 50 Hz mains pickup amplitude, ADC points */
+
+    // timing model
+    uint32_t pmsFramePeriodMs; /*!< PMS5003 active mode frame period */
+    uint32_t networkLatencyMs; /*!< time taken by the network to connect or sync */
+    uint32_t serverResponseMs; /*!< upload server round trip */
+    float netFailRate;         /*!< probability of failure per server connection */
+    float rawDumpHours;        /*!< run time after which the server asks for the last hour of raw samples, 0 = never */
+
+    // scheduler
+    hostRtosMode_t rtosMode;
+    uint32_t timeScale; /*!< concurrent mode: virtual seconds per real second */
+
+    uint32_t seed;
+} hostSimConfig_t;
+
+extern hostSimConfig_t g_tHostSim_config;
+
+// -- synthetic environment --
+typedef struct
+{
+    float temperature; /*!< C */
+    float humidity;    /*!< % */
+    float pressurePa;  /*!< station pressure, Pa */
+    float gasOhm;      /*!< BME680 gas resistance, Ohm */
+    float pm1;         /*!< ug/m3 */
+    float pm25;        /*!< ug/m3 */
+    float pm10;        /*!< ug/m3 */
+    float redRatio;    /*!< MICS Rs/R0, reducing channel */
+    float oxRatio;     /*!< MICS Rs/R0, oxidising channel */
+    float nh3Ratio;    /*!< MICS Rs/R0, NH3 channel */
+    float o3Ugm3;      /*!< ozone seen by the ZE25-O3, ug/m3 */
+} hostEnvSample_t;
+
+void vHostEnv_sample(time_t epoch, hostEnvSample_t *p_tOut);
+void vHostEnv_level(time_t epoch, hostEnvSample_t *p_tOut); /*!< without the fluctuations, leaves the random source alone */
+
+// -- deterministic random source --
+void vHostSim_seed(uint32_t seed);
+uint32_t ulHostSim_random(void);
+float fHostSim_uniform(void);
+bool bHostSim_fault(float rate);
+
+// -- virtual clock --
+void vHostClock_init(time_t wallEpoch);
+uint64_t ullHostClock_micros(void);
+void vHostClock_advance(uint64_t us);
+void vHostClock_advanceTo(uint64_t us);
+time_t tHostClock_wallEpoch(void);
+void vHostClock_setSynced(bool synced);
+bool bHostClock_isSynced(void);
+bool bHostClock_parseStart(const char *text, time_t *p_tEpoch);
+void vHostClock_startRealTime(uint32_t scale);
+void vHostClock_realDeadline(uint64_t us, struct timespec *p_tOut);
+
+// -- simulated peripherals --
+void vHostSensors_attach(void);
+uint64_t ullHostSensors_pmsAwakeUs(void);
+
+// -- scheduler --
+typedef void (*hostRtosFinish_t)(const char *reason);
+
+void vHostRtos_start(uint64_t endUs, hostRtosFinish_t finish);
+bool bHostRtos_isRunning(void);
+void vHostRtos_busy(uint64_t us);
+void vHostRtos_sleepUntil(uint64_t us);
+void vHostRtos_finish(const char *reason);
+void vHostRtos_holdEnd(void); /*!< the run ends with vHostRtos_finish() only, not at its end time */
+void vHostRtos_nameObject(const void *handle, const char *name);
+void vHostRtos_report(void);
+
+// -- SD card CSV, shared by the simulator and the replay engine --
+#define HOST_CSV_RAW_HEADER "recordedAt;temp;hum;pres;voc;PM1;PM2_5;PM10;nox;co;nh3;o3;micsOx;micsRed"
+#define HOST_CSV_RAW_SUFFIX "_raw" /*!< raw samples of a day go to /YYYY/MM/DD_raw.csv */
+#define HOST_CSV_LINE_LEN 256
+#define HOST_CSV_PATH_LEN 32
+
+#define HOST_CSV_HAS_BME (1U << 0)
+#define HOST_CSV_HAS_PMS (1U << 1)
+#define HOST_CSV_HAS_MICS (1U << 2)     /*!< nox, co, nh3 in ug/m3 */
+#define HOST_CSV_HAS_O3 (1U << 3)
+#define HOST_CSV_HAS_MICS_ADC (1U << 4) /*!< MICS4514 OX/RED counts, raw samples only */
+#define HOST_CSV_HAS_MSP (1U << 5)
+
+typedef enum
+{
+    HOST_CSV_COL_IGNORED,
+    HOST_CSV_COL_RECORDED_AT,
+    HOST_CSV_COL_TEMP,
+    HOST_CSV_COL_HUM,
+    HOST_CSV_COL_PRES,
+    HOST_CSV_COL_VOC,
+    HOST_CSV_COL_PM1,
+    HOST_CSV_COL_PM25,
+    HOST_CSV_COL_PM10,
+    HOST_CSV_COL_NOX,
+    HOST_CSV_COL_CO,
+    HOST_CSV_COL_NH3,
+    HOST_CSV_COL_O3,
+    HOST_CSV_COL_MSP,
+    HOST_CSV_COL_MICS_OX,
+    HOST_CSV_COL_MICS_RED
+} hostCsvColumn_t;
+
+#define HOST_CSV_MAX_COLUMNS 24
+
+typedef struct
+{
+    uint8_t column[HOST_CSV_MAX_COLUMNS]; /*!< hostCsvColumn_t of each field */
+    uint8_t count;
+    bool raw; /*!< raw sample file rather than averaged records */
+} hostCsvLayout_t;
+
+// one line of a log: an averaged record or a raw per-minute sample
+typedef struct
+{
+    time_t recordedAt; /*!< wall clock time as written, read as UTC (the log has no offset) */
+    uint8_t present;   /*!< HOST_CSV_HAS_* groups holding a value */
+    float temp;
+    float hum;
+    float pres;
+    float voc;
+    int32_t pm1;
+    int32_t pm25;
+    int32_t pm10;
+    float no2;
+    float co;
+    float nh3;
+    float o3;
+    uint16_t micsOx;
+    uint16_t micsRed;
+    int8_t msp;
+} hostCsvRow_t;
+
+void vHostCsv_logPath(time_t recordedAt, const char *suffix, char *p_cOut, size_t size);
+size_t ulHostCsv_formatRecord(const hostCsvRow_t *p_tRow, char *p_cOut, size_t size);
+size_t ulHostCsv_formatSample(const hostCsvRow_t *p_tRow, char *p_cOut, size_t size);
+bool bHostCsv_parseHeader(const char *p_cLine, size_t len, hostCsvLayout_t *p_tLayout);
+bool bHostCsv_parseRow(const hostCsvLayout_t *p_tLayout, const char *p_cLine, size_t len, hostCsvRow_t *p_tRow);
+
+// -- command line, shared by the simulator and the replay engine --
+bool bHostSim_parseAggregation(const char *p_cArg, uint8_t *p_ucMethods);
+
+// -- run report hooks --
+void vHostSim_appendLog(time_t recordedAt, const char *suffix, const char *header, const char *line);
+void vHostSim_appendFile(char *path, const char *header, const char *line);
+void vHostSim_recordLog(const send_data_t *p_tData);
+void vHostSim_recordUpload(time_t recordedAt);
+bool bHostSim_rawDumpRequest(uint32_t *p_ulFrom, uint32_t *p_ulTo); /*!< once, the window the server asks for */
+void vHostSim_recordRawSample(uint32_t epoch, uint16_t valid, const float *p_fValue);
+void vHostSim_recordRawChunk(void);
+void vHostSim_recordRollup(const rollupRecord_t *p_tRollup);
+void vHostSim_recordRollupUpload(uint32_t seconds, uint32_t start);
+void vHostSim_shutdown(void); /*!< the registered shutdown handlers, at the end of the run */
+
+#endif
@@ -0,0 +1,187 @@
+/******************************************************************************
+ * @file    host_wire.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host I2C master. Transactions are routed to the simulated devices
+ *          registered with vHostI2c_attach() and charged on the virtual clock
+ *          at the configured bus frequency (9 clocks per byte).
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <Wire.h>
+#include "host_sim.h"
+
+#define HOST_I2C_ADDR_NUM 128
+#define HOST_I2C_CLOCKS_PER_BYTE 9ULL
+
+#define HOST_I2C_ERR_OK 0
+#define HOST_I2C_ERR_NACK_ADDR 2
+
+TwoWire Wire(0);
+
+static HostI2cDevice *p_tI2cDevices[HOST_I2C_ADDR_NUM] = {nullptr};
+
+void vHostI2c_attach(uint8_t address, HostI2cDevice *device)
+{
+    if (address < HOST_I2C_ADDR_NUM)
+    {
+        p_tI2cDevices[address] = device;
+    }
+}
+
+void vHostI2c_detach(uint8_t address)
+{
+    vHostI2c_attach(address, nullptr);
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency)
+{
+    (void)sda;
+    (void)scl;
+    if (frequency)
+    {
+        _frequency = frequency;
+    }
+    return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency)
+{
+    if (!frequency)
+    {
+        return false;
+    }
+    _frequency = frequency;
+    return true;
+}
+
+/******************************************************
+ * @brief bus time of a transaction: address byte plus
+ *        payload, 9 SCL periods each (8 bits + ACK)
+ ******************************************************/
+void TwoWire::chargeBusTime(size_t bytes)
+{
+    uint64_t us = ((bytes + 1) * HOST_I2C_CLOCKS_PER_BYTE * 1000000ULL) / _frequency;
+    _busyUs += us;
+    vHostClock_advance(us);
+}
+
+/******************************************************
+ * @brief the ESP32 core serialises the tasks sharing
+ *        the bus from beginTransmission() to the STOP;
+ *        a repeated start keeps the bus to the caller
+ ******************************************************/
+void TwoWire::lock()
+{
+    if (!_lock)
+    {
+        _lock = xSemaphoreCreateMutex();
+        vHostRtos_nameObject(_lock, "Wire");
+    }
+    if (_restartOwner && (_restartOwner == xTaskGetCurrentTaskHandle()))
+    {
+        return;
+    }
+    xSemaphoreTake(_lock, portMAX_DELAY);
+}
+
+void TwoWire::unlock()
+{
+    _restartOwner = nullptr;
+    xSemaphoreGive(_lock);
+}
+
+void TwoWire::beginTransmission(uint16_t address)
+{
+    lock();
+    _txAddress = address;
+    _txLength = 0;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop)
+{
+    uint8_t result = HOST_I2C_ERR_OK;
+    HostI2cDevice *device = (_txAddress < HOST_I2C_ADDR_NUM) ? p_tI2cDevices[_txAddress] : nullptr;
+    if (!device)
+    {
+        chargeBusTime(0);
+        result = HOST_I2C_ERR_NACK_ADDR;
+    }
+    else
+    {
+        chargeBusTime(_txLength);
+        device->receive(_txBuffer, _txLength);
+    }
+    _txLength = 0;
+    if (sendStop || (result != HOST_I2C_ERR_OK))
+    {
+        unlock();
+    }
+    else
+    {
+        _restartOwner = xTaskGetCurrentTaskHandle();
+    }
+    return result;
+}
+
+uint8_t TwoWire::requestFrom(uint16_t address, uint8_t size, bool sendStop)
+{
+    (void)sendStop;
+    lock();
+    _rxIndex = 0;
+    _rxLength = 0;
+    HostI2cDevice *device = (address < HOST_I2C_ADDR_NUM) ? p_tI2cDevices[address] : nullptr;
+    if (!device)
+    {
+        chargeBusTime(0);
+        unlock();
+        return 0;
+    }
+    if (size > I2C_BUFFER_LENGTH)
+    {
+        size = I2C_BUFFER_LENGTH;
+    }
+    _rxLength = device->request(_rxBuffer, size);
+    chargeBusTime(_rxLength);
+    unlock();
+    return (uint8_t)_rxLength;
+}
+
+size_t TwoWire::write(uint8_t data)
+{
+    if (_txLength >= I2C_BUFFER_LENGTH)
+    {
+        return 0;
+    }
+    _txBuffer[_txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity)
+{
+    size_t n = 0;
+    while ((n < quantity) && write(data[n]))
+    {
+        n++;
+    }
+    return n;
+}
+
+int TwoWire::available()
+{
+    return (int)(_rxLength - _rxIndex);
+}
+
+int TwoWire::read()
+{
+    return (_rxIndex < _rxLength) ? _rxBuffer[_rxIndex++] : -1;
+}
+
+int TwoWire::peek()
+{
+    return (_rxIndex < _rxLength) ? _rxBuffer[_rxIndex] : -1;
+}
@@ -0,0 +1,179 @@
+/******************************************************************************
+ * @file    Arduino.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino-ESP32 core used by the host simulation
+ *          build. Only the subset of the API used by the firmware is provided;
+ *          time is driven by the virtual clock in host_clock.cpp.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/time.h>
+#include <algorithm>
+
+#include "WString.h"
+#include "esp32-hal-log.h"
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// -- gpio --
+#define LOW 0x0
+#define HIGH 0x1
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define DISABLED 0x00
+
+#define SERIAL_8N1 0x800001c
+
+typedef enum
+{
+    ADC_0db,
+    ADC_2_5db,
+    ADC_6db,
+    ADC_11db
+} adc_attenuation_t;
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+uint16_t analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+void analogSetAttenuation(adc_attenuation_t attenuation);
+
+// -- time, backed by the virtual clock --
+unsigned long millis(void);
+unsigned long micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield(void);
+
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+void configTime(long gmtOffset_sec, int daylightOffset_sec, const char *server1, const char *server2 = nullptr, const char *server3 = nullptr);
+void configTzTime(const char *tz, const char *server1, const char *server2 = nullptr, const char *server3 = nullptr);
+
+// -- memory, the host has no PSRAM apart from the heap --
+#define MALLOC_CAP_8BIT (1U << 2)
+#define MALLOC_CAP_SPIRAM (1U << 10)
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps)
+{
+    (void)caps;
+    return malloc(size);
+}
+
+static inline void heap_caps_free(void *ptr)
+{
+    free(ptr);
+}
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+// -- serial --
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+
+    size_t print(const char *str) { return write(str); }
+    size_t print(const String &str) { return write(str.c_str()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(int n) { return print(String(n)); }
+    size_t print(unsigned int n) { return print(String(n)); }
+    size_t print(long n) { return print(String(n)); }
+    size_t print(unsigned long n) { return print(String(n)); }
+    size_t print(double n, int digits = 2) { return print(String(n, digits)); }
+    size_t println(void) { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T &value) { return print(value) + println(); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+    size_t readBytes(uint8_t *buffer, size_t length);
+    size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+    String readString();
+    String readStringUntil(char terminator);
+    void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+protected:
+    unsigned long _timeout = 1000;
+};
+
+/******************************************************
+ * @brief host UART: port 0 prints to stdout, the other
+ *        ports are fed by the simulated peripherals
+ *        registered with vHostUart_attach().
+ ******************************************************/
+class HardwareSerial : public Stream
+{
+public:
+    explicit HardwareSerial(int uart_nr) : _uart_nr(uart_nr) {}
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rxPin = -1, int8_t txPin = -1);
+    void end() {}
+    size_t setRxBufferSize(size_t new_size);
+    int available() override;
+    int read() override;
+    int peek() override;
+    using Print::write;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    operator bool() const { return true; }
+    int port() const { return _uart_nr; }
+
+private:
+    int _uart_nr;
+};
+
+extern HardwareSerial Serial;
+
+/******************************************************
+ * @brief peripheral model behind a host UART
+ ******************************************************/
+class HostUartDevice
+{
+public:
+    virtual ~HostUartDevice() {}
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void write(uint8_t c) = 0;
+    virtual void setRxBufferSize(size_t size) { (void)size; }
+};
+
+void vHostUart_attach(int uart_nr, HostUartDevice *device);
+
+#endif
@@ -0,0 +1,36 @@
+/******************************************************************************
+ * @file    Client.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino Client interface.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_CLIENT_H
+#define HOST_CLIENT_H
+
+#include <Arduino.h>
+#include "IPAddress.h"
+
+class Client : public Stream
+{
+public:
+    virtual int connect(IPAddress ip, uint16_t port) = 0;
+    virtual int connect(const char *host, uint16_t port) = 0;
+    using Print::write;
+    virtual size_t write(uint8_t c) override = 0;
+    virtual size_t write(const uint8_t *buf, size_t size) override = 0;
+    virtual int available() override = 0;
+    virtual int read() override = 0;
+    virtual int read(uint8_t *buf, size_t size) = 0;
+    virtual int peek() override = 0;
+    virtual void flush() override = 0;
+    virtual void stop() = 0;
+    virtual uint8_t connected() = 0;
+    virtual operator bool() = 0;
+};
+
+#endif
@@ -0,0 +1,60 @@
+/******************************************************************************
+ * @file    DFRobot_MICS.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the DFRobot_MICS library (SEN0377, MiCS-4514).
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_DFROBOT_MICS_H
+#define HOST_DFROBOT_MICS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define OX_MODE 0x00
+#define RED_MODE 0x01
+
+#define SLEEP_MODE 0x00
+#define WAKE_UP_MODE 0x01
+
+#define ERROR -1
+
+class DFRobot_MICS
+{
+public:
+    virtual ~DFRobot_MICS() {}
+    bool warmUpTime(uint8_t minute);
+    int16_t getADCData(uint8_t mode);
+    void sleepMode(void);
+    void wakeUpMode(void);
+    uint8_t getPowerState(void);
+
+protected:
+    virtual bool readData(uint8_t reg, uint8_t *data, uint8_t len) = 0;
+    virtual void writeData(uint8_t reg, uint8_t *data, uint8_t len) = 0;
+
+    unsigned long _warmupStartMs = 0;
+    int16_t _r0Ox = 0;  /*!< latched when the warm-up ends, as the library does */
+    int16_t _r0Red = 0;
+};
+
+class DFRobot_MICS_I2C : public DFRobot_MICS
+{
+public:
+    DFRobot_MICS_I2C(TwoWire *pWire = &Wire, uint8_t addr = 0x75) : _pWire(pWire), _addr(addr) {}
+    bool begin(void);
+
+protected:
+    bool readData(uint8_t reg, uint8_t *data, uint8_t len) override;
+    void writeData(uint8_t reg, uint8_t *data, uint8_t len) override;
+
+private:
+    TwoWire *_pWire;
+    uint8_t _addr;
+};
+
+#endif
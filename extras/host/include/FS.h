@@ -0,0 +1,87 @@
+/******************************************************************************
+ * @file    FS.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino-ESP32 FS layer, backed by a directory on
+ *          the host (see vHostFs_setRoot()).
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_FS_H
+#define HOST_FS_H
+
+#include <Arduino.h>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+struct HostFile;
+
+namespace fs
+{
+
+class File : public Stream
+{
+public:
+    File() : _impl(nullptr) {}
+    explicit File(HostFile *impl) : _impl(impl) {}
+    File(const File &other);
+    File &operator=(const File &other);
+    ~File() override;
+
+    using Print::write;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t read(uint8_t *buf, size_t size);
+    void flush() override;
+    bool seek(uint32_t pos);
+    size_t position() const;
+    size_t size() const;
+    void close();
+    operator bool() const { return _impl != nullptr; }
+    const char *name() const;
+    const char *path() const;
+    bool isDirectory(void) const;
+    File openNextFile(const char *mode = FILE_READ);
+    void rewindDirectory(void);
+
+private:
+    HostFile *_impl;
+};
+
+class FS
+{
+public:
+    File open(const char *path, const char *mode = FILE_READ, const bool create = false);
+    File open(const String &path, const char *mode = FILE_READ, const bool create = false)
+    {
+        return open(path.c_str(), mode, create);
+    }
+    bool exists(const char *path);
+    bool exists(const String &path) { return exists(path.c_str()); }
+    bool remove(const char *path);
+    bool remove(const String &path) { return remove(path.c_str()); }
+    bool rename(const char *pathFrom, const char *pathTo);
+    bool rename(const String &pathFrom, const String &pathTo) { return rename(pathFrom.c_str(), pathTo.c_str()); }
+    bool mkdir(const char *path);
+    bool mkdir(const String &path) { return mkdir(path.c_str()); }
+    bool rmdir(const char *path);
+    bool rmdir(const String &path) { return rmdir(path.c_str()); }
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+
+void vHostFs_setRoot(const char *root);
+const char *pcHostFs_root(void);
+
+#endif
@@ -0,0 +1,53 @@
+/******************************************************************************
+ * @file    HTTPClient.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino-ESP32 HTTP client, answered by the
+ *          simulated server in host_net.cpp.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_HTTPCLIENT_H
+#define HOST_HTTPCLIENT_H
+
+#include <Arduino.h>
+#include "WiFi.h"
+
+#define HTTP_CODE_OK 200
+#define HTTP_CODE_NOT_FOUND 404
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+
+class HTTPClient
+{
+public:
+    bool begin(WiFiClient &client, const String &url)
+    {
+        _client = &client;
+        _url = url;
+        return true;
+    }
+    bool begin(const String &url)
+    {
+        _client = nullptr;
+        _url = url;
+        return true;
+    }
+    void end() { _payload = ""; }
+    void setTimeout(uint16_t timeout) { _timeoutMs = timeout; }
+    void addHeader(const String &name, const String &value) { (void)name; (void)value; }
+    int GET() { return sendRequest("GET", ""); }
+    int sendRequest(const char *type, const String &payload);
+    String getString() { return _payload; }
+
+private:
+    WiFiClient *_client = nullptr;
+    String _url;
+    String _payload;
+    uint16_t _timeoutMs = 5000;
+};
+
+#endif
@@ -0,0 +1,36 @@
+/******************************************************************************
+ * @file    IPAddress.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino IPAddress class.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_IPADDRESS_H
+#define HOST_IPADDRESS_H
+
+#include <Arduino.h>
+
+class IPAddress
+{
+public:
+    IPAddress() : _addr{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _addr{a, b, c, d} {}
+    uint8_t operator[](int index) const { return _addr[index]; }
+    uint8_t &operator[](int index) { return _addr[index]; }
+    bool operator==(const IPAddress &rhs) const { return memcmp(_addr, rhs._addr, sizeof(_addr)) == 0; }
+    String toString() const
+    {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _addr[0], _addr[1], _addr[2], _addr[3]);
+        return String(buf);
+    }
+
+private:
+    uint8_t _addr[4];
+};
+
+#endif
@@ -0,0 +1,60 @@
+/******************************************************************************
+ * @file    MiCS6814-I2C.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the MiCS6814-I2C-MOD library (Grove multichannel
+ *          gas sensor).
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_MICS6814_I2C_H
+#define HOST_MICS6814_I2C_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define DATA_I2C_ADDR 0x04
+
+#define CMD_READ_R0_NH3 0x11
+#define CMD_READ_R0_RED 0x12
+#define CMD_READ_R0_OX 0x13
+#define CMD_READ_RS_NH3 0x01
+#define CMD_READ_RS_RED 0x02
+#define CMD_READ_RS_OX 0x03
+#define CMD_CONTROL_LED 0x0A
+#define CMD_CONTROL_PWR 0x0B
+#define CMD_V2_SET_R0 0x07
+
+typedef enum
+{
+    CH_NH3,
+    CH_RED,
+    CH_OX
+} channel_t;
+
+class MiCS6814
+{
+public:
+    bool begin(uint8_t address = DATA_I2C_ADDR);
+    void powerOn(void);
+    void powerOff(void);
+    void ledOn(void);
+    void ledOff(void);
+    uint16_t getBaseResistance(channel_t channel);
+    uint16_t getResistance(channel_t channel);
+    float measureCO(void);
+    float measureNO2(void);
+    float measureNH3(void);
+    void setOffsets(int16_t *offsets);
+
+private:
+    float getCurrentRatio(channel_t channel);
+
+    uint8_t _address = DATA_I2C_ADDR;
+    int16_t _offsets[3] = {0, 0, 0};
+};
+
+#endif
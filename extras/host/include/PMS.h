@@ -0,0 +1,77 @@
+/******************************************************************************
+ * @file    PMS.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host port of the fu-hsi PMS library (PMS5003 serial protocol). The
+ *          frame parser is the same as upstream; bytes come from the simulated
+ *          sensor attached to the UART.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_PMS_H
+#define HOST_PMS_H
+
+#include <Arduino.h>
+
+class PMS
+{
+public:
+    static const uint16_t SINGLE_RESPONSE_TIME = 1000;
+    static const uint16_t TOTAL_RESPONSE_TIME = 1000 * 10;
+    static const uint16_t STEADY_RESPONSE_TIME = 1000 * 30;
+
+    static const uint16_t BAUD_RATE = 9600;
+
+    struct DATA
+    {
+        // Standard Particles, CF=1
+        uint16_t PM_SP_UG_1_0;
+        uint16_t PM_SP_UG_2_5;
+        uint16_t PM_SP_UG_10_0;
+
+        // Atmospheric environment
+        uint16_t PM_AE_UG_1_0;
+        uint16_t PM_AE_UG_2_5;
+        uint16_t PM_AE_UG_10_0;
+    };
+
+    PMS(Stream &);
+    void sleep();
+    void wakeUp();
+    void activeMode();
+    void passiveMode();
+
+    void requestRead();
+    bool read(DATA &data);
+    bool readUntil(DATA &data, uint16_t timeout = SINGLE_RESPONSE_TIME);
+
+private:
+    enum STATUS
+    {
+        STATUS_WAITING,
+        STATUS_OK
+    };
+    enum MODE
+    {
+        MODE_ACTIVE,
+        MODE_PASSIVE
+    };
+
+    uint8_t _payload[12];
+    Stream *_stream;
+    DATA *_data;
+    STATUS _status;
+    MODE _mode = MODE_ACTIVE;
+
+    uint8_t _index = 0;
+    uint16_t _frameLen;
+    uint16_t _checksum;
+    uint16_t _calculatedChecksum;
+
+    void loop();
+};
+
+#endif
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * @file    SD.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino-ESP32 SD library.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_SD_H
+#define HOST_SD_H
+
+#include "FS.h"
+
+typedef enum
+{
+    CARD_NONE,
+    CARD_MMC,
+    CARD_SD,
+    CARD_SDHC,
+    CARD_UNKNOWN
+} sdcard_type_t;
+
+class SPIClass;
+
+namespace fs
+{
+
+class SDFS : public FS
+{
+public:
+    bool begin(uint8_t ssPin = 5, SPIClass *spi = nullptr, uint32_t frequency = 4000000, const char *mountpoint = "/sd",
+               uint8_t max_files = 5, bool format_if_empty = false);
+    void end();
+    sdcard_type_t cardType();
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+
+private:
+    bool _mounted = false;
+};
+
+} // namespace fs
+
+extern fs::SDFS SD;
+
+#endif
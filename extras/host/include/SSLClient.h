@@ -0,0 +1,101 @@
+/******************************************************************************
+ * @file    SSLClient.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the SSLClient (BearSSL) wrapper. Data passes through
+ *          to the underlying client unencrypted.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_SSLCLIENT_H
+#define HOST_SSLCLIENT_H
+
+#include <Arduino.h>
+#include "Client.h"
+
+// -- BearSSL trust anchor types, as used by trust_anchor.h --
+typedef struct
+{
+    unsigned char *data;
+    size_t len;
+} br_x500_name;
+
+typedef struct
+{
+    unsigned char *n;
+    size_t nlen;
+    unsigned char *e;
+    size_t elen;
+} br_rsa_public_key;
+
+typedef struct
+{
+    int curve;
+    unsigned char *q;
+    size_t qlen;
+} br_ec_public_key;
+
+typedef struct
+{
+    unsigned char key_type;
+    union
+    {
+        br_rsa_public_key rsa;
+        br_ec_public_key ec;
+    } key;
+} br_x509_pkey;
+
+typedef struct
+{
+    br_x500_name dn;
+    unsigned flags;
+    br_x509_pkey pkey;
+} br_x509_trust_anchor;
+
+#define BR_X509_TA_CA 0x0001
+#define BR_KEYTYPE_RSA 1
+#define BR_KEYTYPE_EC 2
+
+class SSLClient : public Client
+{
+public:
+    enum DebugLevel
+    {
+        SSL_NONE = 0,
+        SSL_ERROR = 1,
+        SSL_WARN = 2,
+        SSL_INFO = 3,
+        SSL_DUMP = 4,
+    };
+
+    SSLClient(Client &client, const br_x509_trust_anchor *trust_anchors, const size_t trust_anchors_num,
+              const int analog_pin, const size_t max_sessions = 1, const DebugLevel debug = SSL_WARN)
+        : _client(client)
+    {
+        (void)trust_anchors; (void)trust_anchors_num; (void)analog_pin; (void)max_sessions; (void)debug;
+    }
+
+    int connect(IPAddress ip, uint16_t port) override { return _client.connect(ip, port); }
+    int connect(const char *host, uint16_t port) override { return _client.connect(host, port); }
+    using Print::write;
+    size_t write(uint8_t c) override { return _client.write(c); }
+    size_t write(const uint8_t *buf, size_t size) override { return _client.write(buf, size); }
+    int available() override { return _client.available(); }
+    int read() override { return _client.read(); }
+    int read(uint8_t *buf, size_t size) override { return _client.read(buf, size); }
+    int peek() override { return _client.peek(); }
+    void flush() override { _client.flush(); }
+    void stop() override { _client.stop(); }
+    uint8_t connected() override { return _client.connected(); }
+    operator bool() override { return connected() != 0; }
+    void setVerificationTime(uint32_t days, uint32_t seconds) { (void)days; (void)seconds; }
+    void setMutualAuthParams(const void *params) { (void)params; }
+
+private:
+    Client &_client;
+};
+
+#endif
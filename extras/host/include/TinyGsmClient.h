@@ -0,0 +1,82 @@
+/******************************************************************************
+ * @file    TinyGsmClient.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the TinyGSM SIM800 modem driver. The simulated
+ *          units have no modem: every modem operation fails.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_TINYGSMCLIENT_H
+#define HOST_TINYGSMCLIENT_H
+
+#include <Arduino.h>
+#include "Client.h"
+
+class TinyGsm
+{
+public:
+    explicit TinyGsm(Stream &stream) : _stream(stream) {}
+    bool restart(const char *pin = nullptr) { (void)pin; delay(1000); return false; }
+    bool init(const char *pin = nullptr) { (void)pin; return false; }
+    String getModemName() { return "SIM800 (host stub)"; }
+    String getModemInfo() { return ""; }
+    String getIMEI() { return ""; }
+    String getIMSI() { return ""; }
+    String getSimCCID() { return ""; }
+    String getOperator() { return ""; }
+    int16_t getSignalQuality() { return 99; }
+    bool waitForNetwork(uint32_t timeout_ms = 60000L, bool check_signal = false)
+    {
+        (void)check_signal;
+        delay(timeout_ms);
+        return false;
+    }
+    bool isNetworkConnected() { return false; }
+    bool gprsConnect(const char *apn, const char *user = nullptr, const char *pwd = nullptr)
+    {
+        (void)apn; (void)user; (void)pwd;
+        return false;
+    }
+    bool gprsDisconnect() { return true; }
+    bool isGprsConnected() { return false; }
+    IPAddress localIP() { return IPAddress(); }
+    byte NTPServerSync(String server = "pool.ntp.org", byte TimeZone = 0)
+    {
+        (void)server; (void)TimeZone;
+        return 0;
+    }
+    bool getNetworkTime(int *year, int *month, int *day, int *hour, int *minute, int *second, float *timezone)
+    {
+        (void)year; (void)month; (void)day; (void)hour; (void)minute; (void)second; (void)timezone;
+        return false;
+    }
+
+private:
+    Stream &_stream;
+};
+
+class TinyGsmClient : public Client
+{
+public:
+    TinyGsmClient() {}
+    explicit TinyGsmClient(TinyGsm &modem, uint8_t mux = 0) { (void)modem; (void)mux; }
+    int connect(IPAddress ip, uint16_t port) override { (void)ip; (void)port; return 0; }
+    int connect(const char *host, uint16_t port) override { (void)host; (void)port; return 0; }
+    using Print::write;
+    size_t write(uint8_t c) override { (void)c; return 0; }
+    size_t write(const uint8_t *buf, size_t size) override { (void)buf; (void)size; return 0; }
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int read(uint8_t *buf, size_t size) override { (void)buf; (void)size; return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+    void stop() override {}
+    uint8_t connected() override { return 0; }
+    operator bool() override { return false; }
+};
+
+#endif
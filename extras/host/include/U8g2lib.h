@@ -0,0 +1,83 @@
+/******************************************************************************
+ * @file    U8g2lib.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the U8g2 library. Drawing is discarded; sendBuffer()
+ *          and updateDisplayArea() still move the frame bytes over the
+ *          simulated I2C bus.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_U8G2LIB_H
+#define HOST_U8G2LIB_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+typedef uint8_t u8g2_uint_t;
+
+extern const uint8_t u8g2_font_6x13_tf[];
+extern const uint8_t u8g2_font_6x13_mf[];
+extern const uint8_t u8g2_font_6x13B_tf[];
+
+#define U8X8_PIN_NONE 255
+
+typedef enum
+{
+    U8G2_R0,
+    U8G2_R1,
+    U8G2_R2,
+    U8G2_R3
+} u8g2_cb_t;
+
+class U8G2 : public Print
+{
+public:
+    U8G2(uint8_t width, uint8_t height, uint8_t i2cAddress) : _width(width), _height(height), _addr(i2cAddress) {}
+    bool begin(void);
+    void clearBuffer(void) {}
+    void sendBuffer(void);
+    void updateDisplayArea(unsigned int tx, unsigned int ty, unsigned int tw, unsigned int th);
+    uint8_t getBufferTileWidth(void) const { return (uint8_t)(_width / 8); }
+    uint8_t getBufferTileHeight(void) const { return (uint8_t)(_height / 8); }
+    void firstPage(void) {}
+    uint8_t nextPage(void) { sendBuffer(); return 0; }
+    void setFont(const uint8_t *font) { (void)font; }
+    void setCursor(u8g2_uint_t x, u8g2_uint_t y) { (void)x; (void)y; }
+    void drawStr(u8g2_uint_t x, u8g2_uint_t y, const char *s) { (void)x; (void)y; (void)s; }
+    void drawLine(u8g2_uint_t x1, u8g2_uint_t y1, u8g2_uint_t x2, u8g2_uint_t y2) { (void)x1; (void)y1; (void)x2; (void)y2; }
+    void drawXBM(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, const uint8_t *bitmap)
+    {
+        (void)x; (void)y; (void)w; (void)h; (void)bitmap;
+    }
+    void drawXBMP(u8g2_uint_t x, u8g2_uint_t y, u8g2_uint_t w, u8g2_uint_t h, const uint8_t *bitmap)
+    {
+        (void)x; (void)y; (void)w; (void)h; (void)bitmap;
+    }
+    u8g2_uint_t getDisplayWidth(void) const { return _width; }
+    u8g2_uint_t getDisplayHeight(void) const { return _height; }
+    u8g2_uint_t getStrWidth(const char *s) const { return (u8g2_uint_t)(strlen(s) * 6); }
+    using Print::write;
+    size_t write(uint8_t c) override { (void)c; return 1; }
+
+private:
+    uint8_t _width;
+    uint8_t _height;
+    uint8_t _addr;
+};
+
+class U8G2_SH1106_128X64_NONAME_F_HW_I2C : public U8G2
+{
+public:
+    U8G2_SH1106_128X64_NONAME_F_HW_I2C(u8g2_cb_t rotation, uint8_t reset = U8X8_PIN_NONE, uint8_t clock = U8X8_PIN_NONE,
+                                       uint8_t data = U8X8_PIN_NONE)
+        : U8G2(128, 64, 0x3C)
+    {
+        (void)rotation; (void)reset; (void)clock; (void)data;
+    }
+};
+
+#endif
@@ -0,0 +1,92 @@
+/******************************************************************************
+ * @file    WiFi.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino-ESP32 WiFi station API, backed by the
+ *          simulated access point in host_net.cpp.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <Arduino.h>
+#include "esp_system.h"
+#include "WiFiGeneric.h"
+#include "IPAddress.h"
+#include "Client.h"
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+class WiFiClass
+{
+public:
+    wl_status_t begin(const char *ssid, const char *passphrase = nullptr);
+    bool disconnect(bool wifioff = false, bool eraseap = false);
+    bool mode(wifi_mode_t mode);
+    wifi_mode_t getMode() const { return _mode; }
+    bool setTxPower(wifi_power_t power);
+    wl_status_t status();
+    int16_t scanNetworks(bool async = false, bool show_hidden = false);
+    String SSID(uint8_t networkItem) const;
+    String SSID() const;
+    int32_t RSSI(uint8_t networkItem) const;
+    int8_t RSSI() const;
+    IPAddress localIP() const;
+    IPAddress gatewayIP() const;
+    IPAddress dnsIP(uint8_t dns_no = 0) const;
+    int hostByName(const char *aHostname, IPAddress &aResult);
+    String macAddress() const;
+    bool setAutoReconnect(bool autoReconnect) { (void)autoReconnect; return true; }
+
+private:
+    wifi_mode_t _mode = WIFI_OFF;
+    wl_status_t _status = WL_DISCONNECTED;
+    String _ssid;
+    unsigned long _connectAtMs = 0;
+};
+
+extern WiFiClass WiFi;
+
+/******************************************************
+ * @brief plain TCP client, connected to the simulated
+ *        upload server in host_net.cpp
+ ******************************************************/
+class WiFiClient : public Client
+{
+public:
+    WiFiClient();
+    ~WiFiClient() override;
+    int connect(IPAddress ip, uint16_t port) override;
+    int connect(const char *host, uint16_t port) override;
+    using Print::write;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buf, size_t size) override;
+    int available() override;
+    int read() override;
+    int read(uint8_t *buf, size_t size) override;
+    int peek() override;
+    void flush() override {}
+    void stop() override;
+    uint8_t connected() override;
+    operator bool() override { return connected() != 0; }
+
+private:
+    struct HostSocket *_socket;
+};
+
+typedef enum
+{
+    ESP_MAC_WIFI_STA,
+    ESP_MAC_WIFI_SOFTAP,
+    ESP_MAC_BT,
+    ESP_MAC_ETH
+} esp_mac_type_t;
+
+esp_err_t esp_read_mac(uint8_t *mac, esp_mac_type_t type);
+
+#endif
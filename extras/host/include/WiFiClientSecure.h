@@ -0,0 +1,26 @@
+/******************************************************************************
+ * @file    WiFiClientSecure.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino-ESP32 TLS client (plain TCP on the host).
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_WIFICLIENTSECURE_H
+#define HOST_WIFICLIENTSECURE_H
+
+#include "WiFi.h"
+
+class WiFiClientSecure : public WiFiClient
+{
+public:
+    void setInsecure() {}
+    void setCACert(const char *rootCA) { (void)rootCA; }
+    void setTimeout(uint32_t seconds) { Stream::setTimeout(seconds * 1000UL); }
+    void setHandshakeTimeout(unsigned long handshake_timeout) { (void)handshake_timeout; }
+};
+
+#endif
@@ -0,0 +1,84 @@
+/******************************************************************************
+ * @file    Wire.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino TwoWire (I2C) driver. Transactions are
+ *          routed to the simulated devices and cost virtual bus time.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_WIRE_H
+#define HOST_WIRE_H
+
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define I2C_BUFFER_LENGTH 128
+
+/******************************************************
+ * @brief simulated I2C target
+ ******************************************************/
+class HostI2cDevice
+{
+public:
+    virtual ~HostI2cDevice() {}
+    virtual void receive(const uint8_t *data, size_t len) = 0;
+    virtual size_t request(uint8_t *data, size_t len) = 0;
+};
+
+void vHostI2c_attach(uint8_t address, HostI2cDevice *device);
+void vHostI2c_detach(uint8_t address);
+
+class TwoWire : public Stream
+{
+public:
+    explicit TwoWire(uint8_t bus_num) : _bus_num(bus_num) {}
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    bool end() { return true; }
+    bool setClock(uint32_t frequency);
+    uint32_t getClock() const { return _frequency; }
+    void setTimeOut(uint16_t timeOutMillis) { (void)timeOutMillis; }
+
+    void beginTransmission(uint16_t address);
+    uint8_t endTransmission(bool sendStop = true);
+    uint8_t requestFrom(uint16_t address, uint8_t size, bool sendStop = true);
+
+    using Print::write;
+    size_t write(uint8_t data) override;
+    size_t write(const uint8_t *data, size_t quantity) override;
+    inline size_t write(unsigned long n) { return write((uint8_t)n); }
+    inline size_t write(long n) { return write((uint8_t)n); }
+    inline size_t write(unsigned int n) { return write((uint8_t)n); }
+    inline size_t write(int n) { return write((uint8_t)n); }
+    int available() override;
+    int read() override;
+    int peek() override;
+
+    uint64_t busyMicros() const { return _busyUs; } /*!< accumulated virtual bus time */
+
+private:
+    void chargeBusTime(size_t bytes);
+    void lock();
+    void unlock();
+
+    uint8_t _bus_num;
+    uint32_t _frequency = 100000;
+    uint16_t _txAddress = 0;
+    uint8_t _txBuffer[I2C_BUFFER_LENGTH];
+    size_t _txLength = 0;
+    uint8_t _rxBuffer[I2C_BUFFER_LENGTH];
+    size_t _rxLength = 0;
+    size_t _rxIndex = 0;
+    uint64_t _busyUs = 0;
+    SemaphoreHandle_t _lock = nullptr;     /*!< bus lock, as in the ESP32 core */
+    TaskHandle_t _restartOwner = nullptr;  /*!< holder of the bus across a repeated start */
+};
+
+extern TwoWire Wire;
+
+#endif
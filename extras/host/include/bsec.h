@@ -0,0 +1,95 @@
+/******************************************************************************
+ * @file    bsec.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Bosch BSEC Arduino library. Outputs come from
+ *          the synthetic environment in host_sensors.cpp.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_BSEC_H
+#define HOST_BSEC_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define BME68X_I2C_ADDR_LOW 0x76
+#define BME68X_I2C_ADDR_HIGH 0x77
+#define BME68X_OK 0
+
+#define BSEC_SAMPLE_RATE_DISABLED 65535.0f
+#define BSEC_SAMPLE_RATE_ULP 0.0033333f
+#define BSEC_SAMPLE_RATE_CONTINUOUS 1.0f
+#define BSEC_SAMPLE_RATE_LP 0.33333f
+
+#define BSEC_MAX_STATE_BLOB_SIZE 139
+
+typedef int32_t bsec_library_return_t;
+#define BSEC_OK 0
+#define BSEC_E_DOSTEPS_INVALIDINPUT -2
+#define BSEC_W_DOSTEPS_EXCESSOUTPUTS 10
+
+typedef enum
+{
+    BSEC_OUTPUT_IAQ = 1,
+    BSEC_OUTPUT_STATIC_IAQ = 2,
+    BSEC_OUTPUT_CO2_EQUIVALENT = 3,
+    BSEC_OUTPUT_BREATH_VOC_EQUIVALENT = 4,
+    BSEC_OUTPUT_RAW_TEMPERATURE = 6,
+    BSEC_OUTPUT_RAW_PRESSURE = 7,
+    BSEC_OUTPUT_RAW_HUMIDITY = 8,
+    BSEC_OUTPUT_RAW_GAS = 9,
+    BSEC_OUTPUT_STABILIZATION_STATUS = 12,
+    BSEC_OUTPUT_RUN_IN_STATUS = 13,
+    BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE = 14,
+    BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY = 15,
+} bsec_virtual_sensor_t;
+
+typedef struct
+{
+    int major;
+    int minor;
+    int major_bugfix;
+    int minor_bugfix;
+} bsec_version_t;
+
+class Bsec
+{
+public:
+    bsec_version_t version = {1, 4, 8, 0};
+    bsec_library_return_t bsecStatus = BSEC_OK;
+    int8_t bme68xStatus = BME68X_OK;
+
+    float iaq = 0.0f;
+    float iaqAccuracy = 0.0f;
+    float staticIaq = 0.0f;
+    float co2Equivalent = 0.0f;
+    float breathVocEquivalent = 0.0f;
+    float rawTemperature = 0.0f;
+    float pressure = 0.0f;
+    float rawHumidity = 0.0f;
+    float gasResistance = 0.0f;
+    float temperature = 0.0f;
+    float humidity = 0.0f;
+    int64_t outputTimestamp = 0;
+
+    void begin(uint8_t i2cAddr, TwoWire &i2c);
+    void updateSubscription(bsec_virtual_sensor_t sensorList[], uint8_t nSensors, float sampleRate = BSEC_SAMPLE_RATE_ULP);
+    bool run(int64_t timeMilliseconds = -1);
+    void getState(uint8_t *state);
+    void setState(uint8_t *state);
+    void setConfig(const uint8_t *config) { (void)config; }
+    void setTemperatureOffset(float tempOffset) { _tempOffset = tempOffset; }
+    int64_t getTimeMs(void) { return (int64_t)millis(); }
+
+private:
+    float _sampleRate = BSEC_SAMPLE_RATE_DISABLED;
+    int64_t _nextCallMs = 0;
+    float _tempOffset = 0.0f;
+    uint32_t _runCount = 0;
+};
+
+#endif
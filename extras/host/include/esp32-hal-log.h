@@ -0,0 +1,41 @@
+/******************************************************************************
+ * @file    esp32-hal-log.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the Arduino-ESP32 log macros. The level is chosen at
+ *          run time so the simulation can stay quiet over weeks of virtual time.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_ESP32_HAL_LOG_H
+#define HOST_ESP32_HAL_LOG_H
+
+#define ARDUHAL_LOG_LEVEL_NONE (0)
+#define ARDUHAL_LOG_LEVEL_ERROR (1)
+#define ARDUHAL_LOG_LEVEL_WARN (2)
+#define ARDUHAL_LOG_LEVEL_INFO (3)
+#define ARDUHAL_LOG_LEVEL_DEBUG (4)
+#define ARDUHAL_LOG_LEVEL_VERBOSE (5)
+
+extern int g_iHostLog_level; /*!< run time log level, see ARDUHAL_LOG_LEVEL_* */
+
+void vHostLog_write(char level, const char *file, int line, const char *func, const char *format, ...)
+    __attribute__((format(printf, 5, 6)));
+
+#define HOST_LOG_AT(lvl, letter, format, ...)                                            \
+    do                                                                                   \
+    {                                                                                    \
+        if ((lvl) <= g_iHostLog_level)                                                   \
+            vHostLog_write(letter, __FILE__, __LINE__, __func__, format, ##__VA_ARGS__); \
+    } while (0)
+
+#define log_e(format, ...) HOST_LOG_AT(ARDUHAL_LOG_LEVEL_ERROR, 'E', format, ##__VA_ARGS__)
+#define log_w(format, ...) HOST_LOG_AT(ARDUHAL_LOG_LEVEL_WARN, 'W', format, ##__VA_ARGS__)
+#define log_i(format, ...) HOST_LOG_AT(ARDUHAL_LOG_LEVEL_INFO, 'I', format, ##__VA_ARGS__)
+#define log_d(format, ...) HOST_LOG_AT(ARDUHAL_LOG_LEVEL_DEBUG, 'D', format, ##__VA_ARGS__)
+#define log_v(format, ...) HOST_LOG_AT(ARDUHAL_LOG_LEVEL_VERBOSE, 'V', format, ##__VA_ARGS__)
+
+#endif
@@ -0,0 +1,27 @@
+/******************************************************************************
+ * @file    esp_sntp.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the ESP-IDF SNTP API.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_ESP_SNTP_H
+#define HOST_ESP_SNTP_H
+
+#include <stdint.h>
+
+typedef enum
+{
+    SNTP_SYNC_STATUS_RESET,
+    SNTP_SYNC_STATUS_COMPLETED,
+    SNTP_SYNC_STATUS_IN_PROGRESS
+} sntp_sync_status_t;
+
+sntp_sync_status_t sntp_get_sync_status(void);
+void sntp_set_sync_interval(uint32_t interval_ms);
+
+#endif
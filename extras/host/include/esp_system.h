@@ -0,0 +1,27 @@
+/******************************************************************************
+ * @file    esp_system.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the ESP-IDF system API: error codes and the shutdown
+ *          handlers, run by the simulation at the end of the run as
+ *          esp_restart() runs them before a reboot.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_ESP_SYSTEM_H
+#define HOST_ESP_SYSTEM_H
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+#define ESP_ERR_NO_MEM 0x101
+#define ESP_ERR_INVALID_STATE 0x103
+
+typedef void (*shutdown_handler_t)(void);
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handle);
+
+#endif
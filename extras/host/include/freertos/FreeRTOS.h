@@ -0,0 +1,50 @@
+/******************************************************************************
+ * @file    FreeRTOS.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the FreeRTOS kernel types used by the firmware.
+ *          The primitives are implemented in host_freertos.cpp.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint8_t StackType_t;
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdFAIL (pdFALSE)
+#define pdPASS (pdTRUE)
+#define errQUEUE_EMPTY ((BaseType_t)0)
+#define errQUEUE_FULL ((BaseType_t)0)
+
+#define configTICK_RATE_HZ 1000
+#define configMAX_PRIORITIES 25
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+#define portTICK_PERIOD_MS ((TickType_t)1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(xTimeInMs) ((TickType_t)(((TickType_t)(xTimeInMs) * (TickType_t)configTICK_RATE_HZ) / (TickType_t)1000U))
+#define tskNO_AFFINITY ((BaseType_t)0x7FFFFFFF)
+
+/*!< storage for the *Static() constructors, the host keeps its own objects */
+typedef struct
+{
+    void *pvDummy;
+} StaticTask_t;
+
+typedef StaticTask_t StaticQueue_t;
+typedef StaticTask_t StaticSemaphore_t;
+typedef StaticTask_t StaticEventGroup_t;
+
+#include "freertos/portmacro.h"
+
+#endif
@@ -0,0 +1,21 @@
+/******************************************************************************
+ * @file    portmacro.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Host stub of the FreeRTOS port layer.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef HOST_PORTMACRO_H
+#define HOST_PORTMACRO_H
+
+#include "freertos/FreeRTOS.h"
+
+BaseType_t xPortGetCoreID(void);
+
+#define portYIELD() taskYIELD()
+
+#endif
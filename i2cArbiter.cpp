@@ -0,0 +1,177 @@
+/******************************************************************************
+ * @file    i2cArbiter.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   I2C bus arbiter. A mutex owns the bus; before taking it a client
+ *          waits for the pending clients of higher priority to get it first.
+ *          The statistics are only updated by the holder of the bus, so the
+ *          mutex protects them as well.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "i2cArbiter.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define I2C_ARBITER_PERCENT 100.0f
+#define I2C_ARBITER_US_IN_MS 1000.0f
+
+static SemaphoreHandle_t i2cBusMutex = NULL;
+static StaticSemaphore_t i2cBusMutexBuffer;
+
+static uint32_t ulPending[I2C_CLIENT_MAX]; /*!< clients waiting for the bus, __atomic access */
+static uint32_t ulHoldStartUs;
+static i2cBusUsage_t tTotals;
+static i2cBusUsage_t tWindow;
+static uint32_t ulTotalsStartMs;
+static uint32_t ulWindowStartMs;
+
+static const char *const pcClientNames[I2C_CLIENT_MAX] = {"sensors", "display"};
+
+/******************************************************
+ * @brief adds a take to the usage of a client
+ ******************************************************/
+static void vMspI2c_addWait(i2cClientUsage_t *p_tUsage, uint32_t waitUs)
+{
+  p_tUsage->takes++;
+  p_tUsage->waitUs += waitUs;
+  if (waitUs > p_tUsage->maxWaitUs)
+  {
+    p_tUsage->maxWaitUs = waitUs;
+  }
+}
+
+/******************************************************
+ * @brief adds a hold to the usage of a client
+ ******************************************************/
+static void vMspI2c_addHold(i2cClientUsage_t *p_tUsage, uint32_t heldUs)
+{
+  p_tUsage->heldUs += heldUs;
+  if (heldUs > p_tUsage->maxHeldUs)
+  {
+    p_tUsage->maxHeldUs = heldUs;
+  }
+}
+
+/******************************************************
+ * @brief a client of higher priority waits for the bus
+ ******************************************************/
+static bool bMspI2c_higherPending(i2cClient_t client)
+{
+  for (uint32_t i = 0; i < (uint32_t)client; i++)
+  {
+    if (__atomic_load_n(&ulPending[i], __ATOMIC_ACQUIRE) != 0)
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void vMspI2c_init(void)
+{
+  if (i2cBusMutex == NULL)
+  {
+    i2cBusMutex = xSemaphoreCreateMutexStatic(&i2cBusMutexBuffer);
+    if (i2cBusMutex == NULL)
+    {
+      log_e("Failed to create I2C bus mutex");
+      return;
+    }
+  }
+  memset(ulPending, 0, sizeof(ulPending));
+  memset(&tTotals, 0, sizeof(tTotals));
+  memset(&tWindow, 0, sizeof(tWindow));
+  ulTotalsStartMs = millis();
+  ulWindowStartMs = ulTotalsStartMs;
+}
+
+bool bMspI2c_take(i2cClient_t client, TickType_t timeout)
+{
+  if (i2cBusMutex == NULL)
+  {
+    // before vMspI2c_init() only the boot task runs
+    return true;
+  }
+
+  uint32_t startUs = micros();
+  TickType_t startTick = xTaskGetTickCount();
+  __atomic_add_fetch(&ulPending[client], 1, __ATOMIC_ACQ_REL);
+
+  // a display frame goes one page per take, a sensor read waiting in between takes the bus first
+  while (bMspI2c_higherPending(client))
+  {
+    if ((xTaskGetTickCount() - startTick) >= timeout)
+    {
+      __atomic_sub_fetch(&ulPending[client], 1, __ATOMIC_ACQ_REL);
+      return false;
+    }
+    vTaskDelay(I2C_ARBITER_YIELD_TICKS);
+  }
+
+  TickType_t waited = xTaskGetTickCount() - startTick;
+  bool taken = (xSemaphoreTake(i2cBusMutex, (waited < timeout) ? (timeout - waited) : 0) == pdTRUE);
+  __atomic_sub_fetch(&ulPending[client], 1, __ATOMIC_ACQ_REL);
+  if (!taken)
+  {
+    return false;
+  }
+
+  ulHoldStartUs = micros();
+  uint32_t waitUs = ulHoldStartUs - startUs;
+  vMspI2c_addWait(&tTotals.client[client], waitUs);
+  vMspI2c_addWait(&tWindow.client[client], waitUs);
+  return true;
+}
+
+void vMspI2c_give(i2cClient_t client)
+{
+  if (i2cBusMutex == NULL)
+  {
+    return;
+  }
+  uint32_t heldUs = micros() - ulHoldStartUs;
+  vMspI2c_addHold(&tTotals.client[client], heldUs);
+  vMspI2c_addHold(&tWindow.client[client], heldUs);
+  xSemaphoreGive(i2cBusMutex);
+}
+
+void vMspI2c_takeWindow(i2cBusUsage_t *p_tUsage)
+{
+  if (i2cBusMutex == NULL)
+  {
+    memset(p_tUsage, 0, sizeof(*p_tUsage));
+    return;
+  }
+  xSemaphoreTake(i2cBusMutex, portMAX_DELAY);
+  uint32_t nowMs = millis();
+  *p_tUsage = tWindow;
+  p_tUsage->spanMs = nowMs - ulWindowStartMs;
+  memset(&tWindow, 0, sizeof(tWindow));
+  ulWindowStartMs = nowMs;
+  xSemaphoreGive(i2cBusMutex);
+}
+
+void vMspI2c_getTotals(i2cBusUsage_t *p_tUsage)
+{
+  *p_tUsage = tTotals;
+  p_tUsage->spanMs = millis() - ulTotalsStartMs;
+}
+
+float fMspI2c_heldPercent(const i2cBusUsage_t *p_tUsage, i2cClient_t client)
+{
+  if (p_tUsage->spanMs == 0)
+  {
+    return 0.0f;
+  }
+  return ((float)p_tUsage->client[client].heldUs * I2C_ARBITER_PERCENT) / ((float)p_tUsage->spanMs * I2C_ARBITER_US_IN_MS);
+}
+
+const char *pcMspI2c_clientName(i2cClient_t client)
+{
+  return (client < I2C_CLIENT_MAX) ? pcClientNames[client] : "?";
+}
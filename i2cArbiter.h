@@ -0,0 +1,94 @@
+/******************************************************************************
+ * @file    i2cArbiter.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Arbiter of the I2C bus shared by the sensors and the SH1106 OLED.
+ *          A client takes the bus for a transaction burst and gives it back;
+ *          a client waiting for it goes before any lower priority one, so a
+ *          sensor read gets the bus at the next page boundary of a display
+ *          frame instead of after the whole frame. The time each client
+ *          holds and waits for the bus is kept for the occupancy figures.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef I2C_ARBITER_H
+#define I2C_ARBITER_H
+
+// -- includes --
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+
+// bus users, highest priority first
+typedef enum __I2C_CLIENT__
+{
+  I2C_CLIENT_SENSORS, /*!< BME680, MICS6814/MICS4514: detection and sample reads */
+  I2C_CLIENT_DISPLAY, /*!< SH1106 frames, one tile row (page) per take */
+  I2C_CLIENT_MAX
+} i2cClient_t;
+
+#ifndef I2C_ARBITER_YIELD_TICKS
+#define I2C_ARBITER_YIELD_TICKS 1 // a client polls this often while a higher priority one is waiting
+#endif
+
+typedef struct __I2C_CLIENT_USAGE__
+{
+  uint32_t takes;
+  uint64_t heldUs;
+  uint32_t maxHeldUs;
+  uint64_t waitUs;
+  uint32_t maxWaitUs;
+} i2cClientUsage_t;
+
+typedef struct __I2C_BUS_USAGE__
+{
+  uint32_t spanMs; /*!< time the figures cover */
+  i2cClientUsage_t client[I2C_CLIENT_MAX];
+} i2cBusUsage_t;
+
+/******************************************************
+ * @brief creates the bus mutex and starts the
+ *        statistics, before the first transaction
+ ******************************************************/
+void vMspI2c_init(void);
+
+/******************************************************
+ * @brief takes the bus, after the waiting clients of
+ *        higher priority
+ *
+ * @return false when the bus was not free in time
+ ******************************************************/
+bool bMspI2c_take(i2cClient_t client, TickType_t timeout);
+
+/******************************************************
+ * @brief gives back the bus taken with bMspI2c_take()
+ ******************************************************/
+void vMspI2c_give(i2cClient_t client);
+
+/******************************************************
+ * @brief usage since the previous call, then starts a
+ *        new window
+ ******************************************************/
+void vMspI2c_takeWindow(i2cBusUsage_t *p_tUsage);
+
+/******************************************************
+ * @brief usage since vMspI2c_init(), read without the
+ *        bus lock for the end of run reports: a client
+ *        still running can leave it one take behind
+ ******************************************************/
+void vMspI2c_getTotals(i2cBusUsage_t *p_tUsage);
+
+/******************************************************
+ * @brief share of the span the client held the bus,
+ *        in percent
+ ******************************************************/
+float fMspI2c_heldPercent(const i2cBusUsage_t *p_tUsage, i2cClient_t client);
+
+/******************************************************
+ * @brief short name of a client, used in the logs
+ ******************************************************/
+const char *pcMspI2c_clientName(i2cClient_t client);
+
+#endif
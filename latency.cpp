@@ -0,0 +1,258 @@
+/******************************************************************************
+ * @file    latency.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Latency statistics of the main state machine. Each slot keeps
+ *          count, min, max, sum and a log-linear histogram (4 buckets per
+ *          power of two, ~25% resolution) the p99 is read from, so the
+ *          memory stays fixed whatever the number of runs in a day.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "latency.h"
+
+#define LATENCY_SUB_BUCKET_BITS 2
+#define LATENCY_SUB_BUCKETS (1U << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_P99_PER_MILLE 990
+#define LATENCY_US_PER_MS 1000U
+
+typedef struct
+{
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t sumUs;
+  uint32_t windowMaxUs; /*!< longest run since vMspLatency_takeWindowMax() */
+  uint32_t buckets[LATENCY_BUCKETS];
+} latencyHistogram_t;
+
+static latencyHistogram_t tHistograms[LATENCY_SLOT_MAX];
+static latencyStamp_t tStateEntry;
+static struct tm tDay;
+static bool bDayStarted = false;
+
+static const char *const pcSlotNames[LATENCY_SLOT_MAX] = {
+    "update_config", // SYS_STATE_UPDATE_CONFIG_FROM_SERVER
+    "ntp_sync",      // SYS_STATE_WAIT_FOR_NTP_SYNC
+    "fw_check",      // SYS_STATE_FW_VERSION_CHECK
+    "wait",          // SYS_STATE_WAIT_FOR_TIMEOUT
+    "read",          // SYS_STATE_READ_SENSORS
+    "error",         // SYS_STATE_ERROR
+    "eval",          // SYS_STATE_EVAL_SENSOR_STATUS
+    "send",          // SYS_STATE_SEND_DATA
+    "bme680",        // LATENCY_SLOT_BME680
+    "pms5003",       // LATENCY_SLOT_PMS5003
+    "mics",          // LATENCY_SLOT_MICS
+    "o3",            // LATENCY_SLOT_O3
+};
+
+//------------------------------------------------------------------------------
+// histogram
+//------------------------------------------------------------------------------
+
+static uint32_t ulMspLatency_bucket(uint32_t us)
+{
+  if (us < LATENCY_SUB_BUCKETS)
+  {
+    return us;
+  }
+  uint32_t msb = 31U - (uint32_t)__builtin_clz(us);
+  uint32_t shift = msb - LATENCY_SUB_BUCKET_BITS;
+  return ((msb - 1U) * LATENCY_SUB_BUCKETS) + ((us >> shift) & (LATENCY_SUB_BUCKETS - 1U));
+}
+
+static uint32_t ulMspLatency_bucketUpperUs(uint32_t bucket)
+{
+  if (bucket < LATENCY_SUB_BUCKETS)
+  {
+    return bucket;
+  }
+  uint32_t msb = (bucket / LATENCY_SUB_BUCKETS) + 1U;
+  uint32_t shift = msb - LATENCY_SUB_BUCKET_BITS;
+  uint64_t lower = (uint64_t)(LATENCY_SUB_BUCKETS + (bucket % LATENCY_SUB_BUCKETS)) << shift;
+  uint64_t upper = lower + (1ULL << shift) - 1U;
+  return (upper > UINT32_MAX) ? UINT32_MAX : (uint32_t)upper;
+}
+
+static void vMspLatency_clear(void)
+{
+  memset(tHistograms, 0, sizeof(tHistograms));
+}
+
+//------------------------------------------------------------------------------
+// recording
+//------------------------------------------------------------------------------
+
+void vMspLatency_init(void)
+{
+  vMspLatency_clear();
+  bDayStarted = false;
+  vMspLatency_stamp(&tStateEntry);
+}
+
+void vMspLatency_stamp(latencyStamp_t *p_tStamp)
+{
+  p_tStamp->us = micros();
+  p_tStamp->ms = millis();
+}
+
+uint32_t ulMspLatency_elapsedUs(const latencyStamp_t *p_tStamp)
+{
+  uint32_t ms = millis() - p_tStamp->ms;
+  if (ms < LATENCY_MICROS_SPAN_MS)
+  {
+    return micros() - p_tStamp->us;
+  }
+  uint64_t us = (uint64_t)ms * LATENCY_US_PER_MS;
+  return (us > UINT32_MAX) ? UINT32_MAX : (uint32_t)us;
+}
+
+void vMspLatency_record(latency_slot_t slot, uint32_t us)
+{
+  if ((uint32_t)slot >= LATENCY_SLOT_MAX)
+  {
+    return;
+  }
+  latencyHistogram_t *p_tHist = &tHistograms[slot];
+  if ((p_tHist->count == 0) || (us < p_tHist->minUs))
+  {
+    p_tHist->minUs = us;
+  }
+  if (us > p_tHist->maxUs)
+  {
+    p_tHist->maxUs = us;
+  }
+  if (us > p_tHist->windowMaxUs)
+  {
+    p_tHist->windowMaxUs = us;
+  }
+  p_tHist->count++;
+  p_tHist->sumUs += us;
+  p_tHist->buckets[ulMspLatency_bucket(us)]++;
+}
+
+void vMspLatency_transition(uint8_t from, uint8_t to)
+{
+  if (from == to)
+  {
+    return; // still in the same visit, e.g. the wait state polling the clock
+  }
+  vMspLatency_record((latency_slot_t)from, ulMspLatency_elapsedUs(&tStateEntry));
+  vMspLatency_stamp(&tStateEntry);
+}
+
+//------------------------------------------------------------------------------
+// reporting
+//------------------------------------------------------------------------------
+
+const char *pcMspLatency_slotName(latency_slot_t slot)
+{
+  if ((uint32_t)slot >= LATENCY_SLOT_MAX)
+  {
+    return "unknown";
+  }
+  return pcSlotNames[slot];
+}
+
+void vMspLatency_getSummary(latency_slot_t slot, latencySummary_t *p_tSummary)
+{
+  memset(p_tSummary, 0, sizeof(latencySummary_t));
+  if (((uint32_t)slot >= LATENCY_SLOT_MAX) || (tHistograms[slot].count == 0))
+  {
+    return;
+  }
+  const latencyHistogram_t *p_tHist = &tHistograms[slot];
+  p_tSummary->count = p_tHist->count;
+  p_tSummary->minUs = p_tHist->minUs;
+  p_tSummary->maxUs = p_tHist->maxUs;
+  p_tSummary->avgUs = (uint32_t)(p_tHist->sumUs / p_tHist->count);
+
+  // smallest bucket holding at least 99% of the runs
+  uint64_t rank = (((uint64_t)p_tHist->count * LATENCY_P99_PER_MILLE) + 999U) / 1000U;
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < LATENCY_BUCKETS; i++)
+  {
+    seen += p_tHist->buckets[i];
+    if (seen >= rank)
+    {
+      uint32_t upper = ulMspLatency_bucketUpperUs(i);
+      p_tSummary->p99Us = (upper > p_tHist->maxUs) ? p_tHist->maxUs : upper;
+      break;
+    }
+  }
+}
+
+void vMspLatency_takeWindowMax(uint32_t *p_ulMaxUs)
+{
+  for (uint32_t i = 0; i < LATENCY_SLOT_MAX; i++)
+  {
+    p_ulMaxUs[i] = tHistograms[i].windowMaxUs;
+    tHistograms[i].windowMaxUs = 0;
+  }
+}
+
+bool bMspLatency_rollover(const struct tm *p_tNow)
+{
+  if (!bDayStarted)
+  {
+    vMspLatency_startDay(p_tNow);
+    return false;
+  }
+  return (p_tNow->tm_mday != tDay.tm_mday) || (p_tNow->tm_mon != tDay.tm_mon) || (p_tNow->tm_year != tDay.tm_year);
+}
+
+void vMspLatency_startDay(const struct tm *p_tNow)
+{
+  // the window maxima still belong to the next upload
+  for (uint32_t i = 0; i < LATENCY_SLOT_MAX; i++)
+  {
+    uint32_t windowMaxUs = tHistograms[i].windowMaxUs;
+    memset(&tHistograms[i], 0, sizeof(latencyHistogram_t));
+    tHistograms[i].windowMaxUs = windowMaxUs;
+  }
+  memcpy(&tDay, p_tNow, sizeof(struct tm));
+  bDayStarted = true;
+}
+
+const struct tm *p_tMspLatency_day(void)
+{
+  return &tDay;
+}
+
+uint32_t ulMspLatency_formatCsv(latency_slot_t slot, char *p_cLine, uint32_t len)
+{
+  latencySummary_t summary;
+  vMspLatency_getSummary(slot, &summary);
+  int written = snprintf(p_cLine, len, "%04d-%02d-%02d;%s;%lu;%lu;%lu;%lu;%lu",
+                         tDay.tm_year + 1900, tDay.tm_mon + 1, tDay.tm_mday, pcMspLatency_slotName(slot),
+                         (unsigned long)summary.count, (unsigned long)summary.minUs, (unsigned long)summary.avgUs,
+                         (unsigned long)summary.maxUs, (unsigned long)summary.p99Us);
+  if (written < 0)
+  {
+    return 0;
+  }
+  return ((uint32_t)written < len) ? (uint32_t)written : (len - 1U);
+}
+
+void vMspLatency_print(void)
+{
+  printf("\n==== LOOP LATENCY %04d-%02d-%02d ====\n", tDay.tm_year + 1900, tDay.tm_mon + 1, tDay.tm_mday);
+  printf("%-14s %8s %12s %12s %12s %12s\n", "slot", "count", "min us", "avg us", "max us", "p99 us");
+  for (uint32_t i = 0; i < LATENCY_SLOT_MAX; i++)
+  {
+    latencySummary_t summary;
+    vMspLatency_getSummary((latency_slot_t)i, &summary);
+    if (summary.count == 0)
+    {
+      continue;
+    }
+    printf("%-14s %8lu %12lu %12lu %12lu %12lu\n", pcMspLatency_slotName((latency_slot_t)i),
+           (unsigned long)summary.count, (unsigned long)summary.minUs, (unsigned long)summary.avgUs,
+           (unsigned long)summary.maxUs, (unsigned long)summary.p99Us);
+  }
+  printf("=====================================\n");
+}
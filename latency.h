@@ -0,0 +1,118 @@
+/******************************************************************************
+ * @file    latency.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Latency statistics of the main state machine: time spent in each
+ *          system_states_t visit and in each sensor retry chain of
+ *          SYS_STATE_READ_SENSORS, as min/avg/max/p99 per day.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+// -- includes --
+#include <Arduino.h>
+#include "time.h"
+#include "shared_values.h"
+
+#define LATENCY_BUCKETS 128          /*!< log-linear histogram, 4 buckets per power of two of us */
+#define LATENCY_MICROS_SPAN_MS 60000 /*!< longer spans are timed with millis(), micros() wraps at ~71 min */
+#define LATENCY_CSV_HEADER "date;slot;count;min_us;avg_us;max_us;p99_us"
+#define LATENCY_CSV_LINE_LEN 96
+
+typedef struct __LATENCY_STAMP__
+{
+  uint32_t us;
+  uint32_t ms;
+} latencyStamp_t;
+
+typedef struct __LATENCY_SUMMARY__
+{
+  uint32_t count;
+  uint32_t minUs;
+  uint32_t avgUs;
+  uint32_t maxUs;
+  uint32_t p99Us; /*!< upper bound of the histogram bucket, clipped to maxUs */
+} latencySummary_t;
+
+/******************************************************
+ * @brief clears the statistics and starts timing the
+ *        current state
+ ******************************************************/
+void vMspLatency_init(void);
+
+/******************************************************
+ * @brief takes a timestamp
+ ******************************************************/
+void vMspLatency_stamp(latencyStamp_t *p_tStamp);
+
+/******************************************************
+ * @brief microseconds since the timestamp, saturated
+ *        at UINT32_MAX
+ ******************************************************/
+uint32_t ulMspLatency_elapsedUs(const latencyStamp_t *p_tStamp);
+
+/******************************************************
+ * @brief adds a run to the statistics of a slot
+ ******************************************************/
+void vMspLatency_record(latency_slot_t slot, uint32_t us);
+
+/******************************************************
+ * @brief called for every pass of loop(): when the
+ *        state changes the visit of the one left is
+ *        recorded and the new one starts, states as
+ *        the system_states_t of mainStateMachine
+ ******************************************************/
+void vMspLatency_transition(uint8_t from, uint8_t to);
+
+/******************************************************
+ * @brief short name of a slot, used in the logs and
+ *        in the upload fields
+ ******************************************************/
+const char *pcMspLatency_slotName(latency_slot_t slot);
+
+/******************************************************
+ * @brief statistics of a slot for the current day
+ ******************************************************/
+void vMspLatency_getSummary(latency_slot_t slot, latencySummary_t *p_tSummary);
+
+/******************************************************
+ * @brief longest run of each slot since the previous
+ *        call, LATENCY_SLOT_MAX entries, 0 = no run
+ ******************************************************/
+void vMspLatency_takeWindowMax(uint32_t *p_ulMaxUs);
+
+/******************************************************
+ * @brief true when the date differs from the day the
+ *        statistics were started on, the first call
+ *        only starts the day
+ ******************************************************/
+bool bMspLatency_rollover(const struct tm *p_tNow);
+
+/******************************************************
+ * @brief clears the daily statistics and starts a new
+ *        day on the given date
+ ******************************************************/
+void vMspLatency_startDay(const struct tm *p_tNow);
+
+/******************************************************
+ * @brief date the current statistics started on
+ ******************************************************/
+const struct tm *p_tMspLatency_day(void);
+
+/******************************************************
+ * @brief a LATENCY_CSV_HEADER line for the slot,
+ *        returns the length written
+ ******************************************************/
+uint32_t ulMspLatency_formatCsv(latency_slot_t slot, char *p_cLine, uint32_t len);
+
+/******************************************************
+ * @brief prints the daily table on the serial
+ ******************************************************/
+void vMspLatency_print(void);
+
+#endif
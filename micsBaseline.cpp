@@ -0,0 +1,284 @@
+/******************************************************************************
+ * @file    micsBaseline.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   MICS baseline tracking. The samples come from the I2C worker, the
+ *          proposals and the saves from the loop task once the worker is
+ *          done, so no lock is taken.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "micsBaseline.h"
+
+#define MICS_BASELINE_MAGIC 0x4D425301UL // "MBS" v1
+#define MICS_BASELINE_SEC_IN_DAY 86400UL
+#define MICS_BASELINE_PERCENT 100UL
+
+static micsBaselineStore_t tStore;
+static bool bDayClosed;
+
+static const char *const pcModeNames[MICS_BASELINE_MODE_MAX] = {"off", "propose", "apply"};
+static const char *const pcChannelNames[MICS_BASELINE_CH_MAX] = {"RED", "OX", "NH3"};
+
+/******************************************************
+ * @brief the reducing gases lower Rs, NO2 raises it:
+ *        the cleanest air gives the highest Rs on RED
+ *        and NH3, the lowest on OX
+ ******************************************************/
+static bool bMspBaseline_cleaner(micsBaselineChannel_t channel, uint16_t rs, uint16_t extreme)
+{
+  return (channel == MICS_BASELINE_OX) ? (rs < extreme) : (rs > extreme);
+}
+
+/******************************************************
+ * @brief R0 of a channel
+ ******************************************************/
+static uint16_t uMspBaseline_r0(const sensorR0Value_t *p_tR0, micsBaselineChannel_t channel)
+{
+  return (channel == MICS_BASELINE_RED) ? p_tR0->redSensor : ((channel == MICS_BASELINE_OX) ? p_tR0->oxSensor : p_tR0->nh3Sensor);
+}
+
+/******************************************************
+ * @brief sets the R0 of a channel
+ ******************************************************/
+static void vMspBaseline_setChannelR0(sensorR0Value_t *p_tR0, micsBaselineChannel_t channel, uint16_t value)
+{
+  if (channel == MICS_BASELINE_RED)
+  {
+    p_tR0->redSensor = value;
+  }
+  else if (channel == MICS_BASELINE_OX)
+  {
+    p_tR0->oxSensor = value;
+  }
+  else
+  {
+    p_tR0->nh3Sensor = value;
+  }
+}
+
+/******************************************************
+ * @brief keeps the value of the day that ends, unless
+ *        the station was off for most of it
+ ******************************************************/
+static void vMspBaseline_closeDay(void)
+{
+  bDayClosed = true;
+  if (tStore.todaySamples < MICS_BASELINE_MIN_DAY_SAMPLES)
+  {
+    log_w("MICS baseline: day %lu left out, %u samples only", (unsigned long)tStore.day, tStore.todaySamples);
+    return;
+  }
+  memcpy(tStore.daily[tStore.nextDay], tStore.today, sizeof(tStore.today));
+  tStore.nextDay = (uint8_t)((tStore.nextDay + 1) % MICS_BASELINE_DAYS);
+  if (tStore.dayCount < MICS_BASELINE_DAYS)
+  {
+    tStore.dayCount++;
+  }
+  log_i("MICS baseline: day %lu closed, clean-air Rs RED %u OX %u NH3 %u from %u samples", (unsigned long)tStore.day,
+        tStore.today[MICS_BASELINE_RED], tStore.today[MICS_BASELINE_OX], tStore.today[MICS_BASELINE_NH3], tStore.todaySamples);
+}
+
+/******************************************************
+ * @brief median of the daily values of a channel, 0
+ *        when too few days have it
+ ******************************************************/
+static uint16_t uMspBaseline_median(micsBaselineChannel_t channel, uint8_t *p_ucDays)
+{
+  uint16_t values[MICS_BASELINE_DAYS];
+  uint8_t count = 0;
+  for (uint8_t d = 0; d < tStore.dayCount; d++)
+  {
+    uint16_t value = tStore.daily[d][channel];
+    if (value == 0)
+    {
+      continue;
+    }
+    // insertion sort, a couple of weeks of values
+    uint8_t i = count++;
+    while ((i > 0) && (values[i - 1] > value))
+    {
+      values[i] = values[i - 1];
+      i--;
+    }
+    values[i] = value;
+  }
+  *p_ucDays = count;
+  if (count < MICS_BASELINE_MIN_DAYS)
+  {
+    return 0;
+  }
+  return (count & 1U) ? values[count / 2] : (uint16_t)(((uint32_t)values[(count / 2) - 1] + values[count / 2] + 1U) / 2U);
+}
+
+/******************************************************
+ * @brief a value kept within center +/- pct percent
+ ******************************************************/
+static uint16_t uMspBaseline_bound(uint16_t value, uint16_t center, uint32_t pct)
+{
+  uint32_t span = ((uint32_t)center * pct) / MICS_BASELINE_PERCENT;
+  if (span == 0)
+  {
+    span = 1;
+  }
+  uint32_t low = (center > span) ? (center - span) : 1U;
+  uint32_t high = (uint32_t)center + span;
+  if (high > UINT16_MAX)
+  {
+    high = UINT16_MAX;
+  }
+  return (uint16_t)((value < low) ? low : ((value > high) ? high : value));
+}
+
+void vMspBaseline_init(uint8_t gasSensorType, const sensorR0Value_t *p_tR0)
+{
+  memset(&tStore, 0, sizeof(tStore));
+  tStore.magic = MICS_BASELINE_MAGIC;
+  tStore.gasSensorType = gasSensorType;
+  for (int ch = 0; ch < MICS_BASELINE_CH_MAX; ch++)
+  {
+    tStore.anchor[ch] = uMspBaseline_r0(p_tR0, (micsBaselineChannel_t)ch);
+    tStore.r0[ch] = tStore.anchor[ch];
+  }
+  bDayClosed = false;
+}
+
+bool bMspBaseline_restore(const micsBaselineStore_t *p_tSaved, const sensorR0Value_t *p_tR0)
+{
+  if ((p_tSaved->magic != MICS_BASELINE_MAGIC) || (p_tSaved->gasSensorType != tStore.gasSensorType) ||
+      (p_tSaved->dayCount > MICS_BASELINE_DAYS) || (p_tSaved->nextDay >= MICS_BASELINE_DAYS))
+  {
+    return false;
+  }
+  tStore = *p_tSaved;
+  for (int ch = 0; ch < MICS_BASELINE_CH_MAX; ch++)
+  {
+    uint16_t configured = uMspBaseline_r0(p_tR0, (micsBaselineChannel_t)ch);
+    if (configured != tStore.r0[ch])
+    {
+      // recalibrated by hand, the bounds start from there
+      log_i("MICS baseline %s: R0 changed to %u in the config, new anchor", pcChannelNames[ch], configured);
+      tStore.anchor[ch] = configured;
+      tStore.r0[ch] = configured;
+    }
+  }
+  return true;
+}
+
+const micsBaselineStore_t *p_tMspBaseline_store(void)
+{
+  return &tStore;
+}
+
+void vMspBaseline_add(uint32_t epoch, const int32_t *p_lRs)
+{
+  uint32_t day = epoch / MICS_BASELINE_SEC_IN_DAY;
+  if (day != tStore.day)
+  {
+    if (tStore.day != 0)
+    {
+      vMspBaseline_closeDay();
+    }
+    if (tStore.lastUpdateDay == 0)
+    {
+      tStore.lastUpdateDay = day; // the first update period starts with the tracking
+    }
+    tStore.day = day;
+    tStore.todaySamples = 0;
+    memset(tStore.today, 0, sizeof(tStore.today));
+  }
+
+  if (tStore.todaySamples < UINT16_MAX)
+  {
+    tStore.todaySamples++;
+  }
+  for (int ch = 0; ch < MICS_BASELINE_CH_MAX; ch++)
+  {
+    if (p_lRs[ch] <= 0)
+    {
+      continue;
+    }
+    uint16_t rs = (p_lRs[ch] > UINT16_MAX) ? UINT16_MAX : (uint16_t)p_lRs[ch];
+    if ((tStore.today[ch] == 0) || bMspBaseline_cleaner((micsBaselineChannel_t)ch, rs, tStore.today[ch]))
+    {
+      tStore.today[ch] = rs;
+    }
+  }
+}
+
+bool bMspBaseline_dayClosed(void)
+{
+  bool closed = bDayClosed;
+  bDayClosed = false;
+  return closed;
+}
+
+bool bMspBaseline_propose(uint32_t updateDays, const sensorR0Value_t *p_tR0, sensorR0Value_t *p_tProposed)
+{
+  *p_tProposed = *p_tR0;
+  if ((tStore.day - tStore.lastUpdateDay) < updateDays)
+  {
+    return false;
+  }
+  tStore.lastUpdateDay = tStore.day;
+
+  bool changed = false;
+  for (int ch = 0; ch < MICS_BASELINE_CH_MAX; ch++)
+  {
+    micsBaselineChannel_t channel = (micsBaselineChannel_t)ch;
+    uint8_t days = 0;
+    uint16_t target = uMspBaseline_median(channel, &days);
+    if (target == 0)
+    {
+      if (days != 0)
+      {
+        log_i("MICS baseline %s: %u of %u days needed, no proposal yet", pcChannelNames[ch], days, MICS_BASELINE_MIN_DAYS);
+      }
+      continue;
+    }
+
+    uint16_t current = uMspBaseline_r0(p_tR0, channel);
+    uint16_t proposed = uMspBaseline_bound(target, current, MICS_BASELINE_MAX_STEP_PCT);
+    proposed = uMspBaseline_bound(proposed, tStore.anchor[ch], MICS_BASELINE_MAX_DRIFT_PCT);
+    if (proposed == current)
+    {
+      log_i("MICS baseline %s: R0 %u confirmed by %u days", pcChannelNames[ch], current, days);
+      continue;
+    }
+    log_i("MICS baseline %s: R0 %u -> %u, clean-air median %u over %u days%s", pcChannelNames[ch], current, proposed, target,
+          days, (proposed != target) ? " (bounded)" : "");
+    vMspBaseline_setChannelR0(p_tProposed, channel, proposed);
+    changed = true;
+  }
+  return changed;
+}
+
+void vMspBaseline_setR0(const sensorR0Value_t *p_tR0)
+{
+  for (int ch = 0; ch < MICS_BASELINE_CH_MAX; ch++)
+  {
+    tStore.r0[ch] = uMspBaseline_r0(p_tR0, (micsBaselineChannel_t)ch);
+  }
+}
+
+const char *pcMspBaseline_modeName(micsBaselineMode_t mode)
+{
+  return (mode < MICS_BASELINE_MODE_MAX) ? pcModeNames[mode] : "?";
+}
+
+bool bMspBaseline_parseMode(const char *name, micsBaselineMode_t *p_tMode)
+{
+  for (int i = 0; i < MICS_BASELINE_MODE_MAX; i++)
+  {
+    if (strcmp(name, pcModeNames[i]) == 0)
+    {
+      *p_tMode = (micsBaselineMode_t)i;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ * @file    micsBaseline.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   MICS baseline (R0) tracking. Every sample of the gas sensor feeds
+ *          the clean-air extreme of the day of each channel: the lowest Rs of
+ *          the oxidising channel, the highest of the reducing ones, as the
+ *          gases push them the other way. The last MICS_BASELINE_DAYS of them
+ *          are kept; every update period their median gives the R0 the
+ *          sensor drifted to, proposed in the log or applied, a bounded step
+ *          at a time.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef MICS_BASELINE_H
+#define MICS_BASELINE_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+
+#ifndef MICS_BASELINE_DAYS
+#define MICS_BASELINE_DAYS 14 // daily clean-air values kept
+#endif
+
+#ifndef MICS_BASELINE_MIN_DAYS
+#define MICS_BASELINE_MIN_DAYS 7 // daily values needed before the first proposal
+#endif
+
+#ifndef MICS_BASELINE_MIN_DAY_SAMPLES
+#define MICS_BASELINE_MIN_DAY_SAMPLES 360 // a day with fewer samples (station off most of it) is left out
+#endif
+
+#ifndef MICS_BASELINE_DEFAULT_UPDATE_DAYS
+#define MICS_BASELINE_DEFAULT_UPDATE_DAYS 7 // mics_baseline_days when the config does not set it
+#endif
+
+#ifndef MICS_BASELINE_MAX_STEP_PCT
+#define MICS_BASELINE_MAX_STEP_PCT 5 // largest R0 change of one update
+#endif
+
+#ifndef MICS_BASELINE_MAX_DRIFT_PCT
+#define MICS_BASELINE_MAX_DRIFT_PCT 30 // largest R0 change from the value the tracking started from
+#endif
+
+// what is done with the baseline, mics_baseline in the config
+typedef enum __MICS_BASELINE_MODE__
+{
+  MICS_BASELINE_OFF = 0, /*!< not tracked */
+  MICS_BASELINE_PROPOSE, /*!< tracked, the new R0 is only logged */
+  MICS_BASELINE_APPLY,   /*!< tracked, the new R0 replaces the configured one */
+  MICS_BASELINE_MODE_MAX
+} micsBaselineMode_t;
+
+// same order as the fields of sensorR0Value_t
+typedef enum __MICS_BASELINE_CHANNEL__
+{
+  MICS_BASELINE_RED = 0,
+  MICS_BASELINE_OX,
+  MICS_BASELINE_NH3,
+  MICS_BASELINE_CH_MAX
+} micsBaselineChannel_t;
+
+// what the SD card keeps across reboots, constant size
+typedef struct __MICS_BASELINE_STORE__
+{
+  uint32_t magic;                                        /*!< layout of the store */
+  uint8_t gasSensorType;                                 /*!< the values are in the units of this sensor */
+  uint8_t dayCount;                                      /*!< daily values held */
+  uint8_t nextDay;                                       /*!< slot of the next daily value */
+  uint8_t reserved;
+  uint32_t day;                                          /*!< day number of the values of today, 0 = none yet */
+  uint32_t lastUpdateDay;                                /*!< day number of the last proposal */
+  uint16_t todaySamples;
+  uint16_t today[MICS_BASELINE_CH_MAX];                  /*!< clean-air extreme of today, 0 = not read */
+  uint16_t daily[MICS_BASELINE_DAYS][MICS_BASELINE_CH_MAX];
+  uint16_t anchor[MICS_BASELINE_CH_MAX];                 /*!< R0 the tracking started from, the drift bound */
+  uint16_t r0[MICS_BASELINE_CH_MAX];                     /*!< R0 in use at the last update */
+} micsBaselineStore_t;
+
+/******************************************************
+ * @brief starts an empty store from the configured R0
+ ******************************************************/
+void vMspBaseline_init(uint8_t gasSensorType, const sensorR0Value_t *p_tR0);
+
+/******************************************************
+ * @brief takes over a store saved by a previous boot;
+ *        an R0 changed by hand in the meantime becomes
+ *        the new anchor
+ *
+ * @return false when it is not a store of this sensor
+ ******************************************************/
+bool bMspBaseline_restore(const micsBaselineStore_t *p_tSaved, const sensorR0Value_t *p_tR0);
+
+/******************************************************
+ * @brief the store, to save it
+ ******************************************************/
+const micsBaselineStore_t *p_tMspBaseline_store(void);
+
+/******************************************************
+ * @brief I2C job: one Rs sample per channel, 0 or less
+ *        for a channel not read; O(1)
+ ******************************************************/
+void vMspBaseline_add(uint32_t epoch, const int32_t *p_lRs);
+
+/******************************************************
+ * @brief a day was closed since the previous call
+ ******************************************************/
+bool bMspBaseline_dayClosed(void);
+
+/******************************************************
+ * @brief every updateDays, the R0 the daily values
+ *        point to, bounded and logged
+ *
+ * @return true when it differs from the current R0
+ ******************************************************/
+bool bMspBaseline_propose(uint32_t updateDays, const sensorR0Value_t *p_tR0, sensorR0Value_t *p_tProposed);
+
+/******************************************************
+ * @brief records the R0 now in use, after applying a
+ *        proposal
+ ******************************************************/
+void vMspBaseline_setR0(const sensorR0Value_t *p_tR0);
+
+/******************************************************
+ * @brief config name of a mode
+ ******************************************************/
+const char *pcMspBaseline_modeName(micsBaselineMode_t mode);
+
+/******************************************************
+ * @brief mode from its config name
+ *
+ * @return false when the name is not known
+ ******************************************************/
+bool bMspBaseline_parseMode(const char *name, micsBaselineMode_t *p_tMode);
+
+#endif
@@ -50,6 +50,24 @@
 #include "display_task.h"
 #include "mspOs.h"
 #include "firmware_update.h"
+#include "benchmark.h"
+#include "latency.h"
+#include "acquisition.h"
+#include "pmsStream.h"
+#include "o3Adc.h"
+#include "channelStats.h"
+#include "channelTable.h"
+#include "bootPipeline.h"
+#include "sensorDriver.h"
+#include "sensorHealth.h"
+#include "i2cArbiter.h"
+#include "sampleRing.h"
+#include "micsBaseline.h"
+#include "rawHistory.h"
+#include "rollup.h"
+#include "aqIndex.h"
+#include "sdLogger.h"
+#include "esp_system.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -74,18 +92,23 @@ static PMS pms(pmsSerial);
 #define MICS4514_WARMUP_TIME_MIN 2 // Minimum warmup time in minutes
 #define MICS4514_I2C_ADDR 0x75     // Default I2C address
 
+#define NETWORK_START_SETTLE_MS 2000 // left to the network task to initialize before the loop starts
+
 // -- MICS6814 sensors instances
 static MiCS6814 gas;                                        // MICS6814 sensor instance
 static DFRobot_MICS_I2C mics4514(&Wire, MICS4514_I2C_ADDR); // MICS4514 sensor instance
+static uint32_t micsWarmupStartMs = 0;                       // millis() the MICS4514 heater was switched on
 
 // -- Create a new state machine instance
 static state_machine_t mainStateMachine;
 
 // -- sensor data and status instance
 static sensorData_t sensorData_accumulate;
-static sensorData_t sensorData_single;
 
-// -- bme 680 data instance
+// -- sample of the current period, the channels of the buses that completed in time
+static sensorSample_t tSample;
+
+// -- latest BME680 reading, kept by the I2C worker for the NO2 and VOC compensations
 static bme680Data_t localData;
 
 // -- reading status instance
@@ -109,6 +132,23 @@ static systemData_t sysData;
 // -- structure for PMS5003
 static PMS::DATA data;
 
+// -- results of one run of a bus worker, cleared by the worker, read after the join only when the bus completed
+typedef struct __ACQ_BUS_OUTPUT__
+{
+  sensorSample_t sample;            /*!< channels of the sensors on the bus */
+  errorVars_t err;                  /*!< failed reads of the run */
+  MICS4514AdcAccumulator_t micsAdc; /*!< I2C: MICS4514 counts of the reading */
+  float o3Points;                   /*!< ADC: O3 level, converted once the BME680 sample is in */
+  bool o3Valid;
+} acqBusOutput_t;
+static acqBusOutput_t tBusOutput[ACQ_BUS_MAX];
+
+// -- BME680 temperature of the latest sample that had one, for the O3 compensation
+static float fLastTemperature;
+
+// -- streaming statistics of each channel over the current averaging interval
+static channelStats_t channelStats[STATS_CH_MAX];
+
 //---------------------------------------- FUNCTIONS ----------------------------------------------------------------------
 
 void vMspInit_sensorStatusAndData(sensorData_t *p_tData);
@@ -124,10 +164,95 @@ void vMsp_setGpioPins(void);
 void vMspInit_NetworkAndMeasInfo(void);
 void vMspInit_MeasInfo(void);
 
+void vMspInit_configureSystemFromSD(systemData_t *sysData, systemStatus_t *sysStat,
+                                    deviceNetworkInfo_t *devInfo, deviceMeasurement_t *measStat);
+
 void vMsp_scanI2CDevices(void);
 
 void Msp_getSystemStatus(systemStatus_t *stat);
 
+static void vMsp_acquireBME680(void);
+static void vMsp_acquireMICS6814(void);
+static void vMsp_acquireMICS4514(void);
+static void vMsp_acquireO3(void);
+static void vMsp_accumulateO3(bool sampled);
+static void vMsp_acquirePMS5003(void);
+static void vMsp_accumulatePMS5003(bool sampled);
+static void vMsp_countFailedRead(sens_status_t slot);
+static void vMsp_aggregateSample(const sensorSample_t *p_tSample);
+static void vMsp_emitRollup(rollupRecord_t *p_tRollup);
+static void vMsp_detectBME680(void);
+static void vMsp_detectMICS6814(void);
+static void vMsp_detectMICS4514(void);
+static void vMsp_detectPMS5003(void);
+static void vMsp_detectO3(void);
+static void vMsp_detectSensors(acqBus_t bus);
+static bool bMsp_driverSelected(const sensorDriver_t *p_tDriver);
+static bool bMsp_pmsDutyCycleEnabled(void);
+static void vMsp_pmsDutyCycle(uint32_t secondsToSample);
+static int32_t lMsp_intervalSlots(void);
+static void vMsp_restoreBsecState(void);
+static void vMsp_saveBsecState(void);
+static void vMsp_saveBsecStateAtShutdown(void);
+static void vMsp_checkMics4514Warmup(void);
+static void vMsp_restoreMicsBaseline(void);
+static void vMsp_trackMicsBaseline(void);
+static void vMsp_bootSdRead(void);
+static void vMsp_bootFirmwarePending(void);
+static void vMsp_bootConfigure(void);
+static void vMsp_bootNetwork(void);
+#ifndef ENABLE_FIRMWARE_UPDATE_TESTS
+static void vMsp_bootI2cSensors(void);
+static void vMsp_bootUartSensors(void);
+static void vMsp_bootAdcSensors(void);
+#endif
+
+// sensors the station can carry (sensorDriver.h), the gas sensors only when configured
+static const sensorDriver_t tSensorDrivers[] = {
+    // the gas sensors follow the BME680 on the I2C worker, its sample compensates their NO2
+    {"BME680", ACQ_BUS_I2C, SENSOR_DRIVER_ANY_GAS, SENS_STAT_BME680, &peripheralStatus_t::BME680Sensor,
+     vMsp_detectBME680, vMsp_acquireBME680, NULL, vHalSensor_averageBME680},
+    {"MICS6814", ACQ_BUS_I2C, GAS_SENSOR_MICS6814, SENS_STAT_MICSxxxx, &peripheralStatus_t::MICS6814Sensor,
+     vMsp_detectMICS6814, vMsp_acquireMICS6814, NULL, vHalSensor_averageMICS6814},
+    {"MICS4514", ACQ_BUS_I2C, GAS_SENSOR_MICS4514, SENS_STAT_MICSxxxx, &peripheralStatus_t::MICS4514Sensor,
+     vMsp_detectMICS4514, vMsp_acquireMICS4514, NULL, vHalSensor_averageMICS4514},
+    {"PMS5003", ACQ_BUS_UART, SENSOR_DRIVER_ANY_GAS, SENS_STAT_PMS5003, &peripheralStatus_t::PMS5003Sensor,
+     vMsp_detectPMS5003, vMsp_acquirePMS5003, vMsp_accumulatePMS5003, vHalSensor_averagePMS5003},
+    // the O3 temperature compensation needs the BME680 sample of the same period
+    {"O3", ACQ_BUS_ADC, SENSOR_DRIVER_ANY_GAS, SENS_STAT_O3, &peripheralStatus_t::O3Sensor,
+     vMsp_detectO3, vMsp_acquireO3, vMsp_accumulateO3, vHalSensor_averageO3},
+};
+#define SENSOR_DRIVER_COUNT (sizeof(tSensorDrivers) / sizeof(tSensorDrivers[0]))
+
+// boot stages, in dependency order (bootPipeline.h)
+typedef enum __BOOT_STAGE_ID__
+{
+  BOOT_STAGE_SD_READ,
+  BOOT_STAGE_FW_PENDING,
+  BOOT_STAGE_CONFIGURE,
+  BOOT_STAGE_NETWORK,
+#ifndef ENABLE_FIRMWARE_UPDATE_TESTS
+  BOOT_STAGE_I2C_SENSORS,
+  BOOT_STAGE_UART_SENSORS,
+  BOOT_STAGE_ADC_SENSORS,
+#endif
+  BOOT_STAGE_MAX
+} bootStageId_t;
+
+static const bootStage_t tBootStages[BOOT_STAGE_MAX] = {
+    {"sdRead", BOOT_LANE_MAIN, 0, vMsp_bootSdRead},
+    {"fwPending", BOOT_LANE_MAIN, 0, vMsp_bootFirmwarePending},
+    {"configure", BOOT_LANE_MAIN, 0, vMsp_bootConfigure},
+    {"network", BOOT_LANE_MAIN, 0, vMsp_bootNetwork},
+#ifndef ENABLE_FIRMWARE_UPDATE_TESTS
+    // the BSEC state and the gas sensor type come from the SD card, done with it once configured;
+    // every sensor lane waits for the configuration, their display events copy the strings it writes
+    {"i2cSensors", BOOT_LANE_I2C, BOOT_DEP(BOOT_STAGE_CONFIGURE), vMsp_bootI2cSensors},
+    {"uartSensors", BOOT_LANE_UART, BOOT_DEP(BOOT_STAGE_CONFIGURE), vMsp_bootUartSensors},
+    {"adcSensors", BOOT_LANE_ADC, BOOT_DEP(BOOT_STAGE_CONFIGURE), vMsp_bootAdcSensors},
+#endif
+};
+
 //*******************************************************************************************************************************
 
 void Msp_getSystemStatus(systemStatus_t *stat)
@@ -149,12 +274,12 @@ void setup()
 {
   memset(&mainStateMachine, 0, sizeof(mainStateMachine)); // Initialize the state machine structure
   memset(&sensorData_accumulate, 0, sizeof(sensorData_accumulate));
-  memset(&sensorData_single, 0, sizeof(sensorData_single));
   sysData = systemData_t();
 
   vMsp_setGpioPins();
 
   vMspOs_initDataAccessMutex(); // Create the OS mutex for data access
+  vHalSdLog_init();             // and the one of the SD log streams
 
   // init the sensor data structure /status / offset values with defualt values
   vMspInit_sensorStatusAndData(&sensorData_accumulate);
@@ -192,6 +317,10 @@ void setup()
   printf("Refactor and optimization by AB-Engineering - https://ab-engineering.it\n");
   printf("Compiled %s %s\n", __DATE__, __TIME__);
 
+#ifdef MSP_BENCHMARK
+  vMspBench_run(); // sensor math cost per call, before the sensors and the network task start
+#endif
+
   vMsp_updateDataAndSendEvent(DISP_EVENT_DEVICE_BOOT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
 #ifdef VERSION_STRING
@@ -221,223 +350,29 @@ void setup()
     // Could implement rollback logic here if needed
   }
 
-  // STEP 1: Single SD Card Configuration Reading
-  log_i("=== STEP 1: Loading complete system configuration from SD card ===");
-  vHalSdcard_readSD(&sysStat, &devinfo, &sensorData_accumulate, &measStat, &sysData);
-
-  // Phase 2: Check for downloaded firmware and apply update if newer
-  if (SD.exists("/firmware.bin"))
-  {
-    log_i("Downloaded firmware file found - checking for update");
-    if (bHalFirmware_checkAndApplyPendingUpdate("/firmware.bin"))
-    {
-      log_i("Firmware update applied successfully");
-    }
-    else
-    {
-      log_w("No firmware update needed or update failed - cleaning up file");
-    }
-    // Always remove firmware file after processing
-    if (SD.remove("/firmware.bin"))
-    {
-      log_i("Firmware file cleaned up successfully");
-    }
-    else
-    {
-      log_w("Failed to remove firmware.bin file");
-    }
-  }
-
-  // STEP 2: Fill system configuration with SD data or defaults
-  log_i("=== STEP 2: Configuring system with loaded data or defaults ===");
-  vMspInit_configureSystemFromSD(&sysData, &sysStat, &devinfo, &measStat);
-
-  // Debug: Check final configuration status
-  log_i("Final Configuration Status:");
-  log_i("  SD Card: %s", sysStat.sdCard ? "OK" : "FAILED");
-  log_i("  Config File: %s", sysStat.configuration ? "OK" : "FAILED");
-  log_i("  WiFi SSID: %s", devinfo.ssid.c_str());
-  log_i("  Server: %s", sysData.server.c_str());
-  log_i("  *** MEASUREMENT CONFIG: avg_measurements=%d, max_measurements=%d ***", measStat.avg_measurements, measStat.max_measurements);
-  log_i("  Use Modem: %s", sysStat.use_modem ? "YES" : "NO");
-  log_i("  Firmware Auto-Upgrade: %s", sysStat.fwAutoUpgrade ? "ENABLED" : "DISABLED");
-
-  // Firmware update tests will be run after network connection is established
-
-  // STEP 3: Start network task with complete configuration
-  log_i("=== STEP 3: Starting network task ===");
-  createNetworkEvents();
-  initSendDataOp(&sysData, &sysStat, &devinfo);
-
-  // Wait for network task to initialize
-  vTaskDelay(pdMS_TO_TICKS(2000));
-
-  measStat.max_measurements = measStat.avg_measurements; /*!< fill the max_measurements with the number set by the user */
-
-#ifndef ENABLE_FIRMWARE_UPDATE_TESTS
-  //++++++++++++++++ DETECT AND INIT SENSORS ++++++++++++++++++++++++++++++
-  log_i("Detecting and initializing sensors...\n");
-
-  // BME680 +++++++++++++++++++++++++++++++++++++
-  vMsp_updateDataAndSendEvent(DISP_EVENT_BME680_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-
-  bme680.begin(BME68X_I2C_ADDR_HIGH, Wire);
-  if (tHalSensor_checkBMESensor(&bme680))
-  {
-    log_i("BME680 sensor detected, initializing...\n");
-    bsec_virtual_sensor_t sensor_list[] = {
-        BSEC_OUTPUT_RAW_TEMPERATURE,
-        BSEC_OUTPUT_RAW_PRESSURE,
-        BSEC_OUTPUT_RAW_HUMIDITY,
-        BSEC_OUTPUT_RAW_GAS,
-        BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE,
-        BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY,
-    };
-    bme680.updateSubscription(sensor_list, sizeof(sensor_list) / sizeof(sensor_list[0]), BSEC_SAMPLE_RATE_LP);
-    sensorData_accumulate.status.BME680Sensor = true;
-    vMsp_updateDataAndSendEvent(DISP_EVENT_BME680_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-  }
-  else
-  {
-    log_e("BME680 sensor not detected!\n");
-    vMsp_updateDataAndSendEvent(DISP_EVENT_BME680_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-  }
-  //+++++++++++++++++++++++++++++++++++++++++++++
-
-  // PMS5003 ++++++++++++++++++++++++++++++++++++
-  pmsSerial.begin(9600, SERIAL_8N1, PMSERIAL_RX, PMSERIAL_TX); // baud, type, ESP_RX, ESP_TX
-  delay(1500);
-  vMsp_updateDataAndSendEvent(DISP_EVENT_PMS5003_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-  delay(1000);
-  if (pms.readUntil(data))
-  {
-    log_i("PMS5003 sensor detected, initializing...\n");
-    sensorData_accumulate.status.PMS5003Sensor = true;
-    vMsp_updateDataAndSendEvent(DISP_EVENT_PMS5003_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-    measStat.isPmsAwake = true;
-  }
-  else
-  {
-    log_e("PMS5003 sensor not detected!\n");
-    vMsp_updateDataAndSendEvent(DISP_EVENT_PMS5003_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-  }
-  //++++++++++++++++++++++++++++++++++++++++++++++
-
-  // MICSxx14 ++++++++++++++++++++++++++++++++++++
-  vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-
-  // Initialize gas sensor based on configuration type
-  switch (sysStat.gasSensorType)
-  {
-  case GAS_SENSOR_MICS6814:
-  {
-    if (gas.begin())
-    { // Connect to MICS6814 sensor using default I2C address (0x04)
-      log_i("MICS6814 sensor detected, initializing...\n");
-      sensorData_accumulate.status.MICS6814Sensor = true;
-      gas.powerOn(); // turn on heating element and led
-      gas.ledOn();
-      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-
-      sensorR0Value_t r0Values;
-      r0Values.redSensor = gas.getBaseResistance(CH_RED);
-      r0Values.oxSensor = gas.getBaseResistance(CH_OX);
-      r0Values.nh3Sensor = gas.getBaseResistance(CH_NH3);
-
-      if (tHalSensor_checkMicsValues(&sensorData_accumulate, &r0Values) == STATUS_OK)
-      {
-        log_i("MICS6814 R0 values are already as default!\n");
-        vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_VALUES_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-      }
-      else
-      {
-        log_i("Setting MICS6814 R0 values as default... ");
-        vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_DEF_SETTING, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-
-        vHalSensor_writeMicsValues(&sensorData_accumulate);
+  // STEP 1-3: SD configuration, network task and sensor detection, in parallel where the hardware allows
+  log_i("=== Boot pipeline: SD configuration, network task and sensors ===");
+  ulMspBoot_run(tBootStages, BOOT_STAGE_MAX, pdMS_TO_TICKS(BOOT_RUN_TIMEOUT_MS));
 
-        vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_DONE, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-        log_i("Done!\n");
-      }
-      gas.setOffsets(&sensorData_accumulate.micsTuningData.sensingResInAirOffset.redSensor);
-    }
-    else
-    {
-      log_e("MICS6814 sensor not detected!\n");
-      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-    }
-    break;
-  }
+  // Every raw sample of the last hours, for the dumps the server asks for
+  bMspHistory_init(measStat.delay_between_measurements);
+  vMspRollup_init(measStat.delay_between_measurements);
+  vMspAq_init(measStat.delay_between_measurements);
 
-  case GAS_SENSOR_MICS4514:
+  // Sensor acquisition, one worker per bus running the drivers of its sensors in table order
+  vMspAcq_init();
+  vMspHealth_init();
+  for (uint32_t i = 0; i < SENSOR_DRIVER_COUNT; i++)
   {
-    log_i("Initializing MICS4514 sensor (DFRobot SEN0377)...\n");
-    if (mics4514.begin())
-    {
-      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-      // Connect to MICS4514 sensor using I2C
-      log_i("MICS4514 sensor detected, initializing...\n");
-      sensorData_accumulate.status.MICS4514Sensor = true;
-
-      mics4514.wakeUpMode();
-
-      // Start sensor warmup process
-      log_i("Starting MICS4514 warmup process (%d minutes)...\n", MICS4514_WARMUP_TIME_MIN);
-      uint8_t loadingStep = 0;
-      float delayInMs = 5000.0;
-      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_HEATING_UP, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-      while (mics4514.warmUpTime(MICS4514_WARMUP_TIME_MIN) == false)
-      {
-        // stay here, until the sensor get heaten up.
-        printf("MIXS4514 - Heat-Up: %3.1f %%\n", (float)((loadingStep * delayInMs) / ((MICS4514_WARMUP_TIME_MIN * 60.0f * 1000.0f)) * 100.0f));
-        vTaskDelay(pdMS_TO_TICKS((int32_t)delayInMs));
-        loadingStep++;
-      }
-
-      // Initialize MICS4514 specific data
-      sensorData_accumulate.mics4514Data.warmupComplete = 0;
-      sensorData_accumulate.mics4514Data.powerState = 1;
-
-      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_DONE, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-      log_i("MICS4514 initialization complete!\n");
-    }
-    else
+    if (bMsp_driverSelected(&tSensorDrivers[i]))
     {
-      log_e("MICS4514 sensor not detected!\n");
-      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+      bMspAcq_addJob(tSensorDrivers[i].bus, tSensorDrivers[i].sample);
     }
-    break;
-  }
-
-  default:
-  {
-    log_e("Unknown gas sensor type: %d\n", sysStat.gasSensorType);
-    vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-    break;
-  }
-  }
-  //+++++++++++++++++++++++++++++++++++++++++++++++++++
-
-  // O3 ++++++++++++++++++++++++++++++++++++++++++
-  vMsp_updateDataAndSendEvent(DISP_EVENT_O3_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-
-  if (!tHalSensor_isAnalogO3Connected())
-  {
-    log_e("O3 sensor not detected!\n");
-    vMsp_updateDataAndSendEvent(DISP_EVENT_O3_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
-    sensorData_accumulate.status.O3Sensor = false;
   }
-  else
+  for (uint32_t bus = 0; bus < ACQ_BUS_MAX; bus++)
   {
-    log_i("O3 sensor detected, running...\n");
-    sensorData_accumulate.status.O3Sensor = true;
-    vMsp_updateDataAndSendEvent(DISP_EVENT_O3_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+    vMspAcq_setOutput((acqBus_t)bus, &tBusOutput[bus], sizeof(tBusOutput[bus]));
   }
-#endif
-  //+++++++++++++++++++++++++++++++++++++++++++++++++++++
-
-  // Always use 1-minute intervals for measurements
-  measStat.delay_between_measurements = SEC_IN_MIN;
 
   /*!< Reset measurement count */
   measStat.measurement_count = 0;
@@ -455,6 +390,7 @@ void setup()
   measStat.curr_seconds = 0;
   measStat.curr_total_seconds = 0;
   measStat.last_transmission_epoch = 0; // 0 = never transmitted
+  measStat.last_read_epoch = 0;         // 0 = no reading yet
 
   // STEP 4: Request network connection and wait for NTP sync
   log_i("=== STEP 4: Requesting network connection and NTP sync ===");
@@ -475,8 +411,7 @@ void setup()
   //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
   mainStateMachine.isFirstTransition = true; // set first transition flag
 
-  // copy the whole sensorData_accumulate into sensorData_single
-  memcpy(&sensorData_single, &sensorData_accumulate, sizeof(sensorData_t));
+  vMspLatency_init(); // the first state visit starts here
 
 } // end of SETUP
 //*******************************************************************************************************************************
@@ -716,7 +651,7 @@ void loop()
       current_day = -1;
     }
 
-    vMsp_updateDataAndSendEvent(DISP_EVENT_WAIT_FOR_TIMEOUT, &sensorData_single, &devinfo, &measStat, &sysData, &sysStat);
+    vMsp_updateDataAndSendEvent(DISP_EVENT_WAIT_FOR_TIMEOUT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
     break;
   }
     //------------------------------------------------------------------------------------------------------------------------
@@ -730,6 +665,7 @@ void loop()
     { // Check every 30 seconds
       lastSdCheck = millis();
       vHalSdcard_periodicCheck(&sysStat, &devinfo);
+      vHalSdLog_poll(); // lines waiting too long, files of a day that is over
     }
 
     if (getLocalTime(&timeinfo))
@@ -738,10 +674,13 @@ void loop()
       measStat.curr_seconds = timeinfo.tm_sec;
       measStat.curr_total_seconds = measStat.curr_minutes * SEC_IN_MIN + measStat.curr_seconds;
 
-      // Calculate if we are exactly at the start of a minute (00 seconds)
-      // We trigger measurement only when seconds == 0, ensuring exact minute alignment
+      // Calculate if we are exactly at the start of a sampling period (00 seconds with the default 60 s)
+      // We trigger measurement only on a multiple of the period, ensuring exact alignment
       measStat.timeout_seconds = ((measStat.curr_total_seconds + measStat.additional_delay) % measStat.delay_between_measurements);
 
+      // Wake the PMS5003 ahead of the next measurement, it sleeps in between
+      vMsp_pmsDutyCycle(measStat.delay_between_measurements - measStat.timeout_seconds);
+
       // It is time for a measurement? If so continue, otherwise break.
       if (measStat.timeout_seconds != 0)
       {
@@ -749,7 +688,14 @@ void loop()
         break;
       }
 
-      // It is time for a measurement - trigger at exactly 00 seconds of every minute
+      // A reading can complete within the trigger second, take only one per period
+      if (mktime(&timeinfo) == measStat.last_read_epoch)
+      {
+        mainStateMachine.next_state = SYS_STATE_WAIT_FOR_TIMEOUT;
+        break;
+      }
+
+      // It is time for a measurement - trigger at exactly the start of every period
       if (measStat.timeout_seconds == 0)
       {
         log_i("Timeout expired!");
@@ -763,7 +709,7 @@ void loop()
         // if it is not the first transition, wait for timeout
         if (measStat.isSensorDataAvailable == false)
         {
-          vMsp_updateDataAndSendEvent(DISP_EVENT_WAIT_FOR_TIMEOUT, &sensorData_single, &devinfo, &measStat, &sysData, &sysStat);
+          vMsp_updateDataAndSendEvent(DISP_EVENT_WAIT_FOR_TIMEOUT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
           delay(500);
         }
       }
@@ -788,76 +734,67 @@ void loop()
     {
       log_i("Starting new measurement cycle - resetting accumulation variables");
       // Reset sensor accumulation variables for new measurement cycle
-      sensorData_accumulate.gasData.temperature = 0.0f;
-      sensorData_accumulate.gasData.pressure = 0.0f;
-      sensorData_accumulate.gasData.humidity = 0.0f;
-      sensorData_accumulate.gasData.volatileOrganicCompounds = 0.0f;
-      sensorData_accumulate.airQualityData.particleMicron1 = 0.0f;
-      sensorData_accumulate.airQualityData.particleMicron25 = 0.0f;
-      sensorData_accumulate.airQualityData.particleMicron10 = 0.0f;
-      sensorData_accumulate.pollutionData.carbonMonoxide = 0.0f;
-      sensorData_accumulate.pollutionData.nitrogenDioxide = 0.0f;
-      sensorData_accumulate.pollutionData.ammonia = 0.0f;
-      sensorData_accumulate.ozoneData.ozone = 0.0f;
+      vMspChan_resetAll(&sensorData_accumulate);
 
       // Reset MICS4514 ADC accumulator for new measurement cycle
       sensorData_accumulate.mics4514AdcAccumulator.oxVoltageSum = 0;
       sensorData_accumulate.mics4514AdcAccumulator.redVoltageSum = 0;
+      vMspStats_resetAll(channelStats);
 
-      // Calculate measurements needed to reach next transmission boundary
-      // For max_measurements=5: boundaries at 0,5,10,15,20,25,30,35,40,45,50,55
-      int minutes_to_next_boundary = 0;
-      int next_boundary_minute = 0;
+      // Calculate measurements needed to reach next transmission boundary, counted in
+      // sampling periods (slots) since the start of the hour: one slot per minute by default
+      // For max_measurements=5: boundaries at minutes 0,5,10,15,20,25,30,35,40,45,50,55
+      int32_t interval_slots = lMsp_intervalSlots();
+      int32_t curr_slot = measStat.curr_total_seconds / measStat.delay_between_measurements;
+      int slots_to_next_boundary = 0;
+      int next_boundary_slot = 0;
 
-      // Calculate next boundary from current minute
+      // Calculate next boundary from current slot
       // If we're exactly at a boundary, move to the NEXT one
-      if ((measStat.curr_minutes % measStat.max_measurements) == 0)
+      if ((curr_slot % interval_slots) == 0)
       {
         // Currently at a boundary (e.g., minute 5 with max_measurements=5)
         // Next boundary is one full interval away
-        next_boundary_minute = measStat.curr_minutes + measStat.max_measurements;
+        next_boundary_slot = curr_slot + interval_slots;
       }
       else
       {
         // Not at a boundary, find the next one
-        next_boundary_minute = ((measStat.curr_minutes / measStat.max_measurements) + 1) * measStat.max_measurements;
+        next_boundary_slot = ((curr_slot / interval_slots) + 1) * interval_slots;
       }
 
       // Calculate measurements needed BEFORE handling hour wraparound
-      // This way we can calculate correctly even when next_boundary > 60
-      if (next_boundary_minute > measStat.curr_minutes)
+      // This way we can calculate correctly even when next_boundary is past the hour
+      if (next_boundary_slot > curr_slot)
       {
         // Normal case or max_measurements=60 from minute 0
-        // Examples:
+        // Examples with the default 60 s period:
         //   - minute 3 to boundary 5: (5-3)+1 = 3 measurements
         //   - minute 0 to boundary 60: (60-0)+1 = 61, capped to 60
-        minutes_to_next_boundary = (next_boundary_minute - measStat.curr_minutes) + 1;
+        slots_to_next_boundary = (next_boundary_slot - curr_slot) + 1;
       }
       else
       {
         // This should not happen with correct logic above, but handle it safely
-        minutes_to_next_boundary = measStat.max_measurements;
-      }
-
-      // Handle hour wraparound for next_boundary (for display purposes only)
-      if (next_boundary_minute >= 60)
-      {
-        next_boundary_minute = 0; // Wrap to minute 00 of next hour
+        slots_to_next_boundary = interval_slots;
       }
 
       // Special case: if we calculated more measurements than the interval allows,
-      // cap it to max_measurements (happens when starting exactly at a boundary)
-      if (minutes_to_next_boundary > measStat.max_measurements)
+      // cap it to the interval (happens when starting exactly at a boundary)
+      if (slots_to_next_boundary > interval_slots)
       {
-        minutes_to_next_boundary = measStat.max_measurements;
+        slots_to_next_boundary = interval_slots;
       }
 
-      measStat.avg_measurements = minutes_to_next_boundary;
+      measStat.avg_measurements = slots_to_next_boundary;
+
+      // Boundary minute, wrapped to minute 00 of the next hour (for display purposes only)
+      int next_boundary_minute = ((next_boundary_slot * measStat.delay_between_measurements) / SEC_IN_MIN) % 60;
 
-      log_i("BOUNDARY CALCULATION: curr_minute=%d, max_measurements(interval)=%d, cycle_needs(dynamic)=%d, next_boundary=%d",
-            measStat.curr_minutes, measStat.max_measurements, minutes_to_next_boundary, next_boundary_minute);
-      log_i("TIMING ALIGNMENT: Will collect %d measurements from minute %d to boundary minute %d",
-            measStat.avg_measurements, measStat.curr_minutes, next_boundary_minute);
+      log_i("BOUNDARY CALCULATION: curr_minute=%d, max_measurements(interval)=%d, sampling_period=%ds, cycle_needs(dynamic)=%d, next_boundary=%d",
+            measStat.curr_minutes, measStat.max_measurements, measStat.delay_between_measurements, slots_to_next_boundary, next_boundary_minute);
+      log_i("TIMING ALIGNMENT: Will collect %d measurements from %02d:%02d to boundary minute %d",
+            measStat.avg_measurements, measStat.curr_minutes, measStat.curr_seconds, next_boundary_minute);
 
       if (measStat.avg_measurements == 0)
       {
@@ -885,672 +822,1446 @@ void loop()
     }
 
     log_i("=== READING SENSOR #%d (target: %d measurements) ===", measStat.measurement_count + 1, measStat.avg_measurements);
+    measStat.last_read_epoch = mktime(&timeinfo); // minute the wait state triggered this reading in
+    memset(&tSample, 0, sizeof(tSample));
+    tSample.epoch = (uint32_t)measStat.last_read_epoch;
 
-    vMsp_updateDataAndSendEvent(DISP_EVENT_READING_SENSORS, &sensorData_single, &devinfo, &measStat, &sysData, &sysStat);
+    vMsp_updateDataAndSendEvent(DISP_EVENT_READING_SENSORS, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
-    // READING BME680
-    if (sensorData_accumulate.status.BME680Sensor)
+    // All sensors are sampled at once, one worker per bus (acquisition.h)
+    uint32_t acquired = ulMspAcq_run(pdMS_TO_TICKS(ACQ_RUN_TIMEOUT_MS));
+    if (acquired != ACQ_ALL_BUSES)
     {
-      log_i("Sampling BME680 sensor...");
-      err.count = 0;
-      // Attempt to read BME680 sensor with maximum retries
-      bool sensor_read_success = false;
-      for (int retry = 0; retry < MAX_SENSOR_RETRIES; retry++)
-      {
-        if (!tHalSensor_checkBMESensor(&bme680))
-        {
-          err.count++;
-          log_w("BME680 sensor check failed, attempt %d/%d", retry + 1, MAX_SENSOR_RETRIES);
-          if (retry == (MAX_SENSOR_RETRIES - 1)) // Last attempt failed
-          {
-            log_e("Error while sampling BME680 sensor after %d attempts!", MAX_SENSOR_RETRIES);
-            err.BMEfails++;
-            break;
-          }
-          delay(1000);
-          continue;
-        }
-
-        // Trigger measurement if this is the first attempt
-        if (retry == 0)
-        {
-          // Give BME680 time to prepare measurement (especially gas sensor)
-          delay(500);
-        }
-
-        if (!bme680.run())
-        {
-          log_v("BME680 sensor not ready, waiting... (attempt %d/%d)", retry + 1, MAX_SENSOR_RETRIES);
-          if (retry == (MAX_SENSOR_RETRIES - 1)) // Last attempt and still not ready
-          {
-            log_w("BME680 sensor not ready after %d attempts - measurement #%d will be excluded from averaging", MAX_SENSOR_RETRIES, measStat.measurement_count + 1);
-            err.BMEfails++;
-          }
-          // Increase delay for BME680 gas measurement to complete (datasheet: 150-350ms)
-          delay(300);
-          continue;
-        }
+      log_e("Sensor acquisition incomplete, bus mask 0x%02lx", (unsigned long)acquired);
+    }
 
-        // Successfully read sensor data
-        sensor_read_success = true;
-        localData.temperature = bme680.temperature;
-        log_i("BME680 Temperature: %.3f C (measurement #%d)", localData.temperature, measStat.measurement_count + 1);
-        sensorData_accumulate.gasData.temperature += localData.temperature;
-        sensorData_single.gasData.temperature = localData.temperature;
-        log_i("Temperature accumulated total: %.3f C", sensorData_accumulate.gasData.temperature);
-
-        localData.pressure = bme680.pressure / PERCENT_DIVISOR;
-        localData.pressure = (localData.pressure *
-                              pow(1 - (STD_TEMP_LAPSE_RATE * sensorData_accumulate.gasData.seaLevelAltitude /
-                                       (localData.temperature + STD_TEMP_LAPSE_RATE * sensorData_accumulate.gasData.seaLevelAltitude + CELIUS_TO_KELVIN)),
-                                  ISA_DERIVED_EXPONENTIAL));
-        log_v("Pressure(hPa): %.3f", localData.pressure);
-        sensorData_accumulate.gasData.pressure += localData.pressure;
-        sensorData_single.gasData.pressure = localData.pressure;
-
-        localData.humidity = bme680.humidity;
-        log_v("Humidity(perc.): %.3f", localData.humidity);
-        sensorData_accumulate.gasData.humidity += localData.humidity;
-        sensorData_single.gasData.humidity = localData.humidity;
-
-        localData.volatileOrganicCompounds = bme680.gasResistance / MICROGRAMS_PER_GRAM;
-        localData.volatileOrganicCompounds = fHalSensor_no2AndVocCompensation(localData.volatileOrganicCompounds, &localData, &sensorData_accumulate);
-        log_v("Compensated gas resistance(kOhm): %.3f\n", localData.volatileOrganicCompounds);
-        sensorData_accumulate.gasData.volatileOrganicCompounds += localData.volatileOrganicCompounds;
-        sensorData_single.gasData.volatileOrganicCompounds = localData.volatileOrganicCompounds;
-        break;
-      }
+    // The I2C worker is idle now, the BSEC state can be read out and the MICS R0 updated
+    if (acquired & (1U << ACQ_BUS_I2C))
+    {
+      vMsp_saveBsecState();
+      vMsp_trackMicsBaseline();
+    }
 
-      if (sensor_read_success)
+    // The results of the buses that completed; a late worker keeps writing only its own output
+    for (uint32_t bus = 0; bus < ACQ_BUS_MAX; bus++)
+    {
+      const acqBusOutput_t *p_tOut = &tBusOutput[bus];
+      if (acquired & (1U << bus))
       {
-        log_i("BME680 measurement #%d completed successfully", measStat.measurement_count + 1);
+        vMspRing_mergeChannels(&tSample, &p_tOut->sample);
+        err.BMEfails += p_tOut->err.BMEfails;
+        err.PMSfails += p_tOut->err.PMSfails;
+        err.MICSfails += p_tOut->err.MICSfails;
+        err.O3fails += p_tOut->err.O3fails;
+        sensorData_accumulate.mics4514AdcAccumulator.oxVoltageSum += p_tOut->micsAdc.oxVoltageSum;
+        sensorData_accumulate.mics4514AdcAccumulator.redVoltageSum += p_tOut->micsAdc.redVoltageSum;
       }
     }
-    //------------------------------------------------------------------------------------------------------------------------
-    //------------------------------------------------------------------------------------------------------------------------
 
-    // Gas sensor reading (MICS6814 or MICS4514)
-    switch (sysStat.gasSensorType)
-    {
-    case GAS_SENSOR_MICS6814:
+    // The sensors of a late bus count a failed read, their sample is dropped;
+    // then the readings that need the sample of another bus, the O3 one the BME680 temperature
+    for (uint32_t i = 0; i < SENSOR_DRIVER_COUNT; i++)
     {
-      if (sensorData_accumulate.status.MICS6814Sensor)
+      const sensorDriver_t *p_tDriver = &tSensorDrivers[i];
+      if (!bMsp_driverSelected(p_tDriver))
       {
-        log_i("Sampling MICS6814 sensor...");
-        err.count = 0;
-        // Attempt to read MICS6814 sensor with maximum retries
-        bool mics_read_success = false;
-        for (int retry = 0; retry < MAX_SENSOR_RETRIES; retry++)
-        {
-          MICS6814SensorReading_t micsLocData;
-
-          micsLocData.carbonMonoxide = gas.measureCO();
-          micsLocData.nitrogenDioxide = gas.measureNO2();
-          micsLocData.ammonia = gas.measureNH3();
+        continue;
+      }
+      bool sampled = (acquired & (1U << p_tDriver->bus)) != 0;
+      if (!sampled && sensorData_accumulate.status.*p_tDriver->status)
+      {
+        vMsp_countFailedRead(p_tDriver->statSlot);
+      }
+      if (p_tDriver->accumulate != NULL)
+      {
+        p_tDriver->accumulate(sampled);
+      }
+    }
 
-          if ((micsLocData.carbonMonoxide < 0) || (micsLocData.nitrogenDioxide < 0) || (micsLocData.ammonia < 0))
-          {
-            err.count++;
-            log_w("MICS6814 sensor reading failed, attempt %d/%d", retry + 1, MAX_SENSOR_RETRIES);
-            if (retry == (MAX_SENSOR_RETRIES - 1)) // Last attempt failed
-            {
-              log_e("Error while sampling MICS6814 sensor after %d attempts!", MAX_SENSOR_RETRIES);
-              err.MICSfails++;
-              break;
-            }
-            delay(1000);
-            continue;
-          }
+    // The sample is complete: into the averaging interval, one copy for the display, one for the raw history
+    tSample.ms = millis();
+    vMsp_aggregateSample(&tSample);
+    bTaskDisplay_pushSample(&tSample);
+    vMspHistory_add(&tSample);
 
-          // Successfully read sensor data
-          mics_read_success = true;
-          micsLocData.carbonMonoxide = vGeneric_convertPpmToUgM3(micsLocData.carbonMonoxide, sensorData_accumulate.molarMass.carbonMonoxide);
-          log_v("CO(ug/m3): %.3f", micsLocData.carbonMonoxide);
-          sensorData_accumulate.pollutionData.carbonMonoxide += micsLocData.carbonMonoxide;
-          sensorData_single.pollutionData.carbonMonoxide = micsLocData.carbonMonoxide;
+    measStat.isSensorDataAvailable = true;
 
-          micsLocData.nitrogenDioxide = vGeneric_convertPpmToUgM3(micsLocData.nitrogenDioxide, sensorData_accumulate.molarMass.nitrogenDioxide);
-          if (sensorData_accumulate.status.BME680Sensor)
-          {
-            micsLocData.nitrogenDioxide = fHalSensor_no2AndVocCompensation(micsLocData.nitrogenDioxide, &localData, &sensorData_accumulate);
-          }
-          log_v("NOx(ug/m3): %.3f", micsLocData.nitrogenDioxide);
-          sensorData_accumulate.pollutionData.nitrogenDioxide += micsLocData.nitrogenDioxide;
-          sensorData_single.pollutionData.nitrogenDioxide = micsLocData.nitrogenDioxide;
+    measStat.measurement_count++;
+    log_i("MEASUREMENT COUNT: Incremented to %d (target: %d measurements)", measStat.measurement_count, measStat.avg_measurements);
+    log_i("Current minute: %d, expected transmission at boundary: %s",
+          measStat.curr_minutes, ((measStat.curr_minutes % measStat.max_measurements) == 0) ? "YES" : "NO");
 
-          micsLocData.ammonia = vGeneric_convertPpmToUgM3(micsLocData.ammonia, sensorData_accumulate.molarMass.ammonia);
-          log_v("NH3(ug/m3): %.3f\n", micsLocData.ammonia);
-          sensorData_accumulate.pollutionData.ammonia += micsLocData.ammonia;
-          sensorData_single.pollutionData.ammonia = micsLocData.ammonia;
+    log_i("Sensor values AFTER evaluation:\n");
+    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d\n",
+          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure, sensorData_accumulate.gasData.volatileOrganicCompounds,
+          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
+          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
+          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count);
+    log_i("Measurements done, going to timeout...\n");
 
-          break;
-        }
+    mainStateMachine.prev_state = SYS_STATE_READ_SENSORS;
+    mainStateMachine.next_state = SYS_STATE_EVAL_SENSOR_STATUS;
+    break;
+  }
+  //------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------
+  case SYS_STATE_EVAL_SENSOR_STATUS:
+  {
+    log_i("Evaluating sensor status...");
 
-        if (mics_read_success)
-        {
-          log_i("MICS6814 measurement #%d completed successfully", measStat.measurement_count + 1);
-        }
-      }
-      break;
+    // Update current time for clock-aligned mode evaluation
+    if (getLocalTime(&timeinfo))
+    {
+      measStat.curr_minutes = timeinfo.tm_min;
+      measStat.curr_seconds = timeinfo.tm_sec;
+      measStat.curr_total_seconds = measStat.curr_minutes * SEC_IN_MIN + measStat.curr_seconds;
+      log_v("Current time for evaluation: %02d:%02d", timeinfo.tm_hour, measStat.curr_minutes);
     }
-    case GAS_SENSOR_MICS4514:
+    // Restore the flag of the sensors whose average failed in the last cycle
+    for (uint32_t i = 0; i < SENSOR_DRIVER_COUNT; i++)
     {
-      if (sensorData_accumulate.status.MICS4514Sensor)
+      const sensorDriver_t *p_tDriver = &tSensorDrivers[i];
+      if (bMsp_driverSelected(p_tDriver) && (err.senserrs[p_tDriver->statSlot] == true))
       {
-        log_i("Sampling MICS4514 sensor...");
-        err.count = 0;
-        // Attempt to read MICS4514 sensor with maximum retries
-        bool mics_read_success = false;
-        for (int retry = 0; retry < MAX_SENSOR_RETRIES; retry++)
-        {
-          MICS4514SensorReading_t micsLocData;
+        sensorData_accumulate.status.*p_tDriver->status = true;
+      }
+    }
 
-          // Read raw ADC values and accumulate for averaging
-          if (tHalSensor_readMICS4514_ADC(mics4514, &sensorData_accumulate) != STATUS_OK)
-          {
-            err.count++;
-            log_w("MICS4514 ADC reading failed, attempt %d/%d", retry + 1, MAX_SENSOR_RETRIES);
-            if (retry == (MAX_SENSOR_RETRIES - 1)) // Last attempt failed
-            {
-              log_e("Error while reading MICS4514 ADC after %d attempts!", MAX_SENSOR_RETRIES);
-              err.MICSfails++;
-              break;
-            }
-            delay(1000);
-            continue;
-          }
+    // Check if it's time to send data
+    // We transmit when:
+    //   1) At a clock-aligned interval boundary (first sampling period of minute curr_minutes % max_measurements == 0)
+    //      OR enough seconds have elapsed since the last transmission (fallback for missed windows)
+    //   2) Enough measurements have been collected for this cycle
+    //   3) Haven't already transmitted in this boundary window
 
-          // Also calculate immediate gas concentrations for real-time display (sensorData_single)
-          // This provides instant feedback for LCD while accumulating for accurate averaging
-          if (tHalSensor_calculateMICS4514_Immediate(mics4514, &sensorData_accumulate, &micsLocData) == STATUS_OK)
-          {
-            // Convert PPM to ug/m3 for immediate display values (same as old approach)
-            micsLocData.carbonMonoxide = vGeneric_convertPpmToUgM3(micsLocData.carbonMonoxide, sensorData_accumulate.molarMass.carbonMonoxide);
-            log_v("CO(ug/m3): %.3f", micsLocData.carbonMonoxide);
-            sensorData_single.pollutionData.carbonMonoxide = micsLocData.carbonMonoxide;
-
-            // Convert NO2 from PPM to ug/m3 (with optional BME680 compensation)
-            micsLocData.nitrogenDioxide = vGeneric_convertPpmToUgM3(micsLocData.nitrogenDioxide, sensorData_accumulate.molarMass.nitrogenDioxide);
-            if (sensorData_accumulate.status.BME680Sensor)
-            {
-              micsLocData.nitrogenDioxide = fHalSensor_no2AndVocCompensation(micsLocData.nitrogenDioxide, &localData, &sensorData_accumulate);
-            }
-            log_v("NOx(ug/m3): %.3f", micsLocData.nitrogenDioxide);
-            sensorData_single.pollutionData.nitrogenDioxide = micsLocData.nitrogenDioxide;
-
-            // Convert NH3 from PPM to ug/m3
-            micsLocData.ammonia = vGeneric_convertPpmToUgM3(micsLocData.ammonia, sensorData_accumulate.molarMass.ammonia);
-            log_v("NH3(ug/m3): %.3f", micsLocData.ammonia);
-            sensorData_single.pollutionData.ammonia = micsLocData.ammonia;
-
-            log_i("MICS4514 immediate values for display: CO=%.2f, NO2=%.2f, NH3=%.2f ug/m3",
-                  micsLocData.carbonMonoxide, micsLocData.nitrogenDioxide, micsLocData.ammonia);
-          }
-          else
-          {
-            log_w("MICS4514 immediate gas calculation failed, keeping previous display values");
-          }
+    time_t now_epoch = mktime(&timeinfo);
 
-          // Successfully read and accumulated ADC data
-          mics_read_success = true;
-          log_i("MICS4514 measurement #%d: ADC accumulated and display updated", measStat.measurement_count + 1);
+    // Compute seconds elapsed since last transmission (0 if never transmitted)
+    int32_t seconds_since_last_tx = (measStat.last_transmission_epoch > 0)
+                                    ? (int32_t)(now_epoch - measStat.last_transmission_epoch)
+                                    : 0;
 
-          break;
-        }
+    int32_t interval_seconds = (int32_t)(measStat.max_measurements * SEC_IN_MIN);
 
-        if (mics_read_success)
-        {
-          log_i("MICS4514 measurement #%d completed successfully", measStat.measurement_count + 1);
-        }
-        break;
-      }
-      break;
+    // Standard clock-aligned boundary (e.g. minute 0 for hourly, minute 0/30 for 30-min),
+    // only its first sampling period when sampling faster than once a minute
+    int32_t curr_slot = measStat.curr_total_seconds / measStat.delay_between_measurements;
+    bool at_boundary_slot = ((curr_slot % lMsp_intervalSlots()) == 0);
+    bool at_transmission_boundary = at_boundary_slot;
+
+    // Fallback: enough seconds have elapsed regardless of minute alignment.
+    // This handles all rollover cases (including 60-min: same minute across hours) and
+    // recovers gracefully if the exact boundary second is missed due to processing delays.
+    bool enough_time_passed = (measStat.last_transmission_epoch > 0) &&
+                              (seconds_since_last_tx >= interval_seconds);
+
+    at_transmission_boundary = at_transmission_boundary || enough_time_passed;
+
+    // Duplicate guard: only transmit once per boundary window.
+    // "Not yet transmitted" if we have never transmitted OR enough seconds have passed
+    // since the last one (i.e. we are in a new window, not the same one).
+    bool boundary_not_transmitted = (measStat.last_transmission_epoch == 0) || enough_time_passed;
+
+    // Measurement count guard: don't fire early (e.g. first boot at minute 0 reads
+    // only 1 sample before the boundary check would trigger).
+    bool enough_measurements = (measStat.measurement_count >= measStat.avg_measurements);
+
+    int curr_hour = timeinfo.tm_hour;
+    log_i("TRANSMISSION CHECK: collected %d/%d measurements, boundary=%s (time %02d:%02d, interval=%d), last_tx_epoch=%lld, secs_since_tx=%d",
+          measStat.measurement_count, measStat.avg_measurements,
+          at_transmission_boundary ? "YES" : "NO", curr_hour, measStat.curr_minutes, measStat.max_measurements,
+          (long long)measStat.last_transmission_epoch, seconds_since_last_tx);
+
+    log_i("BOUNDARY DETAILS: standard_boundary=%s, enough_time_passed=%s, enough_measurements=%s",
+          at_boundary_slot ? "YES" : "NO",
+          enough_time_passed ? "YES" : "NO",
+          enough_measurements ? "YES" : "NO");
+
+    if (at_transmission_boundary && boundary_not_transmitted && enough_measurements)
+    {
+      log_i("All measurements obtained, going to send data...\n");
+      mainStateMachine.next_state = SYS_STATE_SEND_DATA; // go to send data state
     }
-    default:
+    else if (!boundary_not_transmitted)
     {
-      log_w("WRONG GAS SENSOR SELECTED - OR NO GAS SENSOR");
-      break;
+      log_i("Data already transmitted at this boundary (%02d:%02d), waiting for next boundary", curr_hour, measStat.curr_minutes);
+      mainStateMachine.next_state = SYS_STATE_WAIT_FOR_TIMEOUT;
+    }
+    else
+    {
+      // MEASUREMENTS MESSAGE
+      log_i("Measurements in progress...\n");
+      vMsp_updateDataAndSendEvent(DISP_EVENT_SHOW_MEAS_DATA, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+
+      log_i("Not enough measurements obtained, going to wait for timeout...\n");
+      mainStateMachine.next_state = SYS_STATE_WAIT_FOR_TIMEOUT;
     }
+
+    mainStateMachine.prev_state = SYS_STATE_EVAL_SENSOR_STATUS;
+    break;
+  }
+  //------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------
+  case SYS_STATE_SEND_DATA:
+  {
+    log_i("Sending data to server...\n");
+
+    // We have obtained all the measurements, do the mean and transmit the data
+    log_i("All measurements obtained, sending data...\n");
+    log_i("Sensor values BEFORE AVERAGE:\n");
+    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d vs %d\n",
+          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure,
+          sensorData_accumulate.gasData.volatileOrganicCompounds,
+          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
+          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
+          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count, measStat.avg_measurements);
+
+    vMsp_updateDataAndSendEvent(DISP_EVENT_SENDING_MEAS, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+
+    bool anySensor = false;
+    for (uint32_t i = 0; i < SENSOR_DRIVER_COUNT; i++)
+    {
+      anySensor |= bMsp_driverSelected(&tSensorDrivers[i]) && sensorData_accumulate.status.*tSensorDrivers[i].status;
     }
 
-    // READING O3
-    if (sensorData_accumulate.status.O3Sensor)
+    if (anySensor)
     {
-      ze25Data_t o3Data;
-      log_i("Sampling O3 sensor...");
-      err.count = 0;
-      // Attempt to read O3 sensor with maximum retries
-      bool o3_read_success = false;
-      for (int retry = 0; retry < MAX_SENSOR_RETRIES; retry++)
+      log_i("Computing averages from %d measurements", measStat.measurement_count);
+      log_i("Error counts: BME=%d, PMS=%d, MICS=%d, O3=%d", err.BMEfails, err.PMSfails, err.MICSfails, err.O3fails);
+
+      // Log values before averaging for debugging
+      vMspChan_log("BEFORE AVERAGING", &sensorData_accumulate);
+
+      log_i("=== AVERAGING CALCULATION ===");
+      for (uint32_t i = 0; i < SENSOR_DRIVER_COUNT; i++)
       {
-        if (!tHalSensor_isAnalogO3Connected())
+        if (bMsp_driverSelected(&tSensorDrivers[i]))
         {
-          err.count++;
-          log_w("O3 sensor connection check failed, attempt %d/%d", retry + 1, MAX_SENSOR_RETRIES);
-          if (retry == (MAX_SENSOR_RETRIES - 1)) // Last attempt failed
-          {
-            log_e("Error while sampling O3 sensor after %d attempts!", MAX_SENSOR_RETRIES);
-            err.O3fails++;
-            break;
-          }
-          delay(1000);
-          continue;
+          tSensorDrivers[i].finalize(&err, &sensorData_accumulate, &measStat);
         }
+      }
+      vHalSensor_applyAggregation(&sensorData_accumulate, channelStats, sysStat.aggregation);
 
-        // Successfully read sensor data
-        o3_read_success = true;
-        o3Data.ozone = fHalSensor_analogUgM3O3Read(&localData.temperature, &sensorData_accumulate);
-        log_v("O3(ug/m3): %.3f", o3Data.ozone);
-        sensorData_accumulate.ozoneData.ozone += o3Data.ozone;
-        sensorData_single.ozoneData.ozone = o3Data.ozone;
+      // Log values after averaging for debugging
+      vMspChan_log("AFTER AVERAGING", &sensorData_accumulate);
+    }
 
-        break;
+    // MSP# Index evaluation, on the 24 h PM2.5, 1 h NO2 and 8 h O3 means once their windows are covered
+    sensorData_t rated = sensorData_accumulate;
+    vMspAq_applyWindows(&rated);
+    sensorData_accumulate.MSP = sHalSensor_evaluateMSPIndex(&rated);
+
+    log_i("Sending data to server...");
+    send_data_t sendData;
+    memcpy(&sendData.sendTimeInfo, &timeinfo, sizeof(tm)); // copy time info to sendData
+    log_i("Current time: %02d:%02d:%02d\n", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
+    // Keep the original timestamp - measurements are aligned to minute boundaries
+    // No need to manipulate time as measurements now start exactly at :00 seconds
+    sendData.sendTimeInfo.tm_sec = 0; // Always send with :00 seconds for consistency
+
+    log_i("Send timestamp: %02d:%02d:%02d\n", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
+    // Every channel; only the gas sensor driver writes CO, NO2 and NH3, zero without one
+    vMspChan_toSendData(&sensorData_accumulate, &sendData);
+    sendData.MSP = sensorData_accumulate.MSP;
+    sendData.caqi = sMspAq_caqi(&sensorData_accumulate.status);
+    log_i("MSP# %d, CAQI %d", sendData.MSP, sendData.caqi);
+
+    // Spread of the samples behind each value, and the periods of the interval they cover
+    sendData.periods = (uint16_t)lMsp_intervalSlots();
+    for (int ch = 0; ch < STATS_CH_MAX; ch++)
+    {
+      sendData.dispersion[ch] = fMspStats_stdDev(&channelStats[ch]);
+      sendData.covered[ch] = (uint16_t)channelStats[ch].count;
+      if ((channelStats[ch].count > 0) && (channelStats[ch].count < sendData.periods))
+      {
+        log_i("Coverage %s: %lu of %u periods%s", pcMspStats_channelName((stats_channel_t)ch), (unsigned long)channelStats[ch].count,
+              sendData.periods, channelStats[ch].uneven ? ", time-weighted" : "");
       }
+    }
+
+    // Longest state visits and sensor reads since the previous record
+    vMspLatency_takeWindowMax(sendData.latencyMaxUs);
+    sendData.hasLatency = (sysStat.uploadLatency != 0);
+    log_i("Latency max (ms): read=%lu bme680=%lu mics=%lu o3=%lu pms5003=%lu send=%lu",
+          (unsigned long)(sendData.latencyMaxUs[SYS_STATE_READ_SENSORS] / 1000), (unsigned long)(sendData.latencyMaxUs[LATENCY_SLOT_BME680] / 1000),
+          (unsigned long)(sendData.latencyMaxUs[LATENCY_SLOT_MICS] / 1000), (unsigned long)(sendData.latencyMaxUs[LATENCY_SLOT_O3] / 1000),
+          (unsigned long)(sendData.latencyMaxUs[LATENCY_SLOT_PMS5003] / 1000), (unsigned long)(sendData.latencyMaxUs[SYS_STATE_SEND_DATA] / 1000));
+
+    // I2C bus occupancy since the previous record
+    i2cBusUsage_t busUsage;
+    vMspI2c_takeWindow(&busUsage);
+    for (int client = 0; client < I2C_CLIENT_MAX; client++)
+    {
+      log_i("I2C bus %s: held %.2f %% of %lu s, %lu takes, max hold %lu ms, max wait %lu ms", pcMspI2c_clientName((i2cClient_t)client),
+            fMspI2c_heldPercent(&busUsage, (i2cClient_t)client), (unsigned long)(busUsage.spanMs / 1000),
+            (unsigned long)busUsage.client[client].takes, (unsigned long)(busUsage.client[client].maxHeldUs / 1000),
+            (unsigned long)(busUsage.client[client].maxWaitUs / 1000));
+    }
+
+    log_i("Sensor values AFTER AVERAGE:\n");
+    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d\n",
+          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure,
+          sensorData_accumulate.gasData.volatileOrganicCompounds,
+          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
+          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
+          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count);
+
+    log_i("Send Time: %02d:%02d:%02d\n", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
+
+    // Always log to SD card FIRST, regardless of network status
+    log_i("Writing data to SD card (mandatory logging)... SD status: %s", sysStat.sdCard ? "OK" : "FAIL");
+    if (sysStat.sdCard)
+    {
+      vHalSdcard_logToSD(&sendData, &sysData, &sysStat, &sensorData_accumulate, &devinfo);
+      log_i("Data logged to SD card successfully with date-based folder structure");
+    }
+    else
+    {
+      log_w("SD card not available for logging - data will be lost!");
+    }
 
-      if (o3_read_success)
+    // Daily latency summary, on the first record of a new day
+    if (bMspLatency_rollover(&sendData.sendTimeInfo))
+    {
+      vMspLatency_print();
+      if (sysStat.sdCard)
       {
-        log_i("O3 measurement #%d completed successfully", measStat.measurement_count + 1);
+        vHalSdcard_logLatencySummary();
       }
+      vMspLatency_startDay(&sendData.sendTimeInfo);
+    }
+
+    // Enqueue data for transmission by network task
+    if (enqueueSendData(sendData, pdMS_TO_TICKS(500)))
+    {
+      log_i("Data enqueued successfully for network transmission");
+      measStat.data_transmitted = true;                                // Mark data as transmitted for this cycle
+      measStat.last_transmission_epoch = mktime(&sendData.sendTimeInfo); // Record epoch time to prevent duplicates
+      log_i("Recorded transmission epoch %lld (%02d:%02d) to prevent duplicates",
+            (long long)measStat.last_transmission_epoch, sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min);
     }
     else
     {
-      sensorData_accumulate.ozoneData.ozone = 0.0f;
-      sensorData_single.ozoneData.ozone = 0.0f;
+      log_e("Failed to enqueue data for transmission - queue might be full");
     }
 
-    // READING PMS5003
-    if (sensorData_accumulate.status.PMS5003Sensor)
+    // show the averaged data after transmission, until the next sample replaces it
+    sensorSample_t recordSample;
+    vMspRing_sampleFromData(&sensorData_accumulate, &recordSample);
+    recordSample.epoch = (uint32_t)mktime(&sendData.sendTimeInfo);
+    recordSample.ms = millis();
+    bTaskDisplay_pushSample(&recordSample);
+    vMsp_updateDataAndSendEvent(DISP_EVENT_SHOW_MEAS_DATA, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+
+    log_i("Data transmission time: %02d:%02d:%02d", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
+    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d vs %d",
+          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure,
+          sensorData_accumulate.gasData.volatileOrganicCompounds,
+          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
+          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
+          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count, measStat.avg_measurements);
+
+    mainStateMachine.isFirstTransition = true; // set first transition flag
+    // This will clean up the sensor variables for the next cycle
+
+    // Always reset measurement count after transmission attempt (success or failure)
+    log_i("TRANSMISSION ATTEMPT COMPLETE: Resetting measurement_count from %d to 0", measStat.measurement_count);
+    measStat.measurement_count = 0;
+    measStat.data_transmitted = false; // Reset flag for new measurement cycle
+    // Note: last_transmission_epoch is NOT reset here - it stays to prevent duplicates in the same boundary window
+
+    // Reset the accumulated sensor data for a clean start of the next cycle
+    log_i("Resetting all sensor data for next measurement cycle");
+    // Reset accumulated sensor data
+    vMspChan_resetAll(&sensorData_accumulate);
+
+    // Reset MICS4514 ADC accumulator
+    sensorData_accumulate.mics4514AdcAccumulator.oxVoltageSum = 0;
+    sensorData_accumulate.mics4514AdcAccumulator.redVoltageSum = 0;
+    vMspStats_resetAll(channelStats);
+
+    // After transmission, system is now aligned - next cycles will be full measurements
+    log_i("Data enqueued successfully. System now aligned - next cycles will collect %d measurements", lMsp_intervalSlots());
+    log_i("Note: Server config from this transmission will be applied in next cycle");
+
+    mainStateMachine.prev_state = SYS_STATE_SEND_DATA;
+    mainStateMachine.next_state = SYS_STATE_UPDATE_CONFIG_FROM_SERVER; // Check for server config from PREVIOUS transmission
+    break;
+  }
+  //------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------
+  case SYS_STATE_ERROR:
+  {
+    vMsp_updateDataAndSendEvent(DISP_EVENT_SYSTEM_ERROR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+    log_e("System in error state! Waiting for reset...");
+    vTaskDelay(portMAX_DELAY);
+    break;
+  }
+  //------------------------------------------------------------------------------------------------------------------------
+  //------------------------------------------------------------------------------------------------------------------------
+  default:
+  {
+    log_e("Unknown state %d!", mainStateMachine.current_state);
+    mainStateMachine.next_state = SYS_STATE_WAIT_FOR_TIMEOUT; // go to error state
+    break;
+  }
+  }
+  vMspLatency_transition(mainStateMachine.current_state, mainStateMachine.next_state);
+  mainStateMachine.current_state = mainStateMachine.next_state; // update current state to next state
+}
+
+/******************************************************
+ * @brief I2C job: one BME680 sample, with as many
+ *        retries as its health allows
+ ******************************************************/
+static void vMsp_acquireBME680(void)
+{
+  acqBusOutput_t *p_tOut = &tBusOutput[ACQ_BUS_I2C];
+  latencyStamp_t sensorStart; // start of the retry chain, for the latency statistics
+
+  if (sensorData_accumulate.status.BME680Sensor)
+  {
+    uint8_t attempts = ucMspHealth_attempts(SENS_STAT_BME680);
+    if (attempts == 0)
     {
-      log_i("Sampling PMS5003 sensor...");
-      err.count = 0;
-      // Attempt to read PMS5003 sensor with maximum retries
-      bool pms_read_success = false;
-      for (int retry = 0; retry < MAX_SENSOR_RETRIES; retry++)
+      // counted as a failed read, so the averages leave it out
+      log_v("BME680 degraded, sample skipped until the next probe");
+      p_tOut->err.BMEfails++;
+      return;
+    }
+    log_i("Sampling BME680 sensor...");
+    vMspLatency_stamp(&sensorStart);
+    // Attempt to read BME680 sensor with the retries its health allows
+    bool sensor_read_success = false;
+    for (int retry = 0; retry < attempts; retry++)
+    {
+      if (!tHalSensor_checkBMESensor(&bme680))
       {
-        // Clear serial buffer
-        while (pmsSerial.available())
+        log_w("BME680 sensor check failed, attempt %d/%d", retry + 1, attempts);
+        if (retry == (attempts - 1)) // Last attempt failed
         {
-          pmsSerial.read();
+          log_e("Error while sampling BME680 sensor after %d attempts!", attempts);
+          p_tOut->err.BMEfails++;
+          break;
         }
+        delay(ulMspHealth_retryDelayMs(retry + 1));
+        continue;
+      }
+
+      // Trigger measurement if this is the first attempt
+      if (retry == 0)
+      {
+        // Give BME680 time to prepare measurement (especially gas sensor)
+        delay(500);
+      }
 
-        if (!pms.readUntil(data))
+      bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+      bool bmeReady = bme680.run();
+      vMspI2c_give(I2C_CLIENT_SENSORS);
+      if (!bmeReady)
+      {
+        log_v("BME680 sensor not ready, waiting... (attempt %d/%d)", retry + 1, attempts);
+        if (retry == (attempts - 1)) // Last attempt and still not ready
         {
-          err.count++;
-          log_w("PMS5003 sensor reading failed, attempt %d/%d", retry + 1, MAX_SENSOR_RETRIES);
-          if (retry == (MAX_SENSOR_RETRIES - 1)) // Last attempt failed
-          {
-            log_e("Error while sampling PMS5003 sensor after %d attempts!", MAX_SENSOR_RETRIES);
-            err.PMSfails++;
-            break;
-          }
-          delay(1000);
-          continue;
+          log_w("BME680 sensor not ready after %d attempts - measurement #%d will be excluded from averaging", attempts, measStat.measurement_count + 1);
+          p_tOut->err.BMEfails++;
         }
+        // Increase delay for BME680 gas measurement to complete (datasheet: 150-350ms)
+        delay(300);
+        continue;
+      }
 
-        // Successfully read sensor data
-        pms_read_success = true;
-        log_v("PM1(ug/m3): %d", data.PM_AE_UG_1_0);
-        sensorData_accumulate.airQualityData.particleMicron1 += data.PM_AE_UG_1_0;
-        sensorData_single.airQualityData.particleMicron1 = data.PM_AE_UG_1_0;
+      // Successfully read sensor data
+      sensor_read_success = true;
+      localData.temperature = bme680.temperature;
+      log_i("BME680 Temperature: %.3f C (measurement #%d)", localData.temperature, measStat.measurement_count + 1);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_TEMP, localData.temperature);
+
+      localData.pressure = bme680.pressure / PERCENT_DIVISOR;
+      localData.pressure = fHalSensor_seaLevelPressure(localData.pressure, localData.temperature, sensorData_accumulate.gasData.seaLevelAltitude);
+      log_v("Pressure(hPa): %.3f", localData.pressure);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_PRE, localData.pressure);
+
+      localData.humidity = bme680.humidity;
+      log_v("Humidity(perc.): %.3f", localData.humidity);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_HUM, localData.humidity);
+
+      localData.volatileOrganicCompounds = bme680.gasResistance / MICROGRAMS_PER_GRAM;
+      localData.volatileOrganicCompounds = fHalSensor_no2AndVocCompensation(localData.volatileOrganicCompounds, &localData, &sensorData_accumulate);
+      log_v("Compensated gas resistance(kOhm): %.3f\n", localData.volatileOrganicCompounds);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_VOC, localData.volatileOrganicCompounds);
+      break;
+    }
 
-        log_v("PM2,5(ug/m3): %d", data.PM_AE_UG_2_5);
-        sensorData_accumulate.airQualityData.particleMicron25 += data.PM_AE_UG_2_5;
-        sensorData_single.airQualityData.particleMicron25 = data.PM_AE_UG_2_5;
+    if (sensor_read_success)
+    {
+      log_i("BME680 measurement #%d completed successfully", measStat.measurement_count + 1);
+    }
+    vMspHealth_report(SENS_STAT_BME680, sensor_read_success);
+    vMspLatency_record(LATENCY_SLOT_BME680, ulMspLatency_elapsedUs(&sensorStart));
+  }
+}
 
-        log_v("PM10(ug/m3): %d\n", data.PM_AE_UG_10_0);
-        sensorData_accumulate.airQualityData.particleMicron10 += data.PM_AE_UG_10_0;
-        sensorData_single.airQualityData.particleMicron10 = data.PM_AE_UG_10_0;
+/******************************************************
+ * @brief I2C job: one MICS6814 sample, with as many
+ *        retries as its health allows; runs after the
+ *        BME680 job, whose sample compensates the NO2
+ *        reading
+ ******************************************************/
+static void vMsp_acquireMICS6814(void)
+{
+  acqBusOutput_t *p_tOut = &tBusOutput[ACQ_BUS_I2C];
+  latencyStamp_t sensorStart; // start of the retry chain, for the latency statistics
 
-        break;
-      }
+  if (sensorData_accumulate.status.MICS6814Sensor)
+  {
+    uint8_t attempts = ucMspHealth_attempts(SENS_STAT_MICSxxxx);
+    if (attempts == 0)
+    {
+      log_v("MICS6814 degraded, sample skipped until the next probe");
+      p_tOut->err.MICSfails++;
+      return;
+    }
+    log_i("Sampling MICS6814 sensor...");
+    vMspLatency_stamp(&sensorStart);
+    // Attempt to read MICS6814 sensor with the retries its health allows
+    bool mics_read_success = false;
+    for (int retry = 0; retry < attempts; retry++)
+    {
+      MICS6814SensorReading_t micsLocData;
+
+      bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+      micsLocData.carbonMonoxide = gas.measureCO();
+      micsLocData.nitrogenDioxide = gas.measureNO2();
+      micsLocData.ammonia = gas.measureNH3();
+      vMspI2c_give(I2C_CLIENT_SENSORS);
 
-      if (pms_read_success)
+      if ((micsLocData.carbonMonoxide < 0) || (micsLocData.nitrogenDioxide < 0) || (micsLocData.ammonia < 0))
       {
-        log_i("PMS5003 measurement #%d completed successfully", measStat.measurement_count + 1);
+        log_w("MICS6814 sensor reading failed, attempt %d/%d", retry + 1, attempts);
+        if (retry == (attempts - 1)) // Last attempt failed
+        {
+          log_e("Error while sampling MICS6814 sensor after %d attempts!", attempts);
+          p_tOut->err.MICSfails++;
+          break;
+        }
+        delay(ulMspHealth_retryDelayMs(retry + 1));
+        continue;
       }
-    }
 
-    // Calculate MSP index for the single measurement data
-    sensorData_single.MSP = sHalSensor_evaluateMSPIndex(&sensorData_single);
+      // Successfully read sensor data
+      mics_read_success = true;
+      micsLocData.carbonMonoxide = vGeneric_convertPpmToUgM3(micsLocData.carbonMonoxide, sensorData_accumulate.molarMass.carbonMonoxide);
+      log_v("CO(ug/m3): %.3f", micsLocData.carbonMonoxide);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_CO, micsLocData.carbonMonoxide);
 
-    measStat.isSensorDataAvailable = true;
+      micsLocData.nitrogenDioxide = vGeneric_convertPpmToUgM3(micsLocData.nitrogenDioxide, sensorData_accumulate.molarMass.nitrogenDioxide);
+      if (sensorData_accumulate.status.BME680Sensor)
+      {
+        micsLocData.nitrogenDioxide = fHalSensor_no2AndVocCompensation(micsLocData.nitrogenDioxide, &localData, &sensorData_accumulate);
+      }
+      log_v("NOx(ug/m3): %.3f", micsLocData.nitrogenDioxide);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_NO2, micsLocData.nitrogenDioxide);
 
-    measStat.measurement_count++;
-    log_i("MEASUREMENT COUNT: Incremented to %d (target: %d measurements)", measStat.measurement_count, measStat.avg_measurements);
-    log_i("Current minute: %d, expected transmission at boundary: %s",
-          measStat.curr_minutes, ((measStat.curr_minutes % measStat.max_measurements) == 0) ? "YES" : "NO");
+      micsLocData.ammonia = vGeneric_convertPpmToUgM3(micsLocData.ammonia, sensorData_accumulate.molarMass.ammonia);
+      log_v("NH3(ug/m3): %.3f\n", micsLocData.ammonia);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_NH3, micsLocData.ammonia);
 
-    log_i("Sensor values AFTER evaluation:\n");
-    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d\n",
-          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure, sensorData_accumulate.gasData.volatileOrganicCompounds,
-          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
-          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
-          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count);
-    log_i("Measurements done, going to timeout...\n");
+      if (sysStat.micsBaselineMode != MICS_BASELINE_OFF)
+      {
+        // Rs as the library sees it, with the configured offsets
+        const sensorOffsetValue_t *p_tOffset = &sensorData_accumulate.micsTuningData.sensingResInAirOffset;
+        int32_t rs[MICS_BASELINE_CH_MAX];
+        bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+        rs[MICS_BASELINE_RED] = (int32_t)gas.getResistance(CH_RED) + p_tOffset->redSensor;
+        rs[MICS_BASELINE_OX] = (int32_t)gas.getResistance(CH_OX) + p_tOffset->oxSensor;
+        rs[MICS_BASELINE_NH3] = (int32_t)gas.getResistance(CH_NH3) + p_tOffset->nh3Sensor;
+        vMspI2c_give(I2C_CLIENT_SENSORS);
+        vMspBaseline_add((uint32_t)measStat.last_read_epoch, rs);
+      }
 
-    mainStateMachine.prev_state = SYS_STATE_READ_SENSORS;
-    mainStateMachine.next_state = SYS_STATE_EVAL_SENSOR_STATUS;
-    break;
+      break;
+    }
+
+    if (mics_read_success)
+    {
+      log_i("MICS6814 measurement #%d completed successfully", measStat.measurement_count + 1);
+    }
+    vMspHealth_report(SENS_STAT_MICSxxxx, mics_read_success);
+    vMspLatency_record(LATENCY_SLOT_MICS, ulMspLatency_elapsedUs(&sensorStart));
   }
-  //------------------------------------------------------------------------------------------------------------------------
-  //------------------------------------------------------------------------------------------------------------------------
-  case SYS_STATE_EVAL_SENSOR_STATUS:
-  {
-    log_i("Evaluating sensor status...");
+}
 
-    // Update current time for clock-aligned mode evaluation
-    if (getLocalTime(&timeinfo))
+/******************************************************
+ * @brief I2C job: one MICS4514 sample, accumulated as
+ *        ADC counts, with as many retries as its health
+ *        allows; skipped while the heater warms up
+ ******************************************************/
+static void vMsp_acquireMICS4514(void)
+{
+  acqBusOutput_t *p_tOut = &tBusOutput[ACQ_BUS_I2C];
+  latencyStamp_t sensorStart; // start of the retry chain, for the latency statistics
+
+  vMsp_checkMics4514Warmup();
+
+  if (sensorData_accumulate.status.MICS4514Sensor)
+  {
+    if (!sensorData_accumulate.mics4514Data.warmupComplete)
     {
-      measStat.curr_minutes = timeinfo.tm_min;
-      log_v("Current time for evaluation: %02d:%02d", timeinfo.tm_hour, measStat.curr_minutes);
+      // counted as a failed read, so the averages leave it out
+      log_i("MICS4514 still warming up, sample skipped");
+      p_tOut->err.MICSfails++;
+      return;
     }
-    int8_t sens_stat_count = 0;
-    for (sens_stat_count = 0; sens_stat_count < SENS_STAT_MAX; sens_stat_count++)
+    uint8_t attempts = ucMspHealth_attempts(SENS_STAT_MICSxxxx);
+    if (attempts == 0)
     {
-      if (err.senserrs[sens_stat_count] == true)
+      log_v("MICS4514 degraded, sample skipped until the next probe");
+      p_tOut->err.MICSfails++;
+      return;
+    }
+    log_i("Sampling MICS4514 sensor...");
+    vMspLatency_stamp(&sensorStart);
+    // Attempt to read MICS4514 sensor with the retries its health allows
+    bool mics_read_success = false;
+    for (int retry = 0; retry < attempts; retry++)
+    {
+      MICS4514SensorReading_t micsLocData;
+
+      // Read raw ADC values and accumulate for averaging
+      MICS4514AdcAccumulator_t adcBefore = p_tOut->micsAdc;
+      bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+      mspStatus_t adcStatus = tHalSensor_readMICS4514_ADC(mics4514, &p_tOut->micsAdc);
+      vMspI2c_give(I2C_CLIENT_SENSORS);
+      if (adcStatus != STATUS_OK)
       {
-        switch (sens_stat_count)
+        log_w("MICS4514 ADC reading failed, attempt %d/%d", retry + 1, attempts);
+        if (retry == (attempts - 1)) // Last attempt failed
         {
-        case SENS_STAT_BME680:
-          sensorData_accumulate.status.BME680Sensor = true;
-          sensorData_single.status.BME680Sensor = true;
-          break;
-        case SENS_STAT_PMS5003:
-          sensorData_accumulate.status.PMS5003Sensor = true;
-          sensorData_single.status.PMS5003Sensor = true;
-          break;
-        case SENS_STAT_MICSxxxx:
-          sensorData_accumulate.status.MICS6814Sensor = true;
-          sensorData_single.status.MICS6814Sensor = true;
-          break;
-        case SENS_STAT_O3:
-          sensorData_accumulate.status.O3Sensor = true;
-          sensorData_single.status.O3Sensor = true;
+          log_e("Error while reading MICS4514 ADC after %d attempts!", attempts);
+          p_tOut->err.MICSfails++;
           break;
         }
+        delay(ulMspHealth_retryDelayMs(retry + 1));
+        continue;
+      }
+
+      if (sysStat.micsBaselineMode != MICS_BASELINE_OFF)
+      {
+        // the counts of this sample are Rs in the units of the configured R0, the NH3 comes from RED
+        int32_t rs[MICS_BASELINE_CH_MAX] = {0};
+        rs[MICS_BASELINE_RED] = (int32_t)(p_tOut->micsAdc.redVoltageSum - adcBefore.redVoltageSum);
+        rs[MICS_BASELINE_OX] = (int32_t)(p_tOut->micsAdc.oxVoltageSum - adcBefore.oxVoltageSum);
+        vMspBaseline_add((uint32_t)measStat.last_read_epoch, rs);
+      }
+
+      // Also calculate immediate gas concentrations for the sample (display and spread)
+      // This provides instant feedback for LCD while accumulating for accurate averaging
+      bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+      mspStatus_t immediateStatus = tHalSensor_calculateMICS4514_Immediate(mics4514, &sensorData_accumulate, &micsLocData);
+      vMspI2c_give(I2C_CLIENT_SENSORS);
+      if (immediateStatus == STATUS_OK)
+      {
+        // Convert PPM to ug/m3 for immediate display values (same as old approach)
+        micsLocData.carbonMonoxide = vGeneric_convertPpmToUgM3(micsLocData.carbonMonoxide, sensorData_accumulate.molarMass.carbonMonoxide);
+        log_v("CO(ug/m3): %.3f", micsLocData.carbonMonoxide);
+
+        // Convert NO2 from PPM to ug/m3 (with optional BME680 compensation)
+        micsLocData.nitrogenDioxide = vGeneric_convertPpmToUgM3(micsLocData.nitrogenDioxide, sensorData_accumulate.molarMass.nitrogenDioxide);
+        if (sensorData_accumulate.status.BME680Sensor)
+        {
+          micsLocData.nitrogenDioxide = fHalSensor_no2AndVocCompensation(micsLocData.nitrogenDioxide, &localData, &sensorData_accumulate);
+        }
+        log_v("NOx(ug/m3): %.3f", micsLocData.nitrogenDioxide);
+
+        // Convert NH3 from PPM to ug/m3
+        micsLocData.ammonia = vGeneric_convertPpmToUgM3(micsLocData.ammonia, sensorData_accumulate.molarMass.ammonia);
+        log_v("NH3(ug/m3): %.3f", micsLocData.ammonia);
+
+        log_i("MICS4514 immediate values for display: CO=%.2f, NO2=%.2f, NH3=%.2f ug/m3",
+              micsLocData.carbonMonoxide, micsLocData.nitrogenDioxide, micsLocData.ammonia);
+
+        // the record comes from the averaged ADC counts, the immediate values give its spread
+        vMspRing_setChannel(&p_tOut->sample, STATS_CH_CO, micsLocData.carbonMonoxide);
+        vMspRing_setChannel(&p_tOut->sample, STATS_CH_NO2, micsLocData.nitrogenDioxide);
+        vMspRing_setChannel(&p_tOut->sample, STATS_CH_NH3, micsLocData.ammonia);
+      }
+      else
+      {
+        log_w("MICS4514 immediate gas calculation failed, keeping previous display values");
       }
+
+      // Successfully read and accumulated ADC data
+      mics_read_success = true;
+      log_i("MICS4514 measurement #%d: ADC accumulated and display updated", measStat.measurement_count + 1);
+
+      break;
     }
 
-    // Check if it's time to send data
-    // We transmit when:
-    //   1) At a clock-aligned interval boundary (curr_minutes % max_measurements == 0)
-    //      OR enough seconds have elapsed since the last transmission (fallback for missed windows)
-    //   2) Enough measurements have been collected for this cycle
-    //   3) Haven't already transmitted in this boundary window
+    if (mics_read_success)
+    {
+      log_i("MICS4514 measurement #%d completed successfully", measStat.measurement_count + 1);
+    }
+    vMspHealth_report(SENS_STAT_MICSxxxx, mics_read_success);
+    vMspLatency_record(LATENCY_SLOT_MICS, ulMspLatency_elapsedUs(&sensorStart));
+  }
+}
 
-    time_t now_epoch = mktime(&timeinfo);
+/******************************************************
+ * @brief ADC job: filtered O3 level from the sampling
+ *        engine; the temperature compensation is done
+ *        after the join, once the BME680 sample is in
+ ******************************************************/
+static void vMsp_acquireO3(void)
+{
+  acqBusOutput_t *p_tOut = &tBusOutput[ACQ_BUS_ADC];
+  latencyStamp_t sensorStart; // start of the read, for the latency statistics
 
-    // Compute seconds elapsed since last transmission (0 if never transmitted)
-    int32_t seconds_since_last_tx = (measStat.last_transmission_epoch > 0)
-                                    ? (int32_t)(now_epoch - measStat.last_transmission_epoch)
-                                    : 0;
+  if (sensorData_accumulate.status.O3Sensor)
+  {
+    log_i("Sampling O3 sensor...");
+    vMspLatency_stamp(&sensorStart);
+    if (!bHalSensor_analogO3Points(&sensorData_accumulate, &p_tOut->o3Points))
+    {
+      log_e("No recent O3 ADC reading, sensor disconnected?");
+      p_tOut->err.O3fails++;
+    }
+    else
+    {
+      // converted after the join
+      p_tOut->o3Valid = true;
+      log_i("O3 measurement #%d completed successfully", measStat.measurement_count + 1);
+    }
+    vMspLatency_record(LATENCY_SLOT_O3, ulMspLatency_elapsedUs(&sensorStart));
+  }
+}
 
-    int32_t interval_seconds = (int32_t)(measStat.max_measurements * SEC_IN_MIN);
+/******************************************************
+ * @brief loop task, after the join: O3 compensated with
+ *        the temperature of the BME680 sample just taken
+ ******************************************************/
+static void vMsp_accumulateO3(bool sampled)
+{
+  if (bMspRing_hasChannel(&tSample, STATS_CH_TEMP))
+  {
+    fLastTemperature = tSample.value[STATS_CH_TEMP];
+  }
+  if (sensorData_accumulate.status.O3Sensor)
+  {
+    if (sampled && tBusOutput[ACQ_BUS_ADC].o3Valid)
+    {
+      ze25Data_t o3Data;
+      o3Data.ozone = fHalSensor_o3ReadingToUgM3(tBusOutput[ACQ_BUS_ADC].o3Points, &fLastTemperature, &sensorData_accumulate);
+      log_v("O3(ug/m3): %.3f", o3Data.ozone);
+      vMspRing_setChannel(&tSample, STATS_CH_O3, o3Data.ozone);
+    }
+  }
+}
 
-    // Standard clock-aligned boundary (e.g. minute 0 for hourly, minute 0/30 for 30-min)
-    bool at_transmission_boundary = ((measStat.curr_minutes % measStat.max_measurements) == 0);
+/******************************************************
+ * @brief loop task: adds a sample to the statistics
+ *        and the sums of the averaging interval, the
+ *        rolling index windows and the rollups
+ ******************************************************/
+static void vMsp_aggregateSample(const sensorSample_t *p_tSample)
+{
+  for (int i = 0; i < STATS_CH_MAX; i++)
+  {
+    if (bMspRing_hasChannel(p_tSample, (stats_channel_t)i))
+    {
+      vMspStats_addTimed(&channelStats[i], p_tSample->value[i], p_tSample->epoch, (uint32_t)measStat.delay_between_measurements);
+    }
+  }
 
-    // Fallback: enough seconds have elapsed regardless of minute alignment.
-    // This handles all rollover cases (including 60-min: same minute across hours) and
-    // recovers gracefully if the exact boundary second is missed due to processing delays.
-    bool enough_time_passed = (measStat.last_transmission_epoch > 0) &&
-                              (seconds_since_last_tx >= interval_seconds);
+  uint16_t summed = p_tSample->valid;
+  if (sensorData_accumulate.status.MICS4514Sensor)
+  {
+    // the MICS4514 sums are its ADC counts, accumulated by the job
+    summed &= (uint16_t)~((1U << STATS_CH_CO) | (1U << STATS_CH_NO2) | (1U << STATS_CH_NH3));
+  }
+  vMspRing_addToSums(p_tSample, summed, &sensorData_accumulate);
+  vMspAq_add(p_tSample);
 
-    at_transmission_boundary = at_transmission_boundary || enough_time_passed;
+  rollupRecord_t closed[ROLLUP_LEVEL_MAX];
+  uint32_t count = ulMspRollup_add(p_tSample, closed);
+  for (uint32_t i = 0; i < count; i++)
+  {
+    vMsp_emitRollup(&closed[i]);
+  }
+}
 
-    // Duplicate guard: only transmit once per boundary window.
-    // "Not yet transmitted" if we have never transmitted OR enough seconds have passed
-    // since the last one (i.e. we are in a new window, not the same one).
-    bool boundary_not_transmitted = (measStat.last_transmission_epoch == 0) || enough_time_passed;
+/******************************************************
+ * @brief a rollup closed on its boundary: rated when an
+ *        hour or longer, then logged and queued for the
+ *        server as its level is set to
+ ******************************************************/
+static void vMsp_emitRollup(rollupRecord_t *p_tRollup)
+{
+  if (p_tRollup->seconds >= ROLLUP_MIN_RATED_SECONDS)
+  {
+    sensorData_t means;
+    memset(&means, 0, sizeof(means));
+    means.status = sensorData_accumulate.status;
+    // a sensor that delivered nothing in the rollup has a mean of 0, it is left out of the index
+    if (p_tRollup->channel[STATS_CH_PM25].count == 0)
+    {
+      means.status.PMS5003Sensor = 0;
+    }
+    if (p_tRollup->channel[STATS_CH_NO2].count == 0)
+    {
+      means.status.MICS6814Sensor = 0;
+    }
+    if (p_tRollup->channel[STATS_CH_O3].count == 0)
+    {
+      means.status.O3Sensor = 0;
+    }
+    means.airQualityData.particleMicron25 = (int32_t)lroundf(p_tRollup->channel[STATS_CH_PM25].mean);
+    means.pollutionData.nitrogenDioxide = p_tRollup->channel[STATS_CH_NO2].mean;
+    means.ozoneData.ozone = p_tRollup->channel[STATS_CH_O3].mean;
+    p_tRollup->msp = (int8_t)sHalSensor_evaluateMSPIndex(&means);
+  }
+  log_i("Rollup %s of %lu closed: %u of %u samples, MSP %d", pcMspRollup_levelName((rollupLevel_t)p_tRollup->level),
+        (unsigned long)p_tRollup->start, p_tRollup->samples, p_tRollup->periods, p_tRollup->msp);
 
-    // Measurement count guard: don't fire early (e.g. first boot at minute 0 reads
-    // only 1 sample before the boundary check would trigger).
-    bool enough_measurements = (measStat.measurement_count >= measStat.avg_measurements);
+  if ((ROLLUP_SD_LEVELS & ROLLUP_LEVEL_BIT(p_tRollup->level)) && sysStat.sdCard)
+  {
+    vHalSdcard_logRollup(p_tRollup);
+  }
+  if (ROLLUP_UPLOAD_LEVELS & ROLLUP_LEVEL_BIT(p_tRollup->level))
+  {
+    enqueueRollup(*p_tRollup);
+  }
+}
 
-    int curr_hour = timeinfo.tm_hour;
-    log_i("TRANSMISSION CHECK: collected %d/%d measurements, boundary=%s (time %02d:%02d, interval=%d), last_tx_epoch=%lld, secs_since_tx=%d",
-          measStat.measurement_count, measStat.avg_measurements,
-          at_transmission_boundary ? "YES" : "NO", curr_hour, measStat.curr_minutes, measStat.max_measurements,
-          (long long)measStat.last_transmission_epoch, seconds_since_last_tx);
+/******************************************************
+ * @brief UART job: mean of the PMS5003 frames streamed
+ *        since the previous sample
+ ******************************************************/
+static void vMsp_acquirePMS5003(void)
+{
+  acqBusOutput_t *p_tOut = &tBusOutput[ACQ_BUS_UART];
+  latencyStamp_t sensorStart; // start of the read, for the latency statistics
 
-    log_i("BOUNDARY DETAILS: standard_boundary=%s, enough_time_passed=%s, enough_measurements=%s",
-          ((measStat.curr_minutes % measStat.max_measurements) == 0) ? "YES" : "NO",
-          enough_time_passed ? "YES" : "NO",
-          enough_measurements ? "YES" : "NO");
+  if (sensorData_accumulate.status.PMS5003Sensor)
+  {
+    log_i("Sampling PMS5003 sensor...");
+    vMspLatency_stamp(&sensorStart);
+    pmsWindow_t window;
+    if (!bHalPms_takeWindow(&window))
+    {
+      log_e("No valid PMS5003 frame since the previous sample (%lu bad checksums)!", (unsigned long)window.checksumErrors);
+      p_tOut->err.PMSfails++;
+    }
+    else
+    {
+      // every frame of the window counts, rounded to the nearest ug/m3
+      int32_t pm1 = (int32_t)((window.pm1Sum + (window.frames / 2)) / window.frames);
+      int32_t pm25 = (int32_t)((window.pm25Sum + (window.frames / 2)) / window.frames);
+      int32_t pm10 = (int32_t)((window.pm10Sum + (window.frames / 2)) / window.frames);
+      log_v("PMS5003 window: %lu frames, %lu bad checksums, PM2,5 min %u max %u", (unsigned long)window.frames,
+            (unsigned long)window.checksumErrors, window.pm25Min, window.pm25Max);
 
-    if (at_transmission_boundary && boundary_not_transmitted && enough_measurements)
+      log_v("PM1(ug/m3): %d", pm1);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_PM1, (float)pm1);
+
+      log_v("PM2,5(ug/m3): %d", pm25);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_PM25, (float)pm25);
+
+      log_v("PM10(ug/m3): %d\n", pm10);
+      vMspRing_setChannel(&p_tOut->sample, STATS_CH_PM10, (float)pm10);
+
+      log_i("PMS5003 measurement #%d completed successfully", measStat.measurement_count + 1);
+    }
+    vMspLatency_record(LATENCY_SLOT_PMS5003, ulMspLatency_elapsedUs(&sensorStart));
+  }
+}
+
+/******************************************************
+ * @brief loop task, after the join: the PMS5003 sleeps
+ *        until the preheat of the next measurement; it
+ *        is left running while its bus is late
+ ******************************************************/
+static void vMsp_accumulatePMS5003(bool sampled)
+{
+  if (sensorData_accumulate.status.PMS5003Sensor && sampled && bMsp_pmsDutyCycleEnabled())
+  {
+    pms.sleep(); // laser and fan off until the preheat of the next measurement
+    measStat.isPmsAwake = false;
+  }
+}
+
+/******************************************************
+ * @brief one more failed read of a sensor in the cycle,
+ *        so its average leaves the sample out
+ ******************************************************/
+static void vMsp_countFailedRead(sens_status_t slot)
+{
+  switch (slot)
+  {
+  case SENS_STAT_BME680:
+    err.BMEfails++;
+    break;
+  case SENS_STAT_PMS5003:
+    err.PMSfails++;
+    break;
+  case SENS_STAT_MICSxxxx:
+    err.MICSfails++;
+    break;
+  case SENS_STAT_O3:
+    err.O3fails++;
+    break;
+  default:
+    break;
+  }
+}
+
+/******************************************************
+ * @brief the PMS5003 sleeps between measurements when
+ *        the interval leaves room for the preheat
+ ******************************************************/
+static bool bMsp_pmsDutyCycleEnabled(void)
+{
+  return measStat.delay_between_measurements >= (PMS_PREHEAT_TIME_IN_SEC + PMS_MIN_SLEEP_TIME_IN_SEC);
+}
+
+/******************************************************
+ * @brief PMS5003 duty cycle, called by the wait state:
+ *        wakes the sensor PMS_PREHEAT_TIME_IN_SEC before
+ *        the measurement and drops the preheat frames
+ *        PMS_SAMPLE_WINDOW_IN_SEC before it
+ *
+ * @param secondsToSample seconds to the next measurement
+ ******************************************************/
+static void vMsp_pmsDutyCycle(uint32_t secondsToSample)
+{
+  static bool bWindowOpen = false; // preheat frames dropped for the coming measurement
+
+  if (!sensorData_accumulate.status.PMS5003Sensor || !bMsp_pmsDutyCycleEnabled())
+  {
+    return;
+  }
+
+  if (!measStat.isPmsAwake && (secondsToSample <= PMS_PREHEAT_TIME_IN_SEC))
+  {
+    log_i("Waking up PMS5003, %lu s before the measurement", (unsigned long)secondsToSample);
+    pms.wakeUp();
+    measStat.isPmsAwake = true;
+    bWindowOpen = false;
+  }
+
+  if (measStat.isPmsAwake && !bWindowOpen && (secondsToSample <= PMS_SAMPLE_WINDOW_IN_SEC))
+  {
+    vHalPms_flush();
+    bWindowOpen = true;
+  }
+}
+
+/******************************************************
+ * @brief loads the BSEC state saved on the SD card, so
+ *        the gas calibration does not start over at
+ *        every reboot
+ ******************************************************/
+static void vMsp_restoreBsecState(void)
+{
+  uint8_t state[BSEC_MAX_STATE_BLOB_SIZE];
+  if (!sysStat.sdCard || !bHalSdcard_loadBsecState(state, sizeof(state)))
+  {
+    log_i("No saved BSEC state, gas calibration starts from scratch");
+    return;
+  }
+  bme680.setState(state);
+  if (bme680.bsecStatus != BSEC_OK)
+  {
+    log_w("Saved BSEC state rejected (status %d), gas calibration starts from scratch", (int)bme680.bsecStatus);
+    bme680.bsecStatus = BSEC_OK;
+    return;
+  }
+  log_i("BSEC state restored from the SD card");
+}
+
+/******************************************************
+ * @brief reads the BSEC state out and saves it to the
+ *        SD card; the I2C worker runs the library with
+ *        the bus taken, so it is read with the bus taken
+ ******************************************************/
+static bool bMsp_writeBsecState(TickType_t wait)
+{
+  if (!bMspI2c_take(I2C_CLIENT_SENSORS, wait))
+  {
+    log_w("BSEC state not saved, the sensors hold the bus");
+    return false;
+  }
+  uint8_t state[BSEC_MAX_STATE_BLOB_SIZE];
+  bme680.getState(state);
+  bsec_library_return_t status = bme680.bsecStatus;
+  bme680.bsecStatus = BSEC_OK;
+  vMspI2c_give(I2C_CLIENT_SENSORS);
+
+  if (status != BSEC_OK)
+  {
+    log_w("Failed to read the BSEC state (status %d)", (int)status);
+    return false;
+  }
+  if (!bHalSdcard_saveBsecState(state, sizeof(state)))
+  {
+    return false;
+  }
+  log_i("BSEC state saved to the SD card");
+  return true;
+}
+
+/******************************************************
+ * @brief saves the BSEC state once it first reports a
+ *        calibrated state, then every
+ *        BSEC_STATE_SAVE_PERIOD_MIN; only while the I2C
+ *        worker is not running the library
+ ******************************************************/
+static void vMsp_saveBsecState(void)
+{
+  static uint32_t lastSaveMs = 0;
+  static bool savedCalibrated = false;
+
+  if (!sensorData_accumulate.status.BME680Sensor || !sysStat.sdCard)
+  {
+    return;
+  }
+  // a unit restarting more often than the period still keeps its calibration
+  bool calibrated = !savedCalibrated && (bme680.iaqAccuracy >= BSEC_STATE_CALIBRATED_ACCURACY);
+  if (!calibrated && ((millis() - lastSaveMs) < (uint32_t)MIN_TO_SEC(BSEC_STATE_SAVE_PERIOD_MIN) * 1000U))
+  {
+    return;
+  }
+  lastSaveMs = millis();
+
+  if (bMsp_writeBsecState(portMAX_DELAY) && calibrated)
+  {
+    savedCalibrated = true;
+  }
+}
+
+/******************************************************
+ * @brief shutdown handler: saves the BSEC state before
+ *        esp_restart() (firmware update, configuration)
+ ******************************************************/
+static void vMsp_saveBsecStateAtShutdown(void)
+{
+  if (sensorData_accumulate.status.BME680Sensor && sysStat.sdCard)
+  {
+    bMsp_writeBsecState(pdMS_TO_TICKS(BSEC_STATE_SHUTDOWN_WAIT_MS));
+  }
+}
+
+/******************************************************
+ * @brief ends the MICS4514 warm-up once the heater has
+ *        been on MICS4514_WARMUP_TIME_MIN; called by the
+ *        I2C job before it takes the sample
+ ******************************************************/
+static void vMsp_checkMics4514Warmup(void)
+{
+  if (!sensorData_accumulate.status.MICS4514Sensor || sensorData_accumulate.mics4514Data.warmupComplete)
+  {
+    return;
+  }
+
+  // the call that ends the warm-up reads the sensor over I2C to latch R0
+  bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+  bool warm = mics4514.warmUpTime(MICS4514_WARMUP_TIME_MIN);
+  vMspI2c_give(I2C_CLIENT_SENSORS);
+  if (!warm)
+  {
+    log_i("MICS4514 - Heat-Up: %3.1f %%", (float)(millis() - micsWarmupStartMs) * 100.0f / (MICS4514_WARMUP_TIME_MIN * 60.0f * 1000.0f));
+    return;
+  }
+
+  sensorData_accumulate.mics4514Data.warmupComplete = 1;
+  vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_DONE, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+  log_i("MICS4514 warmup complete, samples are now averaged");
+}
+
+/******************************************************
+ * @brief starts the MICS baseline tracking, from the
+ *        days saved on the SD card when they are of the
+ *        same sensor
+ ******************************************************/
+static void vMsp_restoreMicsBaseline(void)
+{
+  if ((sysStat.micsBaselineMode == MICS_BASELINE_OFF) ||
+      !(sensorData_accumulate.status.MICS6814Sensor || sensorData_accumulate.status.MICS4514Sensor))
+  {
+    return;
+  }
+  const sensorR0Value_t *p_tR0 = &sensorData_accumulate.micsTuningData.sensingResInAir;
+  vMspBaseline_init(sysStat.gasSensorType, p_tR0);
+
+  micsBaselineStore_t saved;
+  if (sysStat.sdCard && bHalSdcard_loadMicsBaseline(&saved, sizeof(saved)) && bMspBaseline_restore(&saved, p_tR0))
+  {
+    log_i("MICS baseline restored from the SD card, %u days", saved.dayCount);
+    return;
+  }
+  log_i("MICS baseline tracking starts from R0 RED %u OX %u NH3 %u", p_tR0->redSensor, p_tR0->oxSensor, p_tR0->nh3Sensor);
+}
+
+/******************************************************
+ * @brief once a day: the R0 the MICS baseline points
+ *        to, applied when configured so, and the days
+ *        saved; only while the I2C worker is idle
+ ******************************************************/
+static void vMsp_trackMicsBaseline(void)
+{
+  if ((sysStat.micsBaselineMode == MICS_BASELINE_OFF) || !bMspBaseline_dayClosed())
+  {
+    return;
+  }
+
+  sensorR0Value_t proposed;
+  if (bMspBaseline_propose(sysStat.micsBaselineDays, &sensorData_accumulate.micsTuningData.sensingResInAir, &proposed))
+  {
+    if (sysStat.micsBaselineMode == MICS_BASELINE_APPLY)
     {
-      log_i("All measurements obtained, going to send data...\n");
-      mainStateMachine.next_state = SYS_STATE_SEND_DATA; // go to send data state
+      vMspOs_takeDataAccessMutex();
+      sensorData_accumulate.micsTuningData.sensingResInAir = proposed;
+      vMspOs_giveDataAccessMutex();
+      vMspBaseline_setR0(&proposed);
+
+      // the MICS6814 library reads R0 from the sensor EEPROM
+      if (sensorData_accumulate.status.MICS6814Sensor)
+      {
+        bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+        vHalSensor_writeMicsValues(&sensorData_accumulate);
+        vMspI2c_give(I2C_CLIENT_SENSORS);
+      }
+      if (sysStat.sdCard && !bHalSdcard_writeConfig(&devinfo, &sensorData_accumulate, &measStat, &sysStat, &sysData))
+      {
+        log_e("MICS R0 applied but not saved to the configuration");
+      }
+      log_i("MICS R0 applied: RED %u OX %u NH3 %u", proposed.redSensor, proposed.oxSensor, proposed.nh3Sensor);
+    }
+    else
+    {
+      log_i("MICS R0 proposed, not applied (mics_baseline = propose): RED %u OX %u NH3 %u", proposed.redSensor,
+            proposed.oxSensor, proposed.nh3Sensor);
+    }
+  }
+
+  if (sysStat.sdCard && !bHalSdcard_saveMicsBaseline(p_tMspBaseline_store(), sizeof(micsBaselineStore_t)))
+  {
+    log_w("Failed to save the MICS baseline");
+  }
+}
+
+/******************************************************
+ * @brief boot stage: configuration from the SD card
+ ******************************************************/
+static void vMsp_bootSdRead(void)
+{
+  // STEP 1: Single SD Card Configuration Reading
+  log_i("=== STEP 1: Loading complete system configuration from SD card ===");
+  vHalSdcard_readSD(&sysStat, &devinfo, &sensorData_accumulate, &measStat, &sysData);
+}
+
+/******************************************************
+ * @brief boot stage: firmware downloaded before the reboot
+ ******************************************************/
+static void vMsp_bootFirmwarePending(void)
+{
+  // Phase 2: Check for downloaded firmware and apply update if newer
+  if (SD.exists("/firmware.bin"))
+  {
+    log_i("Downloaded firmware file found - checking for update");
+    if (bHalFirmware_checkAndApplyPendingUpdate("/firmware.bin"))
+    {
+      log_i("Firmware update applied successfully");
+    }
+    else
+    {
+      log_w("No firmware update needed or update failed - cleaning up file");
     }
-    else if (!boundary_not_transmitted)
+    // Always remove firmware file after processing
+    if (SD.remove("/firmware.bin"))
     {
-      log_i("Data already transmitted at this boundary (%02d:%02d), waiting for next boundary", curr_hour, measStat.curr_minutes);
-      mainStateMachine.next_state = SYS_STATE_WAIT_FOR_TIMEOUT;
+      log_i("Firmware file cleaned up successfully");
     }
     else
     {
-      // MEASUREMENTS MESSAGE
-      log_i("Measurements in progress...\n");
-      vMsp_updateDataAndSendEvent(DISP_EVENT_SHOW_MEAS_DATA, &sensorData_single, &devinfo, &measStat, &sysData, &sysStat);
-
-      log_i("Not enough measurements obtained, going to wait for timeout...\n");
-      mainStateMachine.next_state = SYS_STATE_WAIT_FOR_TIMEOUT;
+      log_w("Failed to remove firmware.bin file");
     }
-
-    mainStateMachine.prev_state = SYS_STATE_EVAL_SENSOR_STATUS;
-    break;
   }
-  //------------------------------------------------------------------------------------------------------------------------
-  //------------------------------------------------------------------------------------------------------------------------
-  case SYS_STATE_SEND_DATA:
-  {
-    log_i("Sending data to server...\n");
-
-    // We have obtained all the measurements, do the mean and transmit the data
-    log_i("All measurements obtained, sending data...\n");
-    log_i("Sensor values BEFORE AVERAGE:\n");
-    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d vs %d\n",
-          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure,
-          sensorData_accumulate.gasData.volatileOrganicCompounds,
-          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
-          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
-          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count, measStat.avg_measurements);
-
-    vMsp_updateDataAndSendEvent(DISP_EVENT_SENDING_MEAS, &sensorData_single, &devinfo, &measStat, &sysData, &sysStat);
-
-    if (sensorData_accumulate.status.BME680Sensor || sensorData_accumulate.status.PMS5003Sensor || sensorData_accumulate.status.MICS6814Sensor || sensorData_accumulate.status.MICS4514Sensor || sensorData_accumulate.status.O3Sensor)
-    {
-      log_i("Computing averages from %d measurements", measStat.measurement_count);
-      log_i("Error counts: BME=%d, PMS=%d, MICS=%d, O3=%d", err.BMEfails, err.PMSfails, err.MICSfails, err.O3fails);
-
-      // Log values before averaging for debugging
-      log_i("BEFORE AVERAGING: temp=%.2f, PM2.5=%d, CO=%.2f",
-            sensorData_accumulate.gasData.temperature,
-            sensorData_accumulate.airQualityData.particleMicron25,
-            sensorData_accumulate.pollutionData.carbonMonoxide);
+}
 
-      vHalSensor_performAverages(&err, &sensorData_accumulate, &measStat);
+/******************************************************
+ * @brief boot stage: configuration checked, defaults
+ *        where the SD card had none
+ ******************************************************/
+static void vMsp_bootConfigure(void)
+{
+  // STEP 2: Fill system configuration with SD data or defaults
+  log_i("=== STEP 2: Configuring system with loaded data or defaults ===");
+  vMspInit_configureSystemFromSD(&sysData, &sysStat, &devinfo, &measStat);
 
-      // Update sensorData_single with final averaged values for LCD display
-      if (sensorData_accumulate.status.MICS4514Sensor)
-      {
-        log_i("Updating sensorData_single with final averaged MICS4514 values");
-        sensorData_single.pollutionData.carbonMonoxide = sensorData_accumulate.pollutionData.carbonMonoxide;
-        sensorData_single.pollutionData.nitrogenDioxide = sensorData_accumulate.pollutionData.nitrogenDioxide;
-        sensorData_single.pollutionData.ammonia = sensorData_accumulate.pollutionData.ammonia;
-        log_i("sensorData_single updated: CO=%.2f, NO2=%.2f, NH3=%.2f ug/m3",
-              sensorData_single.pollutionData.carbonMonoxide,
-              sensorData_single.pollutionData.nitrogenDioxide,
-              sensorData_single.pollutionData.ammonia);
-      }
+  // Debug: Check final configuration status
+  log_i("Final Configuration Status:");
+  log_i("  SD Card: %s", sysStat.sdCard ? "OK" : "FAILED");
+  log_i("  Config File: %s", sysStat.configuration ? "OK" : "FAILED");
+  log_i("  WiFi SSID: %s", devinfo.ssid.c_str());
+  log_i("  Server: %s", sysData.server.c_str());
+  log_i("  *** MEASUREMENT CONFIG: avg_measurements=%d, max_measurements=%d, sampling period=%d s ***", measStat.avg_measurements, measStat.max_measurements, measStat.delay_between_measurements);
+  log_i("  Use Modem: %s", sysStat.use_modem ? "YES" : "NO");
+  log_i("  Firmware Auto-Upgrade: %s", sysStat.fwAutoUpgrade ? "ENABLED" : "DISABLED");
 
-      // Log values after averaging for debugging
-      log_i("AFTER AVERAGING: temp=%.2f, PM2.5=%d, CO=%.2f",
-            sensorData_accumulate.gasData.temperature,
-            sensorData_accumulate.airQualityData.particleMicron25,
-            sensorData_accumulate.pollutionData.carbonMonoxide);
-    }
+  measStat.max_measurements = measStat.avg_measurements; /*!< fill the max_measurements with the number set by the user */
+}
 
-    // MSP# Index evaluation
-    sensorData_accumulate.MSP = sHalSensor_evaluateMSPIndex(&sensorData_accumulate);
+/******************************************************
+ * @brief boot stage: network task start
+ ******************************************************/
+static void vMsp_bootNetwork(void)
+{
+  // STEP 3: Start network task with complete configuration
+  log_i("=== STEP 3: Starting network task ===");
+  createNetworkEvents();
+  initSendDataOp(&sysData, &sysStat, &devinfo);
 
-    log_i("Sending data to server...");
-    send_data_t sendData;
-    memcpy(&sendData.sendTimeInfo, &timeinfo, sizeof(tm)); // copy time info to sendData
-    log_i("Current time: %02d:%02d:%02d\n", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
-    // Keep the original timestamp - measurements are aligned to minute boundaries
-    // No need to manipulate time as measurements now start exactly at :00 seconds
-    sendData.sendTimeInfo.tm_sec = 0; // Always send with :00 seconds for consistency
+  // Wait for network task to initialize, the sensor lanes go on meanwhile
+  vTaskDelay(pdMS_TO_TICKS(NETWORK_START_SETTLE_MS));
+}
 
-    log_i("Send timestamp: %02d:%02d:%02d\n", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
-    sendData.temp = sensorData_accumulate.gasData.temperature;
-    sendData.hum = sensorData_accumulate.gasData.humidity;
-    sendData.pre = sensorData_accumulate.gasData.pressure;
-    sendData.VOC = sensorData_accumulate.gasData.volatileOrganicCompounds;
-    sendData.PM1 = sensorData_accumulate.airQualityData.particleMicron1;
-    sendData.PM25 = sensorData_accumulate.airQualityData.particleMicron25;
-    sendData.PM10 = sensorData_accumulate.airQualityData.particleMicron10;
-    // Assign gas sensor data based on sensor type
-    switch (sysStat.gasSensorType)
-    {
-    case GAS_SENSOR_MICS6814:
-      sendData.MICS_CO = sensorData_accumulate.pollutionData.carbonMonoxide;
-      sendData.MICS_NO2 = sensorData_accumulate.pollutionData.nitrogenDioxide;
-      sendData.MICS_NH3 = sensorData_accumulate.pollutionData.ammonia;
-      break;
+/******************************************************
+ * @brief BME680 detection and BSEC setup
+ ******************************************************/
+static void vMsp_detectBME680(void)
+{
+  vMsp_updateDataAndSendEvent(DISP_EVENT_BME680_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
-    case GAS_SENSOR_MICS4514:
-      sendData.MICS_CO = sensorData_accumulate.pollutionData.carbonMonoxide;
-      sendData.MICS_NO2 = sensorData_accumulate.pollutionData.nitrogenDioxide;
-      sendData.MICS_NH3 = sensorData_accumulate.pollutionData.ammonia;
-      break;
+  bme680.begin(BME68X_I2C_ADDR_HIGH, Wire);
+  if (tHalSensor_checkBMESensor(&bme680))
+  {
+    log_i("BME680 sensor detected, initializing...\n");
+    vMsp_restoreBsecState(); // before the subscription, so the gas calibration goes on from the last save
+    esp_register_shutdown_handler(vMsp_saveBsecStateAtShutdown);
+    bsec_virtual_sensor_t sensor_list[] = {
+        BSEC_OUTPUT_RAW_TEMPERATURE,
+        BSEC_OUTPUT_RAW_PRESSURE,
+        BSEC_OUTPUT_RAW_HUMIDITY,
+        BSEC_OUTPUT_RAW_GAS,
+        BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_TEMPERATURE,
+        BSEC_OUTPUT_SENSOR_HEAT_COMPENSATED_HUMIDITY,
+    };
+    bme680.updateSubscription(sensor_list, sizeof(sensor_list) / sizeof(sensor_list[0]), BSEC_SAMPLE_RATE_LP);
+    sensorData_accumulate.status.BME680Sensor = true;
+    vMsp_updateDataAndSendEvent(DISP_EVENT_BME680_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+  }
+  else
+  {
+    log_e("BME680 sensor not detected!\n");
+    vMsp_updateDataAndSendEvent(DISP_EVENT_BME680_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+  }
+}
 
-    default:
-      // Default to zero if no gas sensor configured
-      sendData.MICS_CO = 0.0;
-      sendData.MICS_NO2 = 0.0;
-      sendData.MICS_NH3 = 0.0;
-      break;
-    }
-    sendData.ozone = sensorData_accumulate.ozoneData.ozone;
-    sendData.MSP = sensorData_accumulate.MSP;
+/******************************************************
+ * @brief MICS6814 detection, R0 values checked against
+ *        the configured ones
+ ******************************************************/
+static void vMsp_detectMICS6814(void)
+{
+  vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
-    log_i("Sensor values AFTER AVERAGE:\n");
-    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d\n",
-          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure,
-          sensorData_accumulate.gasData.volatileOrganicCompounds,
-          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
-          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
-          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count);
+  if (gas.begin())
+  { // Connect to MICS6814 sensor using default I2C address (0x04)
+    log_i("MICS6814 sensor detected, initializing...\n");
+    sensorData_accumulate.status.MICS6814Sensor = true;
+    gas.powerOn(); // turn on heating element and led
+    gas.ledOn();
+    vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
-    log_i("Send Time: %02d:%02d:%02d\n", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
+    sensorR0Value_t r0Values;
+    r0Values.redSensor = gas.getBaseResistance(CH_RED);
+    r0Values.oxSensor = gas.getBaseResistance(CH_OX);
+    r0Values.nh3Sensor = gas.getBaseResistance(CH_NH3);
 
-    // Always log to SD card FIRST, regardless of network status
-    log_i("Writing data to SD card (mandatory logging)... SD status: %s", sysStat.sdCard ? "OK" : "FAIL");
-    if (sysStat.sdCard)
+    if (tHalSensor_checkMicsValues(&sensorData_accumulate, &r0Values) == STATUS_OK)
     {
-      vHalSdcard_logToSD(&sendData, &sysData, &sysStat, &sensorData_accumulate, &devinfo);
-      log_i("Data logged to SD card successfully with date-based folder structure");
+      log_i("MICS6814 R0 values are already as default!\n");
+      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_VALUES_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
     }
     else
     {
-      log_w("SD card not available for logging - data will be lost!");
-    }
+      log_i("Setting MICS6814 R0 values as default... ");
+      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_DEF_SETTING, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
-    // Enqueue data for transmission by network task
-    if (enqueueSendData(sendData, pdMS_TO_TICKS(500)))
-    {
-      log_i("Data enqueued successfully for network transmission");
-      measStat.data_transmitted = true;                                // Mark data as transmitted for this cycle
-      measStat.last_transmission_epoch = mktime(&sendData.sendTimeInfo); // Record epoch time to prevent duplicates
-      log_i("Recorded transmission epoch %lld (%02d:%02d) to prevent duplicates",
-            (long long)measStat.last_transmission_epoch, sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min);
-    }
-    else
-    {
-      log_e("Failed to enqueue data for transmission - queue might be full");
+      vHalSensor_writeMicsValues(&sensorData_accumulate);
+
+      vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_DONE, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+      log_i("Done!\n");
     }
+    gas.setOffsets(&sensorData_accumulate.micsTuningData.sensingResInAirOffset.redSensor);
+  }
+  else
+  {
+    log_e("MICS6814 sensor not detected!\n");
+    vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+  }
+}
 
-    // show the averaged data after transmission
-    vMsp_updateDataAndSendEvent(DISP_EVENT_SHOW_MEAS_DATA, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+/******************************************************
+ * @brief MICS4514 detection, the heater warm-up starts
+ ******************************************************/
+static void vMsp_detectMICS4514(void)
+{
+  vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
-    log_i("Data transmission time: %02d:%02d:%02d", sendData.sendTimeInfo.tm_hour, sendData.sendTimeInfo.tm_min, sendData.sendTimeInfo.tm_sec);
-    log_i("temp: %.2f, hum: %.2f, pre: %.2f, VOC: %.2f, PM1: %d, PM25: %d, PM10: %d, MICS_CO: %.2f, MICS_NO2: %.2f, MICS_NH3: %.2f, ozone: %.2f, MSP: %d, measurement_count: %d vs %d",
-          sensorData_accumulate.gasData.temperature, sensorData_accumulate.gasData.humidity, sensorData_accumulate.gasData.pressure,
-          sensorData_accumulate.gasData.volatileOrganicCompounds,
-          sensorData_accumulate.airQualityData.particleMicron1, sensorData_accumulate.airQualityData.particleMicron25, sensorData_accumulate.airQualityData.particleMicron10,
-          sensorData_accumulate.pollutionData.carbonMonoxide, sensorData_accumulate.pollutionData.nitrogenDioxide, sensorData_accumulate.pollutionData.ammonia,
-          sensorData_accumulate.ozoneData.ozone, sensorData_accumulate.MSP, measStat.measurement_count, measStat.avg_measurements);
+  log_i("Initializing MICS4514 sensor (DFRobot SEN0377)...\n");
+  if (mics4514.begin())
+  {
+    vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+    // Connect to MICS4514 sensor using I2C
+    log_i("MICS4514 sensor detected, initializing...\n");
+    sensorData_accumulate.status.MICS4514Sensor = true;
 
-    mainStateMachine.isFirstTransition = true; // set first transition flag
-    // This will clean up the sensor variables for the next cycle
+    mics4514.wakeUpMode();
 
-    // Always reset measurement count after transmission attempt (success or failure)
-    log_i("TRANSMISSION ATTEMPT COMPLETE: Resetting measurement_count from %d to 0", measStat.measurement_count);
-    measStat.measurement_count = 0;
-    measStat.data_transmitted = false; // Reset flag for new measurement cycle
-    // Note: last_transmission_epoch is NOT reset here - it stays to prevent duplicates in the same boundary window
+    // The heater warms up in the background, the samples are left out of the averages until it is done
+    log_i("Starting MICS4514 warmup process (%d minutes)...\n", MICS4514_WARMUP_TIME_MIN);
+    vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_HEATING_UP, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+    micsWarmupStartMs = millis();
 
-    // Reset all sensor data (both single and accumulated) for clean start of next cycle
-    log_i("Resetting all sensor data for next measurement cycle");
-    // Reset accumulated sensor data
-    sensorData_accumulate.gasData.temperature = 0.0f;
-    sensorData_accumulate.gasData.pressure = 0.0f;
-    sensorData_accumulate.gasData.humidity = 0.0f;
-    sensorData_accumulate.gasData.volatileOrganicCompounds = 0.0f;
-    sensorData_accumulate.airQualityData.particleMicron1 = 0.0f;
-    sensorData_accumulate.airQualityData.particleMicron25 = 0.0f;
-    sensorData_accumulate.airQualityData.particleMicron10 = 0.0f;
-    sensorData_accumulate.pollutionData.carbonMonoxide = 0.0f;
-    sensorData_accumulate.pollutionData.nitrogenDioxide = 0.0f;
-    sensorData_accumulate.pollutionData.ammonia = 0.0f;
-    sensorData_accumulate.ozoneData.ozone = 0.0f;
+    // Initialize MICS4514 specific data
+    sensorData_accumulate.mics4514Data.warmupComplete = 0;
+    sensorData_accumulate.mics4514Data.powerState = 1;
 
-    // Reset MICS4514 ADC accumulator
-    sensorData_accumulate.mics4514AdcAccumulator.oxVoltageSum = 0;
-    sensorData_accumulate.mics4514AdcAccumulator.redVoltageSum = 0;
+    log_i("MICS4514 initialization complete!\n");
+  }
+  else
+  {
+    log_e("MICS4514 sensor not detected!\n");
+    vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+  }
+}
 
-    // Reset single measurement data
-    sensorData_single.gasData.temperature = 0.0f;
-    sensorData_single.gasData.pressure = 0.0f;
-    sensorData_single.gasData.humidity = 0.0f;
-    sensorData_single.gasData.volatileOrganicCompounds = 0.0f;
-    sensorData_single.airQualityData.particleMicron1 = 0.0f;
-    sensorData_single.airQualityData.particleMicron25 = 0.0f;
-    sensorData_single.airQualityData.particleMicron10 = 0.0f;
-    sensorData_single.pollutionData.carbonMonoxide = 0.0f;
-    sensorData_single.pollutionData.nitrogenDioxide = 0.0f;
-    sensorData_single.pollutionData.ammonia = 0.0f;
-    sensorData_single.ozoneData.ozone = 0.0f;
+/******************************************************
+ * @brief PMS5003 detection, then the frame stream
+ ******************************************************/
+static void vMsp_detectPMS5003(void)
+{
+  pmsSerial.setRxBufferSize(PMS_RX_BUFFER_SIZE);               // before begin(), the driver allocates it there
+  pmsSerial.begin(9600, SERIAL_8N1, PMSERIAL_RX, PMSERIAL_TX); // baud, type, ESP_RX, ESP_TX
+  delay(1500);
+  vMsp_updateDataAndSendEvent(DISP_EVENT_PMS5003_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+  delay(1000);
+  if (pms.readUntil(data))
+  {
+    log_i("PMS5003 sensor detected, initializing...\n");
+    sensorData_accumulate.status.PMS5003Sensor = true;
+    vMsp_updateDataAndSendEvent(DISP_EVENT_PMS5003_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+    measStat.isPmsAwake = true;
+    vHalPms_startStream(&pmsSerial);
+  }
+  else
+  {
+    log_e("PMS5003 sensor not detected!\n");
+    vMsp_updateDataAndSendEvent(DISP_EVENT_PMS5003_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+  }
+}
 
-    // After transmission, system is now aligned - next cycles will be full measurements
-    log_i("Data enqueued successfully. System now aligned - next cycles will collect %d measurements", measStat.max_measurements);
-    log_i("Note: Server config from this transmission will be applied in next cycle");
+/******************************************************
+ * @brief O3 detection, then the ADC sampling
+ ******************************************************/
+static void vMsp_detectO3(void)
+{
+  vMsp_updateDataAndSendEvent(DISP_EVENT_O3_SENSOR_INIT, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
 
-    mainStateMachine.prev_state = SYS_STATE_SEND_DATA;
-    mainStateMachine.next_state = SYS_STATE_UPDATE_CONFIG_FROM_SERVER; // Check for server config from PREVIOUS transmission
-    break;
+  if (!tHalSensor_isAnalogO3Connected())
+  {
+    log_e("O3 sensor not detected!\n");
+    vMsp_updateDataAndSendEvent(DISP_EVENT_O3_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
+    sensorData_accumulate.status.O3Sensor = false;
   }
-  //------------------------------------------------------------------------------------------------------------------------
-  //------------------------------------------------------------------------------------------------------------------------
-  case SYS_STATE_ERROR:
+  else
   {
-    vMsp_updateDataAndSendEvent(DISP_EVENT_SYSTEM_ERROR, &sensorData_single, &devinfo, &measStat, &sysData, &sysStat);
-    log_e("System in error state! Waiting for reset...");
-    vTaskDelay(portMAX_DELAY);
-    break;
+    log_i("O3 sensor detected, running...\n");
+    sensorData_accumulate.status.O3Sensor = true;
+    vHalO3Adc_start();
+    vMsp_updateDataAndSendEvent(DISP_EVENT_O3_SENSOR_OKAY, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
   }
-  //------------------------------------------------------------------------------------------------------------------------
-  //------------------------------------------------------------------------------------------------------------------------
-  default:
+}
+
+/******************************************************
+ * @brief detection of the sensors of a bus fitted with
+ *        the configured gas sensor
+ ******************************************************/
+static void vMsp_detectSensors(acqBus_t bus)
+{
+  for (uint32_t i = 0; i < SENSOR_DRIVER_COUNT; i++)
   {
-    log_e("Unknown state %d!", mainStateMachine.current_state);
-    mainStateMachine.next_state = SYS_STATE_WAIT_FOR_TIMEOUT; // go to error state
-    break;
+    const sensorDriver_t *p_tDriver = &tSensorDrivers[i];
+    if ((p_tDriver->bus == bus) && bMsp_driverSelected(p_tDriver))
+    {
+      // the I2C sensors hold the bus for their whole setup, the display waits at boot
+      if (bus == ACQ_BUS_I2C)
+      {
+        bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
+      }
+      p_tDriver->detect();
+      if (bus == ACQ_BUS_I2C)
+      {
+        vMspI2c_give(I2C_CLIENT_SENSORS);
+      }
+    }
+  }
+}
+
+#ifndef ENABLE_FIRMWARE_UPDATE_TESTS
+/******************************************************
+ * @brief boot stage: BME680 and gas sensor
+ ******************************************************/
+static void vMsp_bootI2cSensors(void)
+{
+  bool gasDriver = false;
+  for (uint32_t i = 0; i < SENSOR_DRIVER_COUNT; i++)
+  {
+    gasDriver |= (tSensorDrivers[i].gasSensorType == sysStat.gasSensorType);
   }
+  if (!gasDriver)
+  {
+    log_e("Unknown gas sensor type: %d\n", sysStat.gasSensorType);
+    vMsp_updateDataAndSendEvent(DISP_EVENT_MICSxx14_SENSOR_ERR, &sensorData_accumulate, &devinfo, &measStat, &sysData, &sysStat);
   }
-  mainStateMachine.current_state = mainStateMachine.next_state; // update current state to next state
+  vMsp_detectSensors(ACQ_BUS_I2C);
+  vMsp_restoreMicsBaseline();
+}
+
+/******************************************************
+ * @brief boot stage: PMS5003
+ ******************************************************/
+static void vMsp_bootUartSensors(void)
+{
+  vMsp_detectSensors(ACQ_BUS_UART);
+}
+
+/******************************************************
+ * @brief boot stage: O3
+ ******************************************************/
+static void vMsp_bootAdcSensors(void)
+{
+  vMsp_detectSensors(ACQ_BUS_ADC);
+}
+#endif
+
+/******************************************************
+ * @brief the driver serves a sensor of this station:
+ *        not a gas sensor, or the configured one
+ ******************************************************/
+static bool bMsp_driverSelected(const sensorDriver_t *p_tDriver)
+{
+  return (p_tDriver->gasSensorType == SENSOR_DRIVER_ANY_GAS) || (p_tDriver->gasSensorType == sysStat.gasSensorType);
+}
+
+/******************************************************
+ * @brief sampling periods in a transmission interval
+ ******************************************************/
+static int32_t lMsp_intervalSlots(void)
+{
+  return (measStat.max_measurements * SEC_IN_MIN) / measStat.delay_between_measurements;
 }
 
 /*********************************************************
@@ -1569,18 +2280,12 @@ void vMspInit_sensorStatusAndData(sensorData_t *p_tData)
   p_tData->status.MICS4514Sensor = DISABLED;
   p_tData->status.O3Sensor = DISABLED;
 
+  // -- every measurement channel starts at zero
+  vMspChan_resetAll(p_tData);
+
   // -- set gas sensor default values
-  p_tData->gasData.humidity = 0.0;
-  p_tData->gasData.temperature = 0.0;
-  p_tData->gasData.pressure = 0.0;
-  p_tData->gasData.volatileOrganicCompounds = 0.0;
   p_tData->gasData.seaLevelAltitude = SEA_LEVEL_ALTITUDE_IN_M;
 
-  // -- set air quality sensor default values
-  p_tData->airQualityData.particleMicron1 = 0;
-  p_tData->airQualityData.particleMicron25 = 0;
-  p_tData->airQualityData.particleMicron10 = 0;
-
   // -- default R0 values for the sensor (RED, OX, NH3)
   p_tData->micsTuningData.sensingResInAir.redSensor = R0_RED_SENSOR;
   p_tData->micsTuningData.sensingResInAir.oxSensor = R0_OX_SENSOR;
@@ -1596,13 +2301,7 @@ void vMspInit_sensorStatusAndData(sensorData_t *p_tData)
   p_tData->molarMass.nitrogenDioxide = NO2_MOLAR_MASS;
   p_tData->molarMass.ammonia = NH3_MOLAR_MASS;
 
-  // -- MICS6814 sensor data
-  p_tData->pollutionData.carbonMonoxide = 0;
-  p_tData->pollutionData.nitrogenDioxide = 0;
-  p_tData->pollutionData.ammonia = 0;
-
   // -- ozone detection module data
-  p_tData->ozoneData.ozone = 0;
   p_tData->ozoneData.o3ZeroOffset = O3_SENS_DISABLE_ZERO_OFFSET;
 
   // -- compensation parameters for MICS6814-OX and BME680-VOC data
@@ -1648,6 +2347,7 @@ void vMspInit_configureSystemFromSD(systemData_t *sysData, systemStatus_t *sysSt
 
   // Measurement configuration - ensure it's a valid submultiple of 60
   int valid_intervals[] = {1, 2, 3, 4, 5, 6, 10, 12, 15, 20, 30, 60};
+  int valid_periods[] = {5, 10, 15, 20, 30, 60};
   bool is_valid = false;
 
   // Apply configuration defaults if SD card data is missing or invalid
@@ -1772,6 +2472,26 @@ void vMspInit_configureSystemFromSD(systemData_t *sysData, systemStatus_t *sysSt
     }
   }
 
+  // Sampling period - a submultiple of a minute, one sample per minute by default
+  is_valid = false;
+  for (size_t i = 0; i < sizeof(valid_periods) / sizeof(valid_periods[0]); i++)
+  {
+    if (measStat->delay_between_measurements == valid_periods[i])
+    {
+      is_valid = true;
+      break;
+    }
+  }
+  if (!is_valid)
+  {
+    if (measStat->delay_between_measurements != 0)
+    {
+      log_w("Invalid sampling period (%d s). Valid values: 5, 10, 15, 20, 30, 60. Setting to 60", measStat->delay_between_measurements);
+    }
+    measStat->delay_between_measurements = SEC_IN_MIN;
+  }
+  log_i("Sampling period: %d s", measStat->delay_between_measurements);
+
 // Apply firmware version
 #ifdef VERSION_STRING
   sysData->ver = VERSION_STRING;
@@ -1814,8 +2534,10 @@ void vMsp_scanI2CDevices(void)
 
   for (uint8_t address = 1; address < 127; address++)
   {
+    bMspI2c_take(I2C_CLIENT_SENSORS, portMAX_DELAY);
     Wire.beginTransmission(address);
     uint8_t error = Wire.endTransmission();
+    vMspI2c_give(I2C_CLIENT_SENSORS);
 
     if (error == 0)
     {
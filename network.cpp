@@ -29,6 +29,11 @@
 #include "sensors.h"
 #include "config.h"
 #include "firmware_update.h"
+#include "latency.h"
+#include "channelStats.h"
+#include "channelTable.h"
+#include "rawHistory.h"
+#include "rollup.h"
 
 // -- Network Configuration Constants
 #define TIME_SYNC_MAX_RETRY 5
@@ -52,6 +57,7 @@ static TaskHandle_t networkTaskHandle = NULL;
 // Queue and synchronization objects
 static QueueHandle_t sendDataQueue = NULL;
 static QueueHandle_t serverConfigQueue = NULL; // Queue for server config responses
+static QueueHandle_t rollupQueue = NULL;       // Closed rollups, sent after the records
 static EventGroupHandle_t networkEventGroup = NULL;
 static StaticEventGroup_t networkEventGroupBuffer;
 static SemaphoreHandle_t networkStateMutex = NULL;
@@ -166,6 +172,23 @@ bool dequeueSendData(send_data_t *data, TickType_t ticksToWait)
     return (xQueueReceive(sendDataQueue, data, ticksToWait) == pdPASS);
 }
 
+bool enqueueRollup(const rollupRecord_t &rollup)
+{
+    if (rollupQueue == NULL)
+    {
+        return false;
+    }
+
+    // the network task peeks the oldest one while sending it, only it takes rollups out
+    if (xQueueSend(rollupQueue, &rollup, 0) != pdPASS)
+    {
+        log_w("Rollup queue full, %s rollup of %lu dropped", pcMspRollup_levelName((rollupLevel_t)rollup.level),
+              (unsigned long)rollup.start);
+        return false;
+    }
+    return true; // no event, they go with the next records
+}
+
 bool dequeueServerConfig(server_config_msg_t *config, TickType_t ticksToWait)
 {
     if (serverConfigQueue == NULL || config == NULL)
@@ -217,6 +240,17 @@ void initSendDataOp(systemData_t *sysData, systemStatus_t *sysStatus, deviceNetw
         log_i("Server config queue created successfully");
     }
 
+    // Create the rollup queue, its rollups wait for the records to be through
+    if (rollupQueue == NULL)
+    {
+        rollupQueue = xQueueCreate(ROLLUP_QUEUE_LENGTH, sizeof(rollupRecord_t));
+        if (rollupQueue == NULL)
+        {
+            log_e("Failed to create rollup queue");
+            return;
+        }
+    }
+
     // Create mutex for network state protection
     if (networkStateMutex == NULL)
     {
@@ -1049,46 +1083,63 @@ static bool sendDataToServer(send_data_t *dataToSend, deviceNetworkInfo_t *devIn
     }
     postData += "&firmwareVersion=" + fwVersion;
 
-    // Add sensor data - match original working logic by including all available data
-    // BME680 data (always include if temperature is in reasonable range)
-    if ((dataToSend->temp > -50.0) && (dataToSend->temp < 85.0))
+    // Add sensor data - the channels of a sensor go together, when it has a reading: BME680 when the
+    // temperature is in a reasonable range, the others when any of their values is positive
+    bool sensorPresent[CHAN_SENSOR_MAX] = {false};
+    for (uint32_t i = 0; i < STATS_CH_MAX; i++)
+    {
+        if (fMspChan_sent(dataToSend, (stats_channel_t)i) >= 0.0)
+        {
+            sensorPresent[tMspChan_sensor((stats_channel_t)i)] = true;
+        }
+    }
+    sensorPresent[CHAN_SENSOR_BME680] = (dataToSend->temp > -50.0) && (dataToSend->temp < 85.0);
+    for (uint32_t i = 0; i < STATS_CH_MAX; i++)
     {
-        postData += "&temp=" + String(dataToSend->temp, 3);
-        postData += "&hum=" + String(dataToSend->hum, 3);
-        postData += "&pre=" + String(dataToSend->pre, 3);
-        postData += "&voc=" + String(dataToSend->VOC, 3);
-        log_d("Added BME680 data: T=%.3f, H=%.3f, P=%.3f, VOC=%.3f",
-              dataToSend->temp, dataToSend->hum, dataToSend->pre, dataToSend->VOC);
+        stats_channel_t channel = (stats_channel_t)i;
+        if (sensorPresent[tMspChan_sensor(channel)])
+        {
+            float value = fMspChan_sent(dataToSend, channel);
+            postData += "&" + String(pcMspChan_name(channel)) + "=" + (bMspChan_whole(channel) ? String((int32_t)value) : String(value, 3));
+        }
     }
 
-    // MICS6814 data (include if any gas reading is positive)
-    if ((dataToSend->MICS_CO >= 0.0) || (dataToSend->MICS_NO2 >= 0.0) || (dataToSend->MICS_NH3 >= 0.0))
+    postData += "&msp=" + String(dataToSend->MSP);
+    if (dataToSend->caqi >= 0)
     {
-        postData += "&cox=" + String(dataToSend->MICS_CO, 3);
-        postData += "&nox=" + String(dataToSend->MICS_NO2, 3);
-        postData += "&nh3=" + String(dataToSend->MICS_NH3, 3);
-        log_d("Added MICS6814 data: CO=%.3f, NO2=%.3f, NH3=%.3f",
-              dataToSend->MICS_CO, dataToSend->MICS_NO2, dataToSend->MICS_NH3);
+        postData += "&caqi=" + String(dataToSend->caqi);
     }
 
-    // PMS5003 data (include if any PM reading is positive)
-    if ((dataToSend->PM1 >= 0) || (dataToSend->PM25 >= 0) || (dataToSend->PM10 >= 0))
+    // Standard deviation of the samples behind each value
+    for (uint32_t i = 0; i < STATS_CH_MAX; i++)
     {
-        postData += "&pm1=" + String(dataToSend->PM1);
-        postData += "&pm25=" + String(dataToSend->PM25);
-        postData += "&pm10=" + String(dataToSend->PM10);
-        log_d("Added PMS5003 data: PM1=%d, PM2.5=%d, PM10=%d",
-              dataToSend->PM1, dataToSend->PM25, dataToSend->PM10);
+        if (dataToSend->dispersion[i] >= 0.0)
+        {
+            postData += "&" + String(pcMspStats_channelName((stats_channel_t)i)) + "_sd=" + String(dataToSend->dispersion[i], 3);
+        }
     }
 
-    // O3 data (include if reading is positive)
-    if (dataToSend->ozone >= 0.0)
+    // Sampling periods of the interval, and how many of them each value comes from
+    postData += "&periods=" + String(dataToSend->periods);
+    for (uint32_t i = 0; i < STATS_CH_MAX; i++)
     {
-        postData += "&o3=" + String(dataToSend->ozone, 3);
-        log_d("Added O3 data: %.3f", dataToSend->ozone);
+        if (dataToSend->covered[i] != 0)
+        {
+            postData += "&" + String(pcMspStats_channelName((stats_channel_t)i)) + "_cov=" + String(dataToSend->covered[i]);
+        }
     }
 
-    postData += "&msp=" + String(dataToSend->MSP);
+    // Loop latency (optional, upload_latency in the config)
+    if (dataToSend->hasLatency)
+    {
+        for (uint32_t i = 0; i < LATENCY_SLOT_MAX; i++)
+        {
+            if (dataToSend->latencyMaxUs[i] != 0)
+            {
+                postData += "&lat_" + String(pcMspLatency_slotName((latency_slot_t)i)) + "=" + String(dataToSend->latencyMaxUs[i]);
+            }
+        }
+    }
     postData += "&recordedAt=" + String(epochTime);
 
     log_d("POST data length: %d bytes", postData.length());
@@ -1240,6 +1291,13 @@ static bool sendDataToServer(send_data_t *dataToSend, deviceNetworkInfo_t *devIn
                 log_i("SUCCESS: Data uploaded successfully! Status: %s",
                       response.substring(0, response.indexOf('\r')).c_str());
 
+                // A raw history dump is not configuration, it is looked for whatever SKIP_SERVER_CONFIG_DOWNLOAD
+                int requestStart = response.indexOf("\r\n\r\n");
+                if (requestStart >= 0)
+                {
+                    bMspHistory_parseRequest(response.c_str() + requestStart + 4);
+                }
+
 #if SKIP_SERVER_CONFIG_DOWNLOAD
                 log_i("SKIP_SERVER_CONFIG_DOWNLOAD is enabled - ignoring server configuration response");
 #else
@@ -1353,6 +1411,181 @@ static bool sendDataToServer(send_data_t *dataToSend, deviceNetworkInfo_t *devIn
     return false;
 }
 
+// POST a form to the server, a single attempt that only reads the status line back
+static bool postFormOnce(const char *path, const String &postData, deviceNetworkInfo_t *devInfo, systemData_t *sysData,
+                         String *status)
+{
+    *status = "";
+    if (!sslClient || !sslClient->connect(sysData->server.c_str(), 443))
+    {
+        *status = "connection failed";
+        return false;
+    }
+
+    String httpRequest = "POST " + String(path) + " HTTP/1.1\r\n";
+    httpRequest += "Host: " + sysData->server + "\r\n";
+    httpRequest += "Authorization: Bearer " + sysData->api_secret_salt + ":" + devInfo->deviceid + "\r\n";
+    httpRequest += "Connection: close\r\n";
+    httpRequest += "User-Agent: MilanoSmartPark/0.2\r\n";
+    httpRequest += "Content-Type: application/x-www-form-urlencoded\r\n";
+    httpRequest += "Content-Length: " + String(postData.length()) + "\r\n";
+    httpRequest += "\r\n";
+    httpRequest += postData;
+
+    bool sent = (sslClient->print(httpRequest) == httpRequest.length());
+    sslClient->flush();
+
+    // the status line is enough
+    unsigned long responseStart = millis();
+    while (sent && (millis() - responseStart < SERVER_RESPONSE_TIMEOUT_MS) && (status->indexOf('\r') < 0))
+    {
+        if (sslClient->available())
+        {
+            *status += (char)sslClient->read();
+        }
+        else
+        {
+            delay(10);
+        }
+    }
+    sslClient->stop();
+
+    if (!sent)
+    {
+        *status = "incomplete request";
+        return false;
+    }
+    if (status->indexOf('\r') >= 0)
+    {
+        *status = status->substring(0, status->indexOf('\r'));
+    }
+    return status->startsWith("HTTP/1.1 200") || status->startsWith("HTTP/1.1 201");
+}
+
+// Send one chunk of a raw history dump, a single attempt: a failed chunk is sent again after the next records
+static bool sendRawHistoryChunk(const sensorSample_t *samples, uint32_t count, bool last, deviceNetworkInfo_t *devInfo,
+                                systemData_t *sysData)
+{
+    String postData = "X-MSP-ID=" + devInfo->deviceid;
+    postData += "&channels=";
+    for (uint32_t ch = 0; ch < STATS_CH_MAX; ch++)
+    {
+        postData += String((ch == 0) ? "" : ",") + pcMspStats_channelName((stats_channel_t)ch);
+    }
+
+    // one sample per row: epoch, then the channels, empty when not read
+    postData += "&samples=";
+    for (uint32_t i = 0; i < count; i++)
+    {
+        postData += String((i == 0) ? "" : ";") + String(samples[i].epoch);
+        for (uint32_t ch = 0; ch < STATS_CH_MAX; ch++)
+        {
+            postData += ",";
+            if (bMspRing_hasChannel(&samples[i], (stats_channel_t)ch))
+            {
+                int8_t decimals = cMspHistory_decimals((stats_channel_t)ch);
+                postData += String(samples[i].value[ch], (decimals > 0) ? decimals : 0);
+            }
+        }
+    }
+    if (last)
+    {
+        postData += "&last=1";
+    }
+
+    String status;
+    if (!postFormOnce("/api/v1/raw", postData, devInfo, sysData, &status))
+    {
+        log_w("Raw history: chunk of %lu samples refused (%s)", (unsigned long)count, status.c_str());
+        return false;
+    }
+    log_i("Raw history: %lu samples sent, %lu..%lu", (unsigned long)count, (unsigned long)samples[0].epoch,
+          (unsigned long)samples[count - 1].epoch);
+    return true;
+}
+
+// Send the pending raw history dump, RAW_HISTORY_CHUNKS_PER_UPLOAD chunks at most so the records are not held back
+static void sendRawHistoryDump(deviceNetworkInfo_t *devInfo, systemData_t *sysData)
+{
+    static sensorSample_t chunk[RAW_HISTORY_CHUNK_SAMPLES];
+
+    for (uint32_t n = 0; n < RAW_HISTORY_CHUNKS_PER_UPLOAD; n++)
+    {
+        uint32_t from = 0;
+        uint32_t to = 0;
+        if (!bMspHistory_dumpPending(&from, &to))
+        {
+            return;
+        }
+        uint32_t count = ulMspHistory_read(from, to, chunk, RAW_HISTORY_CHUNK_SAMPLES);
+        if (count == 0)
+        {
+            // nothing left in the window, or nothing kept that old
+            vMspHistory_dumpSent(to);
+            return;
+        }
+        uint32_t last = chunk[count - 1].epoch;
+        bool isLast = (count < RAW_HISTORY_CHUNK_SAMPLES) || (last >= to);
+        if (!sendRawHistoryChunk(chunk, count, isLast, devInfo, sysData))
+        {
+            return;
+        }
+        vMspHistory_dumpSent(isLast ? to : last);
+    }
+}
+
+// Send one closed rollup, a single attempt: a failed one stays first in the queue for the next records
+static bool sendRollup(const rollupRecord_t *rollup, deviceNetworkInfo_t *devInfo, systemData_t *sysData)
+{
+    String postData = "X-MSP-ID=" + devInfo->deviceid;
+    postData += "&level=" + String(pcMspRollup_levelName((rollupLevel_t)rollup->level));
+    postData += "&start=" + String(rollup->start);
+    postData += "&seconds=" + String(rollup->seconds);
+    postData += "&samples=" + String(rollup->samples);
+    postData += "&periods=" + String(rollup->periods);
+    if (rollup->msp >= 0)
+    {
+        postData += "&msp=" + String(rollup->msp);
+    }
+    for (uint32_t ch = 0; ch < STATS_CH_MAX; ch++)
+    {
+        const rollupChannel_t *channel = &rollup->channel[ch];
+        if (channel->count == 0)
+        {
+            continue;
+        }
+        String name = pcMspStats_channelName((stats_channel_t)ch);
+        postData += "&" + name + "=" + String(channel->mean, 3);
+        postData += "&" + name + "_min=" + String(channel->min, 3);
+        postData += "&" + name + "_max=" + String(channel->max, 3);
+        postData += "&" + name + "_cov=" + String(channel->count);
+    }
+
+    String status;
+    if (!postFormOnce("/api/v1/rollups", postData, devInfo, sysData, &status))
+    {
+        log_w("Rollup: %s of %lu refused (%s)", pcMspRollup_levelName((rollupLevel_t)rollup->level), (unsigned long)rollup->start,
+              status.c_str());
+        return false;
+    }
+    log_i("Rollup: %s of %lu sent", pcMspRollup_levelName((rollupLevel_t)rollup->level), (unsigned long)rollup->start);
+    return true;
+}
+
+// Send the rollups waiting, oldest first, until one fails
+static void sendRollups(deviceNetworkInfo_t *devInfo, systemData_t *sysData)
+{
+    rollupRecord_t rollup;
+    while ((rollupQueue != NULL) && (xQueuePeek(rollupQueue, &rollup, 0) == pdPASS))
+    {
+        if (!sendRollup(&rollup, devInfo, sysData))
+        {
+            return;
+        }
+        xQueueReceive(rollupQueue, &rollup, 0);
+    }
+}
+
 // Main network task
 static void networkTask(void *pvParameters)
 {
@@ -1877,6 +2110,12 @@ static void networkTask(void *pvParameters)
             {
                 log_w("Failed to process: %d data items", failedCount);
             }
+            else if (isNetworkConnected() && networkState.timeSync && sysStatus.server_ok)
+            {
+                // The records are through, the rollups and the raw history asked for by the server can follow
+                sendRollups(&devInfo, &sysData);
+                sendRawHistoryDump(&devInfo, &sysData);
+            }
 
             int finalQueueSize = uxQueueMessagesWaiting(sendDataQueue);
             log_i("Final queue size: %d items (started with %d)", finalQueueSize, initialQueueSize);
@@ -15,6 +15,7 @@
 
 // --includes
 #include "shared_values.h"
+#include "rollup.h"
 #include "SSLClient.h"
 #include <WiFi.h>
 #include <stdbool.h>
@@ -102,6 +103,13 @@ bool enqueueSendData(const send_data_t &data, TickType_t ticksToWait);
  */
 bool dequeueSendData(send_data_t *data, TickType_t ticksToWait);
 
+/**
+ * @brief Enqueue a closed rollup for the server, sent after the records
+ * @param rollup Reference to the rollup to send
+ * @return true if the rollup was enqueued, false if the queue is full and it was dropped
+ */
+bool enqueueRollup(const rollupRecord_t &rollup);
+
 /**
  * @brief Check if server configuration is available from network task
  * @param config Pointer to store the configuration message
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * @file    o3Adc.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Background sampling of the analog O3 sensor. The readings stay
+ *          raw analogRead() points, the scale o3_zero_value is calibrated in:
+ *          analogReadMilliVolts() adds the eFuse characterisation offset, so
+ *          a pulled-down pin never reads 0 mV. The task averages each burst
+ *          and runs a first order low-pass over the bursts.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "o3Adc.h"
+#include "shared_values.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+// weight of a new burst: the discrete equivalent of O3_ADC_FILTER_TAU_MS at the burst period
+#define O3_ADC_FILTER_ALPHA ((float)O3_ADC_BURST_PERIOD_MS / (float)(O3_ADC_FILTER_TAU_MS + O3_ADC_BURST_PERIOD_MS))
+
+static o3AdcFilter_t tFilter;
+static SemaphoreHandle_t o3AdcMutex = NULL;
+static StaticSemaphore_t o3AdcMutexBuffer;
+static TaskHandle_t o3AdcTaskHandle = NULL;
+static StaticTask_t o3AdcTaskBuffer;
+static StackType_t o3AdcTaskStack[O3_ADC_TASK_STACK_SIZE];
+
+void vHalO3Adc_filterInit(o3AdcFilter_t *p_tFilter)
+{
+  memset(p_tFilter, 0, sizeof(o3AdcFilter_t));
+}
+
+bool bHalO3Adc_filterBurst(o3AdcFilter_t *p_tFilter, const uint16_t *p_usPoints, uint32_t count, uint32_t nowMs)
+{
+  uint32_t sum = 0;
+  uint32_t valid = 0;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    if (p_usPoints[i] > 0)
+    {
+      sum += p_usPoints[i];
+      valid++;
+    }
+  }
+  if (valid == 0)
+  {
+    p_tFilter->emptyBursts++;
+    return false;
+  }
+
+  float burst = (float)sum / (float)valid;
+  if (!p_tFilter->primed)
+  {
+    p_tFilter->value = burst; // start from the first burst instead of ramping up from 0
+    p_tFilter->primed = true;
+  }
+  else
+  {
+    p_tFilter->value += O3_ADC_FILTER_ALPHA * (burst - p_tFilter->value);
+  }
+  p_tFilter->lastValidMs = nowMs;
+  p_tFilter->bursts++;
+  return true;
+}
+
+/******************************************************
+ * @brief sampling task, only user of O3_ADC_PIN
+ ******************************************************/
+static void vHalO3Adc_task(void *pvParameters)
+{
+  (void)pvParameters;
+  uint16_t points[O3_ADC_BURST_SAMPLES];
+  for (;;)
+  {
+    for (uint32_t i = 0; i < O3_ADC_BURST_SAMPLES; i++)
+    {
+      points[i] = analogRead(O3_ADC_PIN);
+      pinMode(O3_ADC_PIN, INPUT_PULLDOWN); // must invoke after every analogRead, keeps a missing sensor at 0
+    }
+
+    xSemaphoreTake(o3AdcMutex, portMAX_DELAY);
+    bHalO3Adc_filterBurst(&tFilter, points, O3_ADC_BURST_SAMPLES, millis());
+    xSemaphoreGive(o3AdcMutex);
+
+    vTaskDelay(pdMS_TO_TICKS(O3_ADC_BURST_PERIOD_MS));
+  }
+}
+
+void vHalO3Adc_start(void)
+{
+  if (o3AdcTaskHandle != NULL)
+  {
+    return;
+  }
+  o3AdcMutex = xSemaphoreCreateMutexStatic(&o3AdcMutexBuffer);
+  if (o3AdcMutex == NULL)
+  {
+    log_e("Failed to create the O3 ADC mutex");
+    return;
+  }
+  vHalO3Adc_filterInit(&tFilter);
+
+  o3AdcTaskHandle = xTaskCreateStaticPinnedToCore(
+      vHalO3Adc_task,
+      "o3Adc",
+      O3_ADC_TASK_STACK_SIZE,
+      NULL,
+      O3_ADC_TASK_PRIORITY,
+      o3AdcTaskStack,
+      &o3AdcTaskBuffer,
+      1 // Core 1, with the acquisition tasks
+  );
+  if (o3AdcTaskHandle == NULL)
+  {
+    log_e("Failed to create the O3 ADC task");
+    return;
+  }
+  log_i("O3 ADC sampling task started");
+}
+
+bool bHalO3Adc_read(float *p_fPoints)
+{
+  if (o3AdcMutex == NULL)
+  {
+    return false;
+  }
+  xSemaphoreTake(o3AdcMutex, portMAX_DELAY);
+  bool fresh = tFilter.primed && ((millis() - tFilter.lastValidMs) <= O3_ADC_STALE_MS);
+  float points = tFilter.value;
+  xSemaphoreGive(o3AdcMutex);
+
+  if (!fresh)
+  {
+    return false;
+  }
+  *p_fPoints = points;
+  return true;
+}
@@ -0,0 +1,83 @@
+/******************************************************************************
+ * @file    o3Adc.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Background sampling of the analog O3 sensor: a low priority task
+ *          takes bursts of ADC readings on O3_ADC_PIN, decimates each burst
+ *          to its mean and low-pass filters the bursts, so a filtered value
+ *          is always ready for the read job.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef O3_ADC_H
+#define O3_ADC_H
+
+// -- includes --
+#include <Arduino.h>
+
+// Sampling engine configuration
+#ifndef O3_ADC_BURST_SAMPLES
+#define O3_ADC_BURST_SAMPLES 16 // readings averaged into one decimated sample
+#endif
+
+#ifndef O3_ADC_BURST_PERIOD_MS
+#define O3_ADC_BURST_PERIOD_MS 110 // 5.5 mains periods at 50 Hz, consecutive bursts see opposite hum phases
+#endif
+
+#ifndef O3_ADC_FILTER_TAU_MS
+#define O3_ADC_FILTER_TAU_MS 5000 // time constant of the low-pass on the decimated samples
+#endif
+
+#ifndef O3_ADC_STALE_MS
+#define O3_ADC_STALE_MS 2000 // no valid burst for this long: the sensor is reported missing
+#endif
+
+#ifndef O3_ADC_TASK_STACK_SIZE
+#define O3_ADC_TASK_STACK_SIZE 2048
+#endif
+
+#ifndef O3_ADC_TASK_PRIORITY
+#define O3_ADC_TASK_PRIORITY 2
+#endif
+
+typedef struct __O3_ADC_FILTER__
+{
+  float value;          /*!< filtered level, 12 bit ADC points */
+  bool primed;          /*!< value holds a sample */
+  uint32_t lastValidMs; /*!< millis() of the last burst with a reading */
+  uint32_t bursts;      /*!< bursts with at least one reading */
+  uint32_t emptyBursts; /*!< bursts where every reading was pulled down to 0 */
+} o3AdcFilter_t;
+
+/******************************************************
+ * @brief resets a filter to its empty state
+ ******************************************************/
+void vHalO3Adc_filterInit(o3AdcFilter_t *p_tFilter);
+
+/******************************************************
+ * @brief folds one burst of raw readings into the
+ *        filter; readings at 0 are the pull-down of a
+ *        disconnected sensor and are left out
+ *
+ * @return false when the burst had no reading
+ ******************************************************/
+bool bHalO3Adc_filterBurst(o3AdcFilter_t *p_tFilter, const uint16_t *p_usPoints, uint32_t count, uint32_t nowMs);
+
+/******************************************************
+ * @brief starts the sampling task
+ ******************************************************/
+void vHalO3Adc_start(void);
+
+/******************************************************
+ * @brief latest filtered level in 12 bit ADC points,
+ *        zero offset not removed
+ *
+ * @return false when no valid burst arrived in the
+ *         last O3_ADC_STALE_MS
+ ******************************************************/
+bool bHalO3Adc_read(float *p_fPoints);
+
+#endif
@@ -0,0 +1,234 @@
+/******************************************************************************
+ * @file    pmsStream.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Streaming PMS5003 reader. The UART driver fills its RX ring
+ *          buffer from the interrupt; the stream task wakes every
+ *          PMS_RX_POLL_MS, parses whatever arrived and folds the valid
+ *          frames into the current window under a short lock.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "pmsStream.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+
+#define PMS_START_1 0x42
+#define PMS_START_2 0x4D
+#define PMS_HEADER_LEN 4
+#define PMS_CHECKSUM_LEN 2
+#define PMS5003_DATA_LEN (2 * 13 + 2) /*!< length word of a PMS5003 frame */
+#define PMS3003_DATA_LEN (2 * 9 + 2)  /*!< length word of the older PMS3003/PMS5003 frames */
+#define PMS_AE_PM1_OFFSET 10          /*!< atmospheric environment words, after the CF=1 ones */
+
+static HardwareSerial *p_tPmsSerial = NULL;
+static pmsParser_t tParser;
+static pmsWindow_t tWindow;
+static volatile bool bFlushRequested = false;
+
+static SemaphoreHandle_t pmsWindowMutex = NULL;
+static StaticSemaphore_t pmsWindowMutexBuffer;
+static TaskHandle_t pmsTaskHandle = NULL;
+static StaticTask_t pmsTaskBuffer;
+static StackType_t pmsTaskStack[PMS_TASK_STACK_SIZE];
+
+/******************************************************
+ * @brief clears the window, the latest frame is kept
+ ******************************************************/
+static void vHalPms_clearWindow(void)
+{
+  pmsFrame_t latest = tWindow.latest;
+  memset(&tWindow, 0, sizeof(tWindow));
+  tWindow.latest = latest;
+}
+
+bool bHalPms_parse(pmsParser_t *p_tParser, uint8_t byte, pmsFrame_t *p_tFrame, bool *p_bValid)
+{
+  switch (p_tParser->index)
+  {
+  case 0:
+    if (byte != PMS_START_1)
+    {
+      return false;
+    }
+    break;
+  case 1:
+    if (byte != PMS_START_2)
+    {
+      // the byte may start the next frame
+      p_tParser->index = (byte == PMS_START_1) ? 1 : 0;
+      return false;
+    }
+    break;
+  case 3:
+  {
+    uint16_t dataLen = (uint16_t)((p_tParser->frame[2] << 8) | byte);
+    if ((dataLen != PMS5003_DATA_LEN) && (dataLen != PMS3003_DATA_LEN))
+    {
+      p_tParser->index = 0; // unsupported sensor or line noise, resync on the next start byte
+      return false;
+    }
+    p_tParser->frameLen = (uint8_t)(PMS_HEADER_LEN + dataLen);
+    break;
+  }
+  default:
+    break;
+  }
+
+  p_tParser->frame[p_tParser->index++] = byte;
+  if ((p_tParser->index < PMS_HEADER_LEN) || (p_tParser->index < p_tParser->frameLen))
+  {
+    return false;
+  }
+
+  // whole frame received
+  uint8_t *frame = p_tParser->frame;
+  uint8_t checksumAt = (uint8_t)(p_tParser->frameLen - PMS_CHECKSUM_LEN);
+  uint16_t checksum = 0;
+  for (uint8_t i = 0; i < checksumAt; i++)
+  {
+    checksum += frame[i];
+  }
+  *p_bValid = (checksum == (uint16_t)((frame[checksumAt] << 8) | frame[checksumAt + 1]));
+  if (*p_bValid)
+  {
+    p_tFrame->pm1 = (uint16_t)((frame[PMS_AE_PM1_OFFSET] << 8) | frame[PMS_AE_PM1_OFFSET + 1]);
+    p_tFrame->pm25 = (uint16_t)((frame[PMS_AE_PM1_OFFSET + 2] << 8) | frame[PMS_AE_PM1_OFFSET + 3]);
+    p_tFrame->pm10 = (uint16_t)((frame[PMS_AE_PM1_OFFSET + 4] << 8) | frame[PMS_AE_PM1_OFFSET + 5]);
+    p_tFrame->rxMs = millis();
+  }
+  p_tParser->index = 0;
+  p_tParser->frameLen = 0;
+  return true;
+}
+
+/******************************************************
+ * @brief folds a parsed frame into the window
+ ******************************************************/
+static void vHalPms_addFrame(const pmsFrame_t *p_tFrame, bool valid)
+{
+  xSemaphoreTake(pmsWindowMutex, portMAX_DELAY);
+  if (!valid)
+  {
+    tWindow.checksumErrors++;
+  }
+  else
+  {
+    if ((tWindow.frames == 0) || (p_tFrame->pm25 < tWindow.pm25Min))
+    {
+      tWindow.pm25Min = p_tFrame->pm25;
+    }
+    if (p_tFrame->pm25 > tWindow.pm25Max)
+    {
+      tWindow.pm25Max = p_tFrame->pm25;
+    }
+    tWindow.frames++;
+    tWindow.pm1Sum += p_tFrame->pm1;
+    tWindow.pm25Sum += p_tFrame->pm25;
+    tWindow.pm10Sum += p_tFrame->pm10;
+    tWindow.latest = *p_tFrame;
+  }
+  xSemaphoreGive(pmsWindowMutex);
+}
+
+/******************************************************
+ * @brief stream task, only reader of the sensor UART
+ ******************************************************/
+static void vHalPms_streamTask(void *pvParameters)
+{
+  (void)pvParameters;
+  for (;;)
+  {
+    if (bFlushRequested)
+    {
+      bFlushRequested = false;
+      tParser.index = 0;
+      tParser.frameLen = 0;
+      for (int pending = p_tPmsSerial->available(); pending > 0; pending--)
+      {
+        p_tPmsSerial->read();
+      }
+    }
+
+    for (int pending = p_tPmsSerial->available(); pending > 0; pending--)
+    {
+      int byte = p_tPmsSerial->read();
+      if (byte < 0)
+      {
+        break;
+      }
+      pmsFrame_t frame;
+      bool valid = false;
+      if (bHalPms_parse(&tParser, (uint8_t)byte, &frame, &valid))
+      {
+        vHalPms_addFrame(&frame, valid);
+      }
+    }
+    vTaskDelay(pdMS_TO_TICKS(PMS_RX_POLL_MS));
+  }
+}
+
+void vHalPms_startStream(HardwareSerial *p_tSerial)
+{
+  if (pmsTaskHandle != NULL)
+  {
+    return;
+  }
+  pmsWindowMutex = xSemaphoreCreateMutexStatic(&pmsWindowMutexBuffer);
+  if (pmsWindowMutex == NULL)
+  {
+    log_e("Failed to create the PMS5003 window mutex");
+    return;
+  }
+  p_tPmsSerial = p_tSerial;
+  memset(&tParser, 0, sizeof(tParser));
+  memset(&tWindow, 0, sizeof(tWindow));
+  bFlushRequested = true; // bytes left over by the detection read
+
+  pmsTaskHandle = xTaskCreateStaticPinnedToCore(
+      vHalPms_streamTask,
+      "pmsStream",
+      PMS_TASK_STACK_SIZE,
+      NULL,
+      PMS_TASK_PRIORITY,
+      pmsTaskStack,
+      &pmsTaskBuffer,
+      1 // Core 1, with the acquisition tasks
+  );
+  if (pmsTaskHandle == NULL)
+  {
+    log_e("Failed to create the PMS5003 stream task");
+    return;
+  }
+  log_i("PMS5003 stream task started");
+}
+
+bool bHalPms_takeWindow(pmsWindow_t *p_tWindow)
+{
+  if (pmsWindowMutex == NULL)
+  {
+    memset(p_tWindow, 0, sizeof(pmsWindow_t));
+    return false;
+  }
+  xSemaphoreTake(pmsWindowMutex, portMAX_DELAY);
+  *p_tWindow = tWindow;
+  vHalPms_clearWindow();
+  xSemaphoreGive(pmsWindowMutex);
+  return p_tWindow->frames > 0;
+}
+
+void vHalPms_flush(void)
+{
+  if (pmsWindowMutex == NULL)
+  {
+    return;
+  }
+  xSemaphoreTake(pmsWindowMutex, portMAX_DELAY);
+  vHalPms_clearWindow();
+  bFlushRequested = true;
+  xSemaphoreGive(pmsWindowMutex);
+}
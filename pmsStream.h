@@ -0,0 +1,99 @@
+/******************************************************************************
+ * @file    pmsStream.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Streaming PMS5003 reader: a background task drains the UART RX
+ *          ring buffer (filled by the UART driver interrupt) into an
+ *          incremental frame parser, so the latest valid frame and the
+ *          statistics of every frame since the previous sample are always
+ *          ready without waiting for the sensor.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef PMS_STREAM_H
+#define PMS_STREAM_H
+
+// -- includes --
+#include <Arduino.h>
+#include "freertos/FreeRTOS.h"
+
+#define PMS_FRAME_MAX_LEN 32 /*!< PMS5003 frame: start word, length, 13 data words, checksum */
+
+// Stream task configuration
+#ifndef PMS_RX_BUFFER_SIZE
+#define PMS_RX_BUFFER_SIZE 1024 // UART driver ring buffer, ~30 frames
+#endif
+
+#ifndef PMS_RX_POLL_MS
+#define PMS_RX_POLL_MS 250 // a quarter of the frame period, far from filling the ring buffer
+#endif
+
+#ifndef PMS_TASK_STACK_SIZE
+#define PMS_TASK_STACK_SIZE 2048
+#endif
+
+#ifndef PMS_TASK_PRIORITY
+#define PMS_TASK_PRIORITY 2
+#endif
+
+typedef struct __PMS_FRAME__
+{
+  uint16_t pm1;   /*!< PM1.0 atmospheric environment, ug/m3 */
+  uint16_t pm25;  /*!< PM2.5 atmospheric environment, ug/m3 */
+  uint16_t pm10;  /*!< PM10 atmospheric environment, ug/m3 */
+  uint32_t rxMs;  /*!< millis() when the frame was parsed */
+} pmsFrame_t;
+
+typedef struct __PMS_WINDOW__
+{
+  uint32_t frames;          /*!< valid frames in the window */
+  uint32_t checksumErrors;  /*!< frames dropped for a bad checksum */
+  uint32_t pm1Sum;
+  uint32_t pm25Sum;
+  uint32_t pm10Sum;
+  uint16_t pm25Min;
+  uint16_t pm25Max;
+  pmsFrame_t latest;        /*!< last valid frame, also from earlier windows */
+} pmsWindow_t;
+
+typedef struct __PMS_PARSER__
+{
+  uint8_t frame[PMS_FRAME_MAX_LEN];
+  uint8_t index;      /*!< bytes of the current frame received so far */
+  uint8_t frameLen;   /*!< total length of the current frame, from its length word */
+} pmsParser_t;
+
+/******************************************************
+ * @brief feeds one byte to the frame parser
+ *
+ * @return true when the byte completes a frame, with
+ *         *p_bValid telling whether its checksum
+ *         matched and *p_tFrame filled if so
+ ******************************************************/
+bool bHalPms_parse(pmsParser_t *p_tParser, uint8_t byte, pmsFrame_t *p_tFrame, bool *p_bValid);
+
+/******************************************************
+ * @brief starts the stream task on the sensor UART,
+ *        call after the UART has been set up
+ ******************************************************/
+void vHalPms_startStream(HardwareSerial *p_tSerial);
+
+/******************************************************
+ * @brief statistics of the frames since the previous
+ *        call, the window restarts empty
+ *
+ * @return false when no valid frame arrived since the
+ *         previous call
+ ******************************************************/
+bool bHalPms_takeWindow(pmsWindow_t *p_tWindow);
+
+/******************************************************
+ * @brief drops the bytes and the frames received so
+ *        far, e.g. while the sensor wakes up
+ ******************************************************/
+void vHalPms_flush(void);
+
+#endif
@@ -0,0 +1,253 @@
+/******************************************************************************
+ * @file    rawHistory.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Raw sample history. The loop task adds the samples, the network
+ *          task reads the dumps, both under a mutex held for one record or
+ *          one chunk. The records are in time order, a clock stepping back
+ *          restarts the history.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "rawHistory.h"
+#include "freertos/semphr.h"
+
+#define RAW_HISTORY_SEC_IN_HOUR 3600UL
+
+static rawHistoryRecord_t *p_tRecords = NULL; /*!< PSRAM */
+static uint32_t ulCapacity;
+static uint32_t ulHead;  /*!< slot of the next record */
+static uint32_t ulCount;
+static uint32_t ulSaturated; /*!< readings out of the fixed point range, kept at its end */
+static SemaphoreHandle_t historyMutex = NULL;
+static StaticSemaphore_t historyMutexBuffer;
+
+static bool bDumpPending;
+static uint32_t ulDumpFrom; /*!< first epoch not sent yet */
+static uint32_t ulDumpTo;
+
+// decimals of each channel, stats_channel_t order: C, %, hPa, kOhm, then ug/m3
+static const int8_t cDecimals[STATS_CH_MAX] = {2, 2, 1, 1, -1, 1, 1, 0, 0, 0, 1};
+static const float fScale[STATS_CH_MAX] = {100.0f, 100.0f, 10.0f, 10.0f, 0.1f, 10.0f, 10.0f, 1.0f, 1.0f, 1.0f, 10.0f};
+
+/******************************************************
+ * @brief slot of the i-th record, oldest first
+ ******************************************************/
+static uint32_t ulMspHistory_slot(uint32_t index)
+{
+  return (ulHead + ulCapacity - ulCount + index) % ulCapacity;
+}
+
+/******************************************************
+ * @brief index of the oldest record at or after epoch,
+ *        ulCount when there is none
+ ******************************************************/
+static uint32_t ulMspHistory_find(uint32_t epoch)
+{
+  uint32_t low = 0;
+  uint32_t high = ulCount;
+  while (low < high)
+  {
+    uint32_t mid = low + ((high - low) / 2U);
+    if (p_tRecords[ulMspHistory_slot(mid)].epoch < epoch)
+    {
+      low = mid + 1U;
+    }
+    else
+    {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/******************************************************
+ * @brief unsigned number after "key": in a JSON body
+ ******************************************************/
+static bool bMspHistory_findNumber(const char *p_cBody, const char *key, uint32_t *p_ulValue)
+{
+  char quoted[32];
+  snprintf(quoted, sizeof(quoted), "\"%s\"", key);
+  const char *p_cAt = strstr(p_cBody, quoted);
+  if (p_cAt == NULL)
+  {
+    return false;
+  }
+  p_cAt += strlen(quoted);
+  while ((*p_cAt == ' ') || (*p_cAt == ':'))
+  {
+    p_cAt++;
+  }
+  char *p_cEnd = NULL;
+  unsigned long value = strtoul(p_cAt, &p_cEnd, 10);
+  if (p_cEnd == p_cAt)
+  {
+    return false;
+  }
+  *p_ulValue = (uint32_t)value;
+  return true;
+}
+
+bool bMspHistory_init(uint32_t samplingPeriodS)
+{
+  if (p_tRecords != NULL)
+  {
+    return true;
+  }
+  historyMutex = xSemaphoreCreateMutexStatic(&historyMutexBuffer);
+  ulCapacity = (RAW_HISTORY_HOURS * RAW_HISTORY_SEC_IN_HOUR) / ((samplingPeriodS > 0) ? samplingPeriodS : 1U);
+  p_tRecords = (rawHistoryRecord_t *)heap_caps_malloc(ulCapacity * sizeof(rawHistoryRecord_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (p_tRecords == NULL)
+  {
+    log_w("Raw history: no PSRAM for %lu samples, not kept", (unsigned long)ulCapacity);
+    ulCapacity = 0;
+    return false;
+  }
+  ulHead = 0;
+  ulCount = 0;
+  log_i("Raw history: %lu samples (%u h at %lu s) in PSRAM, %lu bytes", (unsigned long)ulCapacity, RAW_HISTORY_HOURS,
+        (unsigned long)samplingPeriodS, (unsigned long)(ulCapacity * sizeof(rawHistoryRecord_t)));
+  return true;
+}
+
+void vMspHistory_add(const sensorSample_t *p_tSample)
+{
+  if (p_tRecords == NULL)
+  {
+    return;
+  }
+
+  rawHistoryRecord_t record;
+  record.epoch = p_tSample->epoch;
+  record.valid = p_tSample->valid;
+  for (int i = 0; i < STATS_CH_MAX; i++)
+  {
+    float scaled = bMspRing_hasChannel(p_tSample, (stats_channel_t)i) ? roundf(p_tSample->value[i] * fScale[i]) : 0.0f;
+    if ((scaled > (float)INT16_MAX) || (scaled < (float)INT16_MIN))
+    {
+      scaled = (scaled > 0.0f) ? (float)INT16_MAX : (float)INT16_MIN;
+      ulSaturated++;
+    }
+    record.value[i] = (int16_t)scaled;
+  }
+
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  if ((ulCount > 0) && (record.epoch <= p_tRecords[ulMspHistory_slot(ulCount - 1U)].epoch))
+  {
+    log_w("Raw history: clock went back to %lu, history restarted", (unsigned long)record.epoch);
+    ulCount = 0;
+  }
+  p_tRecords[ulHead] = record;
+  ulHead = (ulHead + 1U) % ulCapacity;
+  if (ulCount < ulCapacity)
+  {
+    ulCount++;
+  }
+  xSemaphoreGive(historyMutex);
+}
+
+bool bMspHistory_parseRequest(const char *p_cBody)
+{
+  uint32_t from = 0;
+  if ((p_tRecords == NULL) || !bMspHistory_findNumber(p_cBody, RAW_HISTORY_DUMP_FROM_KEY, &from))
+  {
+    return false;
+  }
+  uint32_t to = UINT32_MAX;
+  bMspHistory_findNumber(p_cBody, RAW_HISTORY_DUMP_TO_KEY, &to);
+  if (to < from)
+  {
+    log_w("Raw history: dump request %lu..%lu ignored", (unsigned long)from, (unsigned long)to);
+    return false;
+  }
+
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  // without an end the window stops at the newest sample, the dump does not chase the new ones
+  if ((to == UINT32_MAX) && (ulCount > 0))
+  {
+    to = p_tRecords[ulMspHistory_slot(ulCount - 1U)].epoch;
+  }
+  uint32_t oldest = (ulCount > 0) ? p_tRecords[ulMspHistory_slot(0)].epoch : 0;
+  bDumpPending = true;
+  ulDumpFrom = from;
+  ulDumpTo = to;
+  xSemaphoreGive(historyMutex);
+
+  if (from < oldest)
+  {
+    log_w("Raw history: dump asked from %lu, history starts at %lu", (unsigned long)from, (unsigned long)oldest);
+  }
+  log_i("Raw history: dump of %lu..%lu requested", (unsigned long)from, (unsigned long)to);
+  return true;
+}
+
+bool bMspHistory_dumpPending(uint32_t *p_ulFrom, uint32_t *p_ulTo)
+{
+  if (historyMutex == NULL)
+  {
+    return false;
+  }
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  bool pending = bDumpPending;
+  *p_ulFrom = ulDumpFrom;
+  *p_ulTo = ulDumpTo;
+  xSemaphoreGive(historyMutex);
+  return pending;
+}
+
+uint32_t ulMspHistory_read(uint32_t from, uint32_t to, sensorSample_t *p_tOut, uint32_t max)
+{
+  if (p_tRecords == NULL)
+  {
+    return 0;
+  }
+
+  uint32_t copied = 0;
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  for (uint32_t i = ulMspHistory_find(from); (i < ulCount) && (copied < max); i++)
+  {
+    const rawHistoryRecord_t *p_tRecord = &p_tRecords[ulMspHistory_slot(i)];
+    if (p_tRecord->epoch > to)
+    {
+      break;
+    }
+    sensorSample_t *p_tSample = &p_tOut[copied++];
+    memset(p_tSample, 0, sizeof(*p_tSample));
+    p_tSample->epoch = p_tRecord->epoch;
+    p_tSample->valid = p_tRecord->valid;
+    for (int ch = 0; ch < STATS_CH_MAX; ch++)
+    {
+      p_tSample->value[ch] = (float)p_tRecord->value[ch] / fScale[ch];
+    }
+  }
+  xSemaphoreGive(historyMutex);
+  return copied;
+}
+
+void vMspHistory_dumpSent(uint32_t epoch)
+{
+  xSemaphoreTake(historyMutex, portMAX_DELAY);
+  bool done = (epoch >= ulDumpTo);
+  if (done)
+  {
+    bDumpPending = false;
+  }
+  else
+  {
+    ulDumpFrom = epoch + 1U;
+  }
+  xSemaphoreGive(historyMutex);
+  if (done)
+  {
+    log_i("Raw history: dump complete%s", (ulSaturated > 0) ? ", some readings saturated" : "");
+  }
+}
+
+int8_t cMspHistory_decimals(stats_channel_t channel)
+{
+  return cDecimals[channel];
+}
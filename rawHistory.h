@@ -0,0 +1,96 @@
+/******************************************************************************
+ * @file    rawHistory.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Raw sample history: every sample of the last RAW_HISTORY_HOURS,
+ *          in fixed point, in a ring allocated from the PSRAM of the WROVER.
+ *          The server asks for a time window in the response to an upload
+ *          ("raw_dump_from" / "raw_dump_to", epoch seconds) and the network
+ *          task sends it a chunk at a time after the records.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef RAW_HISTORY_H
+#define RAW_HISTORY_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+#include "sampleRing.h"
+
+#ifndef RAW_HISTORY_HOURS
+#define RAW_HISTORY_HOURS 24 // samples kept, at the sampling period configured at boot
+#endif
+
+#ifndef RAW_HISTORY_CHUNK_SAMPLES
+#define RAW_HISTORY_CHUNK_SAMPLES 60 // samples in one upload of a dump
+#endif
+
+#ifndef RAW_HISTORY_CHUNKS_PER_UPLOAD
+#define RAW_HISTORY_CHUNKS_PER_UPLOAD 8 // chunks sent after the records of an interval, the rest goes with the next
+#endif
+
+#define RAW_HISTORY_DUMP_FROM_KEY "raw_dump_from"
+#define RAW_HISTORY_DUMP_TO_KEY "raw_dump_to"
+
+// one sample in the ring, 28 bytes
+typedef struct __RAW_HISTORY_RECORD__
+{
+  uint32_t epoch;                /*!< start of the sampling period, seconds */
+  uint16_t valid;                /*!< bit (1 << stats_channel_t) of the channels read */
+  int16_t value[STATS_CH_MAX];   /*!< reading times 10^decimals of the channel, saturated */
+} rawHistoryRecord_t;
+
+/******************************************************
+ * @brief allocates the ring for the sampling period,
+ *        from the PSRAM
+ *
+ * @return false without the memory, nothing is kept
+ ******************************************************/
+bool bMspHistory_init(uint32_t samplingPeriodS);
+
+/******************************************************
+ * @brief loop task: keeps a complete sample, the oldest
+ *        one goes once the ring is full
+ ******************************************************/
+void vMspHistory_add(const sensorSample_t *p_tSample);
+
+/******************************************************
+ * @brief network task: takes the dump request out of
+ *        the body of a server response, if any; a new
+ *        request replaces the pending one
+ *
+ * @return true when the body asked for a dump
+ ******************************************************/
+bool bMspHistory_parseRequest(const char *p_cBody);
+
+/******************************************************
+ * @brief a dump is pending; its window, the part not
+ *        sent yet
+ ******************************************************/
+bool bMspHistory_dumpPending(uint32_t *p_ulFrom, uint32_t *p_ulTo);
+
+/******************************************************
+ * @brief the samples of the window, oldest first, as
+ *        kept (fixed point decoded)
+ *
+ * @return samples copied out, up to max
+ ******************************************************/
+uint32_t ulMspHistory_read(uint32_t from, uint32_t to, sensorSample_t *p_tOut, uint32_t max);
+
+/******************************************************
+ * @brief the dump went up to epoch (included); it is
+ *        over once past the end of its window
+ ******************************************************/
+void vMspHistory_dumpSent(uint32_t epoch);
+
+/******************************************************
+ * @brief decimals kept for a channel, negative for the
+ *        tens
+ ******************************************************/
+int8_t cMspHistory_decimals(stats_channel_t channel);
+
+#endif
@@ -0,0 +1,167 @@
+/******************************************************************************
+ * @file    rollup.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Multi-resolution rollups. Each level keeps the streaming
+ *          statistics of channelStats.cpp for the period it is in, fed by
+ *          the loop task as it aggregates each sample, so no lock is
+ *          taken.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "rollup.h"
+#include "channelStats.h"
+
+typedef struct
+{
+  bool kept;      /*!< longer than the sampling period */
+  uint32_t start; /*!< boundary of the current period, 0 = no sample yet */
+  uint16_t samples;
+  channelStats_t stats[STATS_CH_MAX];
+} rollupState_t;
+
+static const uint32_t ulLevelSeconds[ROLLUP_LEVEL_MAX] = {60UL, 3600UL, 86400UL};
+static const char *const pcLevelNames[ROLLUP_LEVEL_MAX] = {"minute", "hour", "day"};
+
+static rollupState_t tLevels[ROLLUP_LEVEL_MAX];
+static uint32_t ulPeriodS;
+
+/******************************************************
+ * @brief local time boundary of the period of a level
+ *        the epoch falls in
+ ******************************************************/
+static uint32_t ulMspRollup_boundary(uint32_t epoch, uint32_t seconds)
+{
+  time_t now = (time_t)epoch;
+  struct tm local;
+  localtime_r(&now, &local);
+  uint32_t secondOfDay = ((uint32_t)local.tm_hour * 3600UL) + ((uint32_t)local.tm_min * 60UL) + (uint32_t)local.tm_sec;
+  return epoch - (secondOfDay % seconds);
+}
+
+/******************************************************
+ * @brief the record of the period a level is in
+ ******************************************************/
+static void vMspRollup_close(rollupLevel_t level, rollupRecord_t *p_tRecord)
+{
+  const rollupState_t *p_tState = &tLevels[level];
+  memset(p_tRecord, 0, sizeof(*p_tRecord));
+  p_tRecord->start = p_tState->start;
+  p_tRecord->seconds = ulLevelSeconds[level];
+  p_tRecord->level = (uint8_t)level;
+  p_tRecord->msp = -1;
+  p_tRecord->samples = p_tState->samples;
+  p_tRecord->periods = (uint16_t)(ulLevelSeconds[level] / ulPeriodS);
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
+  {
+    const channelStats_t *p_tStats = &p_tState->stats[ch];
+    rollupChannel_t *p_tChannel = &p_tRecord->channel[ch];
+    p_tChannel->count = (uint16_t)p_tStats->count;
+    if (p_tStats->count > 0)
+    {
+      p_tChannel->mean = fMspStats_timeWeightedMean(p_tStats);
+      p_tChannel->min = p_tStats->min;
+      p_tChannel->max = p_tStats->max;
+    }
+  }
+}
+
+void vMspRollup_init(uint32_t samplingPeriodS)
+{
+  memset(tLevels, 0, sizeof(tLevels));
+  ulPeriodS = (samplingPeriodS > 0) ? samplingPeriodS : 1U;
+  for (int level = 0; level < ROLLUP_LEVEL_MAX; level++)
+  {
+    tLevels[level].kept = (ulLevelSeconds[level] > ulPeriodS);
+  }
+}
+
+uint32_t ulMspRollup_add(const sensorSample_t *p_tSample, rollupRecord_t *p_tClosed)
+{
+  uint32_t closed = 0;
+  for (int level = 0; level < ROLLUP_LEVEL_MAX; level++)
+  {
+    rollupState_t *p_tState = &tLevels[level];
+    if (!p_tState->kept)
+    {
+      continue;
+    }
+
+    uint32_t start = ulMspRollup_boundary(p_tSample->epoch, ulLevelSeconds[level]);
+    if (start != p_tState->start)
+    {
+      // past the boundary (or the clock stepped back): the period is over
+      if (p_tState->samples > 0)
+      {
+        vMspRollup_close((rollupLevel_t)level, &p_tClosed[closed++]);
+      }
+      p_tState->start = start;
+      p_tState->samples = 0;
+      vMspStats_resetAll(p_tState->stats);
+    }
+
+    if (p_tState->samples < UINT16_MAX)
+    {
+      p_tState->samples++;
+    }
+    for (int ch = 0; ch < STATS_CH_MAX; ch++)
+    {
+      if (bMspRing_hasChannel(p_tSample, (stats_channel_t)ch))
+      {
+        vMspStats_addTimed(&p_tState->stats[ch], p_tSample->value[ch], p_tSample->epoch, ulPeriodS);
+      }
+    }
+  }
+  return closed;
+}
+
+const char *pcMspRollup_levelName(rollupLevel_t level)
+{
+  return (level < ROLLUP_LEVEL_MAX) ? pcLevelNames[level] : "?";
+}
+
+uint32_t ulMspRollup_formatCsv(const rollupRecord_t *p_tRecord, char *p_cLine, uint32_t len)
+{
+  time_t start = (time_t)p_tRecord->start;
+  struct tm local;
+  localtime_r(&start, &local);
+  int written = snprintf(p_cLine, len, "%04d-%02d-%02dT%02d:%02d;%s;%u;%u;", local.tm_year + 1900, local.tm_mon + 1, local.tm_mday,
+                         local.tm_hour, local.tm_min, pcMspRollup_levelName((rollupLevel_t)p_tRecord->level), p_tRecord->samples,
+                         p_tRecord->periods);
+  if (p_tRecord->msp >= 0)
+  {
+    written += snprintf(p_cLine + written, (written < (int)len) ? (len - written) : 0, "%d", p_tRecord->msp);
+  }
+
+  // a channel not read leaves its three fields empty
+  for (int ch = 0; (ch < STATS_CH_MAX) && (written < (int)len); ch++)
+  {
+    const rollupChannel_t *p_tChannel = &p_tRecord->channel[ch];
+    if (p_tChannel->count == 0)
+    {
+      written += snprintf(p_cLine + written, len - written, ";;;");
+    }
+    else
+    {
+      written += snprintf(p_cLine + written, len - written, ";%.3f;%.3f;%.3f", p_tChannel->mean, p_tChannel->min, p_tChannel->max);
+    }
+  }
+  if (written < 0)
+  {
+    return 0;
+  }
+
+  uint32_t length = ((uint32_t)written < len) ? (uint32_t)written : (len - 1U);
+  for (uint32_t i = 0; i < length; i++)
+  {
+    if (p_cLine[i] == '.')
+    {
+      p_cLine[i] = ',';
+    }
+  }
+  return length;
+}
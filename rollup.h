@@ -0,0 +1,107 @@
+/******************************************************************************
+ * @file    rollup.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Multi-resolution rollups: every sample also feeds a minute, an
+ *          hour and a day aggregate of each channel, all kept at the same
+ *          time in constant memory. Each level is closed on its own local
+ *          time boundary, by the first sample past it, and goes to the SD
+ *          card and the server as ROLLUP_SD_LEVELS / ROLLUP_UPLOAD_LEVELS
+ *          say. The transmission interval level is the record itself.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef ROLLUP_H
+#define ROLLUP_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+#include "sampleRing.h"
+
+typedef enum __ROLLUP_LEVEL__
+{
+  ROLLUP_MINUTE = 0,
+  ROLLUP_HOUR,
+  ROLLUP_DAY,
+  ROLLUP_LEVEL_MAX
+} rollupLevel_t;
+
+#define ROLLUP_LEVEL_BIT(level) (1U << (level))
+
+#ifndef ROLLUP_SD_LEVELS
+#define ROLLUP_SD_LEVELS (ROLLUP_LEVEL_BIT(ROLLUP_MINUTE) | ROLLUP_LEVEL_BIT(ROLLUP_HOUR) | ROLLUP_LEVEL_BIT(ROLLUP_DAY))
+#endif
+
+#ifndef ROLLUP_UPLOAD_LEVELS
+#define ROLLUP_UPLOAD_LEVELS (ROLLUP_LEVEL_BIT(ROLLUP_HOUR) | ROLLUP_LEVEL_BIT(ROLLUP_DAY))
+#endif
+
+#ifndef ROLLUP_QUEUE_LENGTH
+#define ROLLUP_QUEUE_LENGTH 26 // rollups waiting for the server, a day of hourly ones and the daily one
+#endif
+
+#define ROLLUP_MIN_RATED_SECONDS 3600UL // the MSP# index is defined on hourly means and longer
+
+// /YYYY/MM/rollup.csv, one line per rollup of any level
+#define ROLLUP_CSV_HEADER                                                                                          \
+  "start;level;samples;periods;msp;"                                                                               \
+  "temp;temp_min;temp_max;hum;hum_min;hum_max;pre;pre_min;pre_max;voc;voc_min;voc_max;cox;cox_min;cox_max;"        \
+  "nox;nox_min;nox_max;nh3;nh3_min;nh3_max;pm1;pm1_min;pm1_max;pm25;pm25_min;pm25_max;pm10;pm10_min;pm10_max;"     \
+  "o3;o3_min;o3_max"
+#define ROLLUP_CSV_LINE_LEN 512
+
+typedef struct __ROLLUP_CHANNEL__
+{
+  uint16_t count; /*!< sampling periods with a reading, 0 = not read */
+  float mean;     /*!< time-weighted, as the records */
+  float min;
+  float max;
+} rollupChannel_t;
+
+typedef struct __ROLLUP_RECORD__
+{
+  uint32_t start;   /*!< epoch of the local time boundary the rollup starts on */
+  uint32_t seconds; /*!< length of the level */
+  uint8_t level;    /*!< rollupLevel_t */
+  int8_t msp;       /*!< MSP# index of the means, -1 below ROLLUP_MIN_RATED_SECONDS */
+  uint16_t samples; /*!< samples taken */
+  uint16_t periods; /*!< sampling periods in the level */
+  rollupChannel_t channel[STATS_CH_MAX];
+} rollupRecord_t;
+
+/******************************************************
+ * @brief empties every level; a level not longer than
+ *        the sampling period would only copy the
+ *        samples and is not kept
+ ******************************************************/
+void vMspRollup_init(uint32_t samplingPeriodS);
+
+/******************************************************
+ * @brief adds a sample to every level; the levels it
+ *        starts a new period of are closed first
+ *
+ * @param p_tClosed ROLLUP_LEVEL_MAX records, filled
+ *                  with the closed levels, shortest
+ *                  first
+ * @return number of closed levels
+ ******************************************************/
+uint32_t ulMspRollup_add(const sensorSample_t *p_tSample, rollupRecord_t *p_tClosed);
+
+/******************************************************
+ * @brief name of a level, in the log and the uploads
+ ******************************************************/
+const char *pcMspRollup_levelName(rollupLevel_t level);
+
+/******************************************************
+ * @brief a ROLLUP_CSV_HEADER line for a rollup, start
+ *        in local time, decimal commas as the records
+ *
+ * @return characters written
+ ******************************************************/
+uint32_t ulMspRollup_formatCsv(const rollupRecord_t *p_tRecord, char *p_cLine, uint32_t len);
+
+#endif
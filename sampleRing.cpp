@@ -0,0 +1,104 @@
+/******************************************************************************
+ * @file    sampleRing.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Single producer / single consumer sample ring. Each index has a
+ *          single writer; the release store of the head publishes the slot
+ *          the producer just filled, the release store of the tail hands the
+ *          slot the consumer just copied back to the producer.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "sampleRing.h"
+#include "channelTable.h"
+
+#define SAMPLE_RING_MASK (SAMPLE_RING_LEN - 1U)
+
+void vMspRing_init(sampleRing_t *p_tRing)
+{
+  memset(p_tRing, 0, sizeof(*p_tRing));
+}
+
+bool bMspRing_push(sampleRing_t *p_tRing, const sensorSample_t *p_tSample)
+{
+  uint32_t head = p_tRing->head;
+  uint32_t tail = __atomic_load_n(&p_tRing->tail, __ATOMIC_ACQUIRE);
+  if ((head - tail) >= SAMPLE_RING_LEN)
+  {
+    p_tRing->dropped++;
+    return false;
+  }
+  p_tRing->slot[head & SAMPLE_RING_MASK] = *p_tSample;
+  __atomic_store_n(&p_tRing->head, head + 1U, __ATOMIC_RELEASE);
+  return true;
+}
+
+bool bMspRing_pop(sampleRing_t *p_tRing, sensorSample_t *p_tSample)
+{
+  uint32_t tail = p_tRing->tail;
+  uint32_t head = __atomic_load_n(&p_tRing->head, __ATOMIC_ACQUIRE);
+  if (head == tail)
+  {
+    return false;
+  }
+  *p_tSample = p_tRing->slot[tail & SAMPLE_RING_MASK];
+  __atomic_store_n(&p_tRing->tail, tail + 1U, __ATOMIC_RELEASE);
+  return true;
+}
+
+void vMspRing_setChannel(sensorSample_t *p_tSample, stats_channel_t channel, float value)
+{
+  p_tSample->value[channel] = value;
+  p_tSample->valid |= (uint16_t)(1U << channel);
+}
+
+bool bMspRing_hasChannel(const sensorSample_t *p_tSample, stats_channel_t channel)
+{
+  return (p_tSample->valid & (1U << channel)) != 0;
+}
+
+void vMspRing_mergeChannels(sensorSample_t *p_tSample, const sensorSample_t *p_tFrom)
+{
+  for (int i = 0; i < STATS_CH_MAX; i++)
+  {
+    if (bMspRing_hasChannel(p_tFrom, (stats_channel_t)i))
+    {
+      vMspRing_setChannel(p_tSample, (stats_channel_t)i, p_tFrom->value[i]);
+    }
+  }
+}
+
+void vMspRing_addToSums(const sensorSample_t *p_tSample, uint16_t channels, sensorData_t *p_tData)
+{
+  for (int i = 0; i < STATS_CH_MAX; i++)
+  {
+    if (p_tSample->valid & channels & (1U << i))
+    {
+      vMspChan_add(p_tData, (stats_channel_t)i, p_tSample->value[i]);
+    }
+  }
+}
+
+void vMspRing_copyToData(const sensorSample_t *p_tSample, sensorData_t *p_tData)
+{
+  for (int i = 0; i < STATS_CH_MAX; i++)
+  {
+    if (p_tSample->valid & (1U << i))
+    {
+      vMspChan_set(p_tData, (stats_channel_t)i, p_tSample->value[i]);
+    }
+  }
+}
+
+void vMspRing_sampleFromData(const sensorData_t *p_tData, sensorSample_t *p_tSample)
+{
+  memset(p_tSample, 0, sizeof(*p_tSample));
+  for (int i = 0; i < STATS_CH_MAX; i++)
+  {
+    vMspRing_setChannel(p_tSample, (stats_channel_t)i, fMspChan_get(p_tData, (stats_channel_t)i));
+  }
+}
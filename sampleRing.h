@@ -0,0 +1,98 @@
+/******************************************************************************
+ * @file    sampleRing.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Compact timestamped record of one sample of every channel, and a
+ *          single producer / single consumer ring to hand them over without
+ *          locks. The loop task aggregates each sample once the bus workers
+ *          are done and pushes a copy into the display ring, which the display
+ *          task drains at its own pace.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef SAMPLE_RING_H
+#define SAMPLE_RING_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+
+#define SAMPLE_RING_LEN 8 /*!< slots of a ring, a power of two */
+
+typedef struct __SENSOR_SAMPLE__
+{
+  uint32_t epoch;             /*!< start of the sampling period, seconds */
+  uint32_t ms;                /*!< millis() once the sample was complete */
+  uint16_t valid;             /*!< bit (1 << stats_channel_t) of the channels read */
+  float value[STATS_CH_MAX];  /*!< reading of each channel, as averaged: ug/m3, C, %, hPa, kOhm */
+} sensorSample_t;
+
+typedef struct __SAMPLE_RING__
+{
+  sensorSample_t slot[SAMPLE_RING_LEN];
+  uint32_t head;    /*!< next slot written, producer only */
+  uint32_t tail;    /*!< next slot read, consumer only */
+  uint32_t dropped; /*!< samples pushed while the ring was full, producer only */
+} sampleRing_t;
+
+/******************************************************
+ * @brief empties a ring, before its producer and its
+ *        consumer start
+ ******************************************************/
+void vMspRing_init(sampleRing_t *p_tRing);
+
+/******************************************************
+ * @brief producer side: copies the sample in
+ *
+ * @return false when the ring is full, the sample is
+ *         dropped and counted
+ ******************************************************/
+bool bMspRing_push(sampleRing_t *p_tRing, const sensorSample_t *p_tSample);
+
+/******************************************************
+ * @brief consumer side: copies the oldest sample out
+ *
+ * @return false when the ring is empty
+ ******************************************************/
+bool bMspRing_pop(sampleRing_t *p_tRing, sensorSample_t *p_tSample);
+
+/******************************************************
+ * @brief marks a reading of a channel in a sample
+ ******************************************************/
+void vMspRing_setChannel(sensorSample_t *p_tSample, stats_channel_t channel, float value);
+
+/******************************************************
+ * @brief the channel was read in the sample
+ ******************************************************/
+bool bMspRing_hasChannel(const sensorSample_t *p_tSample, stats_channel_t channel);
+
+/******************************************************
+ * @brief copies the channels read in a sample into
+ *        another one (the sample of one bus into the
+ *        sample of the period)
+ ******************************************************/
+void vMspRing_mergeChannels(sensorSample_t *p_tSample, const sensorSample_t *p_tFrom);
+
+/******************************************************
+ * @brief adds the readings of the given channels to the
+ *        sums of a record, over the averaging interval
+ ******************************************************/
+void vMspRing_addToSums(const sensorSample_t *p_tSample, uint16_t channels, sensorData_t *p_tData);
+
+/******************************************************
+ * @brief overwrites the fields of a record with the
+ *        channels read in the sample, the others keep
+ *        their last value
+ ******************************************************/
+void vMspRing_copyToData(const sensorSample_t *p_tSample, sensorData_t *p_tData);
+
+/******************************************************
+ * @brief every channel of a record, the averaged one
+ *        shown after an upload; the caller stamps it
+ ******************************************************/
+void vMspRing_sampleFromData(const sensorData_t *p_tData, sensorSample_t *p_tSample);
+
+#endif
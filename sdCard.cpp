@@ -24,12 +24,19 @@
 #include "mspOs.h"
 #include "config.h"
 #include "sensors.h"
+#include "latency.h"
+#include "channelStats.h"
+#include "micsBaseline.h"
+#include "sdLogger.h"
+#include "esp_system.h"
 
 #define FOLDER_NAME_LEN 16
 #define TIMEFORMAT_LEN 30
 
 // File system constants
 #define LOG_FILE_EXTENSION ".csv"
+#define LATENCY_FILE_NAME "latency.csv"
+#define ROLLUP_FILE_NAME "rollup.csv"
 #define PATH_SEPARATOR "/"
 
 // Date/Time format constants
@@ -45,9 +52,6 @@
 #define MONTH_OFFSET 1
 #define FIRST_DATA_COLUMN_SEPARATOR ";"
 
-// CSV Header
-#define CSV_HEADER "recordedAt;date;time;year;month;temp;hum;PM1;PM2_5;PM10;pres;radiation;nox;co;nh3;o3;voc;msp"
-
 // Log file size and rotation constants
 #define LOG_MAX_SIZE 1000000
 #define RETRY_ATTEMPTS 3
@@ -139,6 +143,8 @@ uint8_t initializeSD(systemStatus_t *p_tSys, deviceNetworkInfo_t *p_tDev)
   }
   delay(SD_DETECTION_DELAY_MS);
   log_v("SD Card size: %lluMB\n", SD.cardSize() / BYTES_TO_MB_DIVISOR);
+  // the log lines still in RAM go to the card before a restart (update, configuration)
+  esp_register_shutdown_handler(vHalSdLog_closeAll);
   return true;
 }
 
@@ -313,6 +319,10 @@ static uint8_t parseConfig(File fl, deviceNetworkInfo_t *p_tDev, sensorData_t *p
   pDev->avg_measurements = config[JSON_KEY_AVERAGE_MEASUREMENTS] | 30;
   log_i("avgMeasure = *%d*", pDev->avg_measurements);
 
+  // Parse Sampling Period
+  pDev->delay_between_measurements = config[JSON_KEY_SAMPLING_PERIOD] | SEC_IN_MIN;
+  log_i("samplingPeriod = *%d*", pDev->delay_between_measurements);
+
   // Parse Sea Level Altitude
   p_tData->gasData.seaLevelAltitude = config[JSON_KEY_SEA_LEVEL_ALTITUDE] | 122.0f;
   log_i("sealevelalt = *%.2f*", p_tData->gasData.seaLevelAltitude);
@@ -480,6 +490,47 @@ static uint8_t parseConfig(File fl, deviceNetworkInfo_t *p_tDev, sensorData_t *p
         (sysStat->gasSensorType == GAS_SENSOR_MICS6814) ? "MICS6814" : (sysStat->gasSensorType == GAS_SENSOR_MICS4514) ? "MICS4514"
                                                                                                                        : "Unknown");
 
+  // Parse Latency Upload
+  sysStat->uploadLatency = config[JSON_KEY_UPLOAD_LATENCY] | false;
+  log_i("uploadLatency = *%s*", (sysStat->uploadLatency) ? STR_TRUE : STR_FALSE);
+
+  // Parse Aggregation Methods, channels not listed keep the mean
+  JsonObject aggregation = config[JSON_KEY_AGGREGATION];
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
+  {
+    const char *channelName = pcMspStats_channelName((stats_channel_t)ch);
+    const char *methodName = aggregation[channelName];
+    statsMethod_t method = STATS_METHOD_MEAN;
+    if ((methodName != NULL) && !bMspStats_parseMethod(methodName, &method))
+    {
+      log_e("Unknown aggregation method *%s* for %s. Falling back to mean", methodName, channelName);
+      method = STATS_METHOD_MEAN;
+    }
+    sysStat->aggregation[ch] = (uint8_t)method;
+    if (method != STATS_METHOD_MEAN)
+    {
+      log_i("aggregation %s = *%s*", channelName, pcMspStats_methodName(method));
+    }
+  }
+
+  // Parse MICS Baseline Tracking
+  const char *baselineName = config[JSON_KEY_MICS_BASELINE] | "propose";
+  micsBaselineMode_t baselineMode = MICS_BASELINE_PROPOSE;
+  if (!bMspBaseline_parseMode(baselineName, &baselineMode))
+  {
+    log_e("Unknown mics_baseline *%s*. Falling back to propose", baselineName);
+    baselineMode = MICS_BASELINE_PROPOSE;
+  }
+  sysStat->micsBaselineMode = (uint8_t)baselineMode;
+  int baselineDays = config[JSON_KEY_MICS_BASELINE_DAYS] | MICS_BASELINE_DEFAULT_UPDATE_DAYS;
+  if ((baselineDays < 1) || (baselineDays > UINT8_MAX))
+  {
+    log_e("Invalid mics_baseline_days %d. Falling back to %d", baselineDays, MICS_BASELINE_DEFAULT_UPDATE_DAYS);
+    baselineDays = MICS_BASELINE_DEFAULT_UPDATE_DAYS;
+  }
+  sysStat->micsBaselineDays = (uint8_t)baselineDays;
+  log_i("micsBaseline = *%s* every %d days", pcMspBaseline_modeName(baselineMode), baselineDays);
+
   return outcome;
 }
 
@@ -535,6 +586,7 @@ uint8_t checkConfig(const char *configpath, deviceNetworkInfo_t *p_tDev, sensorD
       config[JSON_KEY_WIFI_POWER] = DEFAULT_WIFI_POWER;
       config[JSON_KEY_O3_ZERO_VALUE] = p_tData->ozoneData.o3ZeroOffset;
       config[JSON_KEY_AVERAGE_MEASUREMENTS] = pDev->avg_measurements;
+      config[JSON_KEY_SAMPLING_PERIOD] = SEC_IN_MIN;
       config[JSON_KEY_SEA_LEVEL_ALTITUDE] = p_tData->gasData.seaLevelAltitude;
       config[JSON_KEY_UPLOAD_SERVER] = "";
 
@@ -566,6 +618,7 @@ uint8_t checkConfig(const char *configpath, deviceNetworkInfo_t *p_tDev, sensorD
       JsonObject help = doc[JSON_HELP_SECTION].to<JsonObject>();
       help[JSON_KEY_WIFI_POWER] = "Accepted values: -1, 2, 5, 7, 8.5, 11, 13, 15, 17, 18.5, 19, 19.5 dBm";
       help[JSON_KEY_AVERAGE_MEASUREMENTS] = "Accepted values: 1, 2, 3, 4, 5, 6, 10, 12, 15, 20, 30, 60";
+      help[JSON_KEY_SAMPLING_PERIOD] = "Seconds between two samples, averaged over average_measurements minutes. Accepted values: 5, 10, 15, 20, 30, 60";
       help[JSON_KEY_SEA_LEVEL_ALTITUDE] = "Value in meters, must be changed according to device location. 122.0 meters is the average altitude in Milan, Italy";
       help[JSON_KEY_TIMEZONE] = "Standard tz timezone definition. More details at https://www.gnu.org/software/libc/manual/html_node/TZ-Variable.html";
 
@@ -691,6 +744,7 @@ bool bHalSdcard_writeConfig(deviceNetworkInfo_t *p_tDev, sensorData_t *p_tData,
   // Sensor configuration
   config[JSON_KEY_O3_ZERO_VALUE] = p_tData->ozoneData.o3ZeroOffset;
   config[JSON_KEY_AVERAGE_MEASUREMENTS] = pDev->avg_measurements;
+  config[JSON_KEY_SAMPLING_PERIOD] = pDev->delay_between_measurements;
   config[JSON_KEY_SEA_LEVEL_ALTITUDE] = p_tData->gasData.seaLevelAltitude;
   config[JSON_KEY_UPLOAD_SERVER] = p_tSysData->server;
 
@@ -727,6 +781,16 @@ bool bHalSdcard_writeConfig(deviceNetworkInfo_t *p_tDev, sensorData_t *p_tData,
   // System configuration
   config[JSON_KEY_FW_AUTO_UPGRADE] = (p_tSys->fwAutoUpgrade != 0);
   config[JSON_KEY_GAS_SENSOR_TYPE] = p_tSys->gasSensorType;
+  config[JSON_KEY_UPLOAD_LATENCY] = (p_tSys->uploadLatency != 0);
+
+  // Aggregation method of each channel
+  JsonObject aggregation = config[JSON_KEY_AGGREGATION].to<JsonObject>();
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
+  {
+    aggregation[pcMspStats_channelName((stats_channel_t)ch)] = pcMspStats_methodName((statsMethod_t)p_tSys->aggregation[ch]);
+  }
+  config[JSON_KEY_MICS_BASELINE] = pcMspBaseline_modeName((micsBaselineMode_t)p_tSys->micsBaselineMode);
+  config[JSON_KEY_MICS_BASELINE_DAYS] = p_tSys->micsBaselineDays;
 
   // Create default help section if it doesn't exist
   if (!help)
@@ -734,9 +798,14 @@ bool bHalSdcard_writeConfig(deviceNetworkInfo_t *p_tDev, sensorData_t *p_tData,
     help = doc[JSON_HELP_SECTION].to<JsonObject>();
     help[JSON_KEY_WIFI_POWER] = "Accepted values: -1, 2, 5, 7, 8.5, 11, 13, 15, 17, 18.5, 19, 19.5 dBm";
     help[JSON_KEY_AVERAGE_MEASUREMENTS] = "Accepted values: 1, 2, 3, 4, 5, 6, 10, 12, 15, 20, 30, 60";
+    help[JSON_KEY_SAMPLING_PERIOD] = "Seconds between two samples, averaged over average_measurements minutes. Accepted values: 5, 10, 15, 20, 30, 60";
     help[JSON_KEY_SEA_LEVEL_ALTITUDE] = "Value in meters, must be changed according to device location. 122.0 meters is the average altitude in Milan, Italy";
     help[JSON_KEY_TIMEZONE] = "Standard tz timezone definition. More details at https://www.gnu.org/software/libc/manual/html_node/TZ-Variable.html";
     help[JSON_KEY_GAS_SENSOR_TYPE] = "Gas sensor type: 0 = MICS6814, 1 = MICS4514 (DFRobot SEN0377)";
+    help[JSON_KEY_UPLOAD_LATENCY] = "Add the longest duration of each main loop state and sensor reading since the previous record to the uploads";
+    help[JSON_KEY_AGGREGATION] = "Value sent for each channel (temp, hum, pre, voc, cox, nox, nh3, pm1, pm25, pm10, o3) over the averaging interval: mean (weighted by the time each sample stands for), median or trimmed (mean without the lowest and highest sample). The standard deviation of the samples is sent as <channel>_sd, the sampling periods with a sample as <channel>_cov";
+    help[JSON_KEY_MICS_BASELINE] = "MICS R0 tracked from the daily clean-air readings: off, propose (logged only) or apply (written to mics_calibration_values, a few percent per update at most)";
+    help[JSON_KEY_MICS_BASELINE_DAYS] = "Days between two MICS R0 proposals";
   }
 
   // Write config to SD card
@@ -1085,85 +1154,15 @@ uint8_t addToLog(const char *path, const char *oldpath, const char *errpath, Str
  * @param p_tData
  * @param p_tDev
  ******************************************************************************/
-/**************************************************************
- * @brief Create date-based log path (YYYY/MM/DD.csv format)
- * Creates folder structure: /YYYY/MM/DD.csv
- *************************************************************/
-String sHalSdcard_createDateBasedLogPath(const struct tm *timeInfo)
-{
-  char yearStr[FOLDER_NAME_LEN];
-  char monthStr[FOLDER_NAME_LEN];
-  char dayStr[FOLDER_NAME_LEN]; // Generous buffer sizes to avoid any truncation warnings
-
-  // Format components with leading zeros
-  snprintf(yearStr, sizeof(yearStr), YEAR_FORMAT, timeInfo->tm_year + BASE_YEAR_OFFSET);
-  snprintf(monthStr, sizeof(monthStr), MONTH_FORMAT, timeInfo->tm_mon + MONTH_OFFSET);
-  snprintf(dayStr, sizeof(dayStr), DAY_FORMAT, timeInfo->tm_mday);
-
-  // Create path: /YYYY/MM/DD.csv
-  String logPath = PATH_SEPARATOR + String(yearStr) + PATH_SEPARATOR + String(monthStr) + PATH_SEPARATOR + String(dayStr) + LOG_FILE_EXTENSION;
-
-  log_i("Generated log path: %s", logPath.c_str());
-  return logPath;
-}
-
-/**************************************************************
- * @brief Ensure directory path exists, create if necessary
- *************************************************************/
-bool bHalSdcard_ensureDirectoryExists(const String &dirPath)
-{
-  if (SD.exists(dirPath))
-  {
-    log_v("Directory already exists: %s", dirPath.c_str());
-    return true;
-  }
-
-  log_i("Creating directory: %s", dirPath.c_str());
-  if (SD.mkdir(dirPath))
-  {
-    log_i("Directory created successfully: %s", dirPath.c_str());
-    return true;
-  }
-  else
-  {
-    log_e("Failed to create directory: %s", dirPath.c_str());
-    return false;
-  }
-}
-
 void vHalSdcard_logToSD(send_data_t *data, systemData_t *p_tSysData, systemStatus_t *p_tSys, sensorData_t *p_tData, deviceNetworkInfo_t *p_tDev)
 { // builds a new logfile line and calls addToLog() using date-based folder structure
 
   log_i("Logging data to date-based CSV structure on SD Card...");
 
-  // Create date-based log path
-  String logPath = sHalSdcard_createDateBasedLogPath(&data->sendTimeInfo);
-
-  // Extract directory path from full file path
-  int lastSlashIndex = logPath.lastIndexOf(*PATH_SEPARATOR);
-  String dirPath = logPath.substring(0, lastSlashIndex);
-
-  // Ensure year and month directories exist
-  char yearStr[FOLDER_NAME_LEN];
-  char monthStr[FOLDER_NAME_LEN]; // Generous buffer sizes to avoid any truncation warnings
-  snprintf(yearStr, sizeof(yearStr), YEAR_FORMAT, data->sendTimeInfo.tm_year + BASE_YEAR_OFFSET);
-  snprintf(monthStr, sizeof(monthStr), MONTH_FORMAT, data->sendTimeInfo.tm_mon + MONTH_OFFSET);
-
-  String yearPath = PATH_SEPARATOR + String(yearStr);
-  String monthPath = yearPath + PATH_SEPARATOR + String(monthStr);
-
-  // Create directories step by step
-  if (!bHalSdcard_ensureDirectoryExists(yearPath))
-  {
-    log_e("Failed to create year directory: %s", yearPath.c_str());
-    return;
-  }
-
-  if (!bHalSdcard_ensureDirectoryExists(monthPath))
-  {
-    log_e("Failed to create month directory: %s", monthPath.c_str());
-    return;
-  }
+  // Date-based log path /YYYY/MM/DD.csv, the logger creates the directories it does not know
+  char logPath[SDLOG_PATH_LEN];
+  snprintf(logPath, sizeof(logPath), PATH_SEPARATOR YEAR_FORMAT PATH_SEPARATOR MONTH_FORMAT PATH_SEPARATOR DAY_FORMAT LOG_FILE_EXTENSION,
+           data->sendTimeInfo.tm_year + BASE_YEAR_OFFSET, data->sendTimeInfo.tm_mon + MONTH_OFFSET, data->sendTimeInfo.tm_mday);
 
   strftime(p_tSysData->Date, sizeof(p_tSysData->Date), DATE_FORMAT, &data->sendTimeInfo); // Formatting date as DD/MM/YYYY
   strftime(p_tSysData->Time, sizeof(p_tSysData->Time), TIME_FORMAT, &data->sendTimeInfo); // Formatting time as HH:MM:SS
@@ -1245,29 +1244,164 @@ void vHalSdcard_logToSD(send_data_t *data, systemData_t *p_tSysData, systemStatu
   logvalue += FIRST_DATA_COLUMN_SEPARATOR;
   logvalue += String(data->MSP);
 
-  // Simple append-based logging for date-based files
+  // Buffered in RAM, written to the day's file kept open as the flush policy of sdLogger.h says
+  if (!bHalSdLog_append(SDLOG_STREAM_RECORDS, logPath, CSV_HEADER, logvalue.c_str()))
+  {
+    log_e("Failed to open log file for writing: %s", logPath);
+    vMsp_sendNetworkDataToDisplay(p_tDev, p_tSys, DISP_EVENT_SD_CARD_LOG_ERROR);
+    return;
+  }
+
+  log_i("SD Card log updated: %s", logPath);
+}
+
+/**************************************************************
+ * @brief Append the daily latency statistics to the monthly
+ *        /YYYY/MM/latency.csv, one line per slot that ran
+ *************************************************************/
+void vHalSdcard_logLatencySummary(void)
+{
+  const struct tm *p_tDay = p_tMspLatency_day();
+
+  char yearStr[FOLDER_NAME_LEN];
+  char monthStr[FOLDER_NAME_LEN];
+  snprintf(yearStr, sizeof(yearStr), YEAR_FORMAT, p_tDay->tm_year + BASE_YEAR_OFFSET);
+  snprintf(monthStr, sizeof(monthStr), MONTH_FORMAT, p_tDay->tm_mon + MONTH_OFFSET);
+
+  String logPath = PATH_SEPARATOR + String(yearStr) + PATH_SEPARATOR + String(monthStr) + PATH_SEPARATOR + LATENCY_FILE_NAME;
+  if (!bHalSdLog_ensureDirectories(logPath.c_str()))
+  {
+    log_e("Failed to create latency log directory for %s", logPath.c_str());
+    return;
+  }
+
   bool needsHeader = !SD.exists(logPath);
 
   File logFile = SD.open(logPath, FILE_APPEND);
   if (!logFile)
   {
-    log_e("Failed to open log file for writing: %s", logPath.c_str());
-    vMsp_sendNetworkDataToDisplay(p_tDev, p_tSys, DISP_EVENT_SD_CARD_LOG_ERROR);
+    log_e("Failed to open latency log for writing: %s", logPath.c_str());
     return;
   }
 
-  // Add header if this is a new file
   if (needsHeader)
   {
-    logFile.println(CSV_HEADER);
-    log_i("CSV header added to new log file: %s", logPath.c_str());
+    logFile.println(LATENCY_CSV_HEADER);
   }
 
-  // Append the data
-  logFile.println(logvalue);
+  char line[LATENCY_CSV_LINE_LEN];
+  for (uint32_t i = 0; i < LATENCY_SLOT_MAX; i++)
+  {
+    latencySummary_t summary;
+    vMspLatency_getSummary((latency_slot_t)i, &summary);
+    if (summary.count == 0)
+    {
+      continue;
+    }
+    ulMspLatency_formatCsv((latency_slot_t)i, line, sizeof(line));
+    logFile.println(line);
+  }
   logFile.close();
 
-  log_i("SD Card log file updated successfully: %s", logPath.c_str());
+  log_i("Latency summary appended to %s", logPath.c_str());
+}
+
+/**************************************************************
+ * @brief Append a closed rollup to the monthly
+ *        /YYYY/MM/rollup.csv of the month it started in
+ *************************************************************/
+void vHalSdcard_logRollup(const rollupRecord_t *p_tRollup)
+{
+  time_t start = (time_t)p_tRollup->start;
+  struct tm local;
+  localtime_r(&start, &local);
+
+  char logPath[SDLOG_PATH_LEN];
+  snprintf(logPath, sizeof(logPath), PATH_SEPARATOR YEAR_FORMAT PATH_SEPARATOR MONTH_FORMAT PATH_SEPARATOR ROLLUP_FILE_NAME,
+           local.tm_year + BASE_YEAR_OFFSET, local.tm_mon + MONTH_OFFSET);
+
+  char line[ROLLUP_CSV_LINE_LEN];
+  ulMspRollup_formatCsv(p_tRollup, line, sizeof(line));
+  if (!bHalSdLog_append(SDLOG_STREAM_ROLLUPS, logPath, ROLLUP_CSV_HEADER, line))
+  {
+    log_e("Failed to open rollup log for writing: %s", logPath);
+  }
+}
+
+/******************************************************
+ * @brief writes a state blob to a temporary file, then
+ *        renames it over the previous one
+ ******************************************************/
+static bool bHalSdcard_saveBlob(const char *path, const char *tmpPath, const void *p_vBlob, size_t length)
+{
+  File stateFile = SD.open(tmpPath, FILE_WRITE);
+  if (!stateFile)
+  {
+    log_e("Failed to open %s for writing", tmpPath);
+    return false;
+  }
+  size_t written = stateFile.write((const uint8_t *)p_vBlob, length);
+  stateFile.close();
+  if (written != length)
+  {
+    log_e("%s write incomplete: %u of %u bytes", tmpPath, (unsigned)written, (unsigned)length);
+    SD.remove(tmpPath);
+    return false;
+  }
+
+  SD.remove(path);
+  if (!SD.rename(tmpPath, path))
+  {
+    log_e("Failed to rename %s to %s", tmpPath, path);
+    return false;
+  }
+  return true;
+}
+
+/******************************************************
+ * @brief reads a state blob saved by
+ *        bHalSdcard_saveBlob()
+ ******************************************************/
+static bool bHalSdcard_loadBlob(const char *path, const char *tmpPath, void *p_vBlob, size_t length)
+{
+  // a rename cut short by a reset leaves only the temporary file, complete by then
+  const char *filePath = SD.exists(path) ? path : tmpPath;
+  if (!SD.exists(filePath))
+  {
+    return false;
+  }
+  File stateFile = SD.open(filePath, FILE_READ);
+  if (!stateFile)
+  {
+    return false;
+  }
+  bool ok = (stateFile.size() == length) && (stateFile.read((uint8_t *)p_vBlob, length) == length);
+  stateFile.close();
+  if (!ok)
+  {
+    log_w("Ignoring %s: not a state of %u bytes", filePath, (unsigned)length);
+  }
+  return ok;
+}
+
+bool bHalSdcard_saveBsecState(const uint8_t *p_ucState, size_t length)
+{
+  return bHalSdcard_saveBlob(BSEC_STATE_PATH, BSEC_STATE_TMP_PATH, p_ucState, length);
+}
+
+bool bHalSdcard_loadBsecState(uint8_t *p_ucState, size_t length)
+{
+  return bHalSdcard_loadBlob(BSEC_STATE_PATH, BSEC_STATE_TMP_PATH, p_ucState, length);
+}
+
+bool bHalSdcard_saveMicsBaseline(const void *p_vStore, size_t length)
+{
+  return bHalSdcard_saveBlob(MICS_BASELINE_PATH, MICS_BASELINE_TMP_PATH, p_vStore, length);
+}
+
+bool bHalSdcard_loadMicsBaseline(void *p_vStore, size_t length)
+{
+  return bHalSdcard_loadBlob(MICS_BASELINE_PATH, MICS_BASELINE_TMP_PATH, p_vStore, length);
 }
 
 /******************************************************
@@ -1361,6 +1495,8 @@ uint8_t vHalSdcard_periodicCheck(systemStatus_t *p_tSys, deviceNetworkInfo_t *p_
   // Update system status and log changes
   if (currentSdStatus != previousSdStatus)
   {
+    // the open log files belong to the card that was there
+    vHalSdLog_cardChanged();
     if (currentSdStatus)
     {
       log_i("SD Card detected - card was inserted");
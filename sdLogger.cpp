@@ -0,0 +1,296 @@
+/******************************************************************************
+ * @file    sdLogger.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Buffered append-only logger of the SD card. The loop task adds the
+ *          lines and polls the streams; a restart closes them from the task
+ *          restarting, under a mutex held for one line or one write.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include <SD.h>
+#include <time.h>
+#include "sdLogger.h"
+#include "freertos/semphr.h"
+
+#define SDLOG_LINE_END "\r\n" // as println()
+#define SDLOG_LINE_END_LEN 2U
+#define SDLOG_DAYS_IN_YEAR_KEY 1000
+
+typedef struct
+{
+  File file;
+  bool open;
+  char path[SDLOG_PATH_LEN]; /*!< file of the lines waiting, kept while the card is away */
+  const char *header;        /*!< first line of a new file */
+  int32_t day;               /*!< local date the file was opened on, year * 1000 + day of the year */
+  uint32_t used;             /*!< bytes waiting */
+  uint32_t firstMs;          /*!< millis() of the oldest line waiting */
+  uint32_t dropped;          /*!< lines lost, the card could not take them */
+  char buffer[SDLOG_BUFFER_LEN];
+} sdLogState_t;
+
+static sdLogState_t tStreams[SDLOG_STREAM_MAX];
+static char cKnownDir[SDLOG_PATH_LEN]; /*!< last directory known to exist, "" = none */
+static SemaphoreHandle_t logMutex = NULL;
+static StaticSemaphore_t logMutexBuffer;
+
+/******************************************************
+ * @brief local date key of now
+ ******************************************************/
+static int32_t lHalSdLog_today(void)
+{
+  time_t now = time(NULL);
+  struct tm local;
+  localtime_r(&now, &local);
+  return (local.tm_year * SDLOG_DAYS_IN_YEAR_KEY) + local.tm_yday;
+}
+
+/******************************************************
+ * @brief creates the missing directories of a file
+ *        path, unless it is in the last one known
+ ******************************************************/
+static bool bHalSdLog_makeDirectories(const char *path)
+{
+  const char *p_cName = strrchr(path, '/');
+  size_t dirLength = (p_cName != NULL) ? (size_t)(p_cName - path) : 0;
+  if ((dirLength == 0) || (dirLength >= SDLOG_PATH_LEN))
+  {
+    return dirLength == 0;
+  }
+  if ((strncmp(cKnownDir, path, dirLength) == 0) && (cKnownDir[dirLength] == '\0'))
+  {
+    return true;
+  }
+
+  // each level of the path, /YYYY then /YYYY/MM
+  char dir[SDLOG_PATH_LEN];
+  for (size_t i = 1; i <= dirLength; i++)
+  {
+    if ((i < dirLength) && (path[i] != '/'))
+    {
+      continue;
+    }
+    memcpy(dir, path, i);
+    dir[i] = '\0';
+    if (!SD.exists(dir))
+    {
+      log_i("Creating directory: %s", dir);
+      if (!SD.mkdir(dir))
+      {
+        log_e("Failed to create directory: %s", dir);
+        return false;
+      }
+    }
+  }
+  memcpy(cKnownDir, path, dirLength);
+  cKnownDir[dirLength] = '\0';
+  return true;
+}
+
+/******************************************************
+ * @brief opens the file of a stream for appending, with
+ *        its header when new
+ ******************************************************/
+static bool bHalSdLog_open(sdLogState_t *p_tStream)
+{
+  if (!bHalSdLog_makeDirectories(p_tStream->path))
+  {
+    return false;
+  }
+  p_tStream->file = SD.open(p_tStream->path, FILE_APPEND);
+  if (!p_tStream->file)
+  {
+    log_e("SD log: cannot open %s", p_tStream->path);
+    cKnownDir[0] = '\0';
+    return false;
+  }
+  if (p_tStream->file.size() == 0)
+  {
+    p_tStream->file.print(p_tStream->header);
+    p_tStream->file.print(SDLOG_LINE_END);
+    log_i("SD log: new file %s", p_tStream->path);
+  }
+  p_tStream->open = true;
+  p_tStream->day = lHalSdLog_today();
+  return true;
+}
+
+/******************************************************
+ * @brief closes the file of a stream, the lines waiting
+ *        stay
+ ******************************************************/
+static void vHalSdLog_close(sdLogState_t *p_tStream)
+{
+  if (p_tStream->open)
+  {
+    p_tStream->file.close();
+    p_tStream->open = false;
+  }
+}
+
+/******************************************************
+ * @brief writes the lines waiting and flushes the file
+ *        to the card, reopening it when closed; what
+ *        the card did not take stays for the next try
+ ******************************************************/
+static bool bHalSdLog_write(sdLogState_t *p_tStream)
+{
+  if (p_tStream->used == 0)
+  {
+    return true;
+  }
+  if (!p_tStream->open && !bHalSdLog_open(p_tStream))
+  {
+    return false;
+  }
+
+  uint32_t written = (uint32_t)p_tStream->file.write((const uint8_t *)p_tStream->buffer, p_tStream->used);
+  if (written != p_tStream->used)
+  {
+    log_e("SD log: %lu of %lu bytes written to %s", (unsigned long)written, (unsigned long)p_tStream->used, p_tStream->path);
+    memmove(p_tStream->buffer, p_tStream->buffer + written, p_tStream->used - written);
+    p_tStream->used -= written;
+    vHalSdLog_close(p_tStream);
+    cKnownDir[0] = '\0';
+    return false;
+  }
+  // fflush and fsync on the ESP32 core: the lines are on the card, the FAT entry up to date
+  p_tStream->file.flush();
+  p_tStream->used = 0;
+  return true;
+}
+
+void vHalSdLog_init(void)
+{
+  if (logMutex == NULL)
+  {
+    logMutex = xSemaphoreCreateMutexStatic(&logMutexBuffer);
+  }
+}
+
+bool bHalSdLog_append(sdLogStream_t stream, const char *path, const char *header, const char *line)
+{
+  if ((logMutex == NULL) || (stream >= SDLOG_STREAM_MAX))
+  {
+    return false;
+  }
+
+  xSemaphoreTake(logMutex, portMAX_DELAY);
+  sdLogState_t *p_tStream = &tStreams[stream];
+  if (strcmp(p_tStream->path, path) != 0)
+  {
+    // another file, the day or the month is over: the previous one is done
+    if (!bHalSdLog_write(p_tStream))
+    {
+      p_tStream->dropped++;
+      log_w("SD log: lines of %s lost", p_tStream->path);
+      p_tStream->used = 0;
+    }
+    vHalSdLog_close(p_tStream);
+    snprintf(p_tStream->path, sizeof(p_tStream->path), "%s", path);
+  }
+  p_tStream->header = header;
+
+  bool stored = p_tStream->open || bHalSdLog_open(p_tStream);
+  uint32_t length = (uint32_t)strlen(line) + SDLOG_LINE_END_LEN;
+  if (stored && ((p_tStream->used + length) > SDLOG_BUFFER_LEN))
+  {
+    stored = bHalSdLog_write(p_tStream) && (length <= SDLOG_BUFFER_LEN);
+  }
+  if (stored)
+  {
+    if (p_tStream->used == 0)
+    {
+      p_tStream->firstMs = millis();
+    }
+    memcpy(p_tStream->buffer + p_tStream->used, line, length - SDLOG_LINE_END_LEN);
+    memcpy(p_tStream->buffer + p_tStream->used + length - SDLOG_LINE_END_LEN, SDLOG_LINE_END, SDLOG_LINE_END_LEN);
+    p_tStream->used += length;
+    if ((millis() - p_tStream->firstMs) >= SDLOG_FLUSH_INTERVAL_MS)
+    {
+      bHalSdLog_write(p_tStream);
+    }
+  }
+  else
+  {
+    p_tStream->dropped++;
+  }
+  xSemaphoreGive(logMutex);
+  return stored;
+}
+
+void vHalSdLog_poll(void)
+{
+  if (logMutex == NULL)
+  {
+    return;
+  }
+
+  xSemaphoreTake(logMutex, portMAX_DELAY);
+  int32_t today = lHalSdLog_today();
+  for (int i = 0; i < SDLOG_STREAM_MAX; i++)
+  {
+    sdLogState_t *p_tStream = &tStreams[i];
+    if ((p_tStream->used > 0) && ((millis() - p_tStream->firstMs) >= SDLOG_FLUSH_INTERVAL_MS))
+    {
+      bHalSdLog_write(p_tStream);
+    }
+    if (p_tStream->open && (p_tStream->day != today) && bHalSdLog_write(p_tStream))
+    {
+      vHalSdLog_close(p_tStream);
+      log_i("SD log: %s closed at midnight", p_tStream->path);
+    }
+  }
+  xSemaphoreGive(logMutex);
+}
+
+void vHalSdLog_closeAll(void)
+{
+  // at a restart the loop task may be in the middle of a line, it is given a moment
+  if ((logMutex == NULL) || (xSemaphoreTake(logMutex, pdMS_TO_TICKS(SDLOG_SHUTDOWN_WAIT_MS)) != pdTRUE))
+  {
+    return;
+  }
+  for (int i = 0; i < SDLOG_STREAM_MAX; i++)
+  {
+    bHalSdLog_write(&tStreams[i]);
+    vHalSdLog_close(&tStreams[i]);
+    if (tStreams[i].dropped > 0)
+    {
+      log_w("SD log: %lu lines of stream %d lost", (unsigned long)tStreams[i].dropped, i);
+    }
+  }
+  xSemaphoreGive(logMutex);
+}
+
+void vHalSdLog_cardChanged(void)
+{
+  if (logMutex == NULL)
+  {
+    return;
+  }
+  xSemaphoreTake(logMutex, portMAX_DELAY);
+  for (int i = 0; i < SDLOG_STREAM_MAX; i++)
+  {
+    vHalSdLog_close(&tStreams[i]);
+  }
+  cKnownDir[0] = '\0';
+  xSemaphoreGive(logMutex);
+}
+
+bool bHalSdLog_ensureDirectories(const char *path)
+{
+  if (logMutex == NULL)
+  {
+    return bHalSdLog_makeDirectories(path);
+  }
+  xSemaphoreTake(logMutex, portMAX_DELAY);
+  bool made = bHalSdLog_makeDirectories(path);
+  xSemaphoreGive(logMutex);
+  return made;
+}
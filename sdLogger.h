@@ -0,0 +1,85 @@
+/******************************************************************************
+ * @file    sdLogger.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Buffered append-only logger of the SD card. Each stream keeps its
+ *          file open and its lines in RAM, and writes them in one go when
+ *          the buffer fills or SDLOG_FLUSH_INTERVAL_MS after the oldest one,
+ *          then flushes (fsync) the file. A stream moves to a new file when a
+ *          line goes to another path, and is closed at local midnight. The
+ *          year and month directories known to exist are remembered.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef SD_LOGGER_H
+#define SD_LOGGER_H
+
+// -- includes --
+#include <Arduino.h>
+
+#ifndef SDLOG_BUFFER_LEN
+#define SDLOG_BUFFER_LEN 2048 // bytes of lines each stream holds before writing them
+#endif
+
+#ifndef SDLOG_FLUSH_INTERVAL_MS
+#define SDLOG_FLUSH_INTERVAL_MS 60000UL // longest a line waits in RAM, the lines lost at a power cut
+#endif
+
+#define SDLOG_PATH_LEN 32
+#define SDLOG_SHUTDOWN_WAIT_MS 500 // for the loop task to finish a write, at a restart
+
+// files kept open, one per stream
+typedef enum __SDLOG_STREAM__
+{
+  SDLOG_STREAM_RECORDS = 0, /*!< /YYYY/MM/DD.csv */
+  SDLOG_STREAM_ROLLUPS,     /*!< /YYYY/MM/rollup.csv */
+  SDLOG_STREAM_MAX
+} sdLogStream_t;
+
+/******************************************************
+ * @brief creates the lock of the streams, at boot
+ ******************************************************/
+void vHalSdLog_init(void);
+
+/******************************************************
+ * @brief adds a line to a stream; the file of a new
+ *        path is opened (directories created, header
+ *        written when empty) and the previous one is
+ *        written and closed
+ *
+ * @return false when the file cannot be opened or the
+ *         line does not fit a buffer that cannot be
+ *         written; the line is lost
+ ******************************************************/
+bool bHalSdLog_append(sdLogStream_t stream, const char *path, const char *header, const char *line);
+
+/******************************************************
+ * @brief loop task, every few seconds: writes the lines
+ *        waiting longer than SDLOG_FLUSH_INTERVAL_MS and
+ *        closes the files at local midnight
+ ******************************************************/
+void vHalSdLog_poll(void);
+
+/******************************************************
+ * @brief writes every line waiting and closes the files
+ *        (restart, end of a simulation)
+ ******************************************************/
+void vHalSdLog_closeAll(void);
+
+/******************************************************
+ * @brief the card was removed or inserted: the open
+ *        files and the directories known are forgotten,
+ *        the lines waiting go to the next card
+ ******************************************************/
+void vHalSdLog_cardChanged(void);
+
+/******************************************************
+ * @brief creates the /YYYY and /YYYY/MM directories of
+ *        a file path, when not known to exist
+ ******************************************************/
+bool bHalSdLog_ensureDirectories(const char *path);
+
+#endif
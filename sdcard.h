@@ -18,6 +18,10 @@
 
 // -- includes --
 #include "shared_values.h"
+#include "rollup.h"
+
+// CSV header of the daily log files, also read back by the host replay engine
+#define CSV_HEADER "recordedAt;date;time;year;month;temp;hum;PM1;PM2_5;PM10;pres;radiation;nox;co;nh3;o3;voc;msp"
 
 // Legacy function removed - now using date-based logging with automatic file creation
 
@@ -32,21 +36,55 @@
  ******************************************************************************/
 void vHalSdcard_logToSD(send_data_t *data, systemData_t *p_tSysData, systemStatus_t *p_tSys, sensorData_t *p_tData, deviceNetworkInfo_t *p_tDev);
 
-/**************************************************************
- * @brief Create date-based log path (YYYY/MM/DD.csv format)
- * 
- * @param timeInfo Time structure for the log entry
- * @return String Complete path for the log file
- *************************************************************/
-String sHalSdcard_createDateBasedLogPath(const struct tm* timeInfo);
+/*******************************************************************************
+ * @brief append the daily loop latency statistics (latency.h) to
+ *        /YYYY/MM/latency.csv, dated with the day they were collected on
+ ******************************************************************************/
+void vHalSdcard_logLatencySummary(void);
 
-/**************************************************************
- * @brief Ensure directory path exists, create if necessary
- * 
- * @param dirPath Directory path to create
- * @return bool Success/failure
- *************************************************************/
-bool bHalSdcard_ensureDirectoryExists(const String& dirPath);
+/*******************************************************************************
+ * @brief append a closed rollup (rollup.h) to /YYYY/MM/rollup.csv, dated with
+ *        the start of the rollup
+ ******************************************************************************/
+void vHalSdcard_logRollup(const rollupRecord_t *p_tRollup);
+
+/*******************************************************************************
+ * @brief save the BSEC state blob to BSEC_STATE_PATH, written to a temporary
+ *        file first so a reset mid-write leaves the previous state in place
+ *
+ * @param p_ucState state from Bsec::getState()
+ * @param length blob size
+ * @return bool success/failure
+ ******************************************************************************/
+bool bHalSdcard_saveBsecState(const uint8_t *p_ucState, size_t length);
+
+/*******************************************************************************
+ * @brief load the BSEC state blob saved by bHalSdcard_saveBsecState()
+ *
+ * @param p_ucState buffer for Bsec::setState()
+ * @param length blob size
+ * @return bool false when there is no state of that size
+ ******************************************************************************/
+bool bHalSdcard_loadBsecState(uint8_t *p_ucState, size_t length);
+
+/*******************************************************************************
+ * @brief save the MICS baseline store to MICS_BASELINE_PATH, through a
+ *        temporary file like the BSEC state
+ *
+ * @param p_vStore store from p_tMspBaseline_store()
+ * @param length store size
+ * @return bool success/failure
+ ******************************************************************************/
+bool bHalSdcard_saveMicsBaseline(const void *p_vStore, size_t length);
+
+/*******************************************************************************
+ * @brief load the MICS baseline store saved by bHalSdcard_saveMicsBaseline()
+ *
+ * @param p_vStore buffer for the store
+ * @param length store size
+ * @return bool false when there is no store of that size
+ ******************************************************************************/
+bool bHalSdcard_loadMicsBaseline(void *p_vStore, size_t length);
 
 /******************************************************
  * @brief read SD card 
@@ -0,0 +1,41 @@
+/******************************************************************************
+ * @file    sensorDriver.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Sensor driver interface. Every sensor the station can carry is an
+ *          entry of the constant driver table of the sketch: boot detection,
+ *          the sampling job of its bus worker, the loop task step after the
+ *          join and the cycle average all come from there. A new sensor is
+ *          one more entry with its four functions, the state machine does
+ *          not change.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef SENSOR_DRIVER_H
+#define SENSOR_DRIVER_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+#include "acquisition.h"
+
+#define SENSOR_DRIVER_ANY_GAS 0xFF /*!< gasSensorType of the drivers fitted whatever the configured gas sensor */
+
+typedef struct __SENSOR_DRIVER__
+{
+  const char *name;
+  acqBus_t bus;                        /*!< worker running sample(), and boot lane of detect() */
+  uint8_t gasSensorType;               /*!< gas_sensor_type_t the driver serves, SENSOR_DRIVER_ANY_GAS for the other sensors */
+  sens_status_t statSlot;              /*!< entry of errorVars_t::senserrs that finalize() raises */
+  uint8_t peripheralStatus_t::*status; /*!< flag of the sensor, &peripheralStatus_t::... */
+
+  void (*detect)(void);             /*!< boot: probes and sets up the sensor, sets its flag when found */
+  void (*sample)(void);             /*!< one reading on the bus worker, added to the cycle sums */
+  void (*accumulate)(bool sampled); /*!< optional, on the loop task after the join: what needs the sample of another bus or must not run late */
+  void (*finalize)(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas); /*!< cycle average */
+} sensorDriver_t;
+
+#endif
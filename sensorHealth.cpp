@@ -0,0 +1,111 @@
+/******************************************************************************
+ * @file    sensorHealth.cpp
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Sensor health. Each entry is only touched by the bus worker
+ *          sampling that sensor, so no lock is taken.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+// -- includes --
+#include "sensorHealth.h"
+#include "sensors.h"
+
+#define SENSOR_HEALTH_MS_IN_SEC 1000UL
+
+static sensorHealth_t tHealth[SENS_STAT_MAX];
+
+static const char *const pcSensorNames[SENS_STAT_MAX] = {"BME680", "PMS5003", "MICS", "O3"};
+
+void vMspHealth_init(void)
+{
+  memset(tHealth, 0, sizeof(tHealth));
+  for (uint32_t i = 0; i < SENS_STAT_MAX; i++)
+  {
+    tHealth[i].state = SENSOR_HEALTH_OK;
+    tHealth[i].probePeriodS = SENSOR_HEALTH_PROBE_MIN_S;
+  }
+}
+
+uint8_t ucMspHealth_attempts(sens_status_t sensor)
+{
+  sensorHealth_t *p_tHealth = &tHealth[sensor];
+
+  if (p_tHealth->state == SENSOR_HEALTH_DEGRADED)
+  {
+    if ((int32_t)(millis() - p_tHealth->nextProbeMs) < 0)
+    {
+      p_tHealth->skipped++;
+      return 0;
+    }
+    return 1;
+  }
+
+  // retries rarely save the sample of a sensor losing most of them, they only eat the sampling period
+  uint8_t attempts = 1 + (uint8_t)(((MAX_SENSOR_RETRIES - 1) * (1.0f - p_tHealth->failRate)) + ROUNDING_THRESHOLD);
+  return (attempts > MAX_SENSOR_RETRIES) ? MAX_SENSOR_RETRIES : attempts;
+}
+
+uint32_t ulMspHealth_retryDelayMs(uint8_t attempt)
+{
+  uint32_t delayMs = SENSOR_RETRY_BASE_MS;
+  for (uint8_t i = 1; (i < attempt) && (delayMs < SENSOR_RETRY_MAX_MS); i++)
+  {
+    delayMs *= 2;
+  }
+  return (delayMs > SENSOR_RETRY_MAX_MS) ? SENSOR_RETRY_MAX_MS : delayMs;
+}
+
+void vMspHealth_report(sens_status_t sensor, bool ok)
+{
+  sensorHealth_t *p_tHealth = &tHealth[sensor];
+
+  p_tHealth->failRate += SENSOR_HEALTH_RATE_WEIGHT * ((ok ? 0.0f : 1.0f) - p_tHealth->failRate);
+
+  if (ok)
+  {
+    if (p_tHealth->state == SENSOR_HEALTH_DEGRADED)
+    {
+      log_i("%s answered the probe, back to normal sampling after %lu skipped samples", pcSensorNames[sensor],
+            (unsigned long)p_tHealth->skipped);
+      p_tHealth->state = SENSOR_HEALTH_OK;
+      p_tHealth->probePeriodS = SENSOR_HEALTH_PROBE_MIN_S;
+      p_tHealth->skipped = 0;
+    }
+    p_tHealth->failsInARow = 0;
+    return;
+  }
+
+  if (p_tHealth->failsInARow < UINT16_MAX)
+  {
+    p_tHealth->failsInARow++;
+  }
+
+  if (p_tHealth->state == SENSOR_HEALTH_DEGRADED)
+  {
+    // failed probe, the next one further away
+    p_tHealth->probePeriodS *= 2;
+    if (p_tHealth->probePeriodS > SENSOR_HEALTH_PROBE_MAX_S)
+    {
+      p_tHealth->probePeriodS = SENSOR_HEALTH_PROBE_MAX_S;
+    }
+    p_tHealth->nextProbeMs = millis() + (p_tHealth->probePeriodS * SENSOR_HEALTH_MS_IN_SEC);
+    log_w("%s probe failed, next one in %lu s", pcSensorNames[sensor], (unsigned long)p_tHealth->probePeriodS);
+  }
+  else if (p_tHealth->failsInARow >= SENSOR_HEALTH_DEGRADE_FAILS)
+  {
+    p_tHealth->state = SENSOR_HEALTH_DEGRADED;
+    p_tHealth->probePeriodS = SENSOR_HEALTH_PROBE_MIN_S;
+    p_tHealth->nextProbeMs = millis() + (p_tHealth->probePeriodS * SENSOR_HEALTH_MS_IN_SEC);
+    log_e("%s lost %u samples in a row, degraded: samples skipped, probed every %lu s at least", pcSensorNames[sensor],
+          p_tHealth->failsInARow, (unsigned long)p_tHealth->probePeriodS);
+  }
+}
+
+const sensorHealth_t *p_tMspHealth_get(sens_status_t sensor)
+{
+  return &tHealth[sensor];
+}
@@ -0,0 +1,93 @@
+/******************************************************************************
+ * @file    sensorHealth.h
+ * @author  AB-Engineering - https://ab-engineering.it
+ * @brief   Health of the sensors read with a retry chain: a failure rate
+ *          kept across the averaging intervals sets how many attempts a
+ *          sample gets and how long to wait between them. A sensor failing
+ *          persistently is marked degraded, its samples are skipped without
+ *          any attempt and it is probed again on a slower schedule.
+ * @version 0.1
+ * @date    2025-10-17
+ *
+ * @copyright Copyright (c) 2025
+ *
+ *****************************************************************************/
+
+#ifndef SENSOR_HEALTH_H
+#define SENSOR_HEALTH_H
+
+// -- includes --
+#include <Arduino.h>
+#include "shared_values.h"
+
+#ifndef SENSOR_HEALTH_DEGRADE_FAILS
+#define SENSOR_HEALTH_DEGRADE_FAILS 5 // samples lost in a row before the sensor is degraded
+#endif
+
+#ifndef SENSOR_HEALTH_PROBE_MIN_S
+#define SENSOR_HEALTH_PROBE_MIN_S 300 // first probe of a degraded sensor
+#endif
+
+#ifndef SENSOR_HEALTH_PROBE_MAX_S
+#define SENSOR_HEALTH_PROBE_MAX_S 3600 // the probe period doubles up to this while the sensor stays dead
+#endif
+
+#ifndef SENSOR_RETRY_BASE_MS
+#define SENSOR_RETRY_BASE_MS 250 // wait before the first retry, doubled for each following one
+#endif
+
+#ifndef SENSOR_RETRY_MAX_MS
+#define SENSOR_RETRY_MAX_MS 1000
+#endif
+
+#define SENSOR_HEALTH_RATE_WEIGHT 0.125f /*!< weight of the last sample in the failure rate, ~8 samples of memory */
+
+typedef enum __SENSOR_HEALTH_STATE__
+{
+  SENSOR_HEALTH_OK,
+  SENSOR_HEALTH_DEGRADED, /*!< samples skipped, one attempt at each probe */
+} sensorHealthState_t;
+
+typedef struct __SENSOR_HEALTH__
+{
+  sensorHealthState_t state;
+  float failRate;          /*!< moving average of the lost samples, 0..1 */
+  uint16_t failsInARow;    /*!< samples lost since the last good one */
+  uint32_t probePeriodS;   /*!< degraded: time from a failed probe to the next */
+  uint32_t nextProbeMs;    /*!< degraded: millis() of the next probe */
+  uint32_t skipped;        /*!< samples skipped while degraded */
+} sensorHealth_t;
+
+/******************************************************
+ * @brief every sensor healthy, to be called before the
+ *        acquisition workers start
+ ******************************************************/
+void vMspHealth_init(void);
+
+/******************************************************
+ * @brief attempts the next sample of the sensor gets:
+ *        up to MAX_SENSOR_RETRIES, fewer as its failure
+ *        rate grows; 1 for the probe of a degraded one
+ *        and 0 while it waits for it (sample skipped)
+ ******************************************************/
+uint8_t ucMspHealth_attempts(sens_status_t sensor);
+
+/******************************************************
+ * @brief wait before the retry after a failed attempt,
+ *        attempt counting from 1
+ ******************************************************/
+uint32_t ulMspHealth_retryDelayMs(uint8_t attempt);
+
+/******************************************************
+ * @brief outcome of a sample the sensor was given
+ *        attempts for; degrades it, or brings it back
+ *        after a good probe
+ ******************************************************/
+void vMspHealth_report(sens_status_t sensor, bool ok);
+
+/******************************************************
+ * @brief current health of a sensor
+ ******************************************************/
+const sensorHealth_t *p_tMspHealth_get(sens_status_t sensor);
+
+#endif
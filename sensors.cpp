@@ -17,6 +17,8 @@
 #include <MiCS6814-I2C.h>
 #include <DFRobot_MICS.h>
 #include "sensors.h"
+#include "o3Adc.h"
+#include "channelTable.h"
 #include <stdbool.h>
 
 // PM25 THRESHOLDS
@@ -143,31 +145,87 @@ float fHalSensor_no2AndVocCompensation(float inputGas, bme680Data_t *p_tcurrData
  *******************************************************************************/
 float fHalSensor_analogUgM3O3Read(float *intemp, sensorData_t *p_tData)
 {
+  float points = 0.0f;
+  bHalSensor_analogO3Points(p_tData, &points);
+  return fHalSensor_o3ReadingToUgM3(points, intemp, p_tData);
+}
 
-  int points = 0;
+/********************************************************************************
+ * @brief ozone sample from the ADC sampling engine: filtered ADC points, zero
+ *        offset removed
+ *
+ * @param p_tData
+ * @param p_fPoints
+ * @return false when the engine has no recent reading
+ *******************************************************************************/
+bool bHalSensor_analogO3Points(sensorData_t *p_tData, float *p_fPoints)
+{
+  float filtered = 0.0f;
+  if (!bHalO3Adc_read(&filtered))
+  {
+    return false;
+  }
+  // kept fractional: one point is ~4 ug/m3, rounding would throw the oversampling away
+  log_d("ADC filtered points: %.2f", filtered);
+  *p_fPoints = filtered;
+  if (p_tData->ozoneData.o3ZeroOffset != O3_SENS_DISABLE_ZERO_OFFSET)
+  {
+    *p_fPoints -= (float)p_tData->ozoneData.o3ZeroOffset;
+  }
+  return true;
+}
+
+/********************************************************************************
+ * @brief converts an ozone sample to ug/m3, compensated with the measured
+ *        temperature when the BME680 is available
+ *
+ * @param points
+ * @param intemp
+ * @param p_tData
+ * @return float
+ *******************************************************************************/
+float fHalSensor_o3ReadingToUgM3(float points, float *intemp, sensorData_t *p_tData)
+{
   float currTemp = REFERENCE_TEMP_C; // initialized at OSHA standard conditions for temperature compensation
   if (p_tData->status.BME680Sensor)
   {
     currTemp = *intemp; // using current measured temperature
     log_d("Current measured temperature is %.3f", currTemp);
   }
-  const short readtimes = 10; // reading 10 times for good measure
-  for (short i = 0; i < readtimes; i++)
-  {
-    int readnow = analogRead(O3_ADC_PIN);
-    pinMode(O3_ADC_PIN, INPUT_PULLDOWN); // must invoke after every analogRead
-    log_v("ADC Read is: %d", readnow);
-    points += readnow;
-    delay(10);
-  }
-  points /= readtimes;
-  log_d("ADC Read averaged is: %d", points);
-  points -= p_tData->ozoneData.o3ZeroOffset;
-  if (points <= 0)
+  return fHalSensor_o3PointsToUgM3(points, currTemp);
+}
+
+/********************************************************************************
+ * @brief converts the averaged ozone ADC points, zero offset removed,
+ *        to a temperature compensated ug/m3 value
+ *
+ * @param points
+ * @param currTemp
+ * @return float
+ *******************************************************************************/
+float fHalSensor_o3PointsToUgM3(float points, float currTemp)
+{
+  if (points <= 0.0f)
     return 0.0;
   return (((points * O3_CALC_FACTOR_1) * O3_CALC_FACTOR_2 * O3_CALC_FACTOR_3) / (CELIUS_TO_KELVIN + currTemp)); // temperature compensated
 }
 
+/********************************************************************************
+ * @brief reduces the station pressure to sea level with the ISA model
+ *
+ * @param pressure      station pressure in hPa
+ * @param temperature   air temperature in C
+ * @param altitude      station altitude in m
+ * @return float
+ *******************************************************************************/
+float fHalSensor_seaLevelPressure(float pressure, float temperature, float altitude)
+{
+  return (pressure *
+          pow(1 - (STD_TEMP_LAPSE_RATE * altitude /
+                   (temperature + STD_TEMP_LAPSE_RATE * altitude + CELIUS_TO_KELVIN)),
+              ISA_DERIVED_EXPONENTIAL));
+}
+
 /******************************************************************************
  * @brief   print measurements to serial output
  *
@@ -184,56 +242,54 @@ void vHalSensor_printMeasurementsOnSerial(send_data_t *data, sensorData_t *p_tPt
 
   log_i("Measurements log:"); // Log measurements to serial output
   log_i("Date&time: %s %s", locDate, locTime);
-  if (p_tPtr->status.BME680Sensor)
-  {
-    log_i("Temperature: %.2f C", data->temp);
-    log_i("Humidity: %.2f%%", data->hum);
-    log_i("Pressure: %.2f hPa", data->pre);
-    log_i("VOC: %.2f kOhm", data->VOC);
-  }
-  if (p_tPtr->status.PMS5003Sensor)
-  {
-    log_i("PM10: %d ug/m3", data->PM10);
-    log_i("PM2.5: %d ug/m3", data->PM25);
-    log_i("PM1: %d ug/m3", data->PM1);
-  }
-  if (p_tPtr->status.O3Sensor)
-  {
-    log_i("O3: %.2f ug/m3", data->ozone);
-  }
-  if (p_tPtr->status.MICS6814Sensor)
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
   {
-    log_i("NOx: %.2f ug/m3", data->MICS_NO2);
-    log_i("CO: %.2f ug/m3", data->MICS_CO);
-    log_i("NH3: %.2f ug/m3", data->MICS_NH3);
+    if (bMspChan_fitted(&p_tPtr->status, tMspChan_sensor((stats_channel_t)ch)))
+    {
+      log_i("%s: %.*f %s", pcMspChan_label((stats_channel_t)ch), bMspChan_whole((stats_channel_t)ch) ? 0 : 2,
+            fMspChan_sent(data, (stats_channel_t)ch), pcMspChan_unit((stats_channel_t)ch));
+    }
   }
   log_i("Measurements logged successfully");
 }
 
 /*****************************************************************************************************
- * @brief
- *
- * @param p_tErr
- * @param p_tData
- * @param number_of_measurements
+ * @brief   divides the sums of the channels of a sensor by its valid readings; the whole channels
+ *          (PMS5003) stay whole, as the driver has always kept them
  *****************************************************************************************************/
-void vHalSensor_performAverages(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas)
+static void vHalSensor_averageChannels(sensorData_t *p_tData, channelSensor_t sensor, short runs)
 {
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
+  {
+    stats_channel_t channel = (stats_channel_t)ch;
+    if (tMspChan_sensor(channel) != sensor)
+    {
+      continue;
+    }
+    if (bMspChan_whole(channel))
+    {
+      float mean = (int32_t)fMspChan_get(p_tData, channel) / runs;
+      vMspChan_set(p_tData, channel, ((mean - (int32_t)mean) >= ROUNDING_THRESHOLD) ? mean + 1.0f : mean);
+    }
+    else
+    {
+      vMspChan_set(p_tData, channel, fMspChan_get(p_tData, channel) / runs);
+    }
+  }
+}
 
-  log_i("=== AVERAGING CALCULATION ===");
-  log_i("Total measurement_count: %d", p_tMeas->measurement_count);
-  log_i("Error counts: BME=%d, PMS=%d, MICS=%d, O3=%d", p_tErr->BMEfails, p_tErr->PMSfails, p_tErr->MICSfails, p_tErr->O3fails);
-
+/*****************************************************************************************************
+ * @brief   BME680 cycle average, the sensor is switched off when no reading was valid
+ *****************************************************************************************************/
+void vHalSensor_averageBME680(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas)
+{
   short runs = p_tMeas->measurement_count - p_tErr->BMEfails;
   log_i("BME680: runs = %d - %d = %d", p_tMeas->measurement_count, p_tErr->BMEfails, runs);
   if (p_tData->status.BME680Sensor && (runs > 0))
   {
     log_i("BME680 BEFORE: temp=%.3f, pressure=%.3f, humidity=%.3f", 
           p_tData->gasData.temperature, p_tData->gasData.pressure, p_tData->gasData.humidity);
-    p_tData->gasData.temperature /= runs;
-    p_tData->gasData.pressure /= runs;
-    p_tData->gasData.humidity /= runs;
-    p_tData->gasData.volatileOrganicCompounds /= runs;
+    vHalSensor_averageChannels(p_tData, CHAN_SENSOR_BME680, runs);
     log_i("BME680 AFTER: temp=%.3f, pressure=%.3f, humidity=%.3f (divided by %d)", 
           p_tData->gasData.temperature, p_tData->gasData.pressure, p_tData->gasData.humidity, runs);
   }
@@ -242,64 +298,49 @@ void vHalSensor_performAverages(errorVars_t *p_tErr, sensorData_t *p_tData, devi
     p_tData->status.BME680Sensor = false;
     p_tErr->senserrs[SENS_STAT_BME680] = true;
   }
+}
 
-  runs = p_tMeas->measurement_count - p_tErr->PMSfails;
+/*****************************************************************************************************
+ * @brief   PMS5003 cycle average, rounded to the nearest integer
+ *****************************************************************************************************/
+void vHalSensor_averagePMS5003(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas)
+{
+  short runs = p_tMeas->measurement_count - p_tErr->PMSfails;
   if (p_tData->status.PMS5003Sensor && (runs > 0))
   {
-    float pmValue = 0.0f;
-
-    pmValue = p_tData->airQualityData.particleMicron1 / runs;
-
-    if ((pmValue - (int32_t) pmValue) >= ROUNDING_THRESHOLD)
-    {
-      p_tData->airQualityData.particleMicron1 = (int32_t) pmValue + 1;
-    }
-    else
-    {
-      p_tData->airQualityData.particleMicron1 = (int32_t) pmValue;
-    }
-
-    pmValue = p_tData->airQualityData.particleMicron25 / runs;
-
-    if ((pmValue - (int32_t) pmValue) >= ROUNDING_THRESHOLD)
-    {
-      p_tData->airQualityData.particleMicron25 = (int32_t) pmValue + 1;
-    }
-    else
-    {
-      p_tData->airQualityData.particleMicron25 = (int32_t) pmValue;
-    }
-
-    pmValue = p_tData->airQualityData.particleMicron10 / runs;
-    if ((pmValue - (int32_t) pmValue) >= ROUNDING_THRESHOLD)
-    {
-      p_tData->airQualityData.particleMicron10 = (int32_t) pmValue + 1;
-    }
-    else
-    {
-      p_tData->airQualityData.particleMicron10 = (int32_t) pmValue;
-    }
+    vHalSensor_averageChannels(p_tData, CHAN_SENSOR_PMS5003, runs);
   }
   else if (p_tData->status.PMS5003Sensor)
   {
     p_tData->status.PMS5003Sensor = false;
     p_tErr->senserrs[SENS_STAT_PMS5003] = true;
   }
+}
 
-  runs = p_tMeas->measurement_count - p_tErr->MICSfails;
+/*****************************************************************************************************
+ * @brief   MICS6814 cycle average
+ *****************************************************************************************************/
+void vHalSensor_averageMICS6814(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas)
+{
+  short runs = p_tMeas->measurement_count - p_tErr->MICSfails;
   if (p_tData->status.MICS6814Sensor && (runs > 0))
   {
-    p_tData->pollutionData.carbonMonoxide /= runs;
-    p_tData->pollutionData.nitrogenDioxide /= runs;
-    p_tData->pollutionData.ammonia /= runs;
+    vHalSensor_averageChannels(p_tData, CHAN_SENSOR_MICS6814, runs);
   }
   else if (p_tData->status.MICS6814Sensor)
   {
     p_tData->status.MICS6814Sensor = false;
     p_tErr->senserrs[SENS_STAT_MICSxxxx] = true;
   }
+}
+
+/*****************************************************************************************************
+ * @brief   MICS4514 gas concentrations from the averaged ADC counts
+ *****************************************************************************************************/
+void vHalSensor_averageMICS4514(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas)
+{
+  short runs = p_tMeas->measurement_count - p_tErr->MICSfails;
 
-  // MICS4514 sensor averaging - calculate gas concentrations from averaged ADC values
   if (p_tData->status.MICS4514Sensor && (runs > 0))
   {
     MICS4514SensorReading_t micsReading;
@@ -352,11 +393,17 @@ void vHalSensor_performAverages(errorVars_t *p_tErr, sensorData_t *p_tData, devi
     p_tData->status.MICS4514Sensor = false;
     p_tErr->senserrs[SENS_STAT_MICSxxxx] = true;
   }
+}
 
-  runs = p_tMeas->measurement_count - p_tErr->O3fails;
+/*****************************************************************************************************
+ * @brief   O3 cycle average
+ *****************************************************************************************************/
+void vHalSensor_averageO3(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas)
+{
+  short runs = p_tMeas->measurement_count - p_tErr->O3fails;
   if (p_tData->status.O3Sensor && runs > 0)
   {
-    p_tData->ozoneData.ozone /= runs;
+    vHalSensor_averageChannels(p_tData, CHAN_SENSOR_O3, runs);
   }
   else if (p_tData->status.O3Sensor)
   {
@@ -365,6 +412,62 @@ void vHalSensor_performAverages(errorVars_t *p_tErr, sensorData_t *p_tData, devi
   }
 }
 
+/*****************************************************************************************************
+ * @brief   cycle average of every sensor, for the callers without the driver table of the sketch
+ *          (host replay engine)
+ *
+ * @param p_tErr
+ * @param p_tData
+ * @param p_tMeas
+ *****************************************************************************************************/
+void vHalSensor_performAverages(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas)
+{
+  log_i("=== AVERAGING CALCULATION ===");
+  log_i("Total measurement_count: %d", p_tMeas->measurement_count);
+  log_i("Error counts: BME=%d, PMS=%d, MICS=%d, O3=%d", p_tErr->BMEfails, p_tErr->PMSfails, p_tErr->MICSfails, p_tErr->O3fails);
+
+  vHalSensor_averageBME680(p_tErr, p_tData, p_tMeas);
+  vHalSensor_averagePMS5003(p_tErr, p_tData, p_tMeas);
+  vHalSensor_averageMICS6814(p_tErr, p_tData, p_tMeas);
+  vHalSensor_averageMICS4514(p_tErr, p_tData, p_tMeas);
+  vHalSensor_averageO3(p_tErr, p_tData, p_tMeas);
+}
+
+/*****************************************************************************************************
+ * @brief   aggregated value of a channel, false when the mean of the driver has to stay
+ *******************************************************************************************************/
+static bool bHalSensor_aggregate(const channelStats_t *p_tStats, const uint8_t *p_ucMethods, stats_channel_t channel, float *p_fValue)
+{
+  statsMethod_t method = (statsMethod_t)p_ucMethods[channel];
+  if ((method >= STATS_METHOD_MAX) || (p_tStats[channel].count == 0))
+  {
+    return false;
+  }
+  // with a sample every period the time weights are all the same, the driver mean stands
+  if ((method == STATS_METHOD_MEAN) && !p_tStats[channel].uneven)
+  {
+    return false;
+  }
+  *p_fValue = fMspStats_value(&p_tStats[channel], method);
+  log_i("%s: %s %.3f over %lu samples", pcMspStats_channelName(channel), pcMspStats_methodName(method), *p_fValue,
+        (unsigned long)p_tStats[channel].count);
+  return true;
+}
+
+void vHalSensor_applyAggregation(sensorData_t *p_tData, const channelStats_t *p_tStats, const uint8_t *p_ucMethods)
+{
+  float value = 0.0f;
+
+  for (int ch = 0; ch < STATS_CH_MAX; ch++)
+  {
+    stats_channel_t channel = (stats_channel_t)ch;
+    if (bMspChan_fitted(&p_tData->status, tMspChan_sensor(channel)) && bHalSensor_aggregate(p_tStats, p_ucMethods, channel, &value))
+    {
+      vMspChan_set(p_tData, channel, bMspChan_whole(channel) ? (float)lroundf(value) : value);
+    }
+  }
+}
+
 /*****************************************************************************************************
  * @brief   evaluates the MSP# index from ug/m3 concentrations of specific gases using standard
  *          IAQ values (needs 1h averages)
@@ -446,10 +549,10 @@ short sHalSensor_evaluateMSPIndex(sensorData_t *p_tData)
 /**
  * @brief Read raw ADC values from MICS4514 sensor and accumulate for averaging
  * @param mics4514          Reference to DFRobot MICS4514 sensor object
- * @param p_tData           Pointer to sensor data structure with accumulator
+ * @param p_tAdc            Pointer to the ADC accumulator of the reading
  * @return mspStatus_t      STATUS_OK on success, STATUS_ERR on failure
  */
-mspStatus_t tHalSensor_readMICS4514_ADC(DFRobot_MICS& mics4514, sensorData_t* p_tData)
+mspStatus_t tHalSensor_readMICS4514_ADC(DFRobot_MICS& mics4514, MICS4514AdcAccumulator_t* p_tAdc)
 {
   // Get voltage readings from MICS4514 sensor using standard DFRobot API
   // getADCData() returns voltage in ADC counts (10-bit ADC: 0-1023)
@@ -466,12 +569,12 @@ mspStatus_t tHalSensor_readMICS4514_ADC(DFRobot_MICS& mics4514, sensorData_t* p_
   }
 
   // Accumulate raw ADC values for later averaging
-  p_tData->mics4514AdcAccumulator.oxVoltageSum += (uint32_t)ox_voltage_counts;
-  p_tData->mics4514AdcAccumulator.redVoltageSum += (uint32_t)red_voltage_counts;
+  p_tAdc->oxVoltageSum += (uint32_t)ox_voltage_counts;
+  p_tAdc->redVoltageSum += (uint32_t)red_voltage_counts;
 
   log_d("MICS4514 accumulated - OX sum: %u, RED sum: %u",
-        p_tData->mics4514AdcAccumulator.oxVoltageSum,
-        p_tData->mics4514AdcAccumulator.redVoltageSum);
+        p_tAdc->oxVoltageSum,
+        p_tAdc->redVoltageSum);
 
   return STATUS_OK;
 }
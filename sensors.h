@@ -17,6 +17,7 @@
 
 // -- includes --
 #include "shared_values.h"
+#include "channelStats.h"
 #include <bsec.h>
 
 // Forward declaration to avoid circular includes
@@ -56,6 +57,14 @@ class DFRobot_MICS;
 #define O3_SENS_DISABLE_ZERO_OFFSET (-1)
 
 #define PMS_PREHEAT_TIME_IN_SEC 20 /*!<PMS5003 preheat time in seconds, defaults to 45 seconds */
+#define PMS_SAMPLE_WINDOW_IN_SEC 5  /*!<frames averaged into a sample, the last ones of the preheat */
+#define PMS_MIN_SLEEP_TIME_IN_SEC 10 /*!<shorter sleeps keep the PMS5003 running between samples */
+
+#ifndef BSEC_STATE_SAVE_PERIOD_MIN
+#define BSEC_STATE_SAVE_PERIOD_MIN 60 /*!<BSEC calibration state saved to the SD card this often */
+#endif
+#define BSEC_STATE_CALIBRATED_ACCURACY 3 /*!<IAQ accuracy of a calibrated BSEC, its state is saved once reached */
+#define BSEC_STATE_SHUTDOWN_WAIT_MS 500  /*!<for the I2C worker to finish a BSEC run, at a restart */
 
 // PPM to µg/m³ conversion constants
 #define MOLAR_VOLUME_STP            24.45f             // Molar volume at STP (L/mol)
@@ -130,6 +139,47 @@ float fHalSensor_no2AndVocCompensation(float inputGas, bme680Data_t *p_tcurrData
  *******************************************************************************/
 float fHalSensor_analogUgM3O3Read(float *intemp, sensorData_t *p_tData);
 
+/********************************************************************************
+ * @brief ozone sample from the ADC sampling engine: filtered ADC points, zero
+ *        offset removed
+ *
+ * @param p_tData
+ * @param p_fPoints
+ * @return false when the engine has no recent reading
+ *******************************************************************************/
+bool bHalSensor_analogO3Points(sensorData_t *p_tData, float *p_fPoints);
+
+/********************************************************************************
+ * @brief converts an ozone sample to ug/m3, compensated with the measured
+ *        temperature when the BME680 is available
+ *
+ * @param points
+ * @param intemp
+ * @param p_tData
+ * @return float
+ *******************************************************************************/
+float fHalSensor_o3ReadingToUgM3(float points, float *intemp, sensorData_t *p_tData);
+
+/********************************************************************************
+ * @brief converts the averaged ozone ADC points, zero offset removed,
+ *        to a temperature compensated ug/m3 value
+ *
+ * @param points
+ * @param currTemp
+ * @return float
+ *******************************************************************************/
+float fHalSensor_o3PointsToUgM3(float points, float currTemp);
+
+/********************************************************************************
+ * @brief reduces the station pressure to sea level with the ISA model
+ *
+ * @param pressure      station pressure in hPa
+ * @param temperature   air temperature in C
+ * @param altitude      station altitude in m
+ * @return float
+ *******************************************************************************/
+float fHalSensor_seaLevelPressure(float pressure, float temperature, float altitude);
+
 /*******************************************************************************
  * @brief print measurements to serial output
  * 
@@ -140,14 +190,37 @@ void vHalSensor_printMeasurementsOnSerial(send_data_t *data, sensorData_t *p_tPt
 
 
 /*****************************************************************************************************
- * @brief 
- * 
- * @param p_tErr 
- * @param p_tData 
- * @param number_of_measurements 
+ * @brief   cycle average of one sensor: the sums of the cycle are divided by its valid readings;
+ *          with none the sensor is switched off and flagged in p_tErr->senserrs
+ *****************************************************************************************************/
+void vHalSensor_averageBME680(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas);
+void vHalSensor_averagePMS5003(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas);
+void vHalSensor_averageMICS6814(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas);
+void vHalSensor_averageMICS4514(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas);
+void vHalSensor_averageO3(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas);
+
+/*****************************************************************************************************
+ * @brief   cycle average of every sensor, in the order of the sketch driver table
+ *
+ * @param p_tErr
+ * @param p_tData
+ * @param p_tMeas
  *****************************************************************************************************/
 void vHalSensor_performAverages(errorVars_t *p_tErr, sensorData_t *p_tData, deviceMeasurement_t *p_tMeas);
 
+/*****************************************************************************************************
+ * @brief   replaces the means of vHalSensor_performAverages() with the aggregation method set for
+ *          each channel, computed on the streaming statistics of the interval; channels on
+ *          STATS_METHOD_MEAN get the time-weighted mean once a sampling period was missed, the
+ *          others on it, without samples or of a sensor averaging failed are left alone.
+ *          The MICS4514 gases are computed from the averaged ADC counts and keep the mean.
+ *
+ * @param  p_tData     averaged sensor data
+ * @param  p_tStats    statistics of the interval, STATS_CH_MAX channels
+ * @param  p_ucMethods statsMethod_t of each channel
+ *******************************************************************************************************/
+void vHalSensor_applyAggregation(sensorData_t *p_tData, const channelStats_t *p_tStats, const uint8_t *p_ucMethods);
+
 
 /*****************************************************************************************************
  * @brief   evaluates the MSP# index from ug/m3 concentrations of specific gases using standard
@@ -174,10 +247,10 @@ short sHalSensor_evaluateMSPIndex(sensorData_t *p_tData);
 /**
  * @brief Read raw ADC values from MICS4514 sensor and accumulate for averaging
  * @param mics4514          Reference to DFRobot MICS4514 sensor object
- * @param p_tData           Pointer to sensor data structure with accumulator
+ * @param p_tAdc            Pointer to the ADC accumulator of the reading
  * @return mspStatus_t      STATUS_OK on success, STATUS_ERR on failure
  */
-mspStatus_t tHalSensor_readMICS4514_ADC(DFRobot_MICS& mics4514, sensorData_t* p_tData);
+mspStatus_t tHalSensor_readMICS4514_ADC(DFRobot_MICS& mics4514, MICS4514AdcAccumulator_t* p_tAdc);
 
 /**
  * @brief Calculate gas concentrations from averaged MICS4514 ADC values
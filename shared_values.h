@@ -60,6 +60,16 @@ typedef enum __SYSTEM_STATES__
   SYS_STATE_MAX_STATES
 } system_states_t;
 
+// latency statistics slots: the system_states_t visits, then the sensor retry chains of SYS_STATE_READ_SENSORS
+typedef enum __LATENCY_SLOTS__
+{
+  LATENCY_SLOT_BME680 = SYS_STATE_MAX_STATES,
+  LATENCY_SLOT_PMS5003,
+  LATENCY_SLOT_MICS, /*!< MICS6814 or MICS4514 */
+  LATENCY_SLOT_O3,
+  LATENCY_SLOT_MAX
+} latency_slot_t;
+
 typedef enum __MY_NETWORK_EVENTS__
 {
   NET_EVENT_CONNECTED = (1 << 0),    /*!< Network connected event */
@@ -219,6 +229,23 @@ typedef enum __MSP_ELEMENT_INDEX__
   MSP_INDEX_MAX = 3
 } msp_index_t;
 
+// measurement channels of the streaming statistics (channelStats.h)
+typedef enum __STATS_CHANNELS__
+{
+  STATS_CH_TEMP = 0,
+  STATS_CH_HUM,
+  STATS_CH_PRE,
+  STATS_CH_VOC,
+  STATS_CH_CO,
+  STATS_CH_NO2,
+  STATS_CH_NH3,
+  STATS_CH_PM1,
+  STATS_CH_PM25,
+  STATS_CH_PM10,
+  STATS_CH_O3,
+  STATS_CH_MAX
+} stats_channel_t;
+
 //-- Gas sensor types --
 typedef enum __GAS_SENSOR_TYPE__
 {
@@ -237,6 +264,10 @@ typedef struct __SYSTEM_STATUS__
   uint8_t server_ok;
   uint8_t fwAutoUpgrade;
   uint8_t gasSensorType; // 0 = MICS6814, 1 = MICS4514, etc.
+  uint8_t uploadLatency; // add the loop latency fields to the uploads
+  uint8_t aggregation[STATS_CH_MAX]; // statsMethod_t of each channel over the averaging interval
+  uint8_t micsBaselineMode; // micsBaselineMode_t, what is done with the tracked MICS R0
+  uint8_t micsBaselineDays; // days between two MICS R0 proposals
 } systemStatus_t;
 
 typedef struct __NETWORK__
@@ -260,6 +291,7 @@ typedef struct __MEASUREMENT__
   int32_t measurement_count; /*!< Number of measurements in the current cycle */
   bool data_transmitted; /*!< Flag to prevent duplicate transmissions in the same cycle */
   time_t last_transmission_epoch; /*!< Unix timestamp of last transmission (0 = never transmitted) */
+  time_t last_read_epoch; /*!< Unix timestamp of the minute of the last sensor reading (0 = none) */
   int32_t curr_minutes;
   int32_t curr_seconds;
   int32_t curr_total_seconds;
@@ -310,6 +342,12 @@ typedef struct __SEND_DATA__
   float MICS_NH3;
   float ozone;
   int8_t MSP; /*!< MSP# Index */
+  int16_t caqi; /*!< EU Common Air Quality Index of the rolling windows, -1 = none covered yet */
+  bool hasLatency; /*!< latencyMaxUs is filled in and goes to the server */
+  uint32_t latencyMaxUs[LATENCY_SLOT_MAX]; /*!< longest run of each latency slot since the previous record, 0 = none */
+  float dispersion[STATS_CH_MAX]; /*!< standard deviation of the samples of each channel, < 0 = not available */
+  uint16_t periods;               /*!< sampling periods in the interval */
+  uint16_t covered[STATS_CH_MAX]; /*!< periods with a sample of each channel, 0 = none */
 } send_data_t;
 
 #endif
\ No newline at end of file